@@ -0,0 +1,180 @@
+#include "pixelforge.h"
+#include "pfm.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#else
+#   include <time.h>
+#endif
+
+#define THUMBNAIL_SIZE  128
+#define JOB_COUNT       512
+
+#define SPHERE_SLICES   48
+#define SPHERE_STACKS   32
+
+typedef struct {
+    PFrenderlist sphere;        // Shared by all the contexts of the pool
+    PFtexture texture;          // Shared by all the contexts of the pool
+    PFuint *checksums;          // Stands in for the encoding of the images
+} Scene;
+
+static double GetTime(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart/frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
+static void Sphere_Record(void)
+{
+    pfBegin(PF_TRIANGLES);
+    for (int j = 0; j < SPHERE_STACKS; j++) {
+        for (int i = 0; i < SPHERE_SLICES; i++) {
+            const int corners[6][2] = { {0,0}, {0,1}, {1,0}, {1,0}, {0,1}, {1,1} };
+            for (int k = 0; k < 6; k++) {
+                float u = (float)(i + corners[k][0])/SPHERE_SLICES;
+                float v = (float)(j + corners[k][1])/SPHERE_STACKS;
+                float theta = v*PFM_PI, phi = u*2.0f*PFM_PI;
+                float x = sinf(theta)*cosf(phi), y = cosf(theta), z = sinf(theta)*sinf(phi);
+                pfColor3f(1.0f, 1.0f, 1.0f);
+                pfTexCoord2f(4.0f*u, 2.0f*v);
+                pfNormal3f(x, y, z);
+                pfVertex3f(x, y, z);
+            }
+        }
+    }
+    pfEnd();
+}
+
+static void RenderThumbnail(PFsizei jobIndex, void* pixels, void* userData)
+{
+    Scene *scene = userData;
+
+    pfClearColor(32, 32, 48, 255);
+    pfClear(PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT);
+
+    pfMatrixMode(PF_PROJECTION);
+    pfLoadIdentity();
+    pfFrustum(-0.1, 0.1, -0.1, 0.1, 0.1, 100.0);
+
+    pfMatrixMode(PF_MODELVIEW);
+    pfLoadIdentity();
+    pfTranslatef(0.0f, 0.0f, -3.0f);
+    pfRotatef(jobIndex*7.0f, 0.3f, 1.0f, 0.0f);
+
+    pfEnable(PF_DEPTH_TEST);
+    pfEnable(PF_TEXTURE_2D);
+    pfEnable(PF_LIGHTING);
+    pfEnableLight(PF_LIGHT0);
+
+    PFfloat lightPos[3] = { 2.0f, 2.0f, 2.0f };
+    pfLightfv(PF_LIGHT0, PF_POSITION, lightPos);
+
+    pfBindTexture(scene->texture);
+    pfCallList(scene->sphere);
+
+    // The image must be complete before reading the pixels
+    pfFinish();
+
+    PFuint checksum = 0;
+    for (int i = 0; i < THUMBNAIL_SIZE*THUMBNAIL_SIZE; i++) {
+        checksum = checksum*31 + ((PFuint*)pixels)[i];
+    }
+    scene->checksums[jobIndex] = checksum;
+}
+
+int main(int argc, char* argv[])
+{
+    int jobCount = (argc > 1) ? atoi(argv[1]) : JOB_COUNT;
+    if (jobCount <= 0) jobCount = JOB_COUNT;
+
+    // The default thread count is the number of logical processors
+    int maxThreads = (int)pfGetThreadCount();
+
+    // The shared resources are created with a context of their own
+    PFuint *checker = malloc(64*64*sizeof(PFuint));
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            checker[y*64 + x] = ((x/8 + y/8) & 1) ? 0xFF2080FF : 0xFFFFE0A0;
+        }
+    }
+
+    PFuint *dummy = malloc(sizeof(PFuint));
+    PFcontext ctx = pfCreateContext(dummy, 1, 1, PF_RGBA, PF_UNSIGNED_BYTE);
+    pfMakeCurrent(ctx);
+
+    Scene scene = { 0 };
+    scene.texture = pfGenTexture(checker, 64, 64, PF_RGBA, PF_UNSIGNED_BYTE);
+    scene.checksums = calloc(jobCount, sizeof(PFuint));
+    scene.sphere = pfGenList();
+
+    pfNewList(scene.sphere);
+        Sphere_Record();
+    pfEndList();
+
+    printf("%d thumbnails of %dx%d pixels, %d triangles each\n\n", jobCount,
+        THUMBNAIL_SIZE, THUMBNAIL_SIZE, 2*SPHERE_SLICES*SPHERE_STACKS);
+    printf("threads | time (ms) | images/s | speedup\n");
+
+    double referenceTime = 0.0;
+    PFuint referenceChecksum = 0;
+
+    // NOTE: Doubles the thread count, the highest count is measured even if it isn't a power of two
+    for (int threads = 1; threads <= maxThreads;
+         threads = (threads < maxThreads && threads*2 > maxThreads) ? maxThreads : threads*2) {
+        pfSetThreadCount(threads);
+
+        PFcontextpool pool = pfCreateContextPool(threads,
+            THUMBNAIL_SIZE, THUMBNAIL_SIZE, PF_RGBA, PF_UNSIGNED_BYTE);
+
+        if (pool == NULL) {
+            fprintf(stderr, "Failed to create a pool of %d contexts\n", threads);
+            break;
+        }
+
+        // Warm-up run, also starts the worker threads
+        pfRenderJobs(pool, threads, RenderThumbnail, &scene);
+
+        double start = GetTime();
+        pfRenderJobs(pool, jobCount, RenderThumbnail, &scene);
+        double elapsed = GetTime() - start;
+
+        PFuint checksum = 0;
+        for (int i = 0; i < jobCount; i++) {
+            checksum = checksum*31 + scene.checksums[i];
+        }
+
+        if (threads == 1) {
+            referenceTime = elapsed;
+            referenceChecksum = checksum;
+        }
+
+        printf("%7d | %9.1f | %8.1f | %6.2fx%s\n", threads, elapsed*1000.0, jobCount/elapsed,
+            referenceTime/elapsed, (checksum == referenceChecksum) ? "" : " (images differ!)");
+
+        pfDeleteContextPool(&pool);
+    }
+
+    pfDeleteList(&scene.sphere);
+    pfDeleteTexture(&scene.texture, PF_FALSE);
+    pfDeleteContext(ctx);
+
+    free(scene.checksums);
+    free(checker);
+    free(dummy);
+
+    return 0;
+}
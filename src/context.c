@@ -18,6 +18,13 @@
  */
 
 #include "internal/context/context.h"
+#include "internal/context/command.h"
+#include "internal/context/raster.h"
+#include "internal/primitives/primitives.h"
+#include "internal/renderlist.h"
+#include "internal/attribute.h"
+#include "internal/skinning.h"
+#include "internal/threadpool.h"
 #include "internal/config.h"
 #include "internal/pixel.h"
 #include "internal/blend.h"
@@ -38,82 +45,469 @@ PF_CTX_DECL PFIctx *G_currentCtx = NULL;
 
 /* Some static helper functions */
 
-static void pfiResetVertexBufferForNextElement()
+// NOTE: Only updates the MVP by default but also updates the normal matrix if necessary
+static void pfiUpdateMatrices(PFboolean matNormal)
 {
-    switch (G_currentCtx->currentDrawMode) {
-        case PF_TRIANGLE_FAN:
-        case PF_TRIANGLE_STRIP:
-            G_currentCtx->vertexCounter = 1;
-            G_currentCtx->vertexBuffer[0] = G_currentCtx->vertexBuffer[3];
-            break;
-        case PF_QUAD_FAN:
-        case PF_QUAD_STRIP:
-            G_currentCtx->vertexCounter = 2;
-            G_currentCtx->vertexBuffer[0] = G_currentCtx->vertexBuffer[4];
-            G_currentCtx->vertexBuffer[1] = G_currentCtx->vertexBuffer[5];
-            break;
-        default:
-            G_currentCtx->vertexCounter = 0;
-            break;
+    pfiComputeMVP(G_currentCtx->matMVP);
+
+    if (matNormal && G_currentCtx->state & PF_LIGHTING) {
+        if (G_currentCtx->modelMatrixUsed) {
+            pfmMat4Invert(G_currentCtx->matNormal, G_currentCtx->matModel);
+            pfmMat4Transpose(G_currentCtx->matNormal, G_currentCtx->matNormal);
+        } else {
+            pfmMat4Identity(G_currentCtx->matNormal);
+        }
     }
 }
 
-static PFsizei pfiGetDrawModeVertexCount(PFdrawmode mode)
+typedef struct {
+    const PFIvertexattribs *attribs;
+    const PFMmat4 *bonePalette;
+    const void *indices;        ///< Indices of 'pfDrawElements', NULL for 'pfDrawArrays'
+    PFdatatype type;
+    PFint first;
+    PFcolor color;
+    PFboolean useTexCoordArray;
+    PFboolean useTexCoord1Array;
+    PFboolean useNormalArray;
+    PFboolean useColorArray;
+    PFboolean useSkinning;
+} PFIvertexfetch;
+
+static void pfiInitVertexFetch(PFIvertexfetch* fetch, const void* indices, PFdatatype type, PFint first)
 {
-    switch (mode) {
-        case PF_POINTS:         return 1;
-        case PF_LINES:          return 2;
-        case PF_TRIANGLES:      return 3;
-        case PF_TRIANGLE_FAN:
-        case PF_TRIANGLE_STRIP: return 4;
-        case PF_QUADS:          return 4;
-        case PF_QUAD_FAN:
-        case PF_QUAD_STRIP:     return 6;
+    const PFIvertexattribs *attribs = &G_currentCtx->vertexAttribs;
+
+    fetch->attribs = attribs;
+    fetch->bonePalette = (const PFMmat4*)G_currentCtx->bonePalette;
+    fetch->indices = indices;
+    fetch->type = type;
+    fetch->first = first;
+    fetch->color = G_currentCtx->currentColor;
+
+    fetch->useTexCoordArray = G_currentCtx->state & PF_TEXTURE_COORD_ARRAY && attribs->texcoords.buffer;
+    fetch->useTexCoord1Array = G_currentCtx->texture1State & PF_TEXTURE_COORD_ARRAY && attribs->texcoords1.buffer;
+    fetch->useNormalArray = G_currentCtx->state & PF_NORMAL_ARRAY && attribs->normals.buffer;
+    fetch->useColorArray = G_currentCtx->state & PF_COLOR_ARRAY && attribs->colors.buffer;
+
+    fetch->useSkinning = (G_currentCtx->state & (PF_WEIGHT_ARRAY | PF_BONE_INDEX_ARRAY)) == (PF_WEIGHT_ARRAY | PF_BONE_INDEX_ARRAY)
+                       && attribs->weights.buffer && attribs->boneIndices.buffer;
+}
+
+// NOTE: Does not access the current context, so it can be called
+//       from the jobs of 'pfiProcessRasterize_TRIANGLES_PARALLEL'
+static void pfiFetchVertex(const void* data, PFsizei index, PFIvertex* vertex)
+{
+    const PFIvertexfetch *fetch = data;
+    const PFIvertexattribs *attribs = fetch->attribs;
+
+    // Get vertex index
+    PFsizei j = fetch->first + index;
+
+    if (fetch->indices) {
+        switch(fetch->type) {
+            case PF_UNSIGNED_BYTE:  j = ((const PFubyte*)fetch->indices)[index];  break;
+            case PF_UNSIGNED_SHORT: j = ((const PFushort*)fetch->indices)[index]; break;
+            case PF_UNSIGNED_INT:   j = ((const PFuint*)fetch->indices)[index];   break;
+            default: break;
+        }
+    }
+
+    // Fill the vertex with given vertices data
+    *vertex = (PFIvertex) { 0 };
+    vertex->position[3] = 1.0f;
+    vertex->color = fetch->color;
+
+    pfiFetchAttrib(vertex->position, &attribs->positions, j);
+
+    if (fetch->useNormalArray) {
+        pfiFetchAttrib(vertex->normal, &attribs->normals, j);
+    }
+
+    if (fetch->useTexCoordArray) {
+        pfiFetchAttrib(vertex->texcoord, &attribs->texcoords, j);
+    }
+
+    if (fetch->useTexCoord1Array) {
+        pfiFetchAttrib(vertex->texcoord1, &attribs->texcoords1, j);
+    }
+
+    if (fetch->useColorArray) {
+        vertex->color = pfiFetchColor(&attribs->colors, j);
+    }
+
+    if (fetch->useSkinning) {
+        pfiSkinVertex(vertex->position, fetch->useNormalArray ? vertex->normal : NULL,
+            fetch->bonePalette, attribs, j);
     }
-    return 0;
 }
 
-static PFsizei pfiGetDataTypeSize(PFdatatype type)
+// NOTE: Common path of 'pfDrawElements' and 'pfDrawArrays'
+static void pfiDrawVertices(PFdrawmode mode, PFsizei count, const PFIvertexfetch* fetch)
 {
-    switch (type) {
-        case PF_UNSIGNED_BYTE:          return sizeof(PFubyte);
-        case PF_UNSIGNED_SHORT_5_6_5:
-        case PF_UNSIGNED_SHORT_5_5_5_1:
-        case PF_UNSIGNED_SHORT_4_4_4_4:
-        case PF_UNSIGNED_SHORT:         return sizeof(PFushort);
-        case PF_UNSIGNED_INT:           return sizeof(PFuint);
-        case PF_BYTE:                   return sizeof(PFbyte);
-        case PF_HALF_FLOAT:
-        case PF_SHORT:                  return sizeof(PFshort);
-        case PF_INT:                    return sizeof(PFint);
-        case PF_FLOAT:                  return sizeof(PFfloat);
-        case PF_DOUBLE:                 return sizeof(PFdouble);
+    pfBegin(mode);
+
+    // Large draws of independent triangles have their geometry stage shared between threads
+    if (mode == PF_TRIANGLES && G_currentCtx->currentRenderList == NULL) {
+        if (pfiProcessRasterize_TRIANGLES_PARALLEL(count, PF_PARALLEL_GEOMETRY_THRESHOLD_TRIANGLES, pfiFetchVertex, fetch)) {
+            pfEnd();
+            return;
+        }
+    }
+
+    PFsizei drawModeVertexCount = pfiGetDrawModeVertexCount(mode);
+
+    for (PFsizei i = 0; i < count; i++) {
+        PFIvertex *vertex = G_currentCtx->vertexBuffer + (G_currentCtx->vertexCounter++);
+        pfiFetchVertex(fetch, i, vertex);
+
+        // If the number of vertices has reached that necessary for, we process the shape
+        if (G_currentCtx->vertexCounter == drawModeVertexCount) {
+            pfiProcessAndRasterize();
+            pfiResetVertexBufferForNextElement();
+        }
     }
-    return 0;
+
+    pfEnd();
 }
 
-// NOTE: Only updates the MVP by default but also updates the normal matrix if necessary
-static void pfiUpdateMatrices(PFboolean matNormal)
+/* Parallel loop jobs */
+
+typedef struct {
+    struct PFItex *tex;
+    PFfloat *zbuffer;           ///< Depth buffer, NULL if it is not cleared
+    PFsizei pixelBytes;         ///< Size of a pixel, 0 if the color buffer is not cleared
+    PFcolor color;
+    PFfloat depth;
+} PFIclearjob;
+
+// NOTE: With SIMD support the range is expressed in SIMD blocks, otherwise in pixels
+static void pfiClearJob(void* job, PFint begin, PFint end)
 {
-    if (G_currentCtx->modelMatrixUsed) {
-        pfmMat4MulR(G_currentCtx->matMVP, G_currentCtx->matModel, G_currentCtx->matView);
-        pfmMat4Mul(G_currentCtx->matMVP, G_currentCtx->matMVP, G_currentCtx->matProjection);
-        if (matNormal && G_currentCtx->state & PF_LIGHTING) {
-            pfmMat4Invert(G_currentCtx->matNormal, G_currentCtx->matModel);
-            pfmMat4Transpose(G_currentCtx->matNormal, G_currentCtx->matNormal);
+    const PFIclearjob *clear = job;
+    struct PFItex *tex = clear->tex;
+    PFfloat *zbuffer = clear->zbuffer;
+
+#if PF_SIMD_SUPPORT
+    PFIsimdvi vcolor = pfiSimdSet1_I32(*(PFuint*)&clear->color);
+    PFIsimdvf vdepth = pfiSimdSet1_F32(clear->depth);
+    PFsizei iBegin = (PFsizei)begin*PF_SIMD_SIZE;
+    PFsizei iEnd = (PFsizei)end*PF_SIMD_SIZE;
+
+    if (clear->pixelBytes && zbuffer) {
+        for (PFsizei i = iBegin; i < iEnd; i += PF_SIMD_SIZE) {
+            tex->setterSimd(tex->pixels, i, vcolor, *(PFIsimdvi*)GC_simd_i32_0xffffffff);
+            pfiSimdStore_F32(zbuffer + i, vdepth);
+        }
+    } else if (clear->pixelBytes) {
+        for (PFsizei i = iBegin; i < iEnd; i += PF_SIMD_SIZE) {
+            tex->setterSimd(tex->pixels, i, vcolor, *(PFIsimdvi*)GC_simd_i32_0xffffffff);
         }
     } else {
-        pfmMat4MulR(G_currentCtx->matMVP, G_currentCtx->matView, G_currentCtx->matProjection);
-        if (matNormal && G_currentCtx->state & PF_LIGHTING) {
-            pfmMat4Identity(G_currentCtx->matNormal);
+        for (PFsizei i = iBegin; i < iEnd; i += PF_SIMD_SIZE) {
+            pfiSimdStore_F32(zbuffer + i, vdepth);
+        }
+    }
+#else
+    // NOTE: The first pixel is already set in the format of the buffer
+    PFubyte *pbuffer = (PFubyte*)tex->pixels;
+    PFsizei pixelBytes = clear->pixelBytes;
+
+    if (pixelBytes && zbuffer) {
+        for (PFsizei i = begin; i < (PFsizei)end; i++) {
+            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
+            zbuffer[i] = clear->depth;
+        }
+    } else if (pixelBytes) {
+        for (PFsizei i = begin; i < (PFsizei)end; i++) {
+            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
+        }
+    } else {
+        for (PFsizei i = begin; i < (PFsizei)end; i++) {
+            zbuffer[i] = clear->depth;
+        }
+    }
+#endif //PF_SIMD_SUPPORT
+}
+
+typedef struct {
+    struct PFItex *tex;
+    PFint xMin, xMax;
+    PFcolor color;
+} PFIrectjob;
+
+static void pfiRectJob(void* job, PFint begin, PFint end)
+{
+    const PFIrectjob *rect = job;
+    struct PFItex *tex = rect->tex;
+
+    for (PFint y = begin; y < end; y++) {
+        for (PFint x = rect->xMin; x <= rect->xMax; x++) {
+            tex->setter(tex->pixels, y * tex->w + x, rect->color);
+        }
+    }
+}
+
+typedef struct {
+    const void *pixels;
+    PFIpixelgetter getPixelSrc;
+    struct PFItex *texDst;
+    PFfloat *zBuffer;
+    PFIdepthfunc depthFunction;         ///< NULL if the depth test is disabled
+    PFIblendfunc blendFunction;         ///< NULL if blending is disabled
+    PFint xMin, xMax;
+    PFint xScreen, yScreen;
+    PFfloat zPos;
+    PFfloat invXLen, invYLen;
+    PFsizei width, widthM1, heightM1;
+} PFIdrawpixelsjob;
+
+static void pfiDrawPixelsJob(void* job, PFint begin, PFint end)
+{
+    const PFIdrawpixelsjob *draw = job;
+    struct PFItex *texDst = draw->texDst;
+    PFfloat *zBuffer = draw->zBuffer;
+
+    for (PFint y = begin; y < end; y++) {
+        // Calculate texture V coordinate based on screen Y coordinate
+        PFfloat v = (PFfloat)(y - draw->yScreen)*draw->invYLen;
+        PFsizei ySrcOffset = (PFsizei)(v*draw->heightM1)*draw->width; // Offset into source texture
+
+        // Calculate destination offset for this scanline
+        PFsizei yDstOffset = y*texDst->w;
+
+        for (PFint x = draw->xMin; x <= draw->xMax; x++) {
+            // Calculate destination offset for this pixel
+            PFsizei xyDstOffset = yDstOffset + x;
+
+            // Perform depth test or skip if disabled
+            if (!draw->depthFunction || draw->depthFunction(draw->zPos, zBuffer[xyDstOffset])) {
+                // Calculate texture U coordinate based on screen X coordinate
+                PFfloat u = (PFfloat)(x - draw->xScreen)*draw->invXLen;
+
+                // Calculate offset into source texture for this pixel
+                PFsizei xySrcOffset = ySrcOffset + (PFsizei)(u*draw->widthM1);
+
+                // Update depth buffer with new depth value
+                zBuffer[xyDstOffset] = draw->zPos;
+
+                // Retrieve source color
+                PFcolor color = draw->getPixelSrc(draw->pixels, xySrcOffset);
+
+                // Blend source and destination colors and update framebuffer
+                texDst->setter(texDst->pixels, xyDstOffset, draw->blendFunction
+                    ? draw->blendFunction(color, texDst->getter(texDst->pixels, xyDstOffset)) : color);
+            }
+        }
+    }
+}
+
+typedef struct {
+    struct PFItex *tex;
+    const PFfloat *zBuffer;
+    PFcolor color;
+    PFfogmode mode;
+    PFfloat density;
+    PFfloat start;
+    PFfloat end;
+} PFIfogjob;
+
+static void pfiFogJob(void* job, PFint begin, PFint end)
+{
+    const PFIfogjob *fog = job;
+
+    struct PFItex *tex = fog->tex;
+    PFint width = tex->w;
+    void *pixels = tex->pixels;
+    const PFfloat *zBuffer = fog->zBuffer;
+
+    PFIpixelgetter getter = tex->getter;
+    PFIpixelsetter setter = tex->setter;
+
+    PFcolor fogColor = fog->color;
+    PFfloat invLen = 1/(fog->end - fog->start);
+    PFubyte alpha = fogColor.a;
+
+    PFsizei yOffset = begin*width;
+    for (PFint y = begin; y < end; y++, yOffset += width) {
+        for (PFint x = 0; x < width; x++) {
+            PFsizei xyOffset = yOffset + x;
+            PFfloat depth = zBuffer[xyOffset];
+            if (depth >= fog->end) {
+                fogColor.a = alpha;
+                setter(pixels, xyOffset, alpha == 255 ? fogColor
+                    : pfiBlendAlpha(fogColor, getter(pixels, xyOffset)));
+            } else if (depth > fog->start) {
+                PFfloat t = 0;
+                switch (fog->mode) {
+                    case PF_LINEAR:
+                        t = (depth - fog->start)*invLen;
+                        break;
+                    case PF_EXP:
+                        t = 1.0f - expf(-fog->density*(depth - fog->start));
+                        break;
+                    case PF_EXP2:
+                        t = 1.0f - exp2f(-fog->density*(depth - fog->start));
+                        break;
+                }
+                fogColor.a = (PFubyte)(t * alpha);
+                PFcolor color = getter(pixels, xyOffset);
+                setter(pixels, xyOffset, pfiBlendAlpha(fogColor, color));
+            }
         }
     }
 }
 
+typedef struct {
+    const struct PFItex *texSrc;
+    PFIpixelsetter dstPixelSetter;
+    void *pixels;
+    PFsizei width;
+    PFint xMin, xMax, yMin;
+} PFIreadpixelsjob;
+
+static void pfiReadPixelsJob(void* job, PFint begin, PFint end)
+{
+    const PFIreadpixelsjob *read = job;
+
+    PFIpixelgetter srcPixelGetter = read->texSrc->getter;
+    const void *srcPixels = read->texSrc->pixels;
+    PFsizei srcWidth = read->texSrc->w;
+
+    for (PFint ySrc = begin; ySrc < end; ySrc++) {
+        PFsizei yDst = ySrc - read->yMin;
+        for (PFint xSrc = read->xMin, xDst = 0; xSrc < read->xMax; xSrc++, xDst++) {
+            PFcolor color = srcPixelGetter(srcPixels, ySrc * srcWidth + xSrc);
+            read->dstPixelSetter(read->pixels, yDst * read->width + xDst, color);
+        }
+    }
+}
+
+typedef struct {
+    struct PFItex *tex;
+    const PFfloat *zBuffer;
+    PFpostprocessfunc postProcessFunction;
+} PFIpostprocessjob;
+
+static void pfiPostProcessJob(void* job, PFint begin, PFint end)
+{
+    const PFIpostprocessjob *post = job;
+
+    struct PFItex *tex = post->tex;
+    PFint width = tex->w;
+    void *pixels = tex->pixels;
+
+    PFsizei yOffset = begin*width;
+    for (PFint y = begin; y < end; y++, yOffset += width) {
+        for (PFint x = 0; x < width; x++) {
+            PFsizei xyOffset = yOffset + x;
+            PFcolor color = tex->getter(pixels, xyOffset);
+            PFfloat depth = post->zBuffer[xyOffset];
+
+            color = post->postProcessFunction(x, y, depth, color);
+            tex->setter(pixels, xyOffset, color);
+        }
+    }
+}
+
+/* Raster commands */
+
+// NOTE: Doesn't use the context, so that the clear can be run by the raster thread (see PF_FRAME_PIPELINING)
+static void pfiClearBuffers(struct PFItex* tex, PFfloat* zbuffer, PFclearflag flag, PFcolor color, PFfloat depth)
+{
+    PFsizei size = tex->w * tex->h;
+
+    PFIclearjob clear = {
+        .tex = tex,
+        .color = color,
+        .depth = depth
+    };
+
+    PFboolean parallel = size >= PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD;
+
+#   if PF_SIMD_SUPPORT
+
+    // SIMD-aligned size calculation
+    PFsizei simdAlignedSize = size - (size % PF_SIMD_SIZE);
+    PFint simdBlockCount = simdAlignedSize / PF_SIMD_SIZE;
+
+    // If both color and depth buffers should be cleared
+    if (flag & (PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT)) {
+        PFsizei pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
+        PFubyte *pbuffer = (PFubyte*)tex->pixels;
+        clear.pixelBytes = pixelBytes;
+        clear.zbuffer = zbuffer;
+        pfiParallelForIf(parallel, 1, simdBlockCount, 0, pfiClearJob, &clear);
+        for (PFsizei i = simdAlignedSize; i < size; i++) {
+            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
+            zbuffer[i] = zbuffer[0];
+        }
+    }
+    // If only the color buffer should be cleared
+    else if (flag & PF_COLOR_BUFFER_BIT) {
+        PFsizei pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
+        PFubyte *pbuffer = (PFubyte*)tex->pixels;
+        clear.pixelBytes = pixelBytes;
+        pfiParallelForIf(parallel, 1, simdBlockCount, 0, pfiClearJob, &clear);
+        for (PFsizei i = simdAlignedSize; i < size; i++) {
+            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
+        }
+    }
+    // If only the depth buffer should be cleared
+    else if (flag & PF_DEPTH_BUFFER_BIT) {
+        clear.zbuffer = zbuffer;
+        pfiParallelForIf(parallel, 1, simdBlockCount, 0, pfiClearJob, &clear);
+        for (PFsizei i = simdAlignedSize; i < size; i++) {
+            zbuffer[i] = zbuffer[0];
+        }
+    }
+
+#else
+
+    // If both color and depth buffers should be cleared
+    if (flag & (PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT)) {
+        tex->setter(tex->pixels, 0, color);
+        zbuffer[0] = depth;
+        clear.pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
+        clear.zbuffer = zbuffer;
+        pfiParallelForIf(parallel, 1, size, 0, pfiClearJob, &clear);
+    }
+    // If only the color buffer should be cleared
+    else if (flag & PF_COLOR_BUFFER_BIT) {
+        tex->setter(tex->pixels, 0, color);
+        clear.pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
+        pfiParallelForIf(parallel, 1, size, 0, pfiClearJob, &clear);
+    }
+    // If only the depth buffer should be cleared
+    else if (flag & PF_DEPTH_BUFFER_BIT) {
+        clear.zbuffer = zbuffer;
+        pfiParallelForIf(parallel, 0, size, 0, pfiClearJob, &clear);
+    }
+
+#endif //PF_SIMD_SUPPORT
+}
+
+typedef struct {
+    struct PFItex *tex;
+    PFfloat *zbuffer;
+    PFclearflag flag;
+    PFcolor color;
+    PFfloat depth;
+} PFIclearcmd;
+
+static void pfiClearCommand(void* data)
+{
+    const PFIclearcmd *cmd = data;
+    pfiClearBuffers(cmd->tex, cmd->zbuffer, cmd->flag, cmd->color, cmd->depth);
+}
+
 /* Context API functions */
 
 PFcontext pfCreateContext(void* targetBuffer, PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type)
 {
+    // NOTE: The compressed formats are valid for textures, but cannot be rendered to
+    if (!pfiIsPixelFormatValid(format, type)) return NULL;
+
     /* Memory allocation for the context */
 
     PFIctx *ctx = (PFIctx*)PF_CALLOC(1, sizeof(PFIctx));
@@ -171,6 +565,8 @@ PFcontext pfCreateContext(void* targetBuffer, PFsizei width, PFsizei height, PFp
 
     /* Initialization of vertex attributes */
 
+    pfmVec4Set(ctx->vertexAttribs.positions.scale, 1.0f, 1.0f, 1.0f, 1.0f);
+
     ctx->currentColor = (PFcolor) { 255, 255, 255, 255 };
     ctx->vertexCounter = 0;
 
@@ -210,17 +606,7 @@ PFcontext pfCreateContext(void* targetBuffer, PFsizei width, PFsizei height, PFp
 
     /* Initialization of materials */
 
-    ctx->faceMaterial[0] = ctx->faceMaterial[1] = (PFImaterial) {
-        .ambient = (PFcolor) { 255, 255, 255, 255 },
-        .diffuse = (PFcolor) { 255, 255, 255, 255 },
-        .specular = (PFcolor) { 255, 255, 255, 255 },
-        .emission = (PFcolor) { 0, 0, 0, 255 },
-#ifdef PF_PHONG_REFLECTION
-        .shininess = 16.0f,
-#else
-        .shininess = 64.0f,
-#endif
-    };
+    ctx->faceMaterial[0] = ctx->faceMaterial[1] = pfiGetDefaultMaterial();
 
     ctx->materialColorFollowing = (PFImatcolfollowing) {
         .face = PF_FRONT_AND_BACK,
@@ -238,9 +624,15 @@ PFcontext pfCreateContext(void* targetBuffer, PFsizei width, PFsizei height, PFp
     pfmMat4Identity(ctx->matModel);
     pfmMat4Identity(ctx->matView);
 
+    for (PFsizei i = 0; i < PF_MAX_BONE_MATRICES; i++) {
+        pfmMat4Identity(ctx->bonePalette[i]);
+    }
+
     /* Initialization of the context state */
 
     ctx->state |= PF_CULL_FACE;
+    ctx->activeTexture = PF_TEXTURE0;
+    ctx->textureCombine[0] = ctx->textureCombine[1] = PF_COMBINE_MODULATE;
     ctx->shadingMode = PF_SMOOTH;
     ctx->lightingMode = PF_GOURAUD;
     ctx->cullFace = PF_BACK;
@@ -249,9 +641,32 @@ PFcontext pfCreateContext(void* targetBuffer, PFsizei width, PFsizei height, PFp
     return ctx;
 }
 
+PFcontext pfCreateDeferredContext(void* targetBuffer, PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type)
+{
+    PFIctx *ctx = pfCreateContext(targetBuffer, width, height, format, type);
+    if (!ctx) return NULL;
+
+    ctx->commandQueue = pfiCreateCommandQueue(ctx);
+
+    if (!ctx->commandQueue) {
+        pfDeleteContext(ctx);
+        return NULL;
+    }
+
+    return ctx;
+}
+
 void pfDeleteContext(PFcontext ctx)
 {
     if (ctx) {
+        if (((PFIctx*)ctx)->commandQueue) {
+            pfiDeleteCommandQueue(((PFIctx*)ctx)->commandQueue);
+            ((PFIctx*)ctx)->commandQueue = NULL;
+        }
+        if (((PFIctx*)ctx)->rasterQueue) {
+            pfiDeleteRasterQueue(((PFIctx*)ctx)->rasterQueue);
+            ((PFIctx*)ctx)->rasterQueue = NULL;
+        }
         if (((PFIctx*)ctx)->mainFramebuffer.zbuffer) {
             PF_FREE(((PFIctx*)ctx)->mainFramebuffer.zbuffer);
             ((PFIctx*)ctx)->mainFramebuffer = (PFframebuffer) { 0 };
@@ -262,6 +677,15 @@ void pfDeleteContext(PFcontext ctx)
 
 void pfSetMainBuffer(void* targetBuffer, PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .p = targetBuffer }, { .u = width }, { .u = height }, { .i = format }, { .i = type } };
+        pfiPushCommand(PFI_CMD_SET_MAIN_BUFFER, args, 5, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+    pfiSyncRaster();
+
     /* Check if targetBuffer, width, or height is invalid */
 
     if (targetBuffer == NULL || width == 0 || height == 0) {
@@ -323,11 +747,33 @@ void pfSetMainBuffer(void* targetBuffer, PFsizei width, PFsizei height, PFpixelf
 
 PF_API void pfSetAuxBuffer(void *auxFramebuffer)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .p = auxFramebuffer } };
+        pfiPushCommand(PFI_CMD_SET_AUX_BUFFER, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiSyncRaster();
+
     G_currentCtx->auxFramebuffer = auxFramebuffer;
 }
 
 PF_API void pfSwapBuffers(void)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_SWAP_BUFFERS, NULL, 0, NULL, 0);
+        pfFlush();
+        return;
+    }
+
+    pfiFlushBatch();
+
+    // NOTE: The frame is rasterized while the next one is processed, it is submitted
+    //       even if it cannot be swapped so that the bin never spans several frames
+    if (G_currentCtx->rasterQueue) {
+        pfiSubmitRasterCommands(G_currentCtx->rasterQueue);
+    }
+
     if (G_currentCtx->auxFramebuffer == NULL) {
         G_currentCtx->errCode = PF_INVALID_OPERATION;
         return;
@@ -335,6 +781,12 @@ PF_API void pfSwapBuffers(void)
 
     struct PFItex* tex = G_currentCtx->currentFramebuffer->texture;
 
+    // NOTE: The swap is applied once the raster thread has completed the frame
+    if (G_currentCtx->rasterQueue) {
+        G_currentCtx->rasterQueue->swapTexture = tex;
+        return;
+    }
+
     void *tmp = tex->pixels;
     tex->pixels = G_currentCtx->auxFramebuffer;
     G_currentCtx->auxFramebuffer = tmp;
@@ -347,31 +799,110 @@ PFcontext pfGetCurrentContext(void)
 
 void pfMakeCurrent(PFcontext ctx)
 {
+    // NOTE: The render thread of a deferred context must be
+    //       idle before another context can become current
+    if (G_currentCtx) {
+        pfFinish();
+    }
+
     G_currentCtx = ctx;
 }
 
+void pfFlush(void)
+{
+    if (pfiIsDeferred()) {
+        pfiSubmitCommands(G_currentCtx->commandQueue);
+    } else {
+        pfiFlushBatch();
+    }
+}
+
+void pfFinish(void)
+{
+    pfiSyncCommands();
+    pfiFlushBatch();
+    pfiSyncRaster();
+}
+
 PFboolean pfIsEnabled(PFstate state)
 {
+    pfiSyncCommands();
+
+    if (G_currentCtx->activeTexture == PF_TEXTURE1 && (state & PFI_TEXTURE_UNIT_STATES)) {
+        return (G_currentCtx->state & state & ~PFI_TEXTURE_UNIT_STATES)
+            || (G_currentCtx->texture1State & state);
+    }
+
     return G_currentCtx->state & state;
 }
 
 void pfEnable(PFstate state)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = state } };
+        pfiPushCommand(PFI_CMD_ENABLE, args, 1, NULL, 0);
+        return;
+    }
+
+    PFIcmdarg args[] = { { .u = state } };
+    if (pfiRecordCommand(PFI_CMD_ENABLE, args, 1, NULL, 0)) {
+        return;
+    }
+
+    pfiFlushBatch();
+
+    // NOTE: The texture states of PF_TEXTURE1 are kept apart from the context state
+    if (G_currentCtx->activeTexture == PF_TEXTURE1) {
+        G_currentCtx->texture1State |= state & PFI_TEXTURE_UNIT_STATES;
+        state &= ~PFI_TEXTURE_UNIT_STATES;
+    }
+
     G_currentCtx->state |= state;
 
     if (state & PF_FRAMEBUFFER) {
         G_currentCtx->currentFramebuffer = G_currentCtx->bindedFramebuffer
             ? G_currentCtx->bindedFramebuffer : &G_currentCtx->mainFramebuffer;
     }
+
+    if ((state & PF_FRAME_PIPELINING) && !G_currentCtx->rasterQueue) {
+        G_currentCtx->rasterQueue = pfiCreateRasterQueue(G_currentCtx);
+        if (!G_currentCtx->rasterQueue) {
+            G_currentCtx->state &= ~PF_FRAME_PIPELINING;
+            G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        }
+    }
 }
 
 void pfDisable(PFstate state)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = state } };
+        pfiPushCommand(PFI_CMD_DISABLE, args, 1, NULL, 0);
+        return;
+    }
+
+    PFIcmdarg args[] = { { .u = state } };
+    if (pfiRecordCommand(PFI_CMD_DISABLE, args, 1, NULL, 0)) {
+        return;
+    }
+
+    pfiFlushBatch();
+
+    if (G_currentCtx->activeTexture == PF_TEXTURE1) {
+        G_currentCtx->texture1State &= ~(state & PFI_TEXTURE_UNIT_STATES);
+        state &= ~PFI_TEXTURE_UNIT_STATES;
+    }
+
     G_currentCtx->state &= ~state;
 
     if (state & PF_FRAMEBUFFER) {
         G_currentCtx->currentFramebuffer = &G_currentCtx->mainFramebuffer;
     }
+
+    if ((state & PF_FRAME_PIPELINING) && G_currentCtx->rasterQueue) {
+        pfiDeleteRasterQueue(G_currentCtx->rasterQueue);
+        G_currentCtx->rasterQueue = NULL;
+    }
 }
 
 
@@ -379,6 +910,8 @@ void pfDisable(PFstate state)
 
 PFerrcode pfGetError(void)
 {
+    pfiSyncCommands();
+
     PFerrcode errCode = G_currentCtx->errCode;
     G_currentCtx->errCode = PF_NO_ERROR;
     return errCode;
@@ -394,6 +927,22 @@ PFerrcode pfGetError(void)
 
 void pfMatrixMode(PFmatrixmode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_MATRIX_MODE, args, 1, NULL, 0);
+        return;
+    }
+
+    if (mode < PF_MODELVIEW || mode > PF_TEXTURE) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
+
+    PFIcmdarg args[] = { { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_MATRIX_MODE, args, 1, NULL, 0)) {
+        return;
+    }
+
     switch (mode) {
         case PF_PROJECTION:
             G_currentCtx->currentMatrix = &G_currentCtx->matProjection;
@@ -405,9 +954,6 @@ void pfMatrixMode(PFmatrixmode mode)
         case PF_TEXTURE:
             G_currentCtx->currentMatrix = &G_currentCtx->matTexture;
             break;
-        default:
-            G_currentCtx->errCode = PF_INVALID_ENUM;
-            return;
     }
 
     G_currentCtx->currentMatrixMode = mode;
@@ -415,6 +961,15 @@ void pfMatrixMode(PFmatrixmode mode)
 
 void pfPushMatrix(void)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_PUSH_MATRIX, NULL, 0, NULL, 0);
+        return;
+    }
+
+    if (pfiRecordCommand(PFI_CMD_PUSH_MATRIX, NULL, 0, NULL, 0)) {
+        return;
+    }
+
     switch (G_currentCtx->currentMatrixMode) {
         case PF_PROJECTION: {
             if (G_currentCtx->stackProjectionCounter >= PF_MAX_PROJECTION_STACK_SIZE) {
@@ -455,6 +1010,17 @@ void pfPushMatrix(void)
 
 void pfPopMatrix(void)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_POP_MATRIX, NULL, 0, NULL, 0);
+        return;
+    }
+
+    if (pfiRecordCommand(PFI_CMD_POP_MATRIX, NULL, 0, NULL, 0)) {
+        return;
+    }
+
+    pfiFlushBatch();
+
     switch (G_currentCtx->currentMatrixMode) {
         case PF_PROJECTION: {
             if (G_currentCtx->stackProjectionCounter <= 0) {
@@ -496,54 +1062,141 @@ void pfPopMatrix(void)
 
 void pfLoadIdentity(void)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_LOAD_IDENTITY, NULL, 0, NULL, 0);
+        return;
+    }
+
+    if (pfiRecordCommand(PFI_CMD_LOAD_IDENTITY, NULL, 0, NULL, 0)) {
+        return;
+    }
+
+    pfiFlushBatch();
+
     pfmMat4Identity(*G_currentCtx->currentMatrix);
 }
 
 void pfTranslatef(PFfloat x, PFfloat y, PFfloat z)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = x }, { .f = y }, { .f = z } };
+        pfiPushCommand(PFI_CMD_TRANSLATE, args, 3, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFMmat4 translation;
     pfmMat4Translate(translation, x, y, z);
 
+    // NOTE: Lists record the resulting matrix, which is not recomputed on each call
+    if (pfiRecordCommand(PFI_CMD_TRANSFORM, NULL, 0, translation, sizeof(PFMmat4))) {
+        return;
+    }
+
     // NOTE: We transpose matrix with multiplication order
     pfmMat4Mul(*G_currentCtx->currentMatrix, translation, *G_currentCtx->currentMatrix);
 }
 
 void pfRotatef(PFfloat angle, PFfloat x, PFfloat y, PFfloat z)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = angle }, { .f = x }, { .f = y }, { .f = z } };
+        pfiPushCommand(PFI_CMD_ROTATE, args, 4, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFMvec3 axis = { x, y, z }; // TODO: review
 
     PFMmat4 rotation;
     pfmMat4Rotate(rotation, axis, angle * PFM_DEG2RAD);
 
+    // NOTE: Lists record the resulting matrix, which is not recomputed on each call
+    if (pfiRecordCommand(PFI_CMD_TRANSFORM, NULL, 0, rotation, sizeof(PFMmat4))) {
+        return;
+    }
+
     // NOTE: We transpose matrix with multiplication order
     pfmMat4Mul(*G_currentCtx->currentMatrix, rotation, *G_currentCtx->currentMatrix);
 }
 
 void pfScalef(PFfloat x, PFfloat y, PFfloat z)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = x }, { .f = y }, { .f = z } };
+        pfiPushCommand(PFI_CMD_SCALE, args, 3, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFMmat4 scale;
     pfmMat4Scale(scale, x, y, z);
 
+    // NOTE: Lists record the resulting matrix, which is not recomputed on each call
+    if (pfiRecordCommand(PFI_CMD_TRANSFORM, NULL, 0, scale, sizeof(PFMmat4))) {
+        return;
+    }
+
     // NOTE: We transpose matrix with multiplication order
     pfmMat4Mul(*G_currentCtx->currentMatrix, scale, *G_currentCtx->currentMatrix);
 }
 
 void pfMultMatrixf(const PFfloat* mat)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_MULT_MATRIX, NULL, 0, mat, sizeof(PFMmat4));
+        return;
+    }
+
+    if (pfiRecordCommand(PFI_CMD_MULT_MATRIX, NULL, 0, mat, sizeof(PFMmat4))) {
+        return;
+    }
+
+    pfiFlushBatch();
+
     pfmMat4Mul(*G_currentCtx->currentMatrix, *G_currentCtx->currentMatrix, mat);
 }
 
 void pfFrustum(PFfloat left, PFfloat right, PFfloat bottom, PFfloat top, PFfloat znear, PFfloat zfar)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = left }, { .f = right }, { .f = bottom }, { .f = top }, { .f = znear }, { .f = zfar } };
+        pfiPushCommand(PFI_CMD_FRUSTUM, args, 6, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFMmat4 frustum;
     pfmMat4Frustum(frustum, left, right, bottom, top, znear, zfar);
+
+    if (pfiRecordCommand(PFI_CMD_MULT_MATRIX, NULL, 0, frustum, sizeof(PFMmat4))) {
+        return;
+    }
+
     pfmMat4Mul(*G_currentCtx->currentMatrix, *G_currentCtx->currentMatrix, frustum);
 }
 
 void pfOrtho(PFfloat left, PFfloat right, PFfloat bottom, PFfloat top, PFfloat znear, PFfloat zfar)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = left }, { .f = right }, { .f = bottom }, { .f = top }, { .f = znear }, { .f = zfar } };
+        pfiPushCommand(PFI_CMD_ORTHO, args, 6, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFMmat4 ortho;
     pfmMat4Ortho(ortho, left, right, bottom, top, znear, zfar);
+
+    if (pfiRecordCommand(PFI_CMD_MULT_MATRIX, NULL, 0, ortho, sizeof(PFMmat4))) {
+        return;
+    }
+
     pfmMat4Mul(*G_currentCtx->currentMatrix, *G_currentCtx->currentMatrix, ortho);
 }
 
@@ -552,6 +1205,14 @@ void pfOrtho(PFfloat left, PFfloat right, PFfloat bottom, PFfloat top, PFfloat z
 
 void pfViewport(PFint x, PFint y, PFsizei width, PFsizei height)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = x }, { .i = y }, { .u = width }, { .u = height } };
+        pfiPushCommand(PFI_CMD_VIEWPORT, args, 4, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (x <= -(PFint)width || y <= -(PFint)height) {
         G_currentCtx->errCode = PF_INVALID_OPERATION;
         return;
@@ -572,11 +1233,29 @@ void pfViewport(PFint x, PFint y, PFsizei width, PFsizei height)
 
 void pfPolygonMode(PFface face, PFpolygonmode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = face }, { .i = mode } };
+        pfiPushCommand(PFI_CMD_POLYGON_MODE, args, 2, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (!(mode == PF_POINT || mode == PF_LINE || mode == PF_FILL)) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
 
+    if (face < PF_FRONT || face > PF_FRONT_AND_BACK) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
+
+    PFIcmdarg args[] = { { .i = face }, { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_POLYGON_MODE, args, 2, NULL, 0)) {
+        return;
+    }
+
     switch (face) {
         case PF_FRONT:
             G_currentCtx->polygonMode[0] = mode;
@@ -590,57 +1269,131 @@ void pfPolygonMode(PFface face, PFpolygonmode mode)
             G_currentCtx->polygonMode[0] = mode;
             G_currentCtx->polygonMode[1] = mode;
             break;
-
-        default:
-            G_currentCtx->errCode = PF_INVALID_ENUM;
-            break;
     }
 }
 
 void pfShadeModel(PFshademode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_SHADE_MODEL, args, 1, NULL, 0);
+        return;
+    }
+
+    PFIcmdarg args[] = { { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_SHADE_MODEL, args, 1, NULL, 0)) {
+        return;
+    }
+
+    pfiFlushBatch();
+
     G_currentCtx->shadingMode = mode;
 }
 
 void pfLightModel(PFlightmode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_LIGHT_MODEL, args, 1, NULL, 0);
+        return;
+    }
+
+    PFIcmdarg args[] = { { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_LIGHT_MODEL, args, 1, NULL, 0)) {
+        return;
+    }
+
+    pfiFlushBatch();
+
     G_currentCtx->lightingMode = mode;
 }
 
 void pfLineWidth(PFfloat width)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = width } };
+        pfiPushCommand(PFI_CMD_LINE_WIDTH, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (width <= 0.0f) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
+
+    PFIcmdarg args[] = { { .f = width } };
+    if (pfiRecordCommand(PFI_CMD_LINE_WIDTH, args, 1, NULL, 0)) {
+        return;
+    }
     G_currentCtx->lineWidth = width;
 }
 
 void pfPointSize(PFfloat size)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = size } };
+        pfiPushCommand(PFI_CMD_POINT_SIZE, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (size <= 0.0f) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
+
+    PFIcmdarg args[] = { { .f = size } };
+    if (pfiRecordCommand(PFI_CMD_POINT_SIZE, args, 1, NULL, 0)) {
+        return;
+    }
     G_currentCtx->pointSize = size;
 }
 
 void pfCullFace(PFface face)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = face } };
+        pfiPushCommand(PFI_CMD_CULL_FACE, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (face < PF_FRONT || face > PF_BACK) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
+
+    PFIcmdarg args[] = { { .i = face } };
+    if (pfiRecordCommand(PFI_CMD_CULL_FACE, args, 1, NULL, 0)) {
+        return;
+    }
     G_currentCtx->cullFace = face;
 }
 
 void pfBlendFunc(PFblendmode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_BLEND_FUNC, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (!pfiIsBlendModeValid(mode)) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
 
+    PFIcmdarg args[] = { { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_BLEND_FUNC, args, 1, NULL, 0)) {
+        return;
+    }
+
     G_currentCtx->blendFunction = GC_blendFuncs[mode];
 
 #   if PF_SIMD_SUPPORT
@@ -650,11 +1403,24 @@ void pfBlendFunc(PFblendmode mode)
 
 void pfDepthFunc(PFdepthmode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_DEPTH_FUNC, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (!pfiIsDepthModeValid(mode)) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
 
+    PFIcmdarg args[] = { { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_DEPTH_FUNC, args, 1, NULL, 0)) {
+        return;
+    }
+
     G_currentCtx->depthFunction = GC_depthTestFuncs[mode];
 
 #   if PF_SIMD_SUPPORT
@@ -664,6 +1430,14 @@ void pfDepthFunc(PFdepthmode mode)
 
 void pfBindFramebuffer(PFframebuffer* framebuffer)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .p = framebuffer } };
+        pfiPushCommand(PFI_CMD_BIND_FRAMEBUFFER, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     G_currentCtx->bindedFramebuffer = framebuffer;
 
     if (G_currentCtx->state & PF_FRAMEBUFFER) {
@@ -674,125 +1448,108 @@ void pfBindFramebuffer(PFframebuffer* framebuffer)
 
 void pfBindTexture(PFtexture texture)
 {
-    G_currentCtx->currentTexture = texture;
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .p = texture } };
+        pfiPushCommand(PFI_CMD_BIND_TEXTURE, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
+    if (G_currentCtx->activeTexture == PF_TEXTURE1) {
+        G_currentCtx->currentTexture1 = texture;
+    } else {
+        G_currentCtx->currentTexture = texture;
+    }
 }
 
-void pfClear(PFclearflag flag)
+void pfActiveTexture(PFtextureunit unit)
 {
-    // If no flag is set, return early (nothing to clear)
-    if (!flag) return;
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = unit } };
+        pfiPushCommand(PFI_CMD_ACTIVE_TEXTURE, args, 1, NULL, 0);
+        return;
+    }
 
-    // Retrieve the current framebuffer and its associated texture
-    PFframebuffer *framebuffer = G_currentCtx->currentFramebuffer;
-    struct PFItex *tex = framebuffer->texture;
-    PFsizei size = tex->w * tex->h;
+    if (unit != PF_TEXTURE0 && unit != PF_TEXTURE1) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
 
-#   if PF_SIMD_SUPPORT
+    // NOTE: The unit is also selected while recording a list, since
+    //       the textures bound during the recording are those of its draws
+    PFIcmdarg args[] = { { .i = unit } };
+    pfiRecordCommand(PFI_CMD_ACTIVE_TEXTURE, args, 1, NULL, 0);
 
-    // SIMD-aligned size calculation
-    PFsizei simdAlignedSize = size - (size % PF_SIMD_SIZE);
+    G_currentCtx->activeTexture = unit;
+}
 
-    // If both color and depth buffers should be cleared
-    if (flag & (PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT)) {
-        PFsizei pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
-        PFIsimdvi vcolor = pfiSimdSet1_I32(*(PFuint*)&G_currentCtx->clearColor);
-        PFIsimdvf vdepth = pfiSimdSet1_F32(G_currentCtx->clearDepth);
-        PFubyte *pbuffer = (PFubyte*)tex->pixels;
-        PFfloat *zbuffer = framebuffer->zbuffer;
-#       ifdef _OPENMP
-#           pragma omp parallel for if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#       endif //_OPENMP
-        for (PFsizei i = PF_SIMD_SIZE; i < simdAlignedSize; i += PF_SIMD_SIZE) {
-            tex->setterSimd(tex->pixels, i, vcolor, *(PFIsimdvi*)GC_simd_i32_0xffffffff);
-            pfiSimdStore_F32(zbuffer + i, vdepth);
-        }
-        for (PFsizei i = simdAlignedSize; i < size; i++) {
-            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
-            zbuffer[i] = zbuffer[0];
-        }
-    }
-    // If only the color buffer should be cleared
-    else if (flag & PF_COLOR_BUFFER_BIT) {
-        PFsizei pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
-        PFIsimdvi vcolor = pfiSimdSet1_I32(*(PFuint*)&G_currentCtx->clearColor);
-        PFubyte *pbuffer = (PFubyte*)tex->pixels;
-#       ifdef _OPENMP
-#           pragma omp parallel for if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#       endif //_OPENMP
-        for (PFsizei i = PF_SIMD_SIZE; i < simdAlignedSize; i += PF_SIMD_SIZE) {
-            tex->setterSimd(tex->pixels, i, vcolor, *(PFIsimdvi*)GC_simd_i32_0xffffffff);
-        }
-        for (PFsizei i = simdAlignedSize; i < size; i++) {
-            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
-        }
+void pfTexCombine(PFcombinemode mode)
+{
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_TEX_COMBINE, args, 1, NULL, 0);
+        return;
     }
-    // If only the depth buffer should be cleared
-    else if (flag & PF_DEPTH_BUFFER_BIT) {
-        PFIsimdvf vdepth = pfiSimdSet1_F32(G_currentCtx->clearDepth);
-        PFfloat *zbuffer = framebuffer->zbuffer;
-#       ifdef _OPENMP
-#          pragma omp parallel for if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#       endif //_OPENMP
-        for (PFsizei i = PF_SIMD_SIZE; i < simdAlignedSize; i += PF_SIMD_SIZE) {
-            pfiSimdStore_F32(zbuffer + i, vdepth);
-        }
-        for (PFsizei i = simdAlignedSize; i < size; i++) {
-            zbuffer[i] = zbuffer[0];
-        }
+
+    pfiFlushBatch();
+
+    if (!pfiIsCombineModeValid(mode)) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
     }
 
-#else
-
-    // If both color and depth buffers should be cleared
-    if (flag & (PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT)) {
-        PFsizei pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
-        tex->setter(tex->pixels, 0, G_currentCtx->clearColor);
-        framebuffer->zbuffer[0] = G_currentCtx->clearDepth;
-        PFubyte *pbuffer = (PFubyte*)tex->pixels;
-        PFfloat *zbuffer = framebuffer->zbuffer;
-        PFfloat zvalue = zbuffer[0];
-#       ifdef _OPENMP
-#           pragma omp parallel for if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#       endif //_OPENMP
-        for (PFsizei i = 1; i < size; i++) {
-            memcpy(pbuffer + i * pixelBytes, pbuffer, pixelBytes);
-            zbuffer[i] = zvalue;
-        }
+    PFIcmdarg args[] = { { .i = mode } };
+    if (pfiRecordCommand(PFI_CMD_TEX_COMBINE, args, 1, NULL, 0)) {
+        return;
     }
-    // If only the color buffer should be cleared
-    else if (flag & PF_COLOR_BUFFER_BIT) {
-        void *pbuffer = tex->pixels;
-        PFsizei pixelBytes = pfiGetPixelBytes(tex->format, tex->type);
-        tex->setter(pbuffer, 0, G_currentCtx->clearColor);
-#       ifdef _OPENMP
-#           pragma omp parallel for if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#       endif //_OPENMP
-        for (PFsizei i = 0; i < size; i++) {
-            memcpy((PFubyte*)pbuffer + i * pixelBytes, pbuffer, pixelBytes);
-        }
+
+    G_currentCtx->textureCombine[G_currentCtx->activeTexture] = mode;
+}
+
+void pfClear(PFclearflag flag)
+{
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = flag } };
+        pfiPushCommand(PFI_CMD_CLEAR, args, 1, NULL, 0);
+        return;
     }
-    // If only the depth buffer should be cleared
-    else if (flag & PF_DEPTH_BUFFER_BIT) {
-        PFfloat *zbuffer = framebuffer->zbuffer;
-        zbuffer[0] = G_currentCtx->clearDepth;
-#       ifdef _OPENMP
-#           pragma omp parallel for if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#       endif //_OPENMP
-        for (PFsizei i = 0; i < size; i++) {
-            memcpy(zbuffer + i, zbuffer, sizeof(PFfloat));
-        }
+
+    pfiFlushBatch();
+
+    // If no flag is set, return early (nothing to clear)
+    if (!flag) return;
+
+    PFframebuffer *framebuffer = G_currentCtx->currentFramebuffer;
+
+    if (G_currentCtx->rasterQueue) {
+        PFIclearcmd *cmd = pfiPushRasterCommand(G_currentCtx->rasterQueue, pfiClearCommand, sizeof(PFIclearcmd));
+        if (cmd) *cmd = (PFIclearcmd) { framebuffer->texture, framebuffer->zbuffer, flag, G_currentCtx->clearColor, G_currentCtx->clearDepth };
+        return;
     }
 
-#endif //PF_SIMD_SUPPORT
+    pfiClearBuffers(framebuffer->texture, framebuffer->zbuffer, flag, G_currentCtx->clearColor, G_currentCtx->clearDepth);
 }
 
 void pfClearDepth(PFfloat depth)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = depth } };
+        pfiPushCommand(PFI_CMD_CLEAR_DEPTH, args, 1, NULL, 0);
+        return;
+    }
+
     G_currentCtx->clearDepth = depth;
 }
 
 void pfClearColor(PFubyte r, PFubyte g, PFubyte b, PFubyte a)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .c = { r, g, b, a } } };
+        pfiPushCommand(PFI_CMD_CLEAR_COLOR, args, 1, NULL, 0);
+        return;
+    }
+
     G_currentCtx->clearColor = (PFcolor) { r, g, b, a };
 }
 
@@ -801,11 +1558,24 @@ void pfClearColor(PFubyte r, PFubyte g, PFubyte b, PFubyte a)
 
 void pfEnableLight(PFsizei light)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = light } };
+        pfiPushCommand(PFI_CMD_ENABLE_LIGHT, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (light >= PF_MAX_LIGHT_STACK) {                      // Check if the specified light index is within the valid range.
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
 
+    PFIcmdarg args[] = { { .u = light } };
+    if (pfiRecordCommand(PFI_CMD_ENABLE_LIGHT, args, 1, NULL, 0)) {
+        return;
+    }
+
     PFIlight *desiredLight = G_currentCtx->lights + light;   // Get the pointer to the desired light from the lights array.
     PFIlight **nodeLight = &G_currentCtx->activeLights;      // Get a pointer to the pointer pointing to the head of the active lights list.
 
@@ -830,11 +1600,24 @@ void pfEnableLight(PFsizei light)
 
 void pfDisableLight(PFsizei light)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = light } };
+        pfiPushCommand(PFI_CMD_DISABLE_LIGHT, args, 1, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (light >= PF_MAX_LIGHT_STACK) {                      // Check if the specified light index is within the valid range.
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
 
+    PFIcmdarg args[] = { { .u = light } };
+    if (pfiRecordCommand(PFI_CMD_DISABLE_LIGHT, args, 1, NULL, 0)) {
+        return;
+    }
+
     PFIlight *desiredLight = G_currentCtx->lights + light;   // Get the pointer to the desired light from the lights array.
     PFIlight **nodeLight = &G_currentCtx->activeLights;      // Get a pointer to the pointer pointing to the head of the active lights list.
 
@@ -852,6 +1635,8 @@ void pfDisableLight(PFsizei light)
 
 PFboolean pfIsEnabledLight(PFsizei light)
 {
+    pfiSyncCommands();
+
     if (light >= PF_MAX_LIGHT_STACK) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return PF_FALSE;
@@ -868,11 +1653,24 @@ PFboolean pfIsEnabledLight(PFsizei light)
 
 void pfLightf(PFsizei light, PFenum param, PFfloat value)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = light }, { .u = param }, { .f = value } };
+        pfiPushCommand(PFI_CMD_LIGHTF, args, 3, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (light >= PF_MAX_LIGHT_STACK) {
         G_currentCtx->errCode = PF_STACK_OVERFLOW;
         return;
     }
 
+    PFIcmdarg args[] = { { .u = light }, { .u = param }, { .f = value } };
+    if (pfiRecordCommand(PFI_CMD_LIGHTF, args, 3, NULL, 0)) {
+        return;
+    }
+
     PFIlight *l = &G_currentCtx->lights[light];
 
     switch (param) {
@@ -908,11 +1706,24 @@ void pfLightf(PFsizei light, PFenum param, PFfloat value)
 
 void pfLightfv(PFsizei light, PFenum param, const void* value)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = light }, { .u = param } };
+        pfiPushCommand(PFI_CMD_LIGHTFV, args, 2, value, pfiGetParamValueSize(param));
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (light >= PF_MAX_LIGHT_STACK) {
         G_currentCtx->errCode = PF_STACK_OVERFLOW;
         return;
     }
 
+    PFIcmdarg args[] = { { .u = light }, { .u = param } };
+    if (pfiRecordCommand(PFI_CMD_LIGHTFV, args, 2, value, pfiGetParamValueSize(param))) {
+        return;
+    }
+
     PFIlight *l = &G_currentCtx->lights[light];
 
     switch (param) {
@@ -982,6 +1793,14 @@ void pfLightfv(PFsizei light, PFenum param, const void* value)
 
 void pfMaterialf(PFface face, PFenum param, PFfloat value)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = face }, { .u = param }, { .f = value } };
+        pfiPushCommand(PFI_CMD_MATERIALF, args, 3, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFImaterial *material0 = NULL;
     PFImaterial *material1 = NULL;
 
@@ -1062,6 +1881,14 @@ void pfMaterialf(PFface face, PFenum param, PFfloat value)
 
 void pfMaterialfv(PFface face, PFenum param, const void *value)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = face }, { .u = param } };
+        pfiPushCommand(PFI_CMD_MATERIALFV, args, 2, value, pfiGetParamValueSize(param));
+        return;
+    }
+
+    pfiFlushBatch();
+
     PFImaterial *material0 = NULL;
     PFImaterial *material1 = NULL;
 
@@ -1083,64 +1910,21 @@ void pfMaterialfv(PFface face, PFenum param, const void *value)
             return;
     }
 
-    switch (param) {
-        case PF_AMBIENT:
-            material0->ambient = material1->ambient = (PFcolor) {
-                (PFubyte)(((PFfloat*)value)[0]*255.0f),
-                (PFubyte)(((PFfloat*)value)[1]*255.0f),
-                (PFubyte)(((PFfloat*)value)[2]*255.0f),
-                255
-            };
-            break;
-        case PF_DIFFUSE:
-            material0->diffuse = material1->diffuse = (PFcolor) {
-                (PFubyte)(((PFfloat*)value)[0]*255.0f),
-                (PFubyte)(((PFfloat*)value)[1]*255.0f),
-                (PFubyte)(((PFfloat*)value)[2]*255.0f),
-                255
-            };
-            break;
-        case PF_SPECULAR:
-            material0->specular = material1->specular = (PFcolor) {
-                (PFubyte)(((PFfloat*)value)[0]*255.0f),
-                (PFubyte)(((PFfloat*)value)[1]*255.0f),
-                (PFubyte)(((PFfloat*)value)[2]*255.0f),
-                255
-            };
-            break;
-        case PF_EMISSION:
-            material0->emission = material1->emission = (PFcolor) {
-                (PFubyte)(((PFfloat*)value)[0]*255.0f),
-                (PFubyte)(((PFfloat*)value)[1]*255.0f),
-                (PFubyte)(((PFfloat*)value)[2]*255.0f),
-                255
-            };
-            break;
-        case PF_SHININESS:
-            material0->shininess = material1->shininess = *((PFfloat*)value);
-            break;
-        case PF_AMBIENT_AND_DIFFUSE:
-            material0->ambient = material1->ambient = (PFcolor) {
-                (PFubyte)(((PFfloat*)value)[0]*255.0f),
-                (PFubyte)(((PFfloat*)value)[1]*255.0f),
-                (PFubyte)(((PFfloat*)value)[2]*255.0f),
-                255
-            };
-            material0->diffuse = material1->diffuse = (PFcolor) {
-                (PFubyte)(((PFfloat*)value)[0]*255.0f),
-                (PFubyte)(((PFfloat*)value)[1]*255.0f),
-                (PFubyte)(((PFfloat*)value)[2]*255.0f),
-                255
-            };
-            break;
-        default:
-            G_currentCtx->errCode = PF_INVALID_ENUM;
-            break;
+    if (!pfiSetMaterialParam(material0, material1, param, value)) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
     }
 }
 
 void pfColorMaterial(PFface face, PFenum mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = face }, { .u = mode } };
+        pfiPushCommand(PFI_CMD_COLOR_MATERIAL, args, 2, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+
     if (face < PF_FRONT || face > PF_FRONT_AND_BACK) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
@@ -1151,6 +1935,11 @@ void pfColorMaterial(PFface face, PFenum mode)
         return;
     }
 
+    PFIcmdarg args[] = { { .i = face }, { .u = mode } };
+    if (pfiRecordCommand(PFI_CMD_COLOR_MATERIAL, args, 2, NULL, 0)) {
+        return;
+    }
+
     G_currentCtx->materialColorFollowing.face = face;
     G_currentCtx->materialColorFollowing.mode = mode;
 }
@@ -1160,62 +1949,134 @@ void pfColorMaterial(PFface face, PFenum mode)
 
 void pfVertexPointer(PFint size, PFenum type, PFsizei stride, const void* pointer)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = size }, { .u = type }, { .u = stride }, { .p = pointer } };
+        pfiPushCommand(PFI_CMD_VERTEX_POINTER, args, 4, NULL, 0);
+        return;
+    }
+
     if (size < 2 || size > 4) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
 
-    if (!(type == PF_SHORT || type == PF_INT || type == PF_FLOAT || type == PF_DOUBLE)) {
+    if (!(type == PF_BYTE || type == PF_UNSIGNED_BYTE || type == PF_SHORT || type == PF_UNSIGNED_SHORT
+       || type == PF_INT || type == PF_HALF_FLOAT || type == PF_FLOAT || type == PF_DOUBLE)) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
 
-    G_currentCtx->vertexAttribs.positions = (PFIvertexattribbuffer) {
-        .buffer = pointer,
-        .stride = stride,
-        .size = size,
-        .type = type
-    };
+    // NOTE: The scale and offset set by 'pfVertexQuantization' are kept
+    PFIvertexattribbuffer *positions = &G_currentCtx->vertexAttribs.positions;
+    positions->buffer = pointer;
+    positions->stride = stride;
+    positions->size = size;
+    positions->type = type;
+}
+
+void pfVertexQuantization(const PFfloat* scale, const PFfloat* offset)
+{
+    if (pfiIsDeferred()) {
+        PFfloat data[6] = { 0 };
+        if (scale) memcpy(data, scale, sizeof(PFMvec3));
+        if (offset) memcpy(data + 3, offset, sizeof(PFMvec3));
+        PFIcmdarg args[] = { { .p = scale }, { .p = offset } };
+        pfiPushCommand(PFI_CMD_VERTEX_QUANTIZATION, args, 2, data, sizeof(data));
+        return;
+    }
+
+    PFIvertexattribbuffer *positions = &G_currentCtx->vertexAttribs.positions;
+
+    if (scale) memcpy(positions->scale, scale, sizeof(PFMvec3));
+    else pfmVec3Set(positions->scale, 1.0f, 1.0f, 1.0f);
+
+    if (offset) memcpy(positions->offset, offset, sizeof(PFMvec3));
+    else pfmVec3Set(positions->offset, 0.0f, 0.0f, 0.0f);
+
+    // NOTE: The fourth component is never quantized
+    positions->scale[3] = 1.0f;
+    positions->offset[3] = 0.0f;
 }
 
 void pfNormalPointer(PFenum type, PFsizei stride, const void* pointer)
 {
-    if (!(type == PF_FLOAT || type == PF_DOUBLE)) {
-        G_currentCtx->errCode = PF_INVALID_ENUM;
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = type }, { .u = stride }, { .p = pointer } };
+        pfiPushCommand(PFI_CMD_NORMAL_POINTER, args, 3, NULL, 0);
         return;
     }
 
+    // NOTE: Integer normals are normalized from their signed range to [-1..1]
+    PFfloat scale = 1.0f;
+
+    switch (type) {
+        case PF_BYTE:   scale = 1.0f/127;   break;
+        case PF_SHORT:  scale = 1.0f/32767; break;
+        case PF_HALF_FLOAT:
+        case PF_FLOAT:
+        case PF_DOUBLE:                     break;
+        default:
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+            return;
+    }
+
     G_currentCtx->vertexAttribs.normals = (PFIvertexattribbuffer) {
         .buffer = pointer,
         .stride = stride,
         .size = 3,
-        .type = type
+        .type = type,
+        .scale = { scale, scale, scale, 1.0f }
     };
 }
 
 void pfTexCoordPointer(PFenum type, PFsizei stride, const void* pointer)
 {
-    if (!(type == PF_FLOAT || type == PF_DOUBLE)) {
-        G_currentCtx->errCode = PF_INVALID_ENUM;
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = type }, { .u = stride }, { .p = pointer } };
+        pfiPushCommand(PFI_CMD_TEXCOORD_POINTER, args, 3, NULL, 0);
         return;
     }
 
-    G_currentCtx->vertexAttribs.texcoords = (PFIvertexattribbuffer) {
+    // NOTE: Integer texture coordinates are normalized to [0..1]
+    PFfloat scale = 1.0f;
+
+    switch (type) {
+        case PF_UNSIGNED_SHORT: scale = 1.0f/65535; break;
+        case PF_HALF_FLOAT:
+        case PF_FLOAT:
+        case PF_DOUBLE:                             break;
+        default:
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+            return;
+    }
+
+    PFIvertexattribbuffer *texcoords = (G_currentCtx->activeTexture == PF_TEXTURE1)
+        ? &G_currentCtx->vertexAttribs.texcoords1 : &G_currentCtx->vertexAttribs.texcoords;
+
+    *texcoords = (PFIvertexattribbuffer) {
         .buffer = pointer,
         .stride = stride,
         .size = 2,
-        .type = type
+        .type = type,
+        .scale = { scale, scale, 1.0f, 1.0f }
     };
 }
 
 void pfColorPointer(PFint size, PFenum type, PFsizei stride, const void* pointer)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = size }, { .u = type }, { .u = stride }, { .p = pointer } };
+        pfiPushCommand(PFI_CMD_COLOR_POINTER, args, 4, NULL, 0);
+        return;
+    }
+
     if (size < 3 || size > 4) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
 
-    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT || type == PF_FLOAT || type == PF_DOUBLE)) {
+    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT
+       || type == PF_HALF_FLOAT || type == PF_FLOAT || type == PF_DOUBLE)) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
@@ -1228,350 +2089,132 @@ void pfColorPointer(PFint size, PFenum type, PFsizei stride, const void* pointer
     };
 }
 
-void pfDrawElements(PFdrawmode mode, PFsizei count, PFdatatype type, const void* indices)
+void pfWeightPointer(PFint size, PFenum type, PFsizei stride, const void* pointer)
 {
-    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT)) {
-        G_currentCtx->errCode = PF_INVALID_ENUM;
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = size }, { .u = type }, { .u = stride }, { .p = pointer } };
+        pfiPushCommand(PFI_CMD_WEIGHT_POINTER, args, 4, NULL, 0);
         return;
     }
 
-    if (!(G_currentCtx->state & PF_VERTEX_ARRAY)) {
-        G_currentCtx->errCode = PF_INVALID_OPERATION;
+    if (size < 1 || size > 4) {
+        G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
     }
 
-    const PFIvertexattribbuffer *positions = &G_currentCtx->vertexAttribs.positions;
-    const PFIvertexattribbuffer *texcoords = &G_currentCtx->vertexAttribs.texcoords;
-    const PFIvertexattribbuffer *normals = &G_currentCtx->vertexAttribs.normals;
-    const PFIvertexattribbuffer *colors = &G_currentCtx->vertexAttribs.colors;
-
-    PFboolean useTexCoordArray = G_currentCtx->state & PF_TEXTURE_COORD_ARRAY && texcoords->buffer;
-    PFboolean useNormalArray = G_currentCtx->state & PF_NORMAL_ARRAY && normals->buffer;
-    PFboolean useColorArray = G_currentCtx->state & PF_COLOR_ARRAY && colors->buffer;
-
-    PFsizei indicesTypeSize = pfiGetDataTypeSize(type);
-    PFsizei drawModeVertexCount = pfiGetDrawModeVertexCount(mode);
-
-    for (PFsizei i = 0; i < drawModeVertexCount; i++) {
-        G_currentCtx->vertexBuffer[i] = (PFIvertex) { 0 };
-        G_currentCtx->vertexBuffer[i].color = G_currentCtx->currentColor;
-    }
-
-    pfBegin(mode);
-
-    for (PFsizei i = 0; i < count; i++) {
-        PFIvertex *vertex = G_currentCtx->vertexBuffer + (G_currentCtx->vertexCounter++);
-
-        // Get vertex index
-        const void *p = (const PFubyte*)indices + i*indicesTypeSize;
+    // NOTE: Integer weights are normalized to [0..1]
+    PFfloat scale = 1.0f;
 
-        PFsizei j = 0;
-        switch(type) {
-            case PF_UNSIGNED_BYTE:  j = *((const PFubyte*)p);  break;
-            case PF_UNSIGNED_SHORT: j = *((const PFushort*)p); break;
-            case PF_UNSIGNED_INT:   j = *((const PFuint*)p);   break;
-            default:
-                G_currentCtx->errCode = PF_INVALID_ENUM;
-                return;
-        }
-
-        // Fill the vertex with given vertices data
-        memset(&vertex->position, 0, sizeof(PFMvec3));
-        vertex->position[3] = 1.0f;
-
-        switch (positions->type) {
-            case PF_SHORT: {
-                for (int_fast8_t k = 0; k < positions->size; k++) {
-                    vertex->position[k] = ((const PFshort*)positions->buffer)[j*positions->size + k];
-                }
-            }
-            break;
-            case PF_INT: {
-                for (int_fast8_t k = 0; k < positions->size; k++) {
-                    vertex->position[k] = ((const PFint*)positions->buffer)[j*positions->size + k];
-                }
-            }
-            break;
-            case PF_FLOAT: {
-                for (int_fast8_t k = 0; k < positions->size; k++) {
-                    vertex->position[k] = ((const PFfloat*)positions->buffer)[j*positions->size + k];
-                }
-            }
-            break;
-            case PF_DOUBLE: {
-                for (int_fast8_t k = 0; k < positions->size; k++) {
-                    vertex->position[k] = ((const PFdouble*)positions->buffer)[j*positions->size + k];
-                }
-            }
-            break;
-            default:
-                G_currentCtx->errCode = PF_INVALID_ENUM;
-                return;
-        }
-
-        if (useNormalArray) {
-            memset(&vertex->normal, 0, sizeof(PFMvec3));
-
-            switch (normals->type) {
-                case PF_FLOAT: {
-                    for (int_fast8_t k = 0; k < 3; k++) {
-                        vertex->normal[k] = ((const PFfloat*)normals->buffer)[j*3 + k];
-                    }
-                }
-                break;
-                case PF_DOUBLE: {
-                    for (int_fast8_t k = 0; k < 3; k++) {
-                        vertex->normal[k] = ((const PFdouble*)normals->buffer)[j*3 + k];
-                    }
-                }
-                break;
-                default:
-                    G_currentCtx->errCode = PF_INVALID_ENUM;
-                    return;
-            }
-        }
-
-        if (useTexCoordArray) {
-            memset(&vertex->texcoord, 0, sizeof(PFMvec2));
-
-            switch (texcoords->type) {
-                case PF_FLOAT: {
-                    for (int_fast8_t k = 0; k < 2; k++)
-                    {
-                        vertex->texcoord[k] = ((const PFfloat*)texcoords->buffer)[j*2 + k];
-                    }
-                }
-                break;
-                case PF_DOUBLE: {
-                    for (int_fast8_t k = 0; k < 2; k++) {
-                        vertex->texcoord[k] = ((const PFdouble*)texcoords->buffer)[j*2 + k];
-                    }
-                }
-                break;
-                default:
-                    G_currentCtx->errCode = PF_INVALID_ENUM;
-                    return;
-            }
-        }
-
-        if (useColorArray) {
-            memset(&vertex->color, 0xFF, sizeof(PFcolor));
-
-            switch (colors->type) {
-                case PF_UNSIGNED_BYTE: {
-                    for (int_fast8_t k = 0; k < colors->size; k++) {
-                        ((PFubyte*)&vertex->color)[k] = ((const PFubyte*)colors->buffer)[j*colors->size + k];
-                    }
-                }
-                break;
-                case PF_UNSIGNED_SHORT: {
-                    for (int_fast8_t k = 0; k < colors->size; k++) {
-                        ((PFubyte*)&vertex->color)[k] = ((const PFushort*)colors->buffer)[j*colors->size + k] >> 8;
-                    }
-                }
-                break;
-                case PF_UNSIGNED_INT: {
-                    for (int_fast8_t k = 0; k < colors->size; k++) {
-                        ((PFubyte*)&vertex->color)[k] = ((const PFuint*)colors->buffer)[j*colors->size + k] >> 24;
-                    }
-                }
-                break;
-                case PF_FLOAT: {
-                    for (int_fast8_t k = 0; k < colors->size; k++) {
-                        ((PFubyte*)&vertex->color)[k] = ((const PFfloat*)colors->buffer)[j*colors->size + k] * 255;
-                    }
-                }
-                break;
-                case PF_DOUBLE: {
-                    for (int_fast8_t k = 0; k < colors->size; k++) {
-                        ((PFubyte*)&vertex->color)[k] = ((const PFdouble*)colors->buffer)[j*colors->size + k] * 255;
-                    }
-                }
-                break;
-                default:
-                    G_currentCtx->errCode = PF_INVALID_ENUM;
-                    return;
-            }
-        }
-
-        // If the number of vertices has reached that necessary for, we process the shape
-        if (G_currentCtx->vertexCounter == drawModeVertexCount) {
-            pfiProcessAndRasterize();
-            pfiResetVertexBufferForNextElement();
-        }
+    switch (type) {
+        case PF_UNSIGNED_BYTE:  scale = 1.0f/255;   break;
+        case PF_UNSIGNED_SHORT: scale = 1.0f/65535; break;
+        case PF_HALF_FLOAT:
+        case PF_FLOAT:                              break;
+        default:
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+            return;
     }
 
-    pfEnd();
+    G_currentCtx->vertexAttribs.weights = (PFIvertexattribbuffer) {
+        .buffer = pointer,
+        .stride = stride,
+        .size = size,
+        .type = type,
+        .scale = { scale, scale, scale, scale }
+    };
 }
 
-void pfDrawArrays(PFdrawmode mode, PFint first, PFsizei count)
+void pfBoneIndexPointer(PFint size, PFenum type, PFsizei stride, const void* pointer)
 {
-    if (!(G_currentCtx->state & PF_VERTEX_ARRAY)) {
-        G_currentCtx->errCode = PF_INVALID_OPERATION;
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = size }, { .u = type }, { .u = stride }, { .p = pointer } };
+        pfiPushCommand(PFI_CMD_BONE_INDEX_POINTER, args, 4, NULL, 0);
         return;
     }
 
-    const PFIvertexattribbuffer *positions = &G_currentCtx->vertexAttribs.positions;
-    const PFIvertexattribbuffer *texcoords = &G_currentCtx->vertexAttribs.texcoords;
-    const PFIvertexattribbuffer *normals = &G_currentCtx->vertexAttribs.normals;
-    const PFIvertexattribbuffer *colors = &G_currentCtx->vertexAttribs.colors;
+    if (size < 1 || size > 4) {
+        G_currentCtx->errCode = PF_INVALID_VALUE;
+        return;
+    }
 
-    PFboolean useTexCoordArray = G_currentCtx->state & PF_TEXTURE_COORD_ARRAY && texcoords->buffer;
-    PFboolean useNormalArray = G_currentCtx->state & PF_NORMAL_ARRAY && normals->buffer;
-    PFboolean useColorArray = G_currentCtx->state & PF_COLOR_ARRAY && colors->buffer;
+    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT)) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
 
-    PFsizei drawModeVertexCount = pfiGetDrawModeVertexCount(mode);
+    G_currentCtx->vertexAttribs.boneIndices = (PFIvertexattribbuffer) {
+        .buffer = pointer,
+        .stride = stride,
+        .size = size,
+        .type = type
+    };
+}
 
-    for (PFsizei i = 0; i < drawModeVertexCount; i++) {
-        G_currentCtx->vertexBuffer[i] = (PFIvertex) { 0 };
-        G_currentCtx->vertexBuffer[i].color = G_currentCtx->currentColor;
+void pfBoneMatrices(PFsizei first, PFsizei count, const PFfloat* matrices)
+{
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .u = first }, { .u = count }, { .p = matrices } };
+        pfiPushCommand(PFI_CMD_BONE_MATRICES, args, 3, matrices, matrices ? count*sizeof(PFMmat4) : 0);
+        return;
     }
 
-    pfBegin(mode);
-
-    for (PFsizei i = 0; i < count; i++) {
-        PFIvertex *vertex = G_currentCtx->vertexBuffer + (G_currentCtx->vertexCounter++);
+    if (first + count > PF_MAX_BONE_MATRICES || first + count < first) {
+        G_currentCtx->errCode = PF_INVALID_VALUE;
+        return;
+    }
 
-        // Fill the vertex with given vertices data
-        memset(&vertex->position, 0, sizeof(PFMvec3));
-        vertex->position[3] = 1.0f;
-
-        switch (positions->type) {
-            case PF_SHORT: {
-                for (int_fast8_t j = 0; j < positions->size; j++) {
-                    vertex->position[j] =
-                        ((const PFshort*)positions->buffer + first*positions->size)[i*positions->size + j];
-                }
-            }
-            break;
-            case PF_INT: {
-                for (int_fast8_t j = 0; j < positions->size; j++) {
-                    vertex->position[j] =
-                        ((const PFint*)positions->buffer + first*positions->size)[i*positions->size + j];
-                }
-            }
-            break;
-            case PF_FLOAT: {
-                for (int_fast8_t j = 0; j < positions->size; j++) {
-                    vertex->position[j] =
-                        ((const PFfloat*)positions->buffer + first*positions->size)[i*positions->size + j];
-                }
-            }
-            break;
-            case PF_DOUBLE: {
-                for (int_fast8_t j = 0; j < positions->size; j++) {
-                    vertex->position[j] =
-                        ((const PFdouble*)positions->buffer + first*positions->size)[i*positions->size + j];
-                }
-            }
-            break;
-            default:
-                G_currentCtx->errCode = PF_INVALID_ENUM;
-                break;
-        }
+    if (!matrices) {
+        G_currentCtx->errCode = PF_INVALID_VALUE;
+        return;
+    }
 
-        if (useNormalArray) {
-            memset(&vertex->normal, 0, sizeof(PFMvec3));
+    memcpy(G_currentCtx->bonePalette + first, matrices, count*sizeof(PFMmat4));
+}
 
-            switch (normals->type) {
-                case PF_FLOAT:
-                {
-                    for (int_fast8_t j = 0; j < 3; j++) {
-                        vertex->normal[j] =
-                            ((const PFfloat*)normals->buffer + first*3)[i*3 + j];
-                    }
-                }
-                break;
-                case PF_DOUBLE: {
-                    for (int_fast8_t j = 0; j < 3; j++) {
-                        vertex->normal[j] =
-                            ((const PFdouble*)normals->buffer + first*3)[i*3 + j];
-                    }
-                }
-                break;
-                default:
-                    G_currentCtx->errCode = PF_INVALID_ENUM;
-                    break;
-            }
+void pfDrawElements(PFdrawmode mode, PFsizei count, PFdatatype type, const void* indices)
+{
+    if (pfiIsDeferred()) {
+        // NOTE: The indices are copied into the command, see 'pfCreateDeferredContext'
+        if (indices == NULL) {
+            G_currentCtx->commandQueue->errCode = PF_INVALID_VALUE;
+            return;
         }
+        PFIcmdarg args[] = { { .i = mode }, { .u = count }, { .i = type } };
+        pfiPushCommand(PFI_CMD_DRAW_ELEMENTS, args, 3, indices, count*pfiGetDataTypeSize(type));
+        return;
+    }
 
-        if (useTexCoordArray) {
-            memset(&vertex->texcoord, 0, sizeof(PFMvec2));
+    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT)) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
 
-            switch (texcoords->type) {
-                case PF_FLOAT: {
-                    for (int_fast8_t j = 0; j < 2; j++) {
-                        vertex->texcoord[j] =
-                            ((const PFfloat*)texcoords->buffer + first*2)[i*2 + j];
-                    }
-                }
-                break;
-                case PF_DOUBLE: {
-                    for (int_fast8_t j = 0; j < 2; j++) {
-                        vertex->texcoord[j] =
-                            ((const PFdouble*)texcoords->buffer + first*2)[i*2 + j];
-                    }
-                }
-                break;
-                default:
-                    G_currentCtx->errCode = PF_INVALID_ENUM;
-                    break;
-            }
-        }
+    if (!(G_currentCtx->state & PF_VERTEX_ARRAY)) {
+        G_currentCtx->errCode = PF_INVALID_OPERATION;
+        return;
+    }
 
-        if (useColorArray) {
-            memset(&vertex->color, 0xFF, sizeof(PFcolor));
+    PFIvertexfetch fetch;
+    pfiInitVertexFetch(&fetch, indices, type, 0);
+    pfiDrawVertices(mode, count, &fetch);
+}
 
-            switch (colors->type) {
-                case PF_UNSIGNED_BYTE: {
-                    for (int_fast8_t j = 0; j < colors->size; j++) {
-                        ((PFubyte*)&vertex->color)[j] =
-                            ((const PFubyte*)colors->buffer + first*colors->size)[i*colors->size + j];
-                    }
-                }
-                break;
-                case PF_UNSIGNED_SHORT: {
-                    for (int_fast8_t j = 0; j < colors->size; j++) {
-                        ((PFubyte*)&vertex->color)[j] =
-                            ((const PFushort*)colors->buffer + first*colors->size)[i*colors->size + j] >> 8;
-                    }
-                }
-                break;
-                case PF_UNSIGNED_INT: {
-                    for (int_fast8_t j = 0; j < colors->size; j++) {
-                        ((PFubyte*)&vertex->color)[j] =
-                            ((const PFuint*)colors->buffer + first*colors->size)[i*colors->size + j] >> 24;
-                    }
-                }
-                break;
-                case PF_FLOAT: {
-                    for (int_fast8_t j = 0; j < colors->size; j++) {
-                        ((PFubyte*)&vertex->color)[j] =
-                            ((const PFfloat*)colors->buffer + first*colors->size)[i*colors->size + j] * 255;
-                    }
-                }
-                break;
-                case PF_DOUBLE: {
-                    for (int_fast8_t j = 0; j < colors->size; j++) {
-                        ((PFubyte*)&vertex->color)[j] =
-                            ((const PFdouble*)colors->buffer + first*colors->size)[i*colors->size + j] * 255;
-                    }
-                }
-                break;
-                default:
-                    G_currentCtx->errCode = PF_INVALID_ENUM;
-                    break;
-            }
-        }
+void pfDrawArrays(PFdrawmode mode, PFint first, PFsizei count)
+{
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode }, { .i = first }, { .u = count } };
+        pfiPushCommand(PFI_CMD_DRAW_ARRAYS, args, 3, NULL, 0);
+        return;
+    }
 
-        // If the number of vertices has reached that necessary for, we process the shape
-        if (G_currentCtx->vertexCounter == drawModeVertexCount) {
-            pfiProcessAndRasterize();
-            pfiResetVertexBufferForNextElement();
-        }
+    if (!(G_currentCtx->state & PF_VERTEX_ARRAY)) {
+        G_currentCtx->errCode = PF_INVALID_OPERATION;
+        return;
     }
 
-    pfEnd();
+    PFIvertexfetch fetch;
+    pfiInitVertexFetch(&fetch, NULL, 0, first);
+    pfiDrawVertices(mode, count, &fetch);
 }
 
 
@@ -1579,31 +2222,35 @@ void pfDrawArrays(PFdrawmode mode, PFint first, PFsizei count)
 
 void pfBegin(PFdrawmode mode)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = mode } };
+        pfiPushCommand(PFI_CMD_BEGIN, args, 1, NULL, 0);
+        return;
+    }
+
     if (G_currentCtx->currentRenderList == NULL) {
         if (mode < PF_POINTS || mode > PF_QUAD_STRIP) {
             G_currentCtx->errCode = PF_INVALID_ENUM;
             return;
         }
+        pfiFlushBatch();
         pfiUpdateMatrices(!(mode == PF_POINTS || mode == PF_LINES));
         G_currentCtx->currentDrawMode = mode;
         G_currentCtx->vertexCounter = 0;
     } else {
-        PFIrendercall call = {
-            .positions = pfiGenVector(8, sizeof(PFMvec4)),
-            .texcoords = pfiGenVector(8, sizeof(PFMvec2)),
-            .normals = pfiGenVector(8, sizeof(PFMvec3)),
-            .colors = pfiGenVector(8, sizeof(PFcolor)),
-            .faceMaterial[0] = G_currentCtx->faceMaterial[0],
-            .faceMaterial[1] = G_currentCtx->faceMaterial[1],
-            .texture = G_currentCtx->currentTexture,
-            .drawMode = mode,
-        };
-        pfiPushBackVector(G_currentCtx->currentRenderList, &call);
+        pfiRecordBegin(G_currentCtx->currentRenderList, mode, G_currentCtx->faceMaterial,
+            G_currentCtx->currentTexture, G_currentCtx->currentTexture1);
     }
 }
 
 void pfEnd(void)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_END, NULL, 0, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
     G_currentCtx->vertexCounter = 0;
 }
 
@@ -1657,36 +2304,45 @@ void pfVertex4f(PFfloat x, PFfloat y, PFfloat z, PFfloat w)
 
 void pfVertex4fv(const PFfloat* v)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_VERTEX, NULL, 0, v, sizeof(PFMvec4));
+        return;
+    }
+
     if (G_currentCtx->currentRenderList == NULL) {
-        // Get the pointer of the current vertex of the batch and pad it with zero
-        PFIvertex *vertex = G_currentCtx->vertexBuffer + (G_currentCtx->vertexCounter++);
+        // Get the pointer of the current vertex of the batch
+        PFIvertex *vertex = G_currentCtx->vertexBatch + (G_currentCtx->batchCounter++);
 
         // Fill the vertex with given vertices data
         memcpy(vertex->position, v, sizeof(PFMvec4));
         memcpy(vertex->normal, G_currentCtx->currentNormal, sizeof(PFMvec3));
         memcpy(vertex->texcoord, G_currentCtx->currentTexcoord, sizeof(PFMvec2));
+        memcpy(vertex->texcoord1, G_currentCtx->currentTexcoord1, sizeof(PFMvec2));
         memcpy(&vertex->color, &G_currentCtx->currentColor, sizeof(PFcolor));
 
-        // If the number of vertices has reached that necessary for, we process the shape
-        if (G_currentCtx->vertexCounter == pfiGetDrawModeVertexCount(G_currentCtx->currentDrawMode)) {
-            pfiProcessAndRasterize();
-            pfiResetVertexBufferForNextElement();
+        // If the batch is full, we process all the shapes it contains
+        if (G_currentCtx->batchCounter == PF_MAX_BATCH_VERTICES) {
+            pfiFlushBatch();
         }
     } else {
-        PFIrendercall *call = pfiAtVector(
-            G_currentCtx->currentRenderList,
-            G_currentCtx->currentRenderList->size - 1);
-
-        pfiPushBackVector(&call->positions, v);
-        pfiPushBackVector(&call->texcoords, G_currentCtx->currentTexcoord);
-        pfiPushBackVector(&call->normals, G_currentCtx->currentNormal);
-        pfiPushBackVector(&call->colors, &G_currentCtx->currentColor);
+        pfiRecordVertex(G_currentCtx->currentRenderList, v, G_currentCtx->currentTexcoord,
+            G_currentCtx->currentTexcoord1, G_currentCtx->currentNormal, G_currentCtx->currentColor);
     }
 }
 
 void pfColor(PFcolor color)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .c = color } };
+        pfiPushCommand(PFI_CMD_COLOR, args, 1, NULL, 0);
+        return;
+    }
+
     if (G_currentCtx->state & PF_COLOR_MATERIAL) {
+        // NOTE: The materials are read during processing, so the
+        //       shapes already submitted must use the previous ones
+        pfiFlushBatch();
+
         PFImaterial *m1 = &G_currentCtx->faceMaterial[PF_FRONT];
         PFImaterial *m2 = &G_currentCtx->faceMaterial[PF_BACK];
 
@@ -1873,17 +2529,17 @@ void pfColor4fv(const PFfloat* v)
 
 void pfTexCoord2f(PFfloat u, PFfloat v)
 {
-    G_currentCtx->currentTexcoord[0] = u;
-    G_currentCtx->currentTexcoord[1] = v;
-
-    pfmVec2Transform(
-        G_currentCtx->currentTexcoord,
-        G_currentCtx->currentTexcoord,
-        G_currentCtx->matTexture);
+    PFMvec2 texcoord = { u, v };
+    pfTexCoordfv(texcoord);
 }
 
 void pfTexCoordfv(const PFfloat* v)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_TEXCOORD, NULL, 0, v, sizeof(PFMvec2));
+        return;
+    }
+
     memcpy(G_currentCtx->currentTexcoord, v, sizeof(PFMvec2));
 
     pfmVec2Transform(
@@ -1892,19 +2548,46 @@ void pfTexCoordfv(const PFfloat* v)
         G_currentCtx->matTexture);
 }
 
-void pfNormal3f(PFfloat x, PFfloat y, PFfloat z)
+void pfMultiTexCoord2f(PFtextureunit unit, PFfloat u, PFfloat v)
+{
+    PFMvec2 texcoord = { u, v };
+    pfMultiTexCoordfv(unit, texcoord);
+}
+
+void pfMultiTexCoordfv(PFtextureunit unit, const PFfloat* v)
 {
-    G_currentCtx->currentNormal[0] = x;
-    G_currentCtx->currentNormal[1] = y;
-    G_currentCtx->currentNormal[2] = z;
+    if (unit == PF_TEXTURE0) {
+        pfTexCoordfv(v);
+        return;
+    }
 
-    if (G_currentCtx->state & PF_NORMALIZE) {
-        pfmVec3Normalize(G_currentCtx->currentNormal, G_currentCtx->currentNormal);
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = unit } };
+        pfiPushCommand(PFI_CMD_MULTI_TEXCOORD, args, 1, v, sizeof(PFMvec2));
+        return;
+    }
+
+    if (unit != PF_TEXTURE1) {
+        G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
     }
+
+    memcpy(G_currentCtx->currentTexcoord1, v, sizeof(PFMvec2));
+}
+
+void pfNormal3f(PFfloat x, PFfloat y, PFfloat z)
+{
+    PFMvec3 normal = { x, y, z };
+    pfNormal3fv(normal);
 }
 
 void pfNormal3fv(const PFfloat* v)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_NORMAL, NULL, 0, v, sizeof(PFMvec3));
+        return;
+    }
+
     memcpy(G_currentCtx->currentNormal, v, sizeof(PFMvec3));
 
     if (G_currentCtx->state & PF_NORMALIZE) {
@@ -1937,6 +2620,15 @@ void pfRectiv(const PFint* v1, const PFint* v2)
 
 void pfRectf(PFfloat x1, PFfloat y1, PFfloat x2, PFfloat y2)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = x1 }, { .f = y1 }, { .f = x2 }, { .f = y2 } };
+        pfiPushCommand(PFI_CMD_RECT, args, 4, NULL, 0);
+        return;
+    }
+
+    pfiFlushBatch();
+    pfiSyncRaster();
+
     // Get the transformation matrix from model to view (ModelView) and projection
     pfiUpdateMatrices(PF_FALSE);
 
@@ -1963,18 +2655,15 @@ void pfRectf(PFfloat x1, PFfloat y1, PFfloat x2, PFfloat y2)
     iY2 = PF_CLAMP(iY2, G_currentCtx->vpMin[1], G_currentCtx->vpMax[1]);
 
     // Retrieve framebuffer texture and current drawing color tint
-    struct PFItex *tex = G_currentCtx->currentFramebuffer->texture;
-    PFcolor color = G_currentCtx->currentColor;
+    PFIrectjob rect = {
+        .tex = G_currentCtx->currentFramebuffer->texture,
+        .xMin = iX1, .xMax = iX2,
+        .color = G_currentCtx->currentColor
+    };
 
     // Draw rectangle
-#   ifdef _OPENMP
-#       pragma omp for collapse(2)
-#   endif //_OPENMP
-    for (PFint y = iY1; y <= iY2; y++) {
-        for (PFint x = iX1; x <= iX2; x++) {
-            tex->setter(tex->pixels, y * tex->w + x, color);
-        }
-    }
+    pfiParallelForIf((iY2 - iY1)*(iX2 - iX1) >= PF_PARALLEL_RASTER_THRESHOLD_AREA,
+                     iY1, iY2 + 1, 0, pfiRectJob, &rect);
 }
 
 void pfRectfv(const PFfloat* v1, const PFfloat* v2)
@@ -1987,6 +2676,20 @@ void pfRectfv(const PFfloat* v1, const PFfloat* v2)
 
 void pfDrawPixels(PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type, const void* pixels)
 {
+    if (pfiIsDeferred()) {
+        // NOTE: See 'pfDrawElements'
+        if (pixels == NULL) {
+            G_currentCtx->commandQueue->errCode = PF_INVALID_VALUE;
+            return;
+        }
+        PFIcmdarg args[] = { { .u = width }, { .u = height }, { .i = format }, { .i = type } };
+        pfiPushCommand(PFI_CMD_DRAW_PIXELS, args, 4, pixels, width*height*pfiGetPixelBytes(format, type));
+        return;
+    }
+
+    pfiFlushBatch();
+    pfiSyncRaster();
+
     // Check if width or height is 0, which is an invalid value
     if (width == 0 || height == 0) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
@@ -2026,132 +2729,107 @@ void pfDrawPixels(PFsizei width, PFsizei height, PFpixelformat format, PFdatatyp
     PFint xMax = PF_CLAMP(xScreen + width*G_currentCtx->pixelZoom[0], G_currentCtx->vpMin[0], G_currentCtx->vpMax[0]);
     PFint yMax = PF_CLAMP(yScreen + height*G_currentCtx->pixelZoom[1], G_currentCtx->vpMin[1], G_currentCtx->vpMax[1]);
 
+    PFIdrawpixelsjob draw = {
+        .pixels = pixels,
+        .getPixelSrc = getPixelSrc,
+        .xMin = xMin, .xMax = xMax,
+        .xScreen = xScreen, .yScreen = yScreen,
+        .zPos = zPos,
+        .width = width
+    };
+
     // Calculate inverse lengths for texture sampling
-    PFfloat invXLen = 1.0f/(PFfloat)(width*G_currentCtx->pixelZoom[0]);
-    PFfloat invYLen = 1.0f/(PFfloat)(height*G_currentCtx->pixelZoom[1]);
+    draw.invXLen = 1.0f/(PFfloat)(width*G_currentCtx->pixelZoom[0]);
+    draw.invYLen = 1.0f/(PFfloat)(height*G_currentCtx->pixelZoom[1]);
 
     // Calculate the dimensions minus 1 to scale the texture coordinates
-    PFsizei widthM1 = width - 1;
-    PFsizei heightM1 = height - 1;
+    draw.widthM1 = width - 1;
+    draw.heightM1 = height - 1;
 
     // Get current framebuffer and depth buffer
-    struct PFItex *texDst = G_currentCtx->currentFramebuffer->texture;
-    PFfloat *zBuffer = G_currentCtx->currentFramebuffer->zbuffer;
+    draw.texDst = G_currentCtx->currentFramebuffer->texture;
+    draw.zBuffer = G_currentCtx->currentFramebuffer->zbuffer;
 
-    // Check if depth test is enabled
-    PFboolean noDepthTest = !(G_currentCtx->state & PF_DEPTH_TEST);
+    // Get the depth testing function (if necessary)
+    draw.depthFunction = G_currentCtx->state & PF_DEPTH_TEST ?
+        G_currentCtx->depthFunction : NULL;
 
     // Get the color mixing function (if necessary)
-    PFIblendfunc blendFunction = G_currentCtx->state & PF_BLEND ?
+    draw.blendFunction = G_currentCtx->state & PF_BLEND ?
         G_currentCtx->blendFunction : NULL;
 
     // Loop through each pixel in the destination rectangle
-#   ifdef _OPENMP
-#       pragma omp parallel for if ((yMax - yMin)*(xMax - xMin) >= PF_OPENMP_RASTER_THRESHOLD_AREA)
-#   endif // _OPENMP
-    for (PFint y = yMin; y <= yMax; y++) {
-        // Calculate texture V coordinate based on screen Y coordinate
-        PFfloat v = (PFfloat)(y - yScreen)*invYLen;
-        PFsizei ySrcOffset = (PFsizei)(v*heightM1)*width; // Offset into source texture
-
-        // Calculate destination offset for this scanline
-        PFsizei yDstOffset = y*texDst->w;
-
-        for (PFint x = xMin; x <= xMax; x++) {
-            // Calculate destination offset for this pixel
-            PFsizei xyDstOffset = yDstOffset + x;
-
-            // Perform depth test or skip if disabled
-            if (noDepthTest || G_currentCtx->depthFunction(zPos, zBuffer[xyDstOffset])) {
-                // Calculate texture U coordinate based on screen X coordinate
-                PFfloat u = (PFfloat)(x - xScreen)*invXLen;
-
-                // Calculate offset into source texture for this pixel
-                PFsizei xySrcOffset = ySrcOffset + (PFsizei)(u*widthM1);
-
-                // Update depth buffer with new depth value
-                zBuffer[xyDstOffset] = zPos;
-
-                // Retrieve source color
-                PFcolor color = getPixelSrc(pixels, xySrcOffset);
-
-                // Blend source and destination colors and update framebuffer
-                texDst->setter(texDst->pixels, xyDstOffset, blendFunction
-                    ? blendFunction(color, texDst->getter(texDst->pixels, xyDstOffset)) : color);
-            }
-        }
-    }
+    pfiParallelForIf((yMax - yMin)*(xMax - xMin) >= PF_PARALLEL_RASTER_THRESHOLD_AREA,
+                     yMin, yMax + 1, 0, pfiDrawPixelsJob, &draw);
 }
 
 void pfPixelZoom(PFfloat xFactor, PFfloat yFactor)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .f = xFactor }, { .f = yFactor } };
+        pfiPushCommand(PFI_CMD_PIXEL_ZOOM, args, 2, NULL, 0);
+        return;
+    }
+
     G_currentCtx->pixelZoom[0] = xFactor;
     G_currentCtx->pixelZoom[1] = yFactor;
 }
 
 void pfRasterPos2i(PFint x, PFint y)
 {
-    G_currentCtx->rasterPos[0] = (PFfloat)x;
-    G_currentCtx->rasterPos[1] = (PFfloat)y;
-    G_currentCtx->rasterPos[2] = 0.0f;
-    G_currentCtx->rasterPos[3] = 1.0f;
+    PFMvec4 v = { (PFfloat)x, (PFfloat)y, 0.0f, 1.0f };
+    pfRasterPos4fv(v);
 }
 
 void pfRasterPos2f(PFfloat x, PFfloat y)
 {
-    G_currentCtx->rasterPos[0] = x;
-    G_currentCtx->rasterPos[1] = y;
-    G_currentCtx->rasterPos[2] = 0.0f;
-    G_currentCtx->rasterPos[3] = 1.0f;
+    PFMvec4 v = { x, y, 0.0f, 1.0f };
+    pfRasterPos4fv(v);
 }
 
 void pfRasterPos2fv(const PFfloat* v)
 {
-    memcpy(G_currentCtx->rasterPos, v, sizeof(PFMvec2));
-    G_currentCtx->rasterPos[2] = 0.0f;
-    G_currentCtx->rasterPos[3] = 1.0f;
+    PFMvec4 v4 = { v[0], v[1], 0.0f, 1.0f };
+    pfRasterPos4fv(v4);
 }
 
 void pfRasterPos3i(PFint x, PFint y, PFint z)
 {
-    G_currentCtx->rasterPos[0] = (PFfloat)x;
-    G_currentCtx->rasterPos[1] = (PFfloat)y;
-    G_currentCtx->rasterPos[2] = (PFfloat)z;
-    G_currentCtx->rasterPos[3] = 1.0f;
+    PFMvec4 v = { (PFfloat)x, (PFfloat)y, (PFfloat)z, 1.0f };
+    pfRasterPos4fv(v);
 }
 
 void pfRasterPos3f(PFfloat x, PFfloat y, PFfloat z)
 {
-    G_currentCtx->rasterPos[0] = x;
-    G_currentCtx->rasterPos[1] = y;
-    G_currentCtx->rasterPos[2] = z;
-    G_currentCtx->rasterPos[3] = 1.0f;
+    PFMvec4 v = { x, y, z, 1.0f };
+    pfRasterPos4fv(v);
 }
 
 void pfRasterPos3fv(const PFfloat* v)
 {
-    memcpy(G_currentCtx->rasterPos, v, sizeof(PFMvec3));
-    G_currentCtx->rasterPos[3] = 1.0f;
+    PFMvec4 v4 = { v[0], v[1], v[2], 1.0f };
+    pfRasterPos4fv(v4);
 }
 
 void pfRasterPos4i(PFint x, PFint y, PFint z, PFint w)
 {
-    G_currentCtx->rasterPos[0] = (PFfloat)x;
-    G_currentCtx->rasterPos[1] = (PFfloat)y;
-    G_currentCtx->rasterPos[2] = (PFfloat)z;
-    G_currentCtx->rasterPos[3] = (PFfloat)w;
+    PFMvec4 v = { (PFfloat)x, (PFfloat)y, (PFfloat)z, (PFfloat)w };
+    pfRasterPos4fv(v);
 }
 
 void pfRasterPos4f(PFfloat x, PFfloat y, PFfloat z, PFfloat w)
 {
-    G_currentCtx->rasterPos[0] = x;
-    G_currentCtx->rasterPos[1] = y;
-    G_currentCtx->rasterPos[2] = z;
-    G_currentCtx->rasterPos[3] = w;
+    PFMvec4 v = { x, y, z, w };
+    pfRasterPos4fv(v);
 }
 
 void pfRasterPos4fv(const PFfloat* v)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_RASTER_POS, NULL, 0, v, sizeof(PFMvec4));
+        return;
+    }
+
     memcpy(G_currentCtx->rasterPos, v, sizeof(PFMvec4));
 }
 
@@ -2160,6 +2838,12 @@ void pfRasterPos4fv(const PFfloat* v)
 
 void pfFogi(PFfogparam pname, PFint param)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = pname }, { .i = param } };
+        pfiPushCommand(PFI_CMD_FOGI, args, 2, NULL, 0);
+        return;
+    }
+
     switch (pname) {
         case PF_FOG_MODE:
             if (param >= PF_LINEAR && param <= PF_EXP2) {
@@ -2189,6 +2873,12 @@ void pfFogi(PFfogparam pname, PFint param)
 
 void pfFogf(PFfogparam pname, PFfloat param)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = pname }, { .f = param } };
+        pfiPushCommand(PFI_CMD_FOGF, args, 2, NULL, 0);
+        return;
+    }
+
     switch (pname) {
         case PF_FOG_DENSITY:
             if (param >= 0 && param <= 1) {
@@ -2211,6 +2901,12 @@ void pfFogf(PFfogparam pname, PFfloat param)
 
 void pfFogiv(PFfogparam pname, PFint* param)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = pname } };
+        pfiPushCommand(PFI_CMD_FOGIV, args, 1, param, (pname == PF_FOG_COLOR ? 4 : 1)*sizeof(PFint));
+        return;
+    }
+
     switch (pname) {
         case PF_FOG_MODE:
             if (*param >= PF_LINEAR || *param <= PF_EXP2) {
@@ -2246,6 +2942,12 @@ void pfFogiv(PFfogparam pname, PFint* param)
 
 void pfFogfv(PFfogparam pname, PFfloat* param)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .i = pname } };
+        pfiPushCommand(PFI_CMD_FOGFV, args, 1, param, (pname == PF_FOG_COLOR ? 4 : 1)*sizeof(PFfloat));
+        return;
+    }
+
     switch (pname) {
         case PF_FOG_DENSITY:
             if (*param >= 0 || *param <= 1) {
@@ -2274,73 +2976,25 @@ void pfFogfv(PFfogparam pname, PFfloat* param)
 
 void pfFogProcess(void)
 {
-    struct PFItex* tex = G_currentCtx->currentFramebuffer->texture;
-
-    PFint width = tex->w;
-    PFint height = tex->h;
-
-    void *pixels = tex->pixels;
-    const PFfloat *zBuffer = G_currentCtx->currentFramebuffer->zbuffer;
-
-    PFIpixelgetter getter = tex->getter;
-    PFIpixelsetter setter = tex->setter;
-
-#ifdef _OPENMP
-#   define BEGIN_FOG_LOOP() \
-    _Pragma("omp parallel for collapse(2) firstprivate(fogColor)") \
-    for (PFint y = 0; y < height; y++) { \
-        for (PFint x = 0; x < width; x++) { \
-            PFsizei xyOffset = y*width + x;
-
-#define END_FOG_LOOP() \
-        } \
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_FOG_PROCESS, NULL, 0, NULL, 0);
+        return;
     }
-#else
-#   define BEGIN_FOG_LOOP() \
-    PFsizei yOffset = 0; \
-    for (PFint y = 0; y < height; y++, yOffset += width) { \
-        for (PFint x = 0; x < width; x++) { \
-            PFsizei xyOffset = yOffset + x;
 
-#define END_FOG_LOOP() \
-        } \
-    }
-#endif
+    pfiFlushBatch();
+    pfiSyncRaster();
 
-    PFfloat density = G_currentCtx->fog.density;
-    PFcolor fogColor = G_currentCtx->fog.color;
-    PFfogmode mode = G_currentCtx->fog.mode;
-    PFfloat start = G_currentCtx->fog.start;
-    PFfloat end = G_currentCtx->fog.end;
-    PFfloat invLen = 1/(end - start);
-    PFubyte alpha = fogColor.a;
+    PFIfogjob fog = {
+        .tex = G_currentCtx->currentFramebuffer->texture,
+        .zBuffer = G_currentCtx->currentFramebuffer->zbuffer,
+        .color = G_currentCtx->fog.color,
+        .mode = G_currentCtx->fog.mode,
+        .density = G_currentCtx->fog.density,
+        .start = G_currentCtx->fog.start,
+        .end = G_currentCtx->fog.end
+    };
 
-    BEGIN_FOG_LOOP()
-    {
-        PFfloat depth = zBuffer[xyOffset];
-        if (depth >= end) {
-            fogColor.a = alpha;
-            setter(pixels, xyOffset, alpha == 255 ? fogColor
-                : pfiBlendAlpha(fogColor, getter(pixels, xyOffset)));
-        } else if (depth > start) {
-            PFfloat t = 0;
-            switch (mode) {
-                case PF_LINEAR:
-                    t = (depth - start)*invLen;
-                    break;
-                case PF_EXP:
-                    t = 1.0f - expf(-density*(depth - start));
-                    break;
-                case PF_EXP2:
-                    t = 1.0f - exp2f(-density*(depth - start));
-                    break;
-            }
-            fogColor.a = (PFubyte)(t * alpha);
-            PFcolor color = getter(pixels, xyOffset);
-            setter(pixels, xyOffset, pfiBlendAlpha(fogColor, color));
-        }
-    }
-    END_FOG_LOOP()
+    pfiParallelFor(0, fog.tex->h, 0, pfiFogJob, &fog);
 }
 
 
@@ -2348,6 +3002,8 @@ void pfFogProcess(void)
 
 void pfReadPixels(PFint x, PFint y, PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type, void* pixels)
 {
+    pfFinish();
+
     if (!pfiIsPixelFormatValid(format, type)) {
         G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
@@ -2363,9 +3019,6 @@ void pfReadPixels(PFint x, PFint y, PFsizei width, PFsizei height, PFpixelformat
     /* Retrieve information about the source framebuffer */
 
     const struct PFItex *texSrc = G_currentCtx->currentFramebuffer->texture;
-    PFIpixelgetter srcPixelGetter = texSrc->getter;
-    const void *srcPixels = texSrc->pixels;
-    PFsizei srcWidth = texSrc->w;
 
     /* Calculate the minimum and maximum coordinates of the region to be read */
 
@@ -2376,66 +3029,34 @@ void pfReadPixels(PFint x, PFint y, PFsizei width, PFsizei height, PFpixelformat
 
     /* Reads pixels from the framebuffer and copies them to the destination */
 
-#ifdef _OPENMP
-#   pragma omp parallel for collapse(2)
-    for (PFsizei ySrc = yMin; ySrc < yMax; ySrc++) {
-        for (PFsizei xSrc = xMin; xSrc < xMax; xSrc++) {
-            PFcolor color = srcPixelGetter(srcPixels, ySrc * srcWidth + xSrc);
-            dstPixelSetter(pixels, (ySrc - yMin) * width + (xSrc - xMin), color);
-        }
-    }
-#else
-    for (PFsizei ySrc = yMin, yDst = 0; ySrc < yMax; ySrc++, yDst++) {
-        for (PFsizei xSrc = xMin, xDst = 0; xSrc < xMax; xSrc++, xDst++) {
-            PFcolor color = srcPixelGetter(srcPixels, ySrc * srcWidth + xSrc);
-            dstPixelSetter(pixels, yDst * width + xDst, color);
-        }
-    }
-#endif
+    PFIreadpixelsjob read = {
+        .texSrc = texSrc,
+        .dstPixelSetter = dstPixelSetter,
+        .pixels = pixels,
+        .width = width,
+        .xMin = xMin, .xMax = xMax,
+        .yMin = yMin
+    };
+
+    pfiParallelFor(yMin, yMax, 0, pfiReadPixelsJob, &read);
 }
 
 void pfPostProcess(PFpostprocessfunc postProcessFunction)
 {
-    struct PFItex* tex = G_currentCtx->currentFramebuffer->texture;
-
-    PFint width = tex->w;
-    PFint height = tex->h;
-
-    void *pixels = tex->pixels;
-    const PFfloat *zBuffer = G_currentCtx->currentFramebuffer->zbuffer;
-
-    PFIpixelgetter getter = tex->getter;
-    PFIpixelsetter setter = tex->setter;
-
-#ifdef _OPENMP
-#   define BEGIN_POSTPROCESS_LOOP() \
-    _Pragma("omp parallel for collapse(2)") \
-    for (PFint y = 0; y < height; y++) { \
-        for (PFint x = 0; x < width; x++) { \
-            PFsizei xyOffset = y*width + x;
-
-#define END_POSTPROCESS_LOOP() \
-        } \
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .fn = postProcessFunction } };
+        pfiPushCommand(PFI_CMD_POST_PROCESS, args, 1, NULL, 0);
+        return;
     }
-#else
-#   define BEGIN_POSTPROCESS_LOOP() \
-    PFsizei yOffset = 0; \
-    for (PFint y = 0; y < height; y++, yOffset += width) { \
-        for (PFint x = 0; x < width; x++) { \
-            PFsizei xyOffset = yOffset + x;
 
-#define END_POSTPROCESS_LOOP() \
-        } \
-    }
-#endif
+    pfiFlushBatch();
+    pfiSyncRaster();
 
-    BEGIN_POSTPROCESS_LOOP()
-    {
-        PFcolor color = getter(pixels, xyOffset);
-        PFfloat depth = zBuffer[xyOffset];
+    PFIpostprocessjob post = {
+        .tex = G_currentCtx->currentFramebuffer->texture,
+        .zBuffer = G_currentCtx->currentFramebuffer->zbuffer,
+        .postProcessFunction = postProcessFunction
+    };
 
-        color = postProcessFunction(x, y, depth, color);
-        setter(pixels, xyOffset, color);
-    }
-    END_POSTPROCESS_LOOP()
+    pfiParallelFor(0, post.tex->h, 0, pfiPostProcessJob, &post);
 }
@@ -0,0 +1,181 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "internal/context/context.h"
+#include "internal/threadpool.h"
+#include "internal/thread.h"
+#include "internal/config.h"
+#include "internal/pixel.h"
+#include "pixelforge.h"
+
+/* Internal structures */
+
+typedef struct {
+    PFcontext *contexts;
+    void **buffers;             ///< Color buffer of each context
+    PFsizei count;
+} PFIcontextpool;
+
+typedef struct {
+    const PFIcontextpool *pool;
+    PFrenderjobfunc func;
+    void *userData;
+    PFint jobCount;
+    volatile PFint nextJob;     ///< Index of the next job to claim
+} PFIrenderjobs;
+
+/* Internal helper functions */
+
+// NOTE: The range is a range of contexts, each context
+//       claims jobs until all of them have been claimed
+static void
+pfiRenderJob(void* job, PFint begin, PFint end)
+{
+    PFIrenderjobs *jobs = job;
+    PFIctx *previousCtx = G_currentCtx;
+
+    for (PFint i = begin; i < end; i++) {
+        G_currentCtx = jobs->pool->contexts[i];
+
+        for (;;) {
+            PFint jobIndex = pfiAtomicFetchAdd(&jobs->nextJob, 1);
+            if (jobIndex >= jobs->jobCount) break;
+
+            jobs->func((PFsizei)jobIndex, jobs->pool->buffers[i], jobs->userData);
+
+            // NOTE: Leaves the context idle for the next job, which can run on another thread
+            pfFinish();
+        }
+    }
+
+    G_currentCtx = previousCtx;
+}
+
+/* Context pool functions */
+
+PFcontextpool pfCreateContextPool(PFsizei contextCount, PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type)
+{
+    if (!pfiIsPixelFormatValid(format, type)) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+        }
+        return NULL;
+    }
+
+    if (contextCount == 0) {
+        contextCount = pfGetThreadCount();
+    }
+
+    PFIcontextpool *pool = PF_CALLOC(1, sizeof(PFIcontextpool));
+    if (pool == NULL) goto error;
+
+    pool->contexts = PF_CALLOC(contextCount, sizeof(PFcontext));
+    pool->buffers = PF_CALLOC(contextCount, sizeof(void*));
+    pool->count = contextCount;
+
+    if (pool->contexts == NULL || pool->buffers == NULL) goto error;
+
+    const PFsizei bufferSize = width*height*pfiGetPixelBytes(format, type);
+
+    for (PFsizei i = 0; i < contextCount; i++) {
+        pool->buffers[i] = PF_CALLOC(1, bufferSize);
+        if (pool->buffers[i] == NULL) goto error;
+
+        pool->contexts[i] = pfCreateContext(pool->buffers[i], width, height, format, type);
+        if (pool->contexts[i] == NULL) goto error;
+    }
+
+    return pool;
+
+error:
+    pfDeleteContextPool((PFcontextpool*)&pool);
+
+    if (G_currentCtx) {
+        G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+    }
+
+    return NULL;
+}
+
+void pfDeleteContextPool(PFcontextpool* pool)
+{
+    if (pool == NULL || *pool == NULL) return;
+
+    PFIcontextpool *p = *pool;
+
+    for (PFsizei i = 0; i < p->count; i++) {
+        if (p->contexts && p->contexts[i]) {
+            pfDeleteContext(p->contexts[i]);
+        }
+        if (p->buffers && p->buffers[i]) {
+            PF_FREE(p->buffers[i]);
+        }
+    }
+
+    PF_FREE(p->contexts);
+    PF_FREE(p->buffers);
+    PF_FREE(p);
+
+    *pool = NULL;
+}
+
+PFsizei pfGetContextPoolSize(PFcontextpool pool)
+{
+    return pool ? ((PFIcontextpool*)pool)->count : 0;
+}
+
+PFcontext pfGetPoolContext(PFcontextpool pool, PFsizei index)
+{
+    if (pool == NULL || index >= ((PFIcontextpool*)pool)->count) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_VALUE;
+        }
+        return NULL;
+    }
+
+    return ((PFIcontextpool*)pool)->contexts[index];
+}
+
+void pfRenderJobs(PFcontextpool pool, PFsizei jobCount, PFrenderjobfunc func, void* userData)
+{
+    if (pool == NULL || func == NULL) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_VALUE;
+        }
+        return;
+    }
+
+    // NOTE: The context of the caller must not be rendering while
+    //       the threads of the library are used by the pool
+    if (G_currentCtx) {
+        pfFinish();
+    }
+
+    PFIrenderjobs jobs = {
+        .pool = pool,
+        .func = func,
+        .userData = userData,
+        .jobCount = (PFint)jobCount,
+        .nextJob = 0
+    };
+
+    PFint contextCount = (PFint)PF_MIN((PFsizei)((PFIcontextpool*)pool)->count, jobCount);
+
+    pfiParallelFor(0, contextCount, 1, pfiRenderJob, &jobs);
+}
@@ -18,12 +18,35 @@
  */
 
 #include "internal/context/context.h"
+#include "internal/context/raster.h"
+#include "internal/threadpool.h"
+#include "internal/config.h"
 #include "internal/pixel.h"
 #include "internal/depth.h"
 #include "pixelforge.h"
 #include <stdlib.h>
 #include <float.h>
 
+/* Internal framebuffer functions */
+
+typedef struct {
+    PFframebuffer *framebuffer;
+    PFcolor color;
+    PFfloat depth;
+} PFIclearframebufferjob;
+
+static void pfiClearFramebufferJob(void* job, PFint begin, PFint end)
+{
+    const PFIclearframebufferjob *clear = job;
+    struct PFItex* tex = clear->framebuffer->texture;
+    PFfloat *zbuffer = clear->framebuffer->zbuffer;
+
+    for (PFsizei i = begin; i < (PFsizei)end; i++) {
+        tex->setter(tex->pixels, i, clear->color);
+        zbuffer[i] = clear->depth;
+    }
+}
+
 /* Framebuffer functions */
 
 PFframebuffer pfGenFramebuffer(PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type)
@@ -31,6 +54,14 @@ PFframebuffer pfGenFramebuffer(PFsizei width, PFsizei height, PFpixelformat form
     PFframebuffer framebuffer = (PFframebuffer) { 0 };
     PFsizei size = width*height;
 
+    // NOTE: The compressed formats are valid for textures, but cannot be rendered to
+    if (!pfiIsPixelFormatValid(format, type)) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+        }
+        return framebuffer;
+    }
+
     void* pixels = PF_CALLOC(size, pfiGetPixelBytes(format, type));
     if (!pixels) return framebuffer;
 
@@ -91,14 +122,13 @@ void pfClearFramebuffer(PFframebuffer* framebuffer, PFcolor color, PFfloat depth
     struct PFItex* tex = framebuffer->texture;
     PFsizei size = tex->w*tex->h;
 
-#   ifdef _OPENMP
-#       pragma omp parallel for \
-            if(size >= PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD)
-#   endif
-    for (PFsizei i = 0; i < size; i++) {
-        tex->setter(tex->pixels, i, color);
-        framebuffer->zbuffer[i] = depth;
-    }
+    PFIclearframebufferjob clear = { framebuffer, color, depth };
+
+    // NOTE: The framebuffer can be in use by the raster thread of the current context
+    if (G_currentCtx) pfiSyncRaster();
+
+    pfiParallelForIf(size >= PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD,
+                     0, size, 0, pfiClearFramebufferJob, &clear);
 }
 
 PFcolor pfGetFramebufferPixel(const PFframebuffer* framebuffer, PFsizei x, PFsizei y)
@@ -18,17 +18,21 @@
  */
 
 #include "internal/context/context.h"
+#include "internal/context/command.h"
 #include <stdint.h>
 #include <string.h>
 
 void pfGetBooleanv(PFenum pname, PFboolean* params)
 {
+    pfiSyncCommands();
+
     switch (pname)
     {
         /* State context */
 
         case PF_TEXTURE_2D:
-            *params = G_currentCtx->state & PF_TEXTURE_2D;
+            *params = ((G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->texture1State : G_currentCtx->state) & PF_TEXTURE_2D;
             break;
 
         case PF_FRAMEBUFFER:
@@ -72,7 +76,8 @@ void pfGetBooleanv(PFenum pname, PFboolean* params)
             break;
 
         case PF_TEXTURE_COORD_ARRAY:
-            *params = G_currentCtx->state & PF_TEXTURE_COORD_ARRAY;
+            *params = ((G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->texture1State : G_currentCtx->state) & PF_TEXTURE_COORD_ARRAY;
             break;
 
         /* Other values */
@@ -114,6 +119,8 @@ void pfGetBooleanv(PFenum pname, PFboolean* params)
 
 void pfGetIntegerv(PFenum pname, PFint* params)
 {
+    pfiSyncCommands();
+
     switch (pname)
     {
         case PF_VIEWPORT:
@@ -215,11 +222,15 @@ void pfGetIntegerv(PFenum pname, PFint* params)
         //    break;
 
         case PF_TEXTURE_COORD_ARRAY_STRIDE:
-            *params = G_currentCtx->vertexAttribs.texcoords.stride;
+            *params = (G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->vertexAttribs.texcoords1.stride
+                : G_currentCtx->vertexAttribs.texcoords.stride;
             break;
 
         case PF_TEXTURE_COORD_ARRAY_TYPE:
-            *params = G_currentCtx->vertexAttribs.texcoords.type;
+            *params = (G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->vertexAttribs.texcoords1.type
+                : G_currentCtx->vertexAttribs.texcoords.type;
             break;
 
         case PF_COLOR_ARRAY_SIZE:
@@ -234,6 +245,18 @@ void pfGetIntegerv(PFenum pname, PFint* params)
             *params = G_currentCtx->vertexAttribs.colors.type;
             break;
 
+        case PF_MAX_BONES:
+            *params = PF_MAX_BONE_MATRICES;
+            break;
+
+        case PF_ACTIVE_TEXTURE:
+            *params = G_currentCtx->activeTexture;
+            break;
+
+        case PF_TEXTURE_COMBINE:
+            *params = G_currentCtx->textureCombine[G_currentCtx->activeTexture];
+            break;
+
         default:
             G_currentCtx->errCode = PF_INVALID_ENUM;
             break;
@@ -242,6 +265,8 @@ void pfGetIntegerv(PFenum pname, PFint* params)
 
 void pfGetFloatv(PFenum pname, PFfloat* params)
 {
+    pfiSyncCommands();
+
     switch (pname)
     {
         case PF_COLOR_CLEAR_VALUE:
@@ -268,10 +293,13 @@ void pfGetFloatv(PFenum pname, PFfloat* params)
             params[2] = G_currentCtx->currentNormal[2];
             break;
 
-        case PF_CURRENT_TEXTURE_COORDS:
-            params[0] = G_currentCtx->currentTexcoord[0];
-            params[1] = G_currentCtx->currentTexcoord[1];
-            break;
+        case PF_CURRENT_TEXTURE_COORDS: {
+            const PFfloat *texcoord = (G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->currentTexcoord1 : G_currentCtx->currentTexcoord;
+            params[0] = texcoord[0];
+            params[1] = texcoord[1];
+        }
+        break;
 
         //case PF_CURRENT_RASTER_COLOR:
         //  break;
@@ -360,6 +388,8 @@ void pfGetFloatv(PFenum pname, PFfloat* params)
 
 void pfGetDoublev(PFenum pname, PFdouble* params)
 {
+    pfiSyncCommands();
+
     switch (pname)
     {
         case PF_COLOR_CLEAR_VALUE:
@@ -386,10 +416,13 @@ void pfGetDoublev(PFenum pname, PFdouble* params)
             params[2] = G_currentCtx->currentNormal[2];
             break;
 
-        case PF_CURRENT_TEXTURE_COORDS:
-            params[0] = G_currentCtx->currentTexcoord[0];
-            params[1] = G_currentCtx->currentTexcoord[1];
-            break;
+        case PF_CURRENT_TEXTURE_COORDS: {
+            const PFfloat *texcoord = (G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->currentTexcoord1 : G_currentCtx->currentTexcoord;
+            params[0] = texcoord[0];
+            params[1] = texcoord[1];
+        }
+        break;
 
         //case PF_CURRENT_RASTER_COLOR:
         //  break;
@@ -492,10 +525,13 @@ void pfGetDoublev(PFenum pname, PFdouble* params)
 
 void pfGetPointerv(PFenum pname, const void** params)
 {
+    pfiSyncCommands();
+
     switch (pname)
     {
         case PF_TEXTURE_2D:
-            *params = G_currentCtx->currentTexture;
+            *params = (G_currentCtx->activeTexture == PF_TEXTURE1)
+                ? G_currentCtx->currentTexture1 : G_currentCtx->currentTexture;
             break;
 
         case PF_FRAMEBUFFER:
@@ -0,0 +1,191 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_ATTRIBUTE_H
+#define PF_INTERNAL_ATTRIBUTE_H
+
+#include "./context/context.h"
+#include "../pixelforge.h"
+#include "./simd.h"
+
+#include <string.h>
+
+/* Helper functions */
+
+static inline PFsizei
+pfiGetDataTypeSize(PFdatatype type)
+{
+    switch (type) {
+        case PF_UNSIGNED_BYTE:          return sizeof(PFubyte);
+        case PF_UNSIGNED_SHORT_5_6_5:
+        case PF_UNSIGNED_SHORT_5_5_5_1:
+        case PF_UNSIGNED_SHORT_4_4_4_4:
+        case PF_UNSIGNED_SHORT:         return sizeof(PFushort);
+        case PF_UNSIGNED_INT:           return sizeof(PFuint);
+        case PF_BYTE:                   return sizeof(PFbyte);
+        case PF_HALF_FLOAT:
+        case PF_SHORT:                  return sizeof(PFshort);
+        case PF_INT:                    return sizeof(PFint);
+        case PF_FLOAT:                  return sizeof(PFfloat);
+        case PF_DOUBLE:                 return sizeof(PFdouble);
+    }
+    return 0;
+}
+
+static inline const void*
+pfiGetAttribElement(const PFIvertexattribbuffer* attrib, PFsizei index)
+{
+    PFsizei stride = attrib->stride ? attrib->stride
+        : attrib->size*pfiGetDataTypeSize(attrib->type);
+
+    return (const PFubyte*)attrib->buffer + index*stride;
+}
+
+/* Vertex attribute fetch functions */
+
+// NOTE: Integer components are converted to float and then mapped with 'attrib->scale'
+//       and 'attrib->offset', which is how normalized and quantized attributes are decoded.
+//       Only the first 'attrib->size' components of 'dst' are written.
+static inline void
+pfiFetchAttrib(PFfloat* PF_RESTRICT dst, const PFIvertexattribbuffer* attrib, PFsizei index)
+{
+    const void *src = pfiGetAttribElement(attrib, index);
+    const PFint size = attrib->size;
+
+    switch (attrib->type) {
+        case PF_FLOAT:
+            memcpy(dst, src, size*sizeof(PFfloat));
+            return;
+        case PF_DOUBLE:
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = (PFfloat)((const PFdouble*)src)[i];
+            }
+            return;
+        case PF_HALF_FLOAT: {
+#       if defined(__F16C__)
+            // NOTE: An element has at most four components and the vertices are fetched one by one,
+            //       so the four lanes of '_mm_cvtph_ps' decode a whole element, the eight lanes of
+            //       '_mm256_cvtph_ps' would only convert four more zeros
+            PFushort raw[4] = { 0 };
+            memcpy(raw, src, size*sizeof(PFushort));
+            PFfloat decoded[4];
+            _mm_storeu_ps(decoded, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)raw)));
+            memcpy(dst, decoded, size*sizeof(PFfloat));
+#       else
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = pfmHalfToFloat(((const PFushort*)src)[i]);
+            }
+#       endif //__F16C__
+        }
+        return;
+        default:
+            break;
+    }
+
+#if defined(__SSE4_1__)
+
+    // Copy the element in a zeroed register-sized
+    // buffer to never read past the end of the array
+    PFubyte raw[16] = { 0 };
+    memcpy(raw, src, size*pfiGetDataTypeSize(attrib->type));
+
+    __m128i v = _mm_loadu_si128((const __m128i*)raw);
+
+    switch (attrib->type) {
+        case PF_UNSIGNED_BYTE:  v = _mm_cvtepu8_epi32(v);   break;
+        case PF_BYTE:           v = _mm_cvtepi8_epi32(v);   break;
+        case PF_UNSIGNED_SHORT: v = _mm_cvtepu16_epi32(v);  break;
+        case PF_SHORT:          v = _mm_cvtepi16_epi32(v);  break;
+        case PF_INT:                                        break;
+        default: return;
+    }
+
+    __m128 f = _mm_cvtepi32_ps(v);
+    f = _mm_add_ps(_mm_mul_ps(f, _mm_loadu_ps(attrib->scale)), _mm_loadu_ps(attrib->offset));
+
+    PFfloat decoded[4];
+    _mm_storeu_ps(decoded, f);
+    memcpy(dst, decoded, size*sizeof(PFfloat));
+
+#else
+
+    for (int_fast8_t i = 0; i < size; i++) {
+        PFfloat value = 0.0f;
+        switch (attrib->type) {
+            case PF_UNSIGNED_BYTE:  value = ((const PFubyte*)src)[i];   break;
+            case PF_BYTE:           value = ((const PFbyte*)src)[i];    break;
+            case PF_UNSIGNED_SHORT: value = ((const PFushort*)src)[i];  break;
+            case PF_SHORT:          value = ((const PFshort*)src)[i];   break;
+            case PF_INT:            value = ((const PFint*)src)[i];     break;
+            default: return;
+        }
+        dst[i] = value*attrib->scale[i] + attrib->offset[i];
+    }
+
+#endif //__SSE4_1__
+}
+
+static inline PFcolor
+pfiFetchColor(const PFIvertexattribbuffer* attrib, PFsizei index)
+{
+    const void *src = pfiGetAttribElement(attrib, index);
+    const PFint size = PF_MIN(attrib->size, 4);
+    PFcolor color = { 255, 255, 255, 255 };
+    PFubyte *dst = (PFubyte*)&color;
+
+    switch (attrib->type) {
+        case PF_UNSIGNED_BYTE:
+            memcpy(dst, src, size);
+            break;
+        case PF_UNSIGNED_SHORT:
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = ((const PFushort*)src)[i] >> 8;
+            }
+            break;
+        case PF_UNSIGNED_INT:
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = ((const PFuint*)src)[i] >> 24;
+            }
+            break;
+        case PF_FLOAT:
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = ((const PFfloat*)src)[i] * 255;
+            }
+            break;
+        case PF_DOUBLE:
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = ((const PFdouble*)src)[i] * 255;
+            }
+            break;
+        case PF_HALF_FLOAT: {
+            PFMvec4 decoded;
+            pfiFetchAttrib(decoded, attrib, index);
+            for (int_fast8_t i = 0; i < size; i++) {
+                dst[i] = decoded[i] * 255;
+            }
+        }
+        break;
+        default:
+            break;
+    }
+
+    return color;
+}
+
+#endif //PF_INTERNAL_ATTRIBUTE_H
@@ -130,6 +130,44 @@ static const PFIblendfunc GC_blendFuncs[8] = {
 };
 #undef ENTRY
 
+/* SISD Texture combine functions (see 'pfTexCombine') */
+
+// NOTE: The combine functions take the texel of a texture unit as 'src', and the color
+//       produced by the previous unit (or the interpolated vertex color) as 'dst'
+
+static inline PFcolor
+pfiCombineAdd(PFcolor src, PFcolor dst)
+{
+    PFcolor result;
+    result.r = (PFubyte)PF_MIN_255((PFint)(dst.r + src.r));
+    result.g = (PFubyte)PF_MIN_255((PFint)(dst.g + src.g));
+    result.b = (PFubyte)PF_MIN_255((PFint)(dst.b + src.b));
+    result.a = (PFubyte)((src.a*dst.a)/255);
+    return result;
+}
+
+static inline PFcolor
+pfiCombineInterpolate(PFcolor src, PFcolor dst)
+{
+    PFuint alpha = src.a + (src.a >> 7);
+    PFuint invAlpha = 256 - alpha;
+
+    PFcolor result;
+    result.r = (PFubyte)((alpha*src.r + invAlpha*dst.r) >> 8);
+    result.g = (PFubyte)((alpha*src.g + invAlpha*dst.g) >> 8);
+    result.b = (PFubyte)((alpha*src.b + invAlpha*dst.b) >> 8);
+    result.a = dst.a;
+    return result;
+}
+
+#define ENTRY(MODE, FUNC) [MODE] = FUNC
+static const PFIblendfunc GC_textureCombineFuncs[3] = {
+    ENTRY(PF_COMBINE_MODULATE, pfiBlendMultiplicative),
+    ENTRY(PF_COMBINE_ADD, pfiCombineAdd),
+    ENTRY(PF_COMBINE_INTERPOLATE, pfiCombineInterpolate)
+};
+#undef ENTRY
+
 /* SIMD Blending functions */
 
 #if PF_SIMD_SUPPORT
@@ -274,6 +312,53 @@ static const PFIblendfunc_simd GC_blendFuncs_simd[8] = {
 };
 #undef ENTRY
 
+/* SIMD Texture combine functions (see 'pfTexCombine') */
+
+static inline PFIsimdvi
+pfiCombineAdd_simd(const PFIsimdvi src, const PFIsimdvi dst)
+{
+    PFIsimdvi srcV[4], dstV[4], outV[4];
+    pfiColorSIMDToVecI_simd(srcV, src, 4);
+    pfiColorSIMDToVecI_simd(dstV, dst, 4);
+
+    outV[0] = pfiSimdMin_I32(pfiSimdAdd_I32(srcV[0], dstV[0]), *(PFIsimdvi*)GC_simd_i32_255);
+    outV[1] = pfiSimdMin_I32(pfiSimdAdd_I32(srcV[1], dstV[1]), *(PFIsimdvi*)GC_simd_i32_255);
+    outV[2] = pfiSimdMin_I32(pfiSimdAdd_I32(srcV[2], dstV[2]), *(PFIsimdvi*)GC_simd_i32_255);
+
+    // NOTE: The alpha is divided by 255 as in 'pfiCombineAdd', '(x + 1 + (x >> 8)) >> 8'
+    //       gives the same result as 'x/255' for every product of two 8-bit values
+    PFIsimdvi alpha = pfiSimdMullo_I32(srcV[3], dstV[3]);
+    alpha = pfiSimdAdd_I32(alpha, pfiSimdAdd_I32(pfiSimdShr_I32(alpha, 8), pfiSimdSet1_I32(1)));
+    outV[3] = pfiSimdShr_I32(alpha, 8);
+
+    return pfiColorSIMDFromVecI_simd(outV, 4);
+}
+
+static inline PFIsimdvi
+pfiCombineInterpolate_simd(const PFIsimdvi src, const PFIsimdvi dst)
+{
+    PFIsimdvi srcV[4], dstV[4], outV[4];
+    pfiColorSIMDToVecI_simd(srcV, src, 4);
+    pfiColorSIMDToVecI_simd(dstV, dst, 4);
+
+    PFIsimdvi alpha = pfiSimdAdd_I32(srcV[3], pfiSimdShr_I32(srcV[3], 7));
+    PFIsimdvi invAlpha = pfiSimdSub_I32(*(PFIsimdvi*)GC_simd_i32_256, alpha);
+    outV[0] = pfiSimdShr_I32(pfiSimdAdd_I32(pfiSimdMullo_I32(srcV[0], alpha), pfiSimdMullo_I32(dstV[0], invAlpha)), 8);
+    outV[1] = pfiSimdShr_I32(pfiSimdAdd_I32(pfiSimdMullo_I32(srcV[1], alpha), pfiSimdMullo_I32(dstV[1], invAlpha)), 8);
+    outV[2] = pfiSimdShr_I32(pfiSimdAdd_I32(pfiSimdMullo_I32(srcV[2], alpha), pfiSimdMullo_I32(dstV[2], invAlpha)), 8);
+    outV[3] = dstV[3];
+
+    return pfiColorSIMDFromVecI_simd(outV, 4);
+}
+
+#define ENTRY(MODE, FUNC) [MODE] = FUNC
+static const PFIblendfunc_simd GC_textureCombineFuncs_simd[3] = {
+    ENTRY(PF_COMBINE_MODULATE, pfiBlendMultiplicative_simd),
+    ENTRY(PF_COMBINE_ADD, pfiCombineAdd_simd),
+    ENTRY(PF_COMBINE_INTERPOLATE, pfiCombineInterpolate_simd)
+};
+#undef ENTRY
+
 #endif //PF_SIMD_SUPPORT
 
 
@@ -285,5 +370,11 @@ pfiIsBlendModeValid(PFblendmode mode)
     return (mode >= PF_BLEND_AVERAGE && mode <= PF_BLEND_DARKEN);
 }
 
+static inline PFboolean
+pfiIsCombineModeValid(PFcombinemode mode)
+{
+    return (mode >= PF_COMBINE_MODULATE && mode <= PF_COMBINE_INTERPOLATE);
+}
+
 
 #endif //PF_INTERNAL_BLEND_H
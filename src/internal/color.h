@@ -42,6 +42,22 @@ pfiColorLerpFlat(PFcolor v1, PFcolor v2, PFfloat t)
     return (t < 0.5f) ? v1 : v2;
 }
 
+// NOTE: Returns the bilinear interpolation of four colors, 'wx' and 'wy' are the weights over 256
+//       of the right colors (c10, c11) and of the bottom colors (c01, c11)
+static inline PFcolor
+pfiColorBilinear(PFcolor c00, PFcolor c10, PFcolor c01, PFcolor c11, PFuint wx, PFuint wy)
+{
+    PFcolor result;
+
+    for (int_fast8_t i = 0; i < 4; i++) {
+        PFuint top = (((PFubyte*)&c00)[i]*(256 - wx) + ((PFubyte*)&c10)[i]*wx + 128) >> 8;
+        PFuint bottom = (((PFubyte*)&c01)[i]*(256 - wx) + ((PFubyte*)&c11)[i]*wx + 128) >> 8;
+        ((PFubyte*)&result)[i] = (PFubyte)((top*(256 - wy) + bottom*wy + 128) >> 8);
+    }
+
+    return result;
+}
+
 static inline PFcolor
 pfiColorBarySmooth(PFcolor v1, PFcolor v2, PFcolor v3, PFfloat w1, PFfloat w2, PFfloat w3)
 {
@@ -138,7 +154,7 @@ static inline PFIsimdvi
 pfiColorLerpSmooth_simd(const PFIsimdvi a, const PFIsimdvi b, PFIsimdvf t)
 {
     PFIsimdv4f aV4; pfiColorSIMDToVecF_simd(aV4, a, 4);
-    PFIsimdv4f bV4; pfiColorSIMDToVecF_simd(aV4, b, 4);
+    PFIsimdv4f bV4; pfiColorSIMDToVecF_simd(bV4, b, 4);
     PFIsimdv4f rV4; pfiVec4LerpR_simd(rV4, aV4, bV4, t);
     return pfiColorSIMDFromVecF_simd(rV4, 4);
 }
@@ -150,6 +166,46 @@ pfiColorLerpFlat_simd(const PFIsimdvi a, const PFIsimdvi b, PFIsimdvf t)
     return pfiSimdBlendV_I8(b, a, mask);
 }
 
+// NOTE: Interpolates the 16-bit components 'a' and 'b' with the weights over 256 'wa' and 'wb',
+//       whose sum is 256, the products and their sum (at most 255*256) fit in 16 bits
+static inline PFIsimdvi
+pfiColorLerpU16_simd(PFIsimdvi a, PFIsimdvi b, PFIsimdvi wa, PFIsimdvi wb)
+{
+    PFIsimdvi sum = pfiSimdAdd_I16(pfiSimdMullo_I16(a, wa), pfiSimdMullo_I16(b, wb));
+    return pfiSimdShr_I16(pfiSimdAdd_I16(sum, pfiSimdSet1_I32(0x00800080)), 8);
+}
+
+// NOTE: Same as 'pfiColorBilinear' for packed colors, 'wx' and 'wy' are one weight per color.
+//       The colors are blended in two halves whose components are extended to 16 bits.
+static inline PFIsimdvi
+pfiColorBilinear_simd(PFIsimdvi c00, PFIsimdvi c10, PFIsimdvi c01, PFIsimdvi c11, PFIsimdvi wx, PFIsimdvi wy)
+{
+    const PFIsimdvi zero = pfiSimdSetZero_I32();
+    const PFIsimdvi one = pfiSimdSet1_I32(256);
+
+    // Repeat the weight of each color for its four components, in the same order as the unpacked colors
+    PFIsimdvi wxOne = pfiSimdOr_I32(wx, pfiSimdShl_I32(wx, 16));
+    PFIsimdvi wyOne = pfiSimdOr_I32(wy, pfiSimdShl_I32(wy, 16));
+    PFIsimdvi ixOne = pfiSimdOr_I32(pfiSimdSub_I32(one, wx), pfiSimdShl_I32(pfiSimdSub_I32(one, wx), 16));
+    PFIsimdvi iyOne = pfiSimdOr_I32(pfiSimdSub_I32(one, wy), pfiSimdShl_I32(pfiSimdSub_I32(one, wy), 16));
+
+    PFIsimdvi wxLo = pfiSimdUnpackLo_I32(wxOne, wxOne), wxHi = pfiSimdUnpackHi_I32(wxOne, wxOne);
+    PFIsimdvi ixLo = pfiSimdUnpackLo_I32(ixOne, ixOne), ixHi = pfiSimdUnpackHi_I32(ixOne, ixOne);
+    PFIsimdvi wyLo = pfiSimdUnpackLo_I32(wyOne, wyOne), wyHi = pfiSimdUnpackHi_I32(wyOne, wyOne);
+    PFIsimdvi iyLo = pfiSimdUnpackLo_I32(iyOne, iyOne), iyHi = pfiSimdUnpackHi_I32(iyOne, iyOne);
+
+    // Interpolate colors horizontally
+    PFIsimdvi topLo = pfiColorLerpU16_simd(pfiSimdUnpackLo_I8(c00, zero), pfiSimdUnpackLo_I8(c10, zero), ixLo, wxLo);
+    PFIsimdvi topHi = pfiColorLerpU16_simd(pfiSimdUnpackHi_I8(c00, zero), pfiSimdUnpackHi_I8(c10, zero), ixHi, wxHi);
+    PFIsimdvi bottomLo = pfiColorLerpU16_simd(pfiSimdUnpackLo_I8(c01, zero), pfiSimdUnpackLo_I8(c11, zero), ixLo, wxLo);
+    PFIsimdvi bottomHi = pfiColorLerpU16_simd(pfiSimdUnpackHi_I8(c01, zero), pfiSimdUnpackHi_I8(c11, zero), ixHi, wxHi);
+
+    // Interpolate colors vertically
+    return pfiSimdPackU_I16_I8(
+        pfiColorLerpU16_simd(topLo, bottomLo, iyLo, wyLo),
+        pfiColorLerpU16_simd(topHi, bottomHi, iyHi, wyHi));
+}
+
 static inline PFIsimdvi
 pfiColorBarySmooth_simd(PFIsimdvi c1, PFIsimdvi c2, PFIsimdvi c3,
                         PFIsimdvf w1, PFIsimdvf w2, PFIsimdvf w3)
@@ -38,6 +38,10 @@
 #   define PF_MAX_LIGHT_STACK 8
 #endif //PF_MAX_LIGHT_STACK
 
+#ifndef PF_MAX_BONE_MATRICES
+#   define PF_MAX_BONE_MATRICES 128
+#endif //PF_MAX_BONE_MATRICES
+
 #ifndef PF_MAX_CLIPPED_POLYGON_VERTICES
 #   define PF_MAX_CLIPPED_POLYGON_VERTICES 12
 #endif //PF_MAX_CLIPPED_POLYGON_VERTICES
@@ -50,28 +54,117 @@
 #   define PF_CLIP_EPSILON 1e-5f
 #endif //PF_CLIP_EPSILON
 
-#ifdef _OPENMP
+//  Number of vertices submitted with 'pfVertex' that can be accumulated
+//  before the batch is flushed through the geometry and raster stages
+//  NOTE: The batch is also flushed by 'pfEnd' and by any state change
+#ifndef PF_MAX_BATCH_VERTICES
+#   define PF_MAX_BATCH_VERTICES 3072
+#endif //PF_MAX_BATCH_VERTICES
+
+//  Size of the FIFO vertex cache simulated by the mesh optimization functions
+#ifndef PF_VERTEX_CACHE_SIZE
+#   define PF_VERTEX_CACHE_SIZE 16
+#endif //PF_VERTEX_CACHE_SIZE
+
+//  Number of bytes of commands recorded by a deferred context
+//  before they are automatically submitted to its render thread
+//  NOTE: Commands are also submitted by 'pfFlush', 'pfFinish' and 'pfSwapBuffers'
+#ifndef PF_COMMAND_BUFFER_SIZE
+#   define PF_COMMAND_BUFFER_SIZE (256*1024)
+#endif //PF_COMMAND_BUFFER_SIZE
+
+//  Initial number of bytes allocated for each frame bin of a context with
+//  PF_FRAME_PIPELINING enabled, the bins grow when a frame needs more
+#ifndef PF_RASTER_BIN_SIZE
+#   define PF_RASTER_BIN_SIZE (1024*1024)
+#endif //PF_RASTER_BIN_SIZE
+
+//  Alignment in bytes of the vertex streams compiled from
+//  render lists, must be a power of two (see 'pfEndList')
+#ifndef PF_LIST_STREAM_ALIGNMENT
+#   define PF_LIST_STREAM_ALIGNMENT 32
+#endif //PF_LIST_STREAM_ALIGNMENT
+
+//  Alignment in bytes of the rows of texels converted by 'pfTextureStorage',
+//  must be a power of two and a multiple of the size of a texel
+#ifndef PF_TEXTURE_STORAGE_ALIGNMENT
+#   define PF_TEXTURE_STORAGE_ALIGNMENT 64
+#endif //PF_TEXTURE_STORAGE_ALIGNMENT
+
+//  Number of decoded blocks of compressed textures kept by each thread,
+//  must be a power of two (see 'PF_COMPRESSED_BC1')
+#ifndef PF_TEXTURE_BLOCK_CACHE_SIZE
+#   define PF_TEXTURE_BLOCK_CACHE_SIZE 16
+#endif //PF_TEXTURE_BLOCK_CACHE_SIZE
+
+//  Number of bytes allocated for the arena of a render list when the first
+//  vertex is recorded, the arena then doubles its size each time it is full
+//  NOTE: The arena is shrunk to fit the compiled vertices by 'pfEndList'
+#ifndef PF_LIST_ARENA_MIN_SIZE
+#   define PF_LIST_ARENA_MIN_SIZE (4*1024)
+#endif //PF_LIST_ARENA_MIN_SIZE
+
+//  Number of bytes initially allocated for the state changes and
+//  render calls encoded in a render list, which grows when needed
+#ifndef PF_LIST_COMMANDS_MIN_SIZE
+#   define PF_LIST_COMMANDS_MIN_SIZE 256
+#endif //PF_LIST_COMMANDS_MIN_SIZE
+
+//  Maximum number of threads that can run the parallel loops,
+//  the thread calling the API function included
+//  NOTE: The default thread count is the number of logical processors
+#ifndef PF_MAX_THREADS
+#   define PF_MAX_THREADS 64
+#endif //PF_MAX_THREADS
+
+//  NOTE: The names of the parallel loop settings from when the loops were run by OpenMP
+//        are still accepted, the 'PF_PARALLEL_*' names take precedence if both are defined
+#if defined(PF_OPENMP_RASTER_THRESHOLD_AREA) && !defined(PF_PARALLEL_RASTER_THRESHOLD_AREA)
+#   define PF_PARALLEL_RASTER_THRESHOLD_AREA PF_OPENMP_RASTER_THRESHOLD_AREA
+#endif //PF_OPENMP_RASTER_THRESHOLD_AREA
+
+#if defined(PF_OPENMP_TRIANGLE_ROW_PER_THREAD) && !defined(PF_PARALLEL_TRIANGLE_ROWS_PER_JOB)
+#   define PF_PARALLEL_TRIANGLE_ROWS_PER_JOB PF_OPENMP_TRIANGLE_ROW_PER_THREAD
+#endif //PF_OPENMP_TRIANGLE_ROW_PER_THREAD
+
+#if defined(PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD) && !defined(PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD)
+#   define PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD
+#endif //PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD
 
 //  Pixel threshold for parallelizing the rasterization loop
 //  NOTE: In barycentric rendering method, this corresponds
 //        to the area of the triangle's bounding box,
 //        whereas in scanline rendering method, it
 //        corresponds to the area of the triangle.
-#   ifndef PF_OPENMP_RASTER_THRESHOLD_AREA
-#       define PF_OPENMP_RASTER_THRESHOLD_AREA 32*32
-#   endif //PF_OPENMP_RASTER_THRESHOLD_AREA
-
-// Number of lines processed per thread during the 
-// traversal of the triangle's bounding box.
-#   ifndef PF_OPENMP_TRIANGLE_ROW_PER_THREAD
-#       define PF_OPENMP_TRIANGLE_ROW_PER_THREAD 4
-#   endif //PF_OPENMP_TRIANGLE_ROW_PER_THREAD
-
-//  Buffer size threshold for parallelizing `pfClear` loops
-#   ifndef PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD
-#       define PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD 640*480
-#   endif //PF_OPENMP_CLEAR_BUFFER_SIZE_THRESHOLD
-
-#endif //_OPENMP
+#ifndef PF_PARALLEL_RASTER_THRESHOLD_AREA
+#   define PF_PARALLEL_RASTER_THRESHOLD_AREA 32*32
+#endif //PF_PARALLEL_RASTER_THRESHOLD_AREA
+
+//  Number of rows of a triangle claimed at once by a thread
+#ifndef PF_PARALLEL_TRIANGLE_ROWS_PER_JOB
+#   define PF_PARALLEL_TRIANGLE_ROWS_PER_JOB 4
+#endif //PF_PARALLEL_TRIANGLE_ROWS_PER_JOB
+
+//  Minimum number of independent triangles in a draw call ('pfDrawElements' or 'pfDrawArrays')
+//  for their geometry stage (fetch, transform, clipping, culling) to be shared between threads
+#ifndef PF_PARALLEL_GEOMETRY_THRESHOLD_TRIANGLES
+#   define PF_PARALLEL_GEOMETRY_THRESHOLD_TRIANGLES 4096
+#endif //PF_PARALLEL_GEOMETRY_THRESHOLD_TRIANGLES
+
+//  Minimum number of independent triangles accumulated by the immediate mode batch (see 'PF_MAX_BATCH_VERTICES')
+//  for their geometry stage to be shared between threads when the batch is flushed
+#ifndef PF_PARALLEL_BATCH_THRESHOLD_TRIANGLES
+#   define PF_PARALLEL_BATCH_THRESHOLD_TRIANGLES 512
+#endif //PF_PARALLEL_BATCH_THRESHOLD_TRIANGLES
+
+//  Number of triangles processed by each job of the geometry stage
+#ifndef PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB
+#   define PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB 256
+#endif //PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB
+
+//  Pixel threshold for parallelizing the clearing of the buffers
+#ifndef PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD
+#   define PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD 640*480
+#endif //PF_PARALLEL_CLEAR_BUFFER_SIZE_THRESHOLD
 
 #endif //PF_CONFIG_H
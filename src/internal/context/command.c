@@ -0,0 +1,301 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "./command.h"
+#include "../config.h"
+
+#include <string.h>
+
+/* Internal helper functions */
+
+// NOTE: Keeps each command aligned on the size of its arguments
+#define PFI_CMD_ALIGN(size) (((size) + sizeof(PFIcmdarg) - 1) & ~(sizeof(PFIcmdarg) - 1))
+
+static void
+pfiTransformMatrix(const PFfloat* mat)
+{
+    pfiFlushBatch();
+
+    // NOTE: We transpose matrix with multiplication order
+    pfmMat4Mul(*G_currentCtx->currentMatrix, mat, *G_currentCtx->currentMatrix);
+}
+
+static void
+pfiExecuteCommands(const PFIcmdbuffer* buffer)
+{
+    const PFubyte *cmd = buffer->data;
+    const PFubyte *end = buffer->data + buffer->size;
+
+    while (cmd < end) {
+        cmd = pfiExecuteCommand(cmd);
+    }
+}
+
+static PFI_THREAD_FUNC(pfiRenderThread, arg)
+{
+    PFIcmdqueue *queue = arg;
+
+    pfiMutexLock(&queue->mutex);
+
+    for (;;) {
+        while (queue->submitted == NULL && !queue->quit) {
+            pfiCondWait(&queue->cond, &queue->mutex);
+        }
+
+        // NOTE: The commands submitted before the deletion of the queue are still executed
+        if (queue->submitted == NULL) break;
+
+        const PFIcmdbuffer *buffer = queue->submitted;
+        pfiMutexUnlock(&queue->mutex);
+
+        // NOTE: Commands are only recorded while their context is current, so this
+        //       assignment only has an effect when 'G_currentCtx' is thread-local
+        if (G_currentCtx != queue->ctx) {
+            G_currentCtx = queue->ctx;
+        }
+
+        pfiExecuteCommands(buffer);
+
+        pfiMutexLock(&queue->mutex);
+        queue->submitted = NULL;
+        pfiCondBroadcast(&queue->cond);
+    }
+
+    pfiMutexUnlock(&queue->mutex);
+
+    PFI_THREAD_RETURN;
+}
+
+/* Command encoding functions */
+
+PFsizei
+pfiGetCommandSize(PFsizei argCount, PFsizei dataSize)
+{
+    return sizeof(PFIcmdheader) + argCount*sizeof(PFIcmdarg) + PFI_CMD_ALIGN(dataSize);
+}
+
+void
+pfiEncodeCommand(void* dst, PFIcmdtype type, const PFIcmdarg* args, PFsizei argCount, const void* data, PFsizei dataSize)
+{
+    PFubyte *cmd = dst;
+    PFsizei argsSize = argCount*sizeof(PFIcmdarg);
+
+    PFIcmdheader header = { (PFushort)type, (PFushort)argCount, dataSize };
+    memcpy(cmd, &header, sizeof(PFIcmdheader));
+    cmd += sizeof(PFIcmdheader);
+
+    if (argsSize > 0) memcpy(cmd, args, argsSize);
+    if (dataSize > 0) memcpy(cmd + argsSize, data, dataSize);
+}
+
+const void*
+pfiExecuteCommand(const void* cmd)
+{
+    const PFIcmdheader *header = cmd;
+    const PFIcmdarg *a = (const PFIcmdarg*)(header + 1);
+    const void *data = a + header->argCount;
+
+    switch ((PFIcmdtype)header->type) {
+        case PFI_CMD_SET_MAIN_BUFFER:       pfSetMainBuffer((void*)a[0].p, a[1].u, a[2].u, a[3].i, a[4].i); break;
+        case PFI_CMD_SET_AUX_BUFFER:        pfSetAuxBuffer((void*)a[0].p); break;
+        case PFI_CMD_SWAP_BUFFERS:          pfSwapBuffers(); break;
+        case PFI_CMD_ENABLE:                pfEnable(a[0].u); break;
+        case PFI_CMD_DISABLE:               pfDisable(a[0].u); break;
+        case PFI_CMD_MATRIX_MODE:           pfMatrixMode(a[0].i); break;
+        case PFI_CMD_PUSH_MATRIX:           pfPushMatrix(); break;
+        case PFI_CMD_POP_MATRIX:            pfPopMatrix(); break;
+        case PFI_CMD_LOAD_IDENTITY:         pfLoadIdentity(); break;
+        case PFI_CMD_TRANSLATE:             pfTranslatef(a[0].f, a[1].f, a[2].f); break;
+        case PFI_CMD_ROTATE:                pfRotatef(a[0].f, a[1].f, a[2].f, a[3].f); break;
+        case PFI_CMD_SCALE:                 pfScalef(a[0].f, a[1].f, a[2].f); break;
+        case PFI_CMD_MULT_MATRIX:           pfMultMatrixf(data); break;
+        case PFI_CMD_FRUSTUM:               pfFrustum(a[0].f, a[1].f, a[2].f, a[3].f, a[4].f, a[5].f); break;
+        case PFI_CMD_ORTHO:                 pfOrtho(a[0].f, a[1].f, a[2].f, a[3].f, a[4].f, a[5].f); break;
+        case PFI_CMD_VIEWPORT:              pfViewport(a[0].i, a[1].i, a[2].u, a[3].u); break;
+        case PFI_CMD_POLYGON_MODE:          pfPolygonMode(a[0].i, a[1].i); break;
+        case PFI_CMD_SHADE_MODEL:           pfShadeModel(a[0].i); break;
+        case PFI_CMD_LIGHT_MODEL:           pfLightModel(a[0].i); break;
+        case PFI_CMD_LINE_WIDTH:            pfLineWidth(a[0].f); break;
+        case PFI_CMD_POINT_SIZE:            pfPointSize(a[0].f); break;
+        case PFI_CMD_CULL_FACE:             pfCullFace(a[0].i); break;
+        case PFI_CMD_BLEND_FUNC:            pfBlendFunc(a[0].i); break;
+        case PFI_CMD_DEPTH_FUNC:            pfDepthFunc(a[0].i); break;
+        case PFI_CMD_BIND_FRAMEBUFFER:      pfBindFramebuffer((PFframebuffer*)a[0].p); break;
+        case PFI_CMD_BIND_TEXTURE:          pfBindTexture((PFtexture)a[0].p); break;
+        case PFI_CMD_ACTIVE_TEXTURE:        pfActiveTexture(a[0].i); break;
+        case PFI_CMD_TEX_COMBINE:           pfTexCombine(a[0].i); break;
+        case PFI_CMD_CLEAR:                 pfClear(a[0].u); break;
+        case PFI_CMD_CLEAR_DEPTH:           pfClearDepth(a[0].f); break;
+        case PFI_CMD_CLEAR_COLOR:           pfClearColor(a[0].c.r, a[0].c.g, a[0].c.b, a[0].c.a); break;
+        case PFI_CMD_ENABLE_LIGHT:          pfEnableLight(a[0].u); break;
+        case PFI_CMD_DISABLE_LIGHT:         pfDisableLight(a[0].u); break;
+        case PFI_CMD_LIGHTF:                pfLightf(a[0].u, a[1].u, a[2].f); break;
+        case PFI_CMD_LIGHTFV:               pfLightfv(a[0].u, a[1].u, data); break;
+        case PFI_CMD_MATERIALF:             pfMaterialf(a[0].i, a[1].u, a[2].f); break;
+        case PFI_CMD_MATERIALFV:            pfMaterialfv(a[0].i, a[1].u, data); break;
+        case PFI_CMD_COLOR_MATERIAL:        pfColorMaterial(a[0].i, a[1].u); break;
+        case PFI_CMD_VERTEX_POINTER:        pfVertexPointer(a[0].i, a[1].u, a[2].u, a[3].p); break;
+        case PFI_CMD_VERTEX_QUANTIZATION:   pfVertexQuantization(a[0].p ? (const PFfloat*)data : NULL, a[1].p ? (const PFfloat*)data + 3 : NULL); break;
+        case PFI_CMD_NORMAL_POINTER:        pfNormalPointer(a[0].u, a[1].u, a[2].p); break;
+        case PFI_CMD_TEXCOORD_POINTER:      pfTexCoordPointer(a[0].u, a[1].u, a[2].p); break;
+        case PFI_CMD_COLOR_POINTER:         pfColorPointer(a[0].i, a[1].u, a[2].u, a[3].p); break;
+        case PFI_CMD_WEIGHT_POINTER:        pfWeightPointer(a[0].i, a[1].u, a[2].u, a[3].p); break;
+        case PFI_CMD_BONE_INDEX_POINTER:    pfBoneIndexPointer(a[0].i, a[1].u, a[2].u, a[3].p); break;
+        case PFI_CMD_BONE_MATRICES:         pfBoneMatrices(a[0].u, a[1].u, a[2].p ? data : NULL); break;
+        case PFI_CMD_DRAW_ELEMENTS:         pfDrawElements(a[0].i, a[1].u, a[2].i, data); break;
+        case PFI_CMD_DRAW_ARRAYS:           pfDrawArrays(a[0].i, a[1].i, a[2].u); break;
+        case PFI_CMD_BEGIN:                 pfBegin(a[0].i); break;
+        case PFI_CMD_END:                   pfEnd(); break;
+        case PFI_CMD_VERTEX:                pfVertex4fv(data); break;
+        case PFI_CMD_COLOR:                 pfColor(a[0].c); break;
+        case PFI_CMD_TEXCOORD:              pfTexCoordfv(data); break;
+        case PFI_CMD_MULTI_TEXCOORD:        pfMultiTexCoordfv(a[0].i, data); break;
+        case PFI_CMD_NORMAL:                pfNormal3fv(data); break;
+        case PFI_CMD_RECT:                  pfRectf(a[0].f, a[1].f, a[2].f, a[3].f); break;
+        case PFI_CMD_DRAW_PIXELS:           pfDrawPixels(a[0].u, a[1].u, a[2].i, a[3].i, data); break;
+        case PFI_CMD_PIXEL_ZOOM:            pfPixelZoom(a[0].f, a[1].f); break;
+        case PFI_CMD_RASTER_POS:            pfRasterPos4fv(data); break;
+        case PFI_CMD_FOGI:                  pfFogi(a[0].i, a[1].i); break;
+        case PFI_CMD_FOGF:                  pfFogf(a[0].i, a[1].f); break;
+        case PFI_CMD_FOGIV:                 pfFogiv(a[0].i, (PFint*)data); break;
+        case PFI_CMD_FOGFV:                 pfFogfv(a[0].i, (PFfloat*)data); break;
+        case PFI_CMD_FOG_PROCESS:           pfFogProcess(); break;
+        case PFI_CMD_POST_PROCESS:          pfPostProcess(a[0].fn); break;
+        case PFI_CMD_NEW_LIST:              pfNewList((PFrenderlist)a[0].p); break;
+        case PFI_CMD_END_LIST:              pfEndList(); break;
+        case PFI_CMD_CALL_LIST:             pfCallList((PFrenderlist)a[0].p); break;
+        case PFI_CMD_TRANSFORM:             pfiTransformMatrix(data); break;
+        case PFI_CMD_RENDER_CALL:           break; // NOTE: Drawn by 'pfCallList', which owns the calls
+    }
+
+    return (const PFubyte*)data + PFI_CMD_ALIGN(header->dataSize);
+}
+
+/* Command queue functions */
+
+PFIcmdqueue*
+pfiCreateCommandQueue(PFIctx* ctx)
+{
+    PFIcmdqueue *queue = PF_CALLOC(1, sizeof(PFIcmdqueue));
+    if (!queue) return NULL;
+
+    queue->ctx = ctx;
+    queue->errCode = PF_NO_ERROR;
+
+    pfiMutexInit(&queue->mutex);
+    pfiCondInit(&queue->cond);
+
+    if (!pfiThreadCreate(&queue->thread, pfiRenderThread, queue)) {
+        pfiCondDestroy(&queue->cond);
+        pfiMutexDestroy(&queue->mutex);
+        PF_FREE(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+void
+pfiDeleteCommandQueue(PFIcmdqueue* queue)
+{
+    pfiSubmitCommands(queue);
+
+    pfiMutexLock(&queue->mutex);
+    queue->quit = PF_TRUE;
+    pfiCondBroadcast(&queue->cond);
+    pfiMutexUnlock(&queue->mutex);
+
+    pfiThreadJoin(queue->thread);
+
+    pfiCondDestroy(&queue->cond);
+    pfiMutexDestroy(&queue->mutex);
+
+    PF_FREE(queue->buffers[0].data);
+    PF_FREE(queue->buffers[1].data);
+    PF_FREE(queue);
+}
+
+void
+pfiPushCommand(PFIcmdtype type, const PFIcmdarg* args, PFsizei argCount, const void* data, PFsizei dataSize)
+{
+    PFIcmdqueue *queue = G_currentCtx->commandQueue;
+    PFIcmdbuffer *buffer = &queue->buffers[queue->recording];
+
+    PFsizei cmdSize = pfiGetCommandSize(argCount, dataSize);
+
+    // Grow the buffer if needed, a single command can exceed 'PF_COMMAND_BUFFER_SIZE'
+    if (buffer->size + cmdSize > buffer->capacity) {
+        PFsizei capacity = buffer->capacity ? 2*buffer->capacity : PF_COMMAND_BUFFER_SIZE;
+        if (capacity < buffer->size + cmdSize) capacity = buffer->size + cmdSize;
+
+        void *newData = PF_REALLOC(buffer->data, capacity);
+        if (!newData) {
+            queue->errCode = PF_ERROR_OUT_OF_MEMORY;
+            return;
+        }
+
+        buffer->data = newData;
+        buffer->capacity = capacity;
+    }
+
+    pfiEncodeCommand(buffer->data + buffer->size, type, args, argCount, data, dataSize);
+    buffer->size += cmdSize;
+
+    if (buffer->size >= PF_COMMAND_BUFFER_SIZE) {
+        pfiSubmitCommands(queue);
+    }
+}
+
+void
+pfiSubmitCommands(PFIcmdqueue* queue)
+{
+    PFIcmdbuffer *buffer = &queue->buffers[queue->recording];
+    if (buffer->size == 0) return;
+
+    // Wait until the render thread has executed the previous buffer
+    pfiMutexLock(&queue->mutex);
+    while (queue->submitted != NULL) {
+        pfiCondWait(&queue->cond, &queue->mutex);
+    }
+    queue->submitted = buffer;
+    pfiCondBroadcast(&queue->cond);
+    pfiMutexUnlock(&queue->mutex);
+
+    // The other buffer is no longer used by the render thread
+    queue->recording ^= 1;
+    queue->buffers[queue->recording].size = 0;
+}
+
+void
+pfiWaitCommands(PFIcmdqueue* queue)
+{
+    pfiSubmitCommands(queue);
+
+    pfiMutexLock(&queue->mutex);
+    while (queue->submitted != NULL) {
+        pfiCondWait(&queue->cond, &queue->mutex);
+    }
+    pfiMutexUnlock(&queue->mutex);
+
+    // Report the errors which occurred while recording
+    if (queue->errCode != PF_NO_ERROR) {
+        queue->ctx->errCode = queue->errCode;
+        queue->errCode = PF_NO_ERROR;
+    }
+}
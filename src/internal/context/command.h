@@ -0,0 +1,199 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_COMMAND_H
+#define PF_INTERNAL_COMMAND_H
+
+#include "../../pixelforge.h"
+#include "../thread.h"
+#include "./context.h"
+
+/* Command definitions */
+
+/**
+ * @brief Identifies the API function encoded by a command.
+ */
+typedef enum {
+    PFI_CMD_SET_MAIN_BUFFER,
+    PFI_CMD_SET_AUX_BUFFER,
+    PFI_CMD_SWAP_BUFFERS,
+    PFI_CMD_ENABLE,
+    PFI_CMD_DISABLE,
+    PFI_CMD_MATRIX_MODE,
+    PFI_CMD_PUSH_MATRIX,
+    PFI_CMD_POP_MATRIX,
+    PFI_CMD_LOAD_IDENTITY,
+    PFI_CMD_TRANSLATE,
+    PFI_CMD_ROTATE,
+    PFI_CMD_SCALE,
+    PFI_CMD_MULT_MATRIX,
+    PFI_CMD_FRUSTUM,
+    PFI_CMD_ORTHO,
+    PFI_CMD_VIEWPORT,
+    PFI_CMD_POLYGON_MODE,
+    PFI_CMD_SHADE_MODEL,
+    PFI_CMD_LIGHT_MODEL,
+    PFI_CMD_LINE_WIDTH,
+    PFI_CMD_POINT_SIZE,
+    PFI_CMD_CULL_FACE,
+    PFI_CMD_BLEND_FUNC,
+    PFI_CMD_DEPTH_FUNC,
+    PFI_CMD_BIND_FRAMEBUFFER,
+    PFI_CMD_BIND_TEXTURE,
+    PFI_CMD_ACTIVE_TEXTURE,
+    PFI_CMD_TEX_COMBINE,
+    PFI_CMD_CLEAR,
+    PFI_CMD_CLEAR_DEPTH,
+    PFI_CMD_CLEAR_COLOR,
+    PFI_CMD_ENABLE_LIGHT,
+    PFI_CMD_DISABLE_LIGHT,
+    PFI_CMD_LIGHTF,
+    PFI_CMD_LIGHTFV,
+    PFI_CMD_MATERIALF,
+    PFI_CMD_MATERIALFV,
+    PFI_CMD_COLOR_MATERIAL,
+    PFI_CMD_VERTEX_POINTER,
+    PFI_CMD_VERTEX_QUANTIZATION,
+    PFI_CMD_NORMAL_POINTER,
+    PFI_CMD_TEXCOORD_POINTER,
+    PFI_CMD_COLOR_POINTER,
+    PFI_CMD_WEIGHT_POINTER,
+    PFI_CMD_BONE_INDEX_POINTER,
+    PFI_CMD_BONE_MATRICES,
+    PFI_CMD_DRAW_ELEMENTS,
+    PFI_CMD_DRAW_ARRAYS,
+    PFI_CMD_BEGIN,
+    PFI_CMD_END,
+    PFI_CMD_VERTEX,
+    PFI_CMD_COLOR,
+    PFI_CMD_TEXCOORD,
+    PFI_CMD_MULTI_TEXCOORD,
+    PFI_CMD_NORMAL,
+    PFI_CMD_RECT,
+    PFI_CMD_DRAW_PIXELS,
+    PFI_CMD_PIXEL_ZOOM,
+    PFI_CMD_RASTER_POS,
+    PFI_CMD_FOGI,
+    PFI_CMD_FOGF,
+    PFI_CMD_FOGIV,
+    PFI_CMD_FOGFV,
+    PFI_CMD_FOG_PROCESS,
+    PFI_CMD_POST_PROCESS,
+    PFI_CMD_NEW_LIST,
+    PFI_CMD_END_LIST,
+    PFI_CMD_CALL_LIST,
+
+    // NOTE: The following commands are only recorded in render lists
+    PFI_CMD_TRANSFORM,              ///< Pre-multiplies the current matrix by the recorded one (see 'pfTranslatef')
+    PFI_CMD_RENDER_CALL,            ///< Draws the render call of the list at the recorded index
+} PFIcmdtype;
+
+/**
+ * @brief Argument of an encoded API call.
+ */
+typedef union {
+    PFint i;
+    PFuint u;
+    PFfloat f;
+    PFcolor c;
+    const void *p;
+    PFpostprocessfunc fn;
+} PFIcmdarg;
+
+/**
+ * @brief Header preceding each command in a command buffer.
+ *
+ * The header is followed by 'argCount' arguments (PFIcmdarg), then by 'dataSize' bytes
+ * of data copied from the memory passed by pointer to the API function (e.g. the vertex
+ * given to 'pfVertex4fv'), padded so that the next command stays aligned.
+ */
+typedef struct {
+    PFushort type;                  ///< Encoded API function (see PFIcmdtype)
+    PFushort argCount;              ///< Number of arguments following the header
+    PFuint dataSize;                ///< Number of bytes of data following the arguments
+} PFIcmdheader;
+
+/**
+ * @brief Growable buffer of encoded commands.
+ */
+typedef struct {
+    PFubyte *data;                  ///< Encoded commands
+    PFsizei size;                   ///< Number of bytes used in 'data'
+    PFsizei capacity;               ///< Number of bytes allocated for 'data'
+} PFIcmdbuffer;
+
+/**
+ * @brief Command queue of a deferred context.
+ *
+ * The API calls made on a deferred context are recorded in 'buffers[recording]'.
+ * When they are submitted (see 'pfiSubmitCommands'), the buffers are swapped and the
+ * render thread executes the submitted one while the next calls are being recorded.
+ */
+typedef struct PFIcmdqueue {
+    PFIctx *ctx;                    ///< Context the commands are executed on
+    PFIthread thread;               ///< Render thread executing the commands
+    PFImutex mutex;                 ///< Protects 'submitted' and 'quit'
+    PFIcond cond;                   ///< Signaled when 'submitted' or 'quit' changes
+    PFIcmdbuffer buffers[2];        ///< Command buffers (one recorded, one executed)
+    PFIcmdbuffer *submitted;        ///< Buffer waiting for or being executed by the render thread (NULL if idle)
+    PFint recording;                ///< Index of the buffer in which the commands are recorded
+    PFerrcode errCode;              ///< Error which occurred while recording (e.g. out of memory)
+    PFboolean quit;                 ///< Tells the render thread to stop
+} PFIcmdqueue;
+
+/* Command encoding functions */
+
+PFsizei pfiGetCommandSize(PFsizei argCount, PFsizei dataSize);
+void pfiEncodeCommand(void* dst, PFIcmdtype type, const PFIcmdarg* args, PFsizei argCount, const void* data, PFsizei dataSize);
+
+// NOTE: Executes a single encoded command, and returns a pointer to the following command
+const void* pfiExecuteCommand(const void* cmd);
+
+/* Command queue functions */
+
+PFIcmdqueue* pfiCreateCommandQueue(PFIctx* ctx);
+void pfiDeleteCommandQueue(PFIcmdqueue* queue);
+
+void pfiPushCommand(PFIcmdtype type, const PFIcmdarg* args, PFsizei argCount, const void* data, PFsizei dataSize);
+void pfiSubmitCommands(PFIcmdqueue* queue);
+void pfiWaitCommands(PFIcmdqueue* queue);
+
+/* Helper functions */
+
+// NOTE: Returns true if the API calls of the current thread must be recorded
+//       rather than executed, which is the case for a deferred context,
+//       unless the calls come from its own render thread
+static inline PFboolean
+pfiIsDeferred(void)
+{
+    PFIcmdqueue *queue = G_currentCtx->commandQueue;
+    return queue != NULL && !pfiThreadIsCurrent(queue->thread);
+}
+
+// NOTE: Waits until the render thread of a deferred context has executed
+//       the recorded commands, so that the caller can access its state
+static inline void
+pfiSyncCommands(void)
+{
+    if (pfiIsDeferred()) {
+        pfiWaitCommands(G_currentCtx->commandQueue);
+    }
+}
+
+#endif //PF_INTERNAL_COMMAND_H
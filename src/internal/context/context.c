@@ -28,10 +28,14 @@ pfiMakeContextBackup(void)
     PFIctxbackup *bck = &G_currentCtx->ctxBackup;
     memcpy(bck->faceMaterial, G_currentCtx->faceMaterial, 2 * sizeof(PFImaterial));
     memcpy(bck->currentTexcoord, G_currentCtx->currentTexcoord, sizeof(PFMvec2));
+    memcpy(bck->currentTexcoord1, G_currentCtx->currentTexcoord1, sizeof(PFMvec2));
     memcpy(bck->currentNormal, G_currentCtx->currentNormal, sizeof(PFMvec3));
     bck->currentColor = G_currentCtx->currentColor;
     bck->currentTexture = G_currentCtx->currentTexture;
+    bck->currentTexture1 = G_currentCtx->currentTexture1;
+    bck->activeTexture = G_currentCtx->activeTexture;
     bck->state = G_currentCtx->state;
+    bck->texture1State = G_currentCtx->texture1State;
 }
 
 void
@@ -40,10 +44,14 @@ pfiRestoreContext(void)
     PFIctxbackup *bck = &G_currentCtx->ctxBackup;
     memcpy(G_currentCtx->faceMaterial, bck->faceMaterial, 2 * sizeof(PFImaterial));
     memcpy(G_currentCtx->currentTexcoord, bck->currentTexcoord, sizeof(PFMvec2));
+    memcpy(G_currentCtx->currentTexcoord1, bck->currentTexcoord1, sizeof(PFMvec2));
     memcpy(G_currentCtx->currentNormal, bck->currentNormal, sizeof(PFMvec3));
     G_currentCtx->currentColor = bck->currentColor;
     G_currentCtx->currentTexture = bck->currentTexture;
+    G_currentCtx->currentTexture1 = bck->currentTexture1;
+    G_currentCtx->activeTexture = bck->activeTexture;
     G_currentCtx->state = bck->state;
+    G_currentCtx->texture1State = bck->texture1State;
 }
 
 /* Internal vertex processing function definitions */
@@ -74,7 +82,7 @@ pfiLerpVertex(const PFIvertex* start, const PFIvertex* end, PFfloat t)
     PFubyte *resultCol = (PFubyte*)(&result.color);
     PFubyte uT = (PFubyte)(255 * t);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -82,13 +90,55 @@ pfiLerpVertex(const PFIvertex* start, const PFIvertex* end, PFfloat t)
         result.position[i] = start->position[i] + t*(end->position[i] - start->position[i]);
         resultCol[i] = startCol[i] + (uT*((PFint)endCol[i] - startCol[i]))/255;
 
-        if (i < 2) result.texcoord[i] = start->texcoord[i] + t*(end->texcoord[i] - start->texcoord[i]);
+        if (i < 2) {
+            result.texcoord[i] = start->texcoord[i] + t*(end->texcoord[i] - start->texcoord[i]);
+            result.texcoord1[i] = start->texcoord1[i] + t*(end->texcoord1[i] - start->texcoord1[i]);
+        }
         if (i < 3) result.normal[i] = start->normal[i] + t*(end->normal[i] - start->normal[i]);
     }
 
     return result;
 }
 
+/* Internal primitive assembly function definitions */
+
+PFsizei
+pfiGetDrawModeVertexCount(PFdrawmode mode)
+{
+    switch (mode) {
+        case PF_POINTS:         return 1;
+        case PF_LINES:          return 2;
+        case PF_TRIANGLES:      return 3;
+        case PF_TRIANGLE_FAN:
+        case PF_TRIANGLE_STRIP: return 4;
+        case PF_QUADS:          return 4;
+        case PF_QUAD_FAN:
+        case PF_QUAD_STRIP:     return 6;
+    }
+    return 0;
+}
+
+void
+pfiResetVertexBufferForNextElement(void)
+{
+    switch (G_currentCtx->currentDrawMode) {
+        case PF_TRIANGLE_FAN:
+        case PF_TRIANGLE_STRIP:
+            G_currentCtx->vertexCounter = 1;
+            G_currentCtx->vertexBuffer[0] = G_currentCtx->vertexBuffer[3];
+            break;
+        case PF_QUAD_FAN:
+        case PF_QUAD_STRIP:
+            G_currentCtx->vertexCounter = 2;
+            G_currentCtx->vertexBuffer[0] = G_currentCtx->vertexBuffer[4];
+            G_currentCtx->vertexBuffer[1] = G_currentCtx->vertexBuffer[5];
+            break;
+        default:
+            G_currentCtx->vertexCounter = 0;
+            break;
+    }
+}
+
 /* Internal processing and rasterization function definitions */
 
 void
@@ -242,3 +292,142 @@ pfiProcessAndRasterize(void)
         break;
     }
 }
+
+// NOTE: Does not access the current context, so it can be called
+//       from the jobs of 'pfiProcessRasterize_TRIANGLES_PARALLEL'
+static void
+pfiFetchBatchVertex(const void* data, PFsizei index, PFIvertex* vertex)
+{
+    *vertex = ((const PFIvertex*)data)[index];
+}
+
+void
+pfiFlushBatch(void)
+{
+    PFsizei batchCounter = G_currentCtx->batchCounter;
+    if (batchCounter == 0) return;
+
+    // NOTE: The counter is reset before processing so that a state
+    //       change triggered during the flush never replays the batch
+    G_currentCtx->batchCounter = 0;
+
+    const PFIvertex *batch = G_currentCtx->vertexBatch;
+    PFsizei drawModeVertexCount = pfiGetDrawModeVertexCount(G_currentCtx->currentDrawMode);
+
+    // The independent triangles of the batch have their geometry stage shared between
+    // threads, when no triangle started by the previous batch is waiting to be completed
+
+    if (G_currentCtx->currentDrawMode == PF_TRIANGLES && G_currentCtx->vertexCounter == 0) {
+        PFsizei triangleVertexCount = batchCounter - batchCounter%3;
+        if (pfiProcessRasterize_TRIANGLES_PARALLEL(triangleVertexCount,
+            PF_PARALLEL_BATCH_THRESHOLD_TRIANGLES, pfiFetchBatchVertex, batch)) {
+            batch += triangleVertexCount;
+            batchCounter -= triangleVertexCount;
+        }
+    }
+
+    // Assemble the primitives in submission order, the incomplete
+    // primitive left at the end stays in 'ctx.vertexBuffer' and
+    // will be completed by the vertices of the next batch
+
+    for (PFsizei i = 0; i < batchCounter; i++) {
+        G_currentCtx->vertexBuffer[G_currentCtx->vertexCounter++] = batch[i];
+
+        if (G_currentCtx->vertexCounter == drawModeVertexCount) {
+            pfiProcessAndRasterize();
+            pfiResetVertexBufferForNextElement();
+        }
+    }
+}
+
+/* Internal matrix function definitions */
+
+void
+pfiComputeMVP(PFMmat4 mvp)
+{
+    if (G_currentCtx->modelMatrixUsed) {
+        pfmMat4MulR(mvp, G_currentCtx->matModel, G_currentCtx->matView);
+        pfmMat4Mul(mvp, mvp, G_currentCtx->matProjection);
+    } else {
+        pfmMat4MulR(mvp, G_currentCtx->matView, G_currentCtx->matProjection);
+    }
+}
+
+/* Internal material function definitions */
+
+PFImaterial
+pfiGetDefaultMaterial(void)
+{
+    return (PFImaterial) {
+        .ambient = (PFcolor) { 255, 255, 255, 255 },
+        .diffuse = (PFcolor) { 255, 255, 255, 255 },
+        .specular = (PFcolor) { 255, 255, 255, 255 },
+        .emission = (PFcolor) { 0, 0, 0, 255 },
+#ifdef PF_PHONG_REFLECTION
+        .shininess = 16.0f,
+#else
+        .shininess = 64.0f,
+#endif
+    };
+}
+
+static inline PFcolor
+pfiMaterialColor(const PFfloat* value)
+{
+    return (PFcolor) {
+        (PFubyte)(value[0]*255.0f),
+        (PFubyte)(value[1]*255.0f),
+        (PFubyte)(value[2]*255.0f),
+        255
+    };
+}
+
+// NOTE: Assigns the parameter to both materials (which can be the same one),
+//       returns PF_FALSE if the parameter is not a material parameter
+PFboolean
+pfiSetMaterialParam(PFImaterial* material0, PFImaterial* material1, PFenum param, const void* value)
+{
+    switch (param) {
+        case PF_AMBIENT:
+            material0->ambient = material1->ambient = pfiMaterialColor(value);
+            break;
+        case PF_DIFFUSE:
+            material0->diffuse = material1->diffuse = pfiMaterialColor(value);
+            break;
+        case PF_SPECULAR:
+            material0->specular = material1->specular = pfiMaterialColor(value);
+            break;
+        case PF_EMISSION:
+            material0->emission = material1->emission = pfiMaterialColor(value);
+            break;
+        case PF_SHININESS:
+            material0->shininess = material1->shininess = *((const PFfloat*)value);
+            break;
+        case PF_AMBIENT_AND_DIFFUSE:
+            material0->ambient = material1->ambient = pfiMaterialColor(value);
+            material0->diffuse = material1->diffuse = pfiMaterialColor(value);
+            break;
+        default:
+            return PF_FALSE;
+    }
+
+    return PF_TRUE;
+}
+
+PFsizei
+pfiGetParamValueSize(PFenum param)
+{
+    switch (param) {
+        case PF_AMBIENT_AND_DIFFUSE:
+        case PF_AMBIENT:
+        case PF_DIFFUSE:
+        case PF_SPECULAR:
+        case PF_EMISSION:
+        case PF_POSITION:
+        case PF_SPOT_DIRECTION:
+            return sizeof(PFMvec3);
+        default:
+            break;
+    }
+    return sizeof(PFfloat);
+}
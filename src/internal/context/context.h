@@ -79,6 +79,14 @@ typedef PFcolor (*PFIpixelgetter)(const void* pixels, PFsizei index);
  */
 typedef void (*PFIpixelsetter)(void* pixels, PFsizei index, PFcolor color);
 
+/**
+ * @brief Function pointer type for decoding a block of a compressed texture.
+ *
+ * @param block A pointer to the block to decode.
+ * @param texels The 16 decoded texels of the block, row by row.
+ */
+typedef void (*PFIblockdecoder)(const void* block, PFcolor* texels);
+
 /**
  * @brief Texture sampler function pointer type.
  * This function samples a texture at the given (u, v) coordinates.
@@ -169,11 +177,23 @@ struct PFItex {
     PFItexturesampler_simd   samplerSimd;
 #endif //PF_SIMD_SUPPORT
 
-    void                    *pixels;
-    PFfloat                 tx, ty;
+    void                    *pixels;            ///< Texels in the layout and format of the texture, 'source' if they are the same
+    void                    *source;            ///< Pixels given to 'pfGenTexture'
+    void                    *storage;           ///< Allocation holding 'pixels' when they are a copy of 'source', NULL otherwise
     PFsizei                 w, h;
-    PFdatatype              type;
-    PFpixelformat           format;
+    PFsizei                 pitch;              ///< Number of texels from a row to the next in PF_LAYOUT_LINEAR
+    PFdatatype              type;               ///< Type of 'pixels' (see 'pfTextureStorage')
+    PFpixelformat           format;             ///< Format of 'pixels' (see 'pfTextureStorage')
+    PFdatatype              sourceType;
+    PFpixelformat           sourceFormat;
+
+    struct PFItex           *mipmaps;           ///< Levels 1 to 'mipmapCount' (see 'pfGenerateMipmaps'), NULL if not generated
+    PFsizei                 mipmapCount;
+    PFtexturefilter         filter;
+    PFtexturelayout         layout;
+    PFuint                  mortonBits;         ///< Number of bits of the coordinates interleaved by PF_LAYOUT_MORTON
+    PFuint                  cacheId;            ///< Identifies the texels in the cache of decoded blocks, renewed when they are updated
+    PFcolor                 *palette;           ///< Colors of the 256 indices of PF_COLOR_INDEX (see 'pfTexturePalette'), NULL otherwise
 
 };
 
@@ -185,6 +205,8 @@ typedef struct {
     PFsizei     stride;                 ///< Byte stride between each vertex
     PFint       size;                   ///< Number of elements per vertex
     PFdatatype  type;                   ///< Data type stored by the buffer
+    PFMvec4     scale;                  ///< Scale applied to integer components when they are decoded
+    PFMvec4     offset;                 ///< Offset added to integer components after the scale
 } PFIvertexattribbuffer;
 
 /**
@@ -195,6 +217,9 @@ typedef struct {
     PFIvertexattribbuffer normals;       ///< Normal attribute buffer
     PFIvertexattribbuffer colors;        ///< Color attribute buffer
     PFIvertexattribbuffer texcoords;     ///< Texture coordinates attribute buffer
+    PFIvertexattribbuffer texcoords1;    ///< Texture coordinates attribute buffer of PF_TEXTURE1
+    PFIvertexattribbuffer weights;       ///< Bone weights attribute buffer (skinning)
+    PFIvertexattribbuffer boneIndices;   ///< Bone indices attribute buffer (skinning)
 } PFIvertexattribs;
 
 /**
@@ -206,6 +231,7 @@ typedef struct {
     PFMvec4 position;                   ///< Position coordinates
     PFMvec3 normal;                     ///< Normal vector
     PFMvec2 texcoord;                   ///< Texture coordinates
+    PFMvec2 texcoord1;                  ///< Texture coordinates of PF_TEXTURE1
     PFcolor color;                      ///< Color
 } PFIvertex;
 
@@ -257,6 +283,41 @@ typedef struct {
     PFcolor color;                     ///< Color of the fog
 } PFIfog;
 
+/**
+ * @brief Vertex streams of a render call, compiled by 'pfEndList'.
+ *
+ * The attributes are stored in the arena of the render list, one contiguous array per
+ * attribute, each aligned on PF_LIST_STREAM_ALIGNMENT bytes. The primitives of the triangle-based
+ * draw modes are also expanded into a list of triangles, in the order in which they are
+ * assembled by 'pfiProcessAndRasterize', so that they can be processed without going
+ * through the vertex buffer of the context.
+ */
+typedef struct {
+    PFsizei     offset;             ///< Offset in bytes of the streams in the arena of the render list
+    PFfloat     *positions;         ///< 4 components per vertex
+    PFfloat     *normals;           ///< 3 components per vertex
+    PFfloat     *texcoords;         ///< 2 components per vertex
+    PFfloat     *texcoords1;        ///< 2 components per vertex, texture coordinates of PF_TEXTURE1
+    PFcolor     *colors;
+    PFuint      *triangles;         ///< 3 vertex indices per triangle, NULL for points and lines
+    PFsizei     triangleCount;
+    PFsizei     elementTriangles;   ///< Number of triangles assembled from each element of the draw mode
+} PFIvertexstreams;
+
+/**
+ * @brief Bounding volumes of the vertices of a render call or of a render list, computed by 'pfEndList'.
+ *
+ * The volumes are in the coordinates given to 'pfVertex', they are only valid if all the vertices
+ * have a W coordinate of 1, otherwise the geometry they enclose is never culled by 'pfCallList'.
+ */
+typedef struct {
+    PFMvec3     min;              ///< Minimum corner of the axis-aligned bounding box
+    PFMvec3     max;              ///< Maximum corner of the axis-aligned bounding box
+    PFMvec3     center;           ///< Center of the bounding sphere (center of the box)
+    PFfloat     radius;           ///< Radius of the bounding sphere
+    PFboolean   valid;            ///< Whether the volumes can be used for culling
+} PFIbounds;
+
 /**
  * @brief Internal structure representing a single render call within a render list.
  *
@@ -267,31 +328,53 @@ typedef struct {
  *
  * This structure is typically created when a render command is issued and is stored in a render list.
  * The render list is then executed later to draw the objects as specified by these render calls.
+ *
+ * The vertices are recorded in the arena of the render list, and replaced
+ * by the compiled 'streams' when the recording of the list ends.
  */
 typedef struct {
     PFImaterial faceMaterial[2];  ///< Materials for the front and back faces of the object
-    PFIvector   positions;        ///< Vertex positions for the render call
-    PFIvector   texcoords;        ///< Texture coordinates for each vertex
-    PFIvector   normals;          ///< Normal vectors for each vertex (used for lighting)
-    PFIvector   colors;           ///< Color values for each vertex (used for per-vertex coloring)
+    PFsizei     firstVertex;      ///< Index of the first vertex of the call in the arena, while recording
+    PFsizei     vertexCount;      ///< Number of vertices of the call
+    PFIvertexstreams streams;     ///< Vertices compiled from the recorded vertices by 'pfEndList'
+    PFIbounds   bounds;           ///< Bounding volumes of the vertices of the call
     PFtexture   texture;          ///< Handle to the texture applied to this render call
+    PFtexture   texture1;         ///< Handle to the texture bound to PF_TEXTURE1 for this render call
     PFdrawmode  drawMode;         ///< Drawing mode (defines how the vertices are interpreted)
+    PFboolean   indexed;          ///< Whether the call is made of the deduplicated vertices and triangles built by PF_LIST_OPTIMIZATION
 } PFIrendercall;
 
 /**
  * @brief Internal representation of a render list.
  *
- * `PFIrenderlist` is a type alias for `PFIvector`, which represents a dynamic collection of `PFIrendercall` structures.
- * This type is used internally to store a sequence of rendering commands (render calls).
+ * `PFIrenderlist` stores a sequence of rendering commands (render calls) in a dynamic collection
+ * of `PFIrendercall` structures, and the vertices of all these calls in a single growable arena.
+ * The state changes recorded between the calls (matrices, enables, lights, etc.) are encoded like
+ * the commands of a deferred context, and replayed in order with the calls by `pfCallList`.
  *
- * Each element of this vector corresponds to a single render call, which contains the necessary 
- * information (such as vertex positions, normals, textures, etc.) to render a specific object or part of an object.
+ * Each element of the calls vector corresponds to a single render call, which contains the necessary 
+ * information (such as the range of its vertices, its materials and texture) to render a specific object
+ * or part of an object.
  *
  * Render lists are compiled by the user through the API (`pfNewList`, `pfEndList`, etc.), and then executed 
- * later with `pfCallList`. The underlying `PFIvector` allows for efficient dynamic storage and retrieval of 
- * these render commands.
+ * later with `pfCallList`. While recording, the vertices are appended to the arena, which is then rewritten
+ * with the vertex streams of the calls and shrunk to fit by `pfEndList`. The arena is kept when the list is
+ * recorded again, so rebuilding a list does not allocate memory once its arena is large enough.
+ *
+ * A list loaded by `pfLoadList` can use the streams in place in the memory given by the user,
+ * the arena is then not owned by the list, and is replaced by a new one if the list is recorded again.
  */
-typedef PFIvector PFIrenderlist;
+typedef struct {
+    PFIvector   commands;         ///< Encoded state changes and render calls, in recording order (see 'PFIcmdheader')
+    PFIvector   calls;            ///< Render calls of the list (PFIrendercall)
+    PFubyte     *arena;           ///< Single allocation containing the vertices of all the calls
+    PFsizei     arenaSize;        ///< Number of bytes used in the arena
+    PFsizei     arenaCapacity;    ///< Number of bytes allocated for the arena
+    PFIbounds   bounds;           ///< Bounding volumes of the vertices of all the calls
+    PFboolean   transforms;       ///< Whether the list records matrix operations, its bounds are then only tested per call
+    PFboolean   compiled;         ///< Whether the arena contains the streams compiled by 'pfEndList'
+    PFboolean   externalArena;    ///< Whether the arena is memory given to 'pfLoadList', which must not be freed
+} PFIrenderlist;
 
 /**
  * @brief Structure for backing up the current rendering context state.
@@ -309,10 +392,14 @@ typedef PFIvector PFIrenderlist;
 typedef struct {
     PFImaterial faceMaterial[2];   //< Materials for the front and back faces.
     PFMvec2     currentTexcoord;   //< Current texture coordinate (2D vector).
+    PFMvec2     currentTexcoord1;  //< Current texture coordinate of PF_TEXTURE1.
     PFMvec3     currentNormal;     //< Current normal vector (3D vector).
     PFcolor     currentColor;      //< Current vertex color.
     PFtexture   currentTexture;    //< Handle to the currently bound texture.
+    PFtexture   currentTexture1;   //< Handle to the texture bound to PF_TEXTURE1.
+    PFtextureunit activeTexture;   //< Texture unit selected by 'pfActiveTexture'.
     PFuint      state;             //< Bitfield representing the current state flags.
+    PFuint      texture1State;     //< Texture states of PF_TEXTURE1.
 } PFIctxbackup;
 
 /**
@@ -322,7 +409,8 @@ typedef struct {
 typedef struct {
 
     PFframebuffer *currentFramebuffer;                      ///< Pointer to the current framebuffer
-    PFtexture currentTexture;                               ///< Pointer to the current texture
+    PFtexture currentTexture;                               ///< Pointer to the current texture (PF_TEXTURE0)
+    PFtexture currentTexture1;                              ///< Pointer to the texture bound to PF_TEXTURE1
     PFMmat4 *currentMatrix;                                 ///< Pointer to the current matrix
     void *auxFramebuffer;                                   ///< Auxiliary buffer for double buffering
 
@@ -343,8 +431,12 @@ typedef struct {
     PFIvertex vertexBuffer[6];                              ///< Buffer used for storing primitive vertices, used for processing and rendering
     PFsizei vertexCounter;                                  ///< Number of vertices in 'ctx.vertexBuffer'
 
+    PFIvertex vertexBatch[PF_MAX_BATCH_VERTICES];           ///< Vertices submitted in immediate mode and waiting to be processed (see 'pfiFlushBatch')
+    PFsizei batchCounter;                                   ///< Number of vertices in 'ctx.vertexBatch'
+
     PFMvec3 currentNormal;                                  ///< Current normal assigned by 'pfNormal'                  - (Stored in 'ctx.vertexBuffer' after the call to 'pfVertex')
     PFMvec2 currentTexcoord;                                ///< Current texture coordinates assigned by 'pfTexCoord'   - (Stored in 'ctx.vertexBuffer' after the call to 'pfVertex')
+    PFMvec2 currentTexcoord1;                               ///< Current texture coordinates of PF_TEXTURE1 assigned by 'pfMultiTexCoord'
     PFcolor currentColor;                                   ///< Current color assigned by by 'pfColor'                 - (Stored in 'ctx.vertexBuffer' after the call to 'pfVertex')
 
     PFframebuffer mainFramebuffer;                          ///< Screen buffer for rendering
@@ -381,6 +473,8 @@ typedef struct {
     PFMmat4 matMVP;                                         ///< Model view projection matrix, calculated and used internally
     PFMmat4 matNormal;                                      ///< Normal matrix, calculated and used internally
 
+    PFMmat4 bonePalette[PF_MAX_BONE_MATRICES];              ///< Bone matrices used to skin the vertex arrays (see 'pfBoneMatrices')
+
     PFMmat4 stackProjection[PF_MAX_PROJECTION_STACK_SIZE];  ///< Projection matrix stack for push/pop operations
     PFMmat4 stackModelview[PF_MAX_MODELVIEW_STACK_SIZE];    ///< Modelview matrix stack for push/pop operations
     PFMmat4 stackTexture[PF_MAX_TEXTURE_STACK_SIZE];        ///< Texture matrix stack for push/pop operations
@@ -398,9 +492,20 @@ typedef struct {
     PFerrcode errCode;                                      ///< Last error code
     PFuint state;                                           ///< Current context state
 
+    PFtextureunit activeTexture;                            ///< Texture unit modified by the texture functions (see 'pfActiveTexture')
+    PFuint texture1State;                                   ///< PFI_TEXTURE_UNIT_STATES of PF_TEXTURE1, those of PF_TEXTURE0 are in 'state'
+    PFcombinemode textureCombine[2];                        ///< Combine mode of each texture unit (see 'pfTexCombine')
+
+    struct PFIcmdqueue *commandQueue;                       ///< Command queue of a deferred context (NULL if the calls are executed immediately)
+    struct PFIrasterqueue *rasterQueue;                     ///< Frame bins rasterized by another thread (NULL if PF_FRAME_PIPELINING is disabled)
+
 } PFIctx;
 
 
+// NOTE: States given to 'pfEnable' that apply to the active texture unit
+#define PFI_TEXTURE_UNIT_STATES (PF_TEXTURE_2D | PF_TEXTURE_COORD_ARRAY)
+
+
 /* Current thread local-thread declaration */
 
 extern PF_CTX_DECL PFIctx *G_currentCtx;
@@ -414,7 +519,20 @@ void pfiRestoreContext(void);
 void pfiHomogeneousToScreen(PFIvertex* v);
 PFIvertex pfiLerpVertex(const PFIvertex* start, const PFIvertex* end, PFfloat t);
 
+PFsizei pfiGetDrawModeVertexCount(PFdrawmode mode);
+void pfiResetVertexBufferForNextElement(void);
+
 void pfiProcessAndRasterize(void);
+void pfiFlushBatch(void);
+
+// NOTE: Computes the model-view-projection matrix from the current matrices, as done by 'pfBegin'
+void pfiComputeMVP(PFMmat4 mvp);
+
+PFImaterial pfiGetDefaultMaterial(void);
+PFboolean pfiSetMaterialParam(PFImaterial* material0, PFImaterial* material1, PFenum param, const void* value);
+
+// NOTE: Returns the number of bytes read by 'pfLightfv' or 'pfMaterialfv' for the given parameter
+PFsizei pfiGetParamValueSize(PFenum param);
 
 
 #endif //PF_INTERNAL_CONTEXT_H
@@ -0,0 +1,218 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "./raster.h"
+#include "../config.h"
+
+#include <string.h>
+
+/* Internal helper functions */
+
+// NOTE: Keeps the data of each command aligned as the memory returned by 'PF_REALLOC'
+#define PFI_RASTER_ALIGN(size) (((size) + 15) & ~(PFsizei)15)
+
+#define PFI_RASTER_NO_STATE ((PFsizei)-1)
+
+static void
+pfiRunRasterCommands(const PFIrasterbin* bin)
+{
+    PFubyte *cmd = bin->data;
+    PFubyte *end = bin->data + bin->size;
+
+    while (cmd < end) {
+        const PFIrastercmdheader *header = (const PFIrastercmdheader*)cmd;
+        PFubyte *data = cmd + PFI_RASTER_ALIGN(sizeof(PFIrastercmdheader));
+        header->func(data);
+        cmd = data + header->size;
+    }
+}
+
+static PFI_THREAD_FUNC(pfiRasterThread, arg)
+{
+    PFIrasterqueue *queue = arg;
+
+    pfiMutexLock(&queue->mutex);
+
+    for (;;) {
+        while (queue->submitted == NULL && !queue->quit) {
+            pfiCondWait(&queue->cond, &queue->mutex);
+        }
+
+        // NOTE: The bin submitted before the deletion of the queue is still rasterized
+        if (queue->submitted == NULL) break;
+
+        const PFIrasterbin *bin = queue->submitted;
+        pfiMutexUnlock(&queue->mutex);
+
+        pfiRunRasterCommands(bin);
+
+        pfiMutexLock(&queue->mutex);
+        queue->submitted = NULL;
+        pfiCondBroadcast(&queue->cond);
+    }
+
+    pfiMutexUnlock(&queue->mutex);
+
+    PFI_THREAD_RETURN;
+}
+
+// NOTE: Waits until the raster thread is idle, then applies the swap
+//       requested by 'pfSwapBuffers' for the frame it has just completed
+static void
+pfiWaitRasterThread(PFIrasterqueue* queue)
+{
+    pfiMutexLock(&queue->mutex);
+    while (queue->submitted != NULL) {
+        pfiCondWait(&queue->cond, &queue->mutex);
+    }
+    pfiMutexUnlock(&queue->mutex);
+
+    if (queue->swapTexture) {
+        struct PFItex *tex = queue->swapTexture;
+        void *tmp = tex->pixels;
+        tex->pixels = queue->ctx->auxFramebuffer;
+        queue->ctx->auxFramebuffer = tmp;
+        queue->swapTexture = NULL;
+    }
+}
+
+/* Raster queue functions */
+
+PFIrasterqueue*
+pfiCreateRasterQueue(PFIctx* ctx)
+{
+    PFIrasterqueue *queue = PF_CALLOC(1, sizeof(PFIrasterqueue));
+    if (!queue) return NULL;
+
+    queue->ctx = ctx;
+    queue->bins[0].stateOffset = PFI_RASTER_NO_STATE;
+    queue->bins[1].stateOffset = PFI_RASTER_NO_STATE;
+
+    pfiMutexInit(&queue->mutex);
+    pfiCondInit(&queue->cond);
+
+    if (!pfiThreadCreate(&queue->thread, pfiRasterThread, queue)) {
+        pfiCondDestroy(&queue->cond);
+        pfiMutexDestroy(&queue->mutex);
+        PF_FREE(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+void
+pfiDeleteRasterQueue(PFIrasterqueue* queue)
+{
+    pfiWaitRasterCommands(queue);
+
+    pfiMutexLock(&queue->mutex);
+    queue->quit = PF_TRUE;
+    pfiCondBroadcast(&queue->cond);
+    pfiMutexUnlock(&queue->mutex);
+
+    pfiThreadJoin(queue->thread);
+
+    pfiCondDestroy(&queue->cond);
+    pfiMutexDestroy(&queue->mutex);
+
+    PF_FREE(queue->bins[0].data);
+    PF_FREE(queue->bins[1].data);
+    PF_FREE(queue);
+}
+
+void*
+pfiPushRasterCommand(PFIrasterqueue* queue, PFIrasterfunc func, PFsizei size)
+{
+    PFIrasterbin *bin = &queue->bins[queue->recording];
+
+    PFsizei headerSize = PFI_RASTER_ALIGN(sizeof(PFIrastercmdheader));
+    PFsizei cmdSize = headerSize + PFI_RASTER_ALIGN(size);
+
+    // Grow the bin if needed, a bin contains a whole frame so it is never submitted when full
+    if (bin->size + cmdSize > bin->capacity) {
+        PFsizei capacity = bin->capacity ? 2*bin->capacity : PF_RASTER_BIN_SIZE;
+        if (capacity < bin->size + cmdSize) capacity = bin->size + cmdSize;
+
+        void *newData = PF_REALLOC(bin->data, capacity);
+        if (!newData) {
+            queue->ctx->errCode = PF_ERROR_OUT_OF_MEMORY;
+            return NULL;
+        }
+
+        bin->data = newData;
+        bin->capacity = capacity;
+    }
+
+    PFubyte *cmd = bin->data + bin->size;
+
+    PFIrastercmdheader header = { func, PFI_RASTER_ALIGN(size) };
+    memcpy(cmd, &header, sizeof(PFIrastercmdheader));
+
+    bin->size += cmdSize;
+
+    return cmd + headerSize;
+}
+
+void*
+pfiPushRasterState(PFIrasterqueue* queue, PFIrasterfunc func, PFsizei size)
+{
+    PFubyte *data = pfiPushRasterCommand(queue, func, size);
+    if (!data) return NULL;
+
+    PFIrasterbin *bin = &queue->bins[queue->recording];
+    bin->stateOffset = (PFsizei)(data - bin->data);
+
+    return data;
+}
+
+void*
+pfiGetRasterState(PFIrasterqueue* queue)
+{
+    PFIrasterbin *bin = &queue->bins[queue->recording];
+    return (bin->stateOffset != PFI_RASTER_NO_STATE) ? bin->data + bin->stateOffset : NULL;
+}
+
+void
+pfiSubmitRasterCommands(PFIrasterqueue* queue)
+{
+    // Wait until the raster thread has completed the previous frame
+    // NOTE: Also applies its swap before the new bin is rasterized
+    pfiWaitRasterThread(queue);
+
+    PFIrasterbin *bin = &queue->bins[queue->recording];
+    if (bin->size == 0) return;
+
+    pfiMutexLock(&queue->mutex);
+    queue->submitted = bin;
+    pfiCondBroadcast(&queue->cond);
+    pfiMutexUnlock(&queue->mutex);
+
+    // The other bin is no longer used by the raster thread
+    queue->recording ^= 1;
+    queue->bins[queue->recording].size = 0;
+    queue->bins[queue->recording].stateOffset = PFI_RASTER_NO_STATE;
+}
+
+void
+pfiWaitRasterCommands(PFIrasterqueue* queue)
+{
+    pfiSubmitRasterCommands(queue);
+    pfiWaitRasterThread(queue);
+}
@@ -0,0 +1,105 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_RASTER_H
+#define PF_INTERNAL_RASTER_H
+
+#include "../../pixelforge.h"
+#include "../thread.h"
+#include "./context.h"
+
+/* Raster command definitions */
+
+/**
+ * @brief Function run by the raster thread for a command recorded in a frame bin.
+ *
+ * The commands of a bin are run while the geometry stage of the next frame modifies
+ * the context, so they must only use the data recorded with them, never 'G_currentCtx'.
+ */
+typedef void (*PFIrasterfunc)(void* data);
+
+/**
+ * @brief Header preceding the data of each command recorded in a frame bin.
+ */
+typedef struct {
+    PFIrasterfunc func;                 ///< Function run with the data following the header
+    PFsizei size;                       ///< Number of bytes of data following the header (aligned)
+} PFIrastercmdheader;
+
+/**
+ * @brief Growable buffer of raster commands recorded for a frame.
+ */
+typedef struct {
+    PFubyte *data;                      ///< Recorded commands
+    PFsizei size;                       ///< Number of bytes used in 'data'
+    PFsizei capacity;                   ///< Number of bytes allocated for 'data'
+    PFsizei stateOffset;                ///< Offset of the data of the last state recorded (see 'pfiPushRasterState')
+} PFIrasterbin;
+
+/**
+ * @brief Raster queue of a context with PF_FRAME_PIPELINING enabled.
+ *
+ * The post-setup primitives of a frame are recorded in 'bins[recording]'. When the frame
+ * is submitted by 'pfSwapBuffers', the raster thread runs its bin while the geometry
+ * stage of the next frame records in the other one. The swap of the framebuffer is
+ * applied once the raster thread is done with the frame, before the next bin is submitted,
+ * so the auxiliary buffer always contains a completed frame.
+ */
+typedef struct PFIrasterqueue {
+    PFIctx *ctx;                        ///< Context the commands are recorded from
+    PFIthread thread;                   ///< Raster thread running the commands
+    PFImutex mutex;                     ///< Protects 'submitted' and 'quit'
+    PFIcond cond;                       ///< Signaled when 'submitted' or 'quit' changes
+    PFIrasterbin bins[2];               ///< Frame bins (one recorded, one rasterized)
+    PFIrasterbin *submitted;            ///< Bin waiting for or being run by the raster thread (NULL if idle)
+    PFint recording;                    ///< Index of the bin in which the commands are recorded
+    struct PFItex *swapTexture;         ///< Texture whose pixels must be swapped with the auxiliary buffer once the raster thread is idle (NULL if none)
+    PFboolean quit;                     ///< Tells the raster thread to stop
+} PFIrasterqueue;
+
+/* Raster queue functions */
+
+PFIrasterqueue* pfiCreateRasterQueue(PFIctx* ctx);
+void pfiDeleteRasterQueue(PFIrasterqueue* queue);
+
+// NOTE: Returns where the 'size' bytes of data of the command must be written (NULL on failure),
+//       the pointer is only valid until the next command is recorded in the queue
+void* pfiPushRasterCommand(PFIrasterqueue* queue, PFIrasterfunc func, PFsizei size);
+
+// NOTE: Same as 'pfiPushRasterCommand' but the data can then be retrieved with 'pfiGetRasterState',
+//       until the bin is submitted, so that the following commands can share it
+void* pfiPushRasterState(PFIrasterqueue* queue, PFIrasterfunc func, PFsizei size);
+void* pfiGetRasterState(PFIrasterqueue* queue);
+
+void pfiSubmitRasterCommands(PFIrasterqueue* queue);
+void pfiWaitRasterCommands(PFIrasterqueue* queue);
+
+/* Helper functions */
+
+// NOTE: Waits until the raster thread has run every recorded command, so that
+//       the caller can access the framebuffers and textures they use
+static inline void
+pfiSyncRaster(void)
+{
+    if (G_currentCtx->rasterQueue) {
+        pfiWaitRasterCommands(G_currentCtx->rasterQueue);
+    }
+}
+
+#endif //PF_INTERNAL_RASTER_H
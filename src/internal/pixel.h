@@ -758,11 +758,198 @@ pfiPixelGet_BGRA_FLOAT(const void* pixels, PFsizei offset)
     };
 }
 
+/* GET COMPRESSED */
+
+/*
+ * NOTE: The texels of the compressed formats are addressed in PF_LAYOUT_TILED, the offset of a texel
+ *       is then the index of its block times 16, plus its index in the block (row by row).
+ *       The blocks have no setters, they can only be decoded.
+ */
+
+// NOTE: Magnitudes of the ETC1 modifiers, for each table of a subblock and the low bit of a texel index
+static const PFint GC_etc1Modifiers[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+static inline PFcolor
+pfiDecodeColor_565(PFushort color)
+{
+    PFubyte r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    return (PFcolor) { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+}
+
+// NOTE: Fills the four colors of a BC1 color block, the two last are interpolated between the endpoints
+//       if the first one is greater (or if 'opaque' is true), otherwise they are their average and transparent black
+static inline void
+pfiDecodePalette_BC1(const PFubyte* block, PFcolor palette[4], PFboolean opaque)
+{
+    PFushort c0 = block[0] | (block[1] << 8);
+    PFushort c1 = block[2] | (block[3] << 8);
+
+    PFboolean fourColors = (c0 > c1) || opaque;
+
+    palette[0] = pfiDecodeColor_565(c0);
+    palette[1] = pfiDecodeColor_565(c1);
+    palette[2] = (PFcolor) { 0, 0, 0, 255 };
+    palette[3] = (PFcolor) { 0, 0, 0, fourColors ? 255 : 0 };
+
+    for (int_fast8_t i = 0; i < 3; i++) {
+        PFuint e0 = ((PFubyte*)&palette[0])[i];
+        PFuint e1 = ((PFubyte*)&palette[1])[i];
+        if (fourColors) {
+            ((PFubyte*)&palette[2])[i] = (PFubyte)((2*e0 + e1 + 1)/3);
+            ((PFubyte*)&palette[3])[i] = (PFubyte)((e0 + 2*e1 + 1)/3);
+        } else {
+            ((PFubyte*)&palette[2])[i] = (PFubyte)((e0 + e1 + 1)/2);
+        }
+    }
+}
+
+// NOTE: Fills the eight alphas of a BC3 alpha block, six are interpolated between the endpoints if
+//       the first one is greater, otherwise four are interpolated and the two last are 0 and 255
+static inline void
+pfiDecodeAlphaPalette_BC3(const PFubyte* block, PFubyte palette[8])
+{
+    PFuint a0 = block[0], a1 = block[1];
+
+    palette[0] = (PFubyte)a0;
+    palette[1] = (PFubyte)a1;
+
+    if (a0 > a1) {
+        for (PFuint k = 1; k <= 6; k++) {
+            palette[k + 1] = (PFubyte)((a0*(7 - k) + a1*k + 3)/7);
+        }
+    } else {
+        for (PFuint k = 1; k <= 4; k++) {
+            palette[k + 1] = (PFubyte)((a0*(5 - k) + a1*k + 2)/5);
+        }
+        palette[6] = 0, palette[7] = 255;
+    }
+}
+
+// NOTE: Returns the 3-bit alpha index of the texel 't' of a BC3 block, the 48 bits of indices are little-endian
+static inline PFuint
+pfiGetAlphaIndex_BC3(const PFubyte* block, PFuint t)
+{
+    PFuint bit = 3*t;
+    PFuint bits = block[2 + bit/8] | (block[3 + bit/8] << 8);
+    return (bits >> (bit & 7)) & 0x7;
+}
+
+// NOTE: Decodes the texel 't' of an ETC1 block, made of two subblocks of 2x4 texels (4x2 if flipped)
+//       each with a base color and a table of modifiers. The 32 bits of texel indices are big-endian
+//       and store a bit plane for each texel in column order.
+static inline PFcolor
+pfiDecodeTexel_ETC1(const PFubyte* block, PFuint t)
+{
+    PFuint control = block[3];
+    PFuint indices = ((PFuint)block[4] << 24) | (block[5] << 16) | (block[6] << 8) | block[7];
+    PFuint x = t & 3, y = t >> 2, p = x*4 + y;
+
+    PFuint sub = (control & 0x1) ? (y >> 1) : (x >> 1);
+    PFuint table = (control >> (sub ? 2 : 5)) & 0x7;
+
+    PFint modifier = GC_etc1Modifiers[table][(indices >> p) & 0x1];
+    if ((indices >> (16 + p)) & 0x1) modifier = -modifier;
+
+    PFcolor color = { 0, 0, 0, 255 };
+
+    for (int_fast8_t i = 0; i < 3; i++) {
+        PFint base;
+        if (control & 0x2) {
+            PFint c = block[i] >> 3;
+            if (sub) c = (c + (block[i] & 0x7) - 2*(block[i] & 0x4)) & 0x1F;
+            base = (c << 3) | (c >> 2);
+        } else {
+            base = (sub ? (block[i] & 0xF) : (block[i] >> 4))*17;
+        }
+        ((PFubyte*)&color)[i] = (PFubyte)PF_CLAMP(base + modifier, 0, 255);
+    }
+
+    return color;
+}
+
+static inline PFcolor
+pfiPixelGet_COMPRESSED_BC1_UBYTE(const void* pixels, PFsizei offset)
+{
+    const PFubyte *block = (const PFubyte*)pixels + (offset >> 4)*8;
+    PFuint indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((PFuint)block[7] << 24);
+
+    PFcolor palette[4];
+    pfiDecodePalette_BC1(block, palette, PF_FALSE);
+
+    return palette[(indices >> 2*(offset & 15)) & 0x3];
+}
+
+static inline PFcolor
+pfiPixelGet_COMPRESSED_BC3_UBYTE(const void* pixels, PFsizei offset)
+{
+    const PFubyte *block = (const PFubyte*)pixels + (offset >> 4)*16;
+    PFuint indices = block[12] | (block[13] << 8) | (block[14] << 16) | ((PFuint)block[15] << 24);
+
+    PFcolor palette[4];
+    PFubyte alphas[8];
+    pfiDecodePalette_BC1(block + 8, palette, PF_TRUE);
+    pfiDecodeAlphaPalette_BC3(block, alphas);
+
+    PFcolor color = palette[(indices >> 2*(offset & 15)) & 0x3];
+    color.a = alphas[pfiGetAlphaIndex_BC3(block, offset & 15)];
+
+    return color;
+}
+
+static inline PFcolor
+pfiPixelGet_COMPRESSED_ETC1_UBYTE(const void* pixels, PFsizei offset)
+{
+    return pfiDecodeTexel_ETC1((const PFubyte*)pixels + (offset >> 4)*8, offset & 15);
+}
+
+/* DECODE COMPRESSED BLOCKS */
+
+static inline void
+pfiBlockDecode_COMPRESSED_BC1(const void* block, PFcolor* texels)
+{
+    const PFubyte *bytes = block;
+    PFuint indices = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((PFuint)bytes[7] << 24);
+
+    PFcolor palette[4];
+    pfiDecodePalette_BC1(bytes, palette, PF_FALSE);
+
+    for (PFuint t = 0; t < 16; t++) {
+        texels[t] = palette[(indices >> 2*t) & 0x3];
+    }
+}
+
+static inline void
+pfiBlockDecode_COMPRESSED_BC3(const void* block, PFcolor* texels)
+{
+    const PFubyte *bytes = block;
+    PFuint indices = bytes[12] | (bytes[13] << 8) | (bytes[14] << 16) | ((PFuint)bytes[15] << 24);
+
+    PFcolor palette[4];
+    PFubyte alphas[8];
+    pfiDecodePalette_BC1(bytes + 8, palette, PF_TRUE);
+    pfiDecodeAlphaPalette_BC3(bytes, alphas);
+
+    for (PFuint t = 0; t < 16; t++) {
+        texels[t] = palette[(indices >> 2*t) & 0x3];
+        texels[t].a = alphas[pfiGetAlphaIndex_BC3(bytes, t)];
+    }
+}
+
+static inline void
+pfiBlockDecode_COMPRESSED_ETC1(const void* block, PFcolor* texels)
+{
+    for (PFuint t = 0; t < 16; t++) {
+        texels[t] = pfiDecodeTexel_ETC1(block, t);
+    }
+}
+
 /* Internal helper constant array */
 
 #define ENTRY(FORMAT, TYPE, FUNC) [FORMAT][TYPE] = FUNC
 
-static const PFIpixelgetter GC_pixelGetters[10][12] = {
+static const PFIpixelgetter GC_pixelGetters[14][12] = {
     ENTRY(PF_RED, PF_UNSIGNED_BYTE, pfiPixelGet_RED_UBYTE),
     ENTRY(PF_RED, PF_HALF_FLOAT, pfiPixelGet_RED_HALF),
     ENTRY(PF_RED, PF_FLOAT, pfiPixelGet_RED_FLOAT),
@@ -808,9 +995,13 @@ static const PFIpixelgetter GC_pixelGetters[10][12] = {
     ENTRY(PF_BGRA, PF_UNSIGNED_SHORT_4_4_4_4, pfiPixelGet_BGRA_USHORT_4_4_4_4),
     ENTRY(PF_BGRA, PF_HALF_FLOAT, pfiPixelGet_BGRA_HALF),
     ENTRY(PF_BGRA, PF_FLOAT, pfiPixelGet_BGRA_FLOAT),
+
+    ENTRY(PF_COMPRESSED_BC1, PF_UNSIGNED_BYTE, pfiPixelGet_COMPRESSED_BC1_UBYTE),
+    ENTRY(PF_COMPRESSED_BC3, PF_UNSIGNED_BYTE, pfiPixelGet_COMPRESSED_BC3_UBYTE),
+    ENTRY(PF_COMPRESSED_ETC1, PF_UNSIGNED_BYTE, pfiPixelGet_COMPRESSED_ETC1_UBYTE),
 };
 
-static const PFIpixelsetter GC_pixelSetters[10][12] = {
+static const PFIpixelsetter GC_pixelSetters[14][12] = {
     ENTRY(PF_RED, PF_UNSIGNED_BYTE, pfiPixelSet_RED_UBYTE),
     ENTRY(PF_RED, PF_HALF_FLOAT, pfiPixelSet_RED_HALF),
     ENTRY(PF_RED, PF_FLOAT, pfiPixelSet_RED_FLOAT),
@@ -860,6 +1051,13 @@ static const PFIpixelsetter GC_pixelSetters[10][12] = {
 
 #undef ENTRY
 
+// NOTE: Indexed by the compressed format minus PF_COMPRESSED_BC1
+static const PFIblockdecoder GC_blockDecoders[3] = {
+    pfiBlockDecode_COMPRESSED_BC1,
+    pfiBlockDecode_COMPRESSED_BC3,
+    pfiBlockDecode_COMPRESSED_ETC1
+};
+
 
 
 
@@ -3039,11 +3237,175 @@ pfiPixelGet_BGRA_FLOAT_simd(const void* pixels, PFIsimdvi offsets)
     return bgra;
 }
 
+/* GET COMPRESSED */
+
+// NOTE: Expands the 5:6:5 colors in the low 16 bits of the lanes into 8-bit red, green and blue lanes
+static inline void
+pfiDecodeColor_565_simd(PFIsimdvi color, PFIsimdvi channels[3])
+{
+    PFIsimdvi r = pfiSimdAnd_I32(pfiSimdShr_I32(color, 11), pfiSimdSet1_I32(0x1F));
+    PFIsimdvi g = pfiSimdAnd_I32(pfiSimdShr_I32(color, 5), pfiSimdSet1_I32(0x3F));
+    PFIsimdvi b = pfiSimdAnd_I32(color, pfiSimdSet1_I32(0x1F));
+
+    channels[0] = pfiSimdOr_I32(pfiSimdShl_I32(r, 3), pfiSimdShr_I32(r, 2));
+    channels[1] = pfiSimdOr_I32(pfiSimdShl_I32(g, 2), pfiSimdShr_I32(g, 4));
+    channels[2] = pfiSimdOr_I32(pfiSimdShl_I32(b, 3), pfiSimdShr_I32(b, 2));
+}
+
+// NOTE: Decodes the texel 'texels' of the BC1 color blocks at the byte offsets 'blocks' (see 'pfiDecodePalette_BC1'),
+//       the division by 3 of the interpolated colors is done by a multiplication by 65536/3 rounded up
+static inline PFIsimdvi
+pfiDecodeColorBlock_BC1_simd(const void* pixels, PFIsimdvi blocks, PFIsimdvi texels, PFboolean opaque)
+{
+    PFIsimdvi endpoints = pfiSimdGather_I32(pixels, blocks, 1);
+    PFIsimdvi indices = pfiSimdGather_I32(pixels, pfiSimdAdd_I32(blocks, pfiSimdSet1_I32(4)), 1);
+    PFIsimdvi index = pfiSimdAnd_I32(pfiSimdShrV_I32(indices, pfiSimdShl_I32(texels, 1)), pfiSimdSet1_I32(0x3));
+
+    PFIsimdvi c0 = pfiSimdAnd_I32(endpoints, pfiSimdSet1_I32(0xFFFF));
+    PFIsimdvi c1 = pfiSimdShr_I32(endpoints, 16);
+
+    PFIsimdvi e0[3], e1[3];
+    pfiDecodeColor_565_simd(c0, e0);
+    pfiDecodeColor_565_simd(c1, e1);
+
+    PFIsimdvi fourColors = opaque ? pfiSimdSet1_I32(-1) : pfiSimdCmpGT_I32(c0, c1);
+    PFIsimdvi isIndex1 = pfiSimdCmpEQ_I32(index, pfiSimdSet1_I32(1));
+    PFIsimdvi isIndex2 = pfiSimdCmpEQ_I32(index, pfiSimdSet1_I32(2));
+    PFIsimdvi isIndex3 = pfiSimdCmpEQ_I32(index, pfiSimdSet1_I32(3));
+
+    PFIsimdvi one = pfiSimdSet1_I32(1);
+    PFIsimdvi third = pfiSimdSet1_I32(21846);
+
+    // NOTE: Transparent black in the three colors mode, opaque otherwise
+    PFIsimdvi color = pfiSimdAndNot_I32(pfiSimdAndNot_I32(fourColors, isIndex3), pfiSimdSet1_I32(0xFF000000));
+
+    for (int_fast8_t i = 0; i < 3; i++) {
+        PFIsimdvi p2 = pfiSimdShr_I32(pfiSimdMullo_I32(pfiSimdAdd_I32(pfiSimdAdd_I32(pfiSimdShl_I32(e0[i], 1), e1[i]), one), third), 16);
+        PFIsimdvi p3 = pfiSimdShr_I32(pfiSimdMullo_I32(pfiSimdAdd_I32(pfiSimdAdd_I32(pfiSimdShl_I32(e1[i], 1), e0[i]), one), third), 16);
+        PFIsimdvi average = pfiSimdShr_I32(pfiSimdAdd_I32(pfiSimdAdd_I32(e0[i], e1[i]), one), 1);
+
+        p2 = pfiSimdBlendV_I8(average, p2, fourColors);
+        p3 = pfiSimdAnd_I32(p3, fourColors);
+
+        PFIsimdvi channel = pfiSimdBlendV_I8(e0[i], e1[i], isIndex1);
+        channel = pfiSimdBlendV_I8(channel, p2, isIndex2);
+        channel = pfiSimdBlendV_I8(channel, p3, isIndex3);
+
+        color = pfiSimdOr_I32(color, pfiSimdShl_I32(channel, 8*i));
+    }
+
+    return color;
+}
+
+// NOTE: Decodes the alpha of the texel 'texels' of the BC3 alpha blocks at the byte offsets 'blocks' (see 'pfiDecodeAlphaPalette_BC3'),
+//       the divisions by 7 and 5 of the interpolated alphas are done by a multiplication by 65536/7 and 65536/5 rounded up
+static inline PFIsimdvi
+pfiDecodeAlphaBlock_BC3_simd(const void* pixels, PFIsimdvi blocks, PFIsimdvi texels)
+{
+    PFIsimdvi endpoints = pfiSimdGather_I32(pixels, blocks, 1);
+    PFIsimdvi a0 = pfiSimdAnd_I32(endpoints, pfiSimdSet1_I32(0xFF));
+    PFIsimdvi a1 = pfiSimdAnd_I32(pfiSimdShr_I32(endpoints, 8), pfiSimdSet1_I32(0xFF));
+
+    // NOTE: The three bits of an index are read from the 32 bits starting at the byte that contains the first one
+    PFIsimdvi bit = pfiSimdAdd_I32(pfiSimdShl_I32(texels, 1), texels);
+    PFIsimdvi bytes = pfiSimdAdd_I32(blocks, pfiSimdAdd_I32(pfiSimdShr_I32(bit, 3), pfiSimdSet1_I32(2)));
+    PFIsimdvi indices = pfiSimdGather_I32(pixels, bytes, 1);
+    PFIsimdvi index = pfiSimdAnd_I32(pfiSimdShrV_I32(indices, pfiSimdAnd_I32(bit, pfiSimdSet1_I32(0x7))), pfiSimdSet1_I32(0x7));
+
+    PFIsimdvi eightAlphas = pfiSimdCmpGT_I32(a0, a1);
+    PFIsimdvi k = pfiSimdSub_I32(index, pfiSimdSet1_I32(1));
+
+    PFIsimdvi sum7 = pfiSimdAdd_I32(pfiSimdMullo_I32(a0, pfiSimdSub_I32(pfiSimdSet1_I32(7), k)), pfiSimdMullo_I32(a1, k));
+    PFIsimdvi sum5 = pfiSimdAdd_I32(pfiSimdMullo_I32(a0, pfiSimdSub_I32(pfiSimdSet1_I32(5), k)), pfiSimdMullo_I32(a1, k));
+    PFIsimdvi alpha7 = pfiSimdShr_I32(pfiSimdMullo_I32(pfiSimdAdd_I32(sum7, pfiSimdSet1_I32(3)), pfiSimdSet1_I32(9363)), 16);
+    PFIsimdvi alpha5 = pfiSimdShr_I32(pfiSimdMullo_I32(pfiSimdAdd_I32(sum5, pfiSimdSet1_I32(2)), pfiSimdSet1_I32(13108)), 16);
+
+    PFIsimdvi alpha = pfiSimdBlendV_I8(alpha5, alpha7, eightAlphas);
+    alpha = pfiSimdBlendV_I8(alpha, pfiSimdSetZero_I32(), pfiSimdAndNot_I32(eightAlphas, pfiSimdCmpEQ_I32(index, pfiSimdSet1_I32(6))));
+    alpha = pfiSimdBlendV_I8(alpha, pfiSimdSet1_I32(255), pfiSimdAndNot_I32(eightAlphas, pfiSimdCmpEQ_I32(index, pfiSimdSet1_I32(7))));
+    alpha = pfiSimdBlendV_I8(alpha, a0, pfiSimdCmpEQ_I32(index, pfiSimdSetZero_I32()));
+    alpha = pfiSimdBlendV_I8(alpha, a1, pfiSimdCmpEQ_I32(index, pfiSimdSet1_I32(1)));
+
+    return alpha;
+}
+
+static inline PFIsimdvi
+pfiPixelGet_COMPRESSED_BC1_UBYTE_simd(const void* pixels, PFIsimdvi offsets)
+{
+    PFIsimdvi blocks = pfiSimdShl_I32(pfiSimdShr_I32(offsets, 4), 3);
+    PFIsimdvi texels = pfiSimdAnd_I32(offsets, pfiSimdSet1_I32(15));
+    return pfiDecodeColorBlock_BC1_simd(pixels, blocks, texels, PF_FALSE);
+}
+
+static inline PFIsimdvi
+pfiPixelGet_COMPRESSED_BC3_UBYTE_simd(const void* pixels, PFIsimdvi offsets)
+{
+    PFIsimdvi blocks = pfiSimdShl_I32(pfiSimdShr_I32(offsets, 4), 4);
+    PFIsimdvi texels = pfiSimdAnd_I32(offsets, pfiSimdSet1_I32(15));
+
+    PFIsimdvi color = pfiDecodeColorBlock_BC1_simd(pixels, pfiSimdAdd_I32(blocks, pfiSimdSet1_I32(8)), texels, PF_TRUE);
+    PFIsimdvi alpha = pfiDecodeAlphaBlock_BC3_simd(pixels, blocks, texels);
+
+    return pfiSimdOr_I32(pfiSimdAnd_I32(color, pfiSimdSet1_I32(0x00FFFFFF)), pfiSimdShl_I32(alpha, 24));
+}
+
+// NOTE: See 'pfiDecodeTexel_ETC1', the bytes of the base colors and of the control are read
+//       in the little-endian word of the first four bytes, the texel indices are swapped
+static inline PFIsimdvi
+pfiPixelGet_COMPRESSED_ETC1_UBYTE_simd(const void* pixels, PFIsimdvi offsets)
+{
+    PFIsimdvi blocks = pfiSimdShl_I32(pfiSimdShr_I32(offsets, 4), 3);
+    PFIsimdvi header = pfiSimdGather_I32(pixels, blocks, 1);
+    PFIsimdvi swapped = pfiSimdGather_I32(pixels, pfiSimdAdd_I32(blocks, pfiSimdSet1_I32(4)), 1);
+
+    PFIsimdvi byteMask = pfiSimdSet1_I32(0xFF);
+    PFIsimdvi indices = pfiSimdOr_I32(
+        pfiSimdOr_I32(pfiSimdShl_I32(swapped, 24), pfiSimdShl_I32(pfiSimdAnd_I32(swapped, pfiSimdSet1_I32(0xFF00)), 8)),
+        pfiSimdOr_I32(pfiSimdAnd_I32(pfiSimdShr_I32(swapped, 8), pfiSimdSet1_I32(0xFF00)), pfiSimdShr_I32(swapped, 24)));
+
+    PFIsimdvi x = pfiSimdAnd_I32(offsets, pfiSimdSet1_I32(3));
+    PFIsimdvi y = pfiSimdAnd_I32(pfiSimdShr_I32(offsets, 2), pfiSimdSet1_I32(3));
+    PFIsimdvi p = pfiSimdAdd_I32(pfiSimdShl_I32(x, 2), y);
+
+    PFIsimdvi control = pfiSimdShr_I32(header, 24);
+    PFIsimdvi one = pfiSimdSet1_I32(1);
+    PFIsimdvi flip = pfiSimdCmpEQ_I32(pfiSimdAnd_I32(control, one), one);
+    PFIsimdvi differential = pfiSimdCmpEQ_I32(pfiSimdAnd_I32(control, pfiSimdSet1_I32(0x2)), pfiSimdSet1_I32(0x2));
+
+    PFIsimdvi sub = pfiSimdBlendV_I8(pfiSimdShr_I32(x, 1), pfiSimdShr_I32(y, 1), flip);
+    PFIsimdvi second = pfiSimdCmpEQ_I32(sub, one);
+    PFIsimdvi table = pfiSimdAnd_I32(pfiSimdShrV_I32(control, pfiSimdBlendV_I8(pfiSimdSet1_I32(5), pfiSimdSet1_I32(2), second)), pfiSimdSet1_I32(0x7));
+
+    PFIsimdvi low = pfiSimdAnd_I32(pfiSimdShrV_I32(indices, p), one);
+    PFIsimdvi high = pfiSimdAnd_I32(pfiSimdShrV_I32(indices, pfiSimdAdd_I32(p, pfiSimdSet1_I32(16))), one);
+
+    PFIsimdvi modifier = pfiSimdGather_I32(&GC_etc1Modifiers[0][0], pfiSimdAdd_I32(pfiSimdShl_I32(table, 1), low), sizeof(PFint));
+    modifier = pfiSimdBlendV_I8(modifier, pfiSimdNeg_I32(modifier), pfiSimdCmpEQ_I32(high, one));
+
+    PFIsimdvi color = pfiSimdSet1_I32(0xFF000000);
+
+    for (int_fast8_t i = 0; i < 3; i++) {
+        PFIsimdvi byte = pfiSimdAnd_I32(pfiSimdShr_I32(header, 8*i), byteMask);
+
+        PFIsimdvi individual = pfiSimdBlendV_I8(pfiSimdShr_I32(byte, 4), pfiSimdAnd_I32(byte, pfiSimdSet1_I32(0xF)), second);
+        individual = pfiSimdOr_I32(pfiSimdShl_I32(individual, 4), individual);
+
+        PFIsimdvi delta = pfiSimdSub_I32(pfiSimdAnd_I32(byte, pfiSimdSet1_I32(0x7)), pfiSimdShl_I32(pfiSimdAnd_I32(byte, pfiSimdSet1_I32(0x4)), 1));
+        PFIsimdvi c = pfiSimdAnd_I32(pfiSimdAdd_I32(pfiSimdShr_I32(byte, 3), pfiSimdAnd_I32(delta, second)), pfiSimdSet1_I32(0x1F));
+        PFIsimdvi base = pfiSimdBlendV_I8(individual, pfiSimdOr_I32(pfiSimdShl_I32(c, 3), pfiSimdShr_I32(c, 2)), differential);
+
+        PFIsimdvi channel = pfiSimdClamp_I32(pfiSimdAdd_I32(base, modifier), pfiSimdSetZero_I32(), byteMask);
+        color = pfiSimdOr_I32(color, pfiSimdShl_I32(channel, 8*i));
+    }
+
+    return color;
+}
+
 /* Internal helper constant array */
 
 #define ENTRY(FORMAT, TYPE, FUNC) [FORMAT][TYPE] = FUNC
 
-static const PFIpixelgetter_simd GC_pixelGetters_simd[10][12] = {
+static const PFIpixelgetter_simd GC_pixelGetters_simd[14][12] = {
     ENTRY(PF_RED, PF_UNSIGNED_BYTE, pfiPixelGet_RED_UBYTE_simd),
     ENTRY(PF_RED, PF_HALF_FLOAT, pfiPixelGet_RED_HALF_simd),
     ENTRY(PF_RED, PF_FLOAT, pfiPixelGet_RED_FLOAT_simd),
@@ -3089,9 +3451,13 @@ static const PFIpixelgetter_simd GC_pixelGetters_simd[10][12] = {
     ENTRY(PF_BGRA, PF_UNSIGNED_SHORT_4_4_4_4, pfiPixelGet_BGRA_USHORT_4_4_4_4_simd),
     ENTRY(PF_BGRA, PF_HALF_FLOAT, pfiPixelGet_BGRA_HALF_simd),
     ENTRY(PF_BGRA, PF_FLOAT, pfiPixelGet_BGRA_FLOAT_simd),
+
+    ENTRY(PF_COMPRESSED_BC1, PF_UNSIGNED_BYTE, pfiPixelGet_COMPRESSED_BC1_UBYTE_simd),
+    ENTRY(PF_COMPRESSED_BC3, PF_UNSIGNED_BYTE, pfiPixelGet_COMPRESSED_BC3_UBYTE_simd),
+    ENTRY(PF_COMPRESSED_ETC1, PF_UNSIGNED_BYTE, pfiPixelGet_COMPRESSED_ETC1_UBYTE_simd),
 };
 
-static const PFIpixelsetter_simd GC_pixelSetters_simd[10][12] = {
+static const PFIpixelsetter_simd GC_pixelSetters_simd[14][12] = {
     ENTRY(PF_RED, PF_UNSIGNED_BYTE, pfiPixelSet_RED_UBYTE_simd),
     ENTRY(PF_RED, PF_HALF_FLOAT, pfiPixelSet_RED_HALF_simd),
     ENTRY(PF_RED, PF_FLOAT, pfiPixelSet_RED_FLOAT_simd),
@@ -3148,8 +3514,31 @@ static const PFIpixelsetter_simd GC_pixelSetters_simd[10][12] = {
 static inline PFboolean
 pfiIsPixelFormatValid(PFpixelformat mode, PFdatatype type)
 {
+    // NOTE: Not all types are supported by each format, e.g. PF_UNSIGNED_SHORT_5_6_5 is only for PF_RGB/PF_BGR
     return (mode >= PF_RED && mode <= PF_BGRA)
-        && (type >= PF_UNSIGNED_BYTE && type <= PF_DOUBLE);
+        && (type >= PF_UNSIGNED_BYTE && type <= PF_DOUBLE)
+        && GC_pixelGetters[mode][type] && GC_pixelSetters[mode][type];
+}
+
+static inline PFboolean
+pfiIsCompressedFormat(PFpixelformat format)
+{
+    return format >= PF_COMPRESSED_BC1 && format <= PF_COMPRESSED_ETC1;
+}
+
+// NOTE: Formats of texels that can be sampled, but not written (no setters)
+static inline PFboolean
+pfiIsDecodeOnlyFormat(PFpixelformat format)
+{
+    return pfiIsCompressedFormat(format) || format == PF_COLOR_INDEX;
+}
+
+// NOTE: The textures can also be created in the formats that can only be decoded
+static inline PFboolean
+pfiIsTextureFormatValid(PFpixelformat format, PFdatatype type)
+{
+    return pfiIsPixelFormatValid(format, type)
+        || (pfiIsDecodeOnlyFormat(format) && type == PF_UNSIGNED_BYTE);
 }
 
 static inline PFsizei
@@ -3164,6 +3553,7 @@ pfiGetPixelBytes(PFpixelformat format, PFdatatype type)
         case PF_BLUE:
         case PF_ALPHA:
         case PF_LUMINANCE:
+        case PF_COLOR_INDEX:
             components = 1;
             break;
         case PF_LUMINANCE_ALPHA:
@@ -3177,6 +3567,10 @@ pfiGetPixelBytes(PFpixelformat format, PFdatatype type)
         case PF_BGRA:
             components = 4;
             break;
+        case PF_COMPRESSED_BC1:
+        case PF_COMPRESSED_BC3:
+        case PF_COMPRESSED_ETC1:
+            return 0;   // NOTE: The texels of a block are not stored separately
     }
 
     switch (type) {
@@ -3186,11 +3580,12 @@ pfiGetPixelBytes(PFpixelformat format, PFdatatype type)
             break;
         case PF_UNSIGNED_SHORT:
         case PF_SHORT:
+            typeSize = 2;
+            break;
         case PF_UNSIGNED_SHORT_5_6_5:
         case PF_UNSIGNED_SHORT_5_5_5_1:
         case PF_UNSIGNED_SHORT_4_4_4_4:
-            typeSize = 2;
-            break;
+            return 2;   // NOTE: All components are packed in a single 16-bit word
         case PF_UNSIGNED_INT:
         case PF_INT:
             typeSize = 4;
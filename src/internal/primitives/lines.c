@@ -18,6 +18,7 @@
  */
 
 #include "../context/context.h"
+#include "../context/raster.h"
 #include "../color.h"
 #include <stdlib.h>
 
@@ -55,6 +56,9 @@ static void Rasterize_Line_THICK_DEPTH(const PFIvertex* v1, const PFIvertex* v2)
 
 void pfiProcessRasterize_LINE(void)
 {
+    // NOTE: The lines are not binned, so the frame bins must be rasterized first
+    pfiSyncRaster();
+
     // Process vertices
     int_fast8_t processedCounter = 2;
 
@@ -78,6 +82,8 @@ void pfiProcessRasterize_LINE(void)
 
 void pfiProcessRasterize_POLY_LINES(int_fast8_t vertexCount)
 {
+    pfiSyncRaster();
+
     for (int_fast8_t i = 0; i < vertexCount; i++) {
         // Process vertices
         int_fast8_t processedCounter = 2;
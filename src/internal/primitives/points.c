@@ -18,6 +18,7 @@
  */
 
 #include "../context/context.h"
+#include "../context/raster.h"
 #include <stdlib.h>
 
 /* Internal point processing functions declarations */
@@ -34,6 +35,9 @@ static void Rasterize_Point_DEPTH(const PFIvertex* point);
 
 void pfiProcessRasterize_POINT(void)
 {
+    // NOTE: The points are not binned, so the frame bins must be rasterized first
+    pfiSyncRaster();
+
     PFIvertex *processed = G_currentCtx->vertexBuffer;
 
     if (Process_ProjectPoint(processed)) {
@@ -44,6 +48,8 @@ void pfiProcessRasterize_POINT(void)
 
 void pfiProcessRasterize_POLY_POINTS(int_fast8_t vertexCount)
 {
+    pfiSyncRaster();
+
     for (int_fast8_t i = 0; i < vertexCount; i++) {
         PFIvertex *processed = G_currentCtx->vertexBuffer + i;
         if (Process_ProjectPoint(processed)) {
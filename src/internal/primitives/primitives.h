@@ -21,6 +21,10 @@
 #define PF_PRIMITIVES_H
 
 #include "../../pixelforge.h"
+#include "../context/context.h"
+
+// NOTE: Fetches the vertex at the position 'index' of a draw call (see 'pfDrawElements')
+typedef void (*PFIvertexfetchfunc)(const void* data, PFsizei index, PFIvertex* vertex);
 
 void pfiProcessRasterize_POINT(void);
 void pfiProcessRasterize_POLY_POINTS(int_fast8_t vertexCount);
@@ -32,4 +36,10 @@ void pfiProcessRasterize_TRIANGLE(PFface faceToRender);
 void pfiProcessRasterize_TRIANGLE_FAN(PFface faceToRender, int_fast8_t numTriangles);
 void pfiProcessRasterize_TRIANGLE_STRIP(PFface faceToRender, int_fast8_t numTriangles);
 
+// NOTE: Shares the geometry stage of the independent triangles of a large draw call between threads,
+//       then rasterizes them in submission order. Returns PF_FALSE without drawing anything if the
+//       draw call is not eligible (fewer than 'minTriangleCount' triangles, a single thread or a
+//       polygon mode other than PF_FILL), it must then be processed by 'pfiProcessAndRasterize'.
+PFboolean pfiProcessRasterize_TRIANGLES_PARALLEL(PFsizei vertexCount, PFsizei minTriangleCount, PFIvertexfetchfunc fetch, const void* data);
+
 #endif //PF_PRIMITIVES_H
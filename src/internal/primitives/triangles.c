@@ -19,12 +19,20 @@
 
 #include "../lighting/lighting.h"
 #include "../context/context.h"
+#include "../context/raster.h"
+#include "./primitives.h"
+#include "../threadpool.h"
+#include "../sampler.h"
+#include "../config.h"
 #include "../../pfm.h"
 #include "../color.h"
 #include "../blend.h"
 
-#define PF_TRIANGLE_RASTER_BARYCENTRIC  1   ///< Can also use OpenMP (if available) in addition to SIMD support
-#define PF_TRIANGLE_RASTER_SCANLINES    2   ///< Can use OpenMP but not SIMD.
+#include <string.h>
+#include <stddef.h>
+
+#define PF_TRIANGLE_RASTER_BARYCENTRIC  1   ///< Uses SIMD and shares the rows of large triangles between threads
+#define PF_TRIANGLE_RASTER_SCANLINES    2   ///< Doesn't use SIMD nor multiple threads.
 
 #if PF_SIMD_SUPPORT
 #   define PF_TRIANGLE_RASTER_MODE \
@@ -42,14 +50,83 @@ typedef PFIsimdvi (*InterpolateColorSimdFunc)(PFIsimdvi, PFIsimdvi, PFIsimdvi, P
 typedef PFcolor (*InterpolateColorFunc)(PFcolor, PFcolor, PFfloat);
 #endif //PF_RASTER_MODE
 
+// NOTE: Texture unit sampled by the rasterization, its texels are combined with the color
+//       produced by the previous unit, or with the interpolated color for the first one
+typedef struct {
+    struct PFItex *texSrc;
+#if PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_BARYCENTRIC
+    PFItexturesampler_simd texSampler;
+    PFIblendfunc_simd combineFunction;
+#elif PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_SCANLINES
+    PFItexturesampler texSampler;
+    PFIblendfunc combineFunction;
+#endif //PF_RASTER_MODE
+    PFtextureunit unit;                     ///< Unit whose texture coordinates are interpolated
+} PFItextureunitstate;
+
+// NOTE: Context values used by the rasterization of the triangles, the rasterizer only
+//       reads them from here so that it can also be run by the raster thread of the
+//       context, while the context is modified by the next frame (see PF_FRAME_PIPELINING)
+typedef struct {
+    struct PFItex *texDst;
+    PFfloat *zbDst;
+    PFint vpMin[2];
+    PFint vpMax[2];
+    PFshademode shadingMode;
+#if PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_BARYCENTRIC
+    PFIblendfunc_simd blendFunction;
+    PFIdepthfunc_simd depthFunction;
+#elif PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_SCANLINES
+    PFIblendfunc blendFunction;
+    PFIdepthfunc depthFunction;
+#endif //PF_RASTER_MODE
+    PFItextureunitstate textures[2];        ///< Enabled texture units, in order
+    PFint textureCount;                     ///< Number of enabled texture units
+    const PFIlight *lights;                 ///< Lights of the Phong model (NULL if not used)
+    const PFImaterial *materials;           ///< Materials of the front and back faces
+} PFItrianglestate;
+
+// NOTE: State recorded in a frame bin, the lights and materials are copied with it
+typedef struct {
+    PFItrianglestate state;
+    PFImaterial materials[2];
+    PFIlight lights[PF_MAX_LIGHT_STACK];
+    PFint lightCount;
+} PFItrianglestatecmd;
+
+// NOTE: Visible triangle ready to be rasterized, produced by the geometry stage
+typedef struct {
+    PFface faceToRender;
+    PFboolean is3D;
+    PFIvertex vertices[3];
+    PFMvec3 viewPos;
+} PFIsetuptriangle;
+
+// NOTE: Triangle recorded in a frame bin, it is rasterized with the last state recorded before it
+typedef struct {
+    PFsizei stateDistance;                  ///< Number of bytes between the state data and this data
+    PFIsetuptriangle triangle;
+} PFItrianglecmd;
+
 /* Internal triangle processing functions declarations */
 
 static PFboolean Process_ClipPolygonW(PFIvertex* polygon, int_fast8_t* vertexCounter);
 static PFboolean Process_ClipPolygonXYZ(PFIvertex* polygon, int_fast8_t* vertexCounter);
 static PFboolean Process_ProjectAndClipTriangle(PFIvertex* polygon, int_fast8_t* vertexCounter);
+static int_fast8_t Process_Triangle(PFface faceToRender, PFIvertex polygon[PF_MAX_CLIPPED_POLYGON_VERTICES], PFboolean* is3D, PFMvec3 viewPos);
 
 /* Internal triangle rasterizer function declarations */
 
+static PFboolean Rasterize_IsFaceVisible(PFface faceToRender, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3);
+
+static void Rasterize_TriangleState(const PFItrianglestate* state, PFface faceToRender, PFboolean is3D,
+                                    const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3,
+                                    const PFMvec3 viewPos);
+
+static void Rasterize_SubmitTriangle(PFface faceToRender, PFboolean is3D,
+                                     const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3,
+                                     const PFMvec3 viewPos);
+
 static void Rasterize_Triangle(PFface faceToRender, PFboolean is3D,
                                const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3,
                                const PFMvec3 viewPos);
@@ -69,44 +146,10 @@ static void pfiProcessRasterize_TRIANGLE_IMPL(PFface faceToRender, PFIvertex pro
     }
 #endif
 
-    PFboolean lighting = (G_currentCtx->state & PF_LIGHTING) &&
-                         (G_currentCtx->activeLights != NULL);
-
-    int_fast8_t processedCounter = 3;
+    PFboolean is3D;
+    PFMvec3 viewPos;
 
-    // Performs certain operations that must be done before
-    // processing the vertices in case of light management
-
-    PFMvec3 viewPos = { 0 };
-
-    if (lighting) {
-        // Get camera position
-        PFMmat4 invMatView;
-        pfmMat4Invert(invMatView, G_currentCtx->matView);
-        pfmVec3Copy(viewPos, invMatView + 12);
-
-        // Transform normals
-        // And multiply vertex color with diffuse color
-        for (int_fast8_t i = 0; i < processedCounter; i++) {
-            pfmVec3Transform(processed[i].normal, processed[i].normal, G_currentCtx->matNormal);
-            pfmVec3Normalize(processed[i].normal, processed[i].normal); // REVIEW: Only with PF_NORMALIZE state??
-            processed[i].color = pfiBlendMultiplicative(processed[i].color, G_currentCtx->faceMaterial[faceToRender].diffuse);
-
-            if (G_currentCtx->lightingMode == PF_GOURAUD) {
-                PFfloat NdotV = pfmVec3Dot(processed[i].normal, G_currentCtx->matView + 8);
-                processed[i].color = pfiLightingProcess(G_currentCtx->activeLights,
-                    &G_currentCtx->faceMaterial[(NdotV < 0) ? PF_FRONT : PF_BACK],
-                    processed[i].color, viewPos,
-                    processed[i].position,
-                    processed[i].normal);
-            }
-        }
-    }
-
-    // Process vertices
-
-    PFboolean is3D = Process_ProjectAndClipTriangle(processed, &processedCounter);
-    if (processedCounter < 3) return;
+    int_fast8_t processedCounter = Process_Triangle(faceToRender, processed, &is3D, viewPos);
 
     // Rasterize filled triangles
 
@@ -154,6 +197,51 @@ void pfiProcessRasterize_TRIANGLE_STRIP(PFface faceToRender, int_fast8_t numTria
 
 /* Internal triangle processing functions definitions */
 
+// NOTE: Lights, projects and clips the triangle stored in the first three vertices of 'polygon',
+//       returns the number of vertices of the resulting polygon (less than three if it is not visible)
+int_fast8_t Process_Triangle(PFface faceToRender, PFIvertex polygon[PF_MAX_CLIPPED_POLYGON_VERTICES], PFboolean* is3D, PFMvec3 viewPos)
+{
+    PFboolean lighting = (G_currentCtx->state & PF_LIGHTING) &&
+                         (G_currentCtx->activeLights != NULL);
+
+    int_fast8_t processedCounter = 3;
+
+    // Performs certain operations that must be done before
+    // processing the vertices in case of light management
+
+    memset(viewPos, 0, sizeof(PFMvec3));
+
+    if (lighting) {
+        // Get camera position
+        PFMmat4 invMatView;
+        pfmMat4Invert(invMatView, G_currentCtx->matView);
+        pfmVec3Copy(viewPos, invMatView + 12);
+
+        // Transform normals
+        // And multiply vertex color with diffuse color
+        for (int_fast8_t i = 0; i < processedCounter; i++) {
+            pfmVec3Transform(polygon[i].normal, polygon[i].normal, G_currentCtx->matNormal);
+            pfmVec3Normalize(polygon[i].normal, polygon[i].normal); // REVIEW: Only with PF_NORMALIZE state??
+            polygon[i].color = pfiBlendMultiplicative(polygon[i].color, G_currentCtx->faceMaterial[faceToRender].diffuse);
+
+            if (G_currentCtx->lightingMode == PF_GOURAUD) {
+                PFfloat NdotV = pfmVec3Dot(polygon[i].normal, G_currentCtx->matView + 8);
+                polygon[i].color = pfiLightingProcess(G_currentCtx->activeLights,
+                    &G_currentCtx->faceMaterial[(NdotV < 0) ? PF_FRONT : PF_BACK],
+                    polygon[i].color, viewPos,
+                    polygon[i].position,
+                    polygon[i].normal);
+            }
+        }
+    }
+
+    // Process vertices
+
+    *is3D = Process_ProjectAndClipTriangle(polygon, &processedCounter);
+
+    return processedCounter;
+}
+
 PFboolean Process_ClipPolygonW(PFIvertex* polygon, int_fast8_t* vertexCounter)
 {
     PFIvertex input[PF_MAX_CLIPPED_POLYGON_VERTICES];
@@ -267,6 +355,7 @@ PFboolean Process_ProjectAndClipTriangle(PFIvertex* polygon, int_fast8_t* vertex
             polygon[i].homogeneous[2] = 1.0f / polygon[i].homogeneous[2];
             // Division of texture coordinates by the Z axis (perspective correct)
             pfmVec2Scale(polygon[i].texcoord, polygon[i].texcoord, polygon[i].homogeneous[2]);
+            pfmVec2Scale(polygon[i].texcoord1, polygon[i].texcoord1, polygon[i].homogeneous[2]);
             // Division of XY coordinates by weight
             PFfloat invW = 1.0f / polygon[i].homogeneous[3];
             polygon[i].homogeneous[0] *= invW;
@@ -284,13 +373,235 @@ PFboolean Process_ProjectAndClipTriangle(PFIvertex* polygon, int_fast8_t* vertex
 
 #if PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_BARYCENTRIC
 
-void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, const PFMvec3 viewPos)
-{
-    PFsizei xMin, yMin, xMax, yMax;
+/* Triangle rasterization jobs */
+
+// NOTE: Values used to sample the texture of an enabled texture unit (see 'PFItextureunitstate')
+typedef struct {
+    PFIsimdv2f tc1V, tc2V, tc3V;
+    PFboolean texLod;                       ///< Whether the mipmap level is selected for each group of pixels
+    PFfloat texLod2D;                       ///< Level of detail of a "2D" triangle, it doesn't vary
+    PFIsimdv2f tcDxV, tcDyV;                ///< Screen-space derivatives of the interpolated texcoords (before the division by z)
+    PFIsimdv2f texSizeV;
+    struct PFItex *texSrc;
+    PFItexturesampler_simd texSampler;
+    PFIblendfunc_simd combineFunction;
+} PFItrianglejobunit;
+
+// NOTE: Contains everything the rows of the triangle need, the rows
+//       are shared between the threads with 'pfiParallelFor'
+typedef struct {
+    PFboolean is3D;
+    PFsizei xMin, yMin, xMax;
     PFint w1Row, w2Row, w3Row;
     PFint w1XStep, w1YStep;
     PFint w2XStep, w2YStep;
     PFint w3XStep, w3YStep;
+    PFIsimdvi w1XStepV, w2XStepV, w3XStepV;
+    PFIsimdvf wInvSumV;
+    PFIsimdvi c1V, c2V, c3V;
+    PFIsimdv3f p1V, p2V, p3V;
+    PFIsimdv3f n1V, n2V, n3V;
+    PFIsimdvf z1V, z2V, z3V;
+    PFIsimdv3f viewPosV;
+    PFItrianglejobunit units[2];            ///< Enabled texture units, in order
+    PFint unitCount;
+    PFIsimdvf zDxV, zDyV;                   ///< Screen-space derivatives of the interpolated reciprocal depths
+    PFfloat *zbDst;
+    PFIpixelgetter_simd fbGetter;
+    PFIpixelsetter_simd fbSetter;
+    PFsizei widthDst;
+    void *pbDst;
+    InterpolateColorSimdFunc interpolateColor;
+    PFIblendfunc_simd blendFunction;
+    PFIdepthfunc_simd depthFunction;
+    const PFIlight *lights;
+    const PFImaterial *material;
+} PFItrianglejob;
+
+/* Loop macro definition */
+
+#define PF_TRIANGLE_TRAVEL_SIMD(NAME, PIXEL_CODE)                                           \
+static void NAME(void* data, PFint begin, PFint end)                                        \
+{                                                                                           \
+    const PFItrianglejob *job = data;                                                       \
+    PFIsimdvi pixOffsetV = pfiSimdSetR_I32(0, 1, 2, 3, 4, 5, 6, 7);                          \
+    PFsizei xMin = job->xMin, xMax = job->xMax;                                             \
+    PFfloat *zbDst = job->zbDst;                                                            \
+    for (PFsizei y = begin; y < (PFsizei)end; ++y)  {                                       \
+        size_t yOffset = y * job->widthDst;                                                 \
+        PFint w1 = job->w1Row + (y - job->yMin)*job->w1YStep;                               \
+        PFint w2 = job->w2Row + (y - job->yMin)*job->w2YStep;                               \
+        PFint w3 = job->w3Row + (y - job->yMin)*job->w3YStep;                               \
+        for (PFsizei x = xMin; x <= xMax; x += PF_SIMD_SIZE) {                              \
+            /* Load the current barycentric coordinates into SIMD registers */              \
+            PFIsimdvi w1V = pfiSimdAdd_I32(pfiSimdSet1_I32(w1), job->w1XStepV);              \
+            PFIsimdvi w2V = pfiSimdAdd_I32(pfiSimdSet1_I32(w2), job->w2XStepV);              \
+            PFIsimdvi w3V = pfiSimdAdd_I32(pfiSimdSet1_I32(w3), job->w3XStepV);              \
+            /* Test if pixels are inside the triangle */                                    \
+            PFIsimdvi mask = pfiSimdOr_I32(pfiSimdOr_I32(w1V, w2V), w3V);                    \
+            mask = pfiSimdCmpGT_I32(mask, pfiSimdSetZero_I32());                            \
+            /* Bounds check to ensure pixels' x-coords are within the xMax limit */         \
+            /* Used for "2D" rendering; 3D clipping removes these cases. */                 \
+            mask = pfiSimdAnd_I32(mask, pfiSimdCmpLT_I32(                                   \
+                pfiSimdAdd_I32(pfiSimdSet1_I32(x), pixOffsetV), pfiSimdSet1_I32(xMax)));    \
+            /* Normalize weights */                                                         \
+            PFIsimdvf w1NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w1V), job->wInvSumV);  \
+            PFIsimdvf w2NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w2V), job->wInvSumV);  \
+            PFIsimdvf w3NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w3V), job->wInvSumV);  \
+            /* Compute Z-Depth values */                                                    \
+            PFIsimdvf zV; {                                                                  \
+                PFIsimdvf wZ1 = pfiSimdMul_F32(job->z1V, w1NormV);                           \
+                PFIsimdvf wZ2 = pfiSimdMul_F32(job->z2V, w2NormV);                           \
+                PFIsimdvf wZ3 = pfiSimdMul_F32(job->z3V, w3NormV);                           \
+                zV = pfiSimdAdd_F32(pfiSimdAdd_F32(wZ1, wZ2), wZ3);                         \
+                zV = pfiSimdRCP_F32(zV);                                                    \
+            }                                                                               \
+            /* Depth Testing */                                                             \
+            PFIsimdvf depths = pfiSimdLoad_F32(zbDst + yOffset + x);                         \
+            if (job->depthFunction)  {                                                      \
+                mask = pfiSimdAnd_I32(mask, pfiSimdCast_F32_I32(                            \
+                    job->depthFunction(zV, depths)));                                       \
+            }                                                                               \
+            /* Run the pixel code! */                                                       \
+            PIXEL_CODE                                                                      \
+            /* Increment the barycentric coordinates for the next pixels */                 \
+            w1 += PF_SIMD_SIZE*job->w1XStep;                                                \
+            w2 += PF_SIMD_SIZE*job->w2XStep;                                                \
+            w3 += PF_SIMD_SIZE*job->w3XStep;                                                \
+        }                                                                                   \
+    }                                                                                       \
+}
+
+/* Texture level of detail */
+
+// NOTE: Returns the level of detail of the texels of a group of pixels, from the largest derivative of
+//       their texcoords. With a perspective division, the derivative of 'u = Q/P' is '(dQ - u*dP)/P',
+//       where 'Q' and 'P' are the interpolated texcoords and reciprocal depths, linear on screen
+static inline PFfloat
+Rasterize_GetTextureLod(const PFItrianglejob* job, const PFItrianglejobunit* unit, const PFIsimdv2f texcoords, PFIsimdvf zV, PFIsimdvi mask)
+{
+    if (!job->is3D) return unit->texLod2D;
+
+    PFIsimdvf rho2X = pfiSimdSetZero_F32(), rho2Y = pfiSimdSetZero_F32();
+
+    for (int_fast8_t i = 0; i < 2; i++) {
+        PFIsimdvf dX = pfiSimdMul_F32(pfiSimdSub_F32(unit->tcDxV[i], pfiSimdMul_F32(texcoords[i], job->zDxV)), zV);
+        PFIsimdvf dY = pfiSimdMul_F32(pfiSimdSub_F32(unit->tcDyV[i], pfiSimdMul_F32(texcoords[i], job->zDyV)), zV);
+        dX = pfiSimdMul_F32(dX, unit->texSizeV[i]);
+        dY = pfiSimdMul_F32(dY, unit->texSizeV[i]);
+        rho2X = pfiSimdAdd_F32(rho2X, pfiSimdMul_F32(dX, dX));
+        rho2Y = pfiSimdAdd_F32(rho2Y, pfiSimdMul_F32(dY, dY));
+    }
+
+    // NOTE: The group uses the level of its most minified pixel, like the 2x2 quads of a GPU
+    PFIsimdvf rho2V = pfiSimdAnd_F32(pfiSimdMax_F32(rho2X, rho2Y), pfiSimdCast_I32_F32(mask));
+
+    PFfloat rho2[PF_SIMD_SIZE], rho2Max = 0.0f;
+    pfiSimdStore_F32(rho2, rho2V);
+
+    for (int_fast8_t i = 0; i < PF_SIMD_SIZE; i++) {
+        rho2Max = PF_MAX(rho2Max, rho2[i]);
+    }
+
+    return pfiTexture2DComputeLod(rho2Max);
+}
+
+/* Processing macro definitions */
+
+#define GET_FRAG() \
+    PFIsimdvi fragments = job->interpolateColor( \
+        job->c1V, job->c2V, job->c3V, w1NormV, w2NormV, w3NormV);
+
+#define TEXTURING(UNIT) \
+{ \
+    const PFItrianglejobunit *unit = &job->units[UNIT]; \
+    PFIsimdv2f texcoords, zeroV2; pfiVec2Zero_simd(zeroV2); \
+    pfiVec2BaryInterpSmoothR_simd(texcoords, unit->tc1V, unit->tc2V, unit->tc3V, w1NormV, w2NormV, w3NormV); \
+    if (job->is3D) pfiVec2Scale_simd(texcoords, texcoords, zV); /* Perspective correct */ \
+    pfiVec2Blend_simd(texcoords, zeroV2, texcoords, pfiSimdCast_I32_F32(mask)); \
+    PFIsimdvi texels = unit->texLod \
+        ? pfiTexture2DSampleLod_simd(unit->texSrc, texcoords, Rasterize_GetTextureLod(job, unit, texcoords, zV, mask)) \
+        : unit->texSampler(unit->texSrc, texcoords); \
+    fragments = unit->combineFunction(texels, fragments); \
+}
+
+#define LIGHTING() \
+{ \
+    PFIsimdv3f normals, positions; \
+    pfiVec3BaryInterpSmoothR_simd(normals, job->n1V, job->n2V, job->n3V, w1NormV, w2NormV, w3NormV); \
+    pfiVec3BaryInterpSmoothR_simd(positions, job->p1V, job->p2V, job->p3V, w1NormV, w2NormV, w3NormV); \
+    fragments = pfiSimdLightingProcess(fragments, job->lights, job->material, job->viewPosV, positions, normals); \
+}
+
+#define SET_FRAG() \
+    if (job->blendFunction) { \
+        PFIsimdvi dstCol = job->fbGetter(job->pbDst, pfiSimdAdd_I32(pfiSimdSet1_I32(yOffset + x), pixOffsetV)); \
+        fragments = job->blendFunction(fragments, dstCol); \
+    } \
+    job->fbSetter(job->pbDst, yOffset + x, fragments, mask); \
+    pfiSimdStore_F32(zbDst + yOffset + x, pfiSimdBlendV_F32(depths, zV, pfiSimdCast_I32_F32(mask)));
+
+/* Row rasterization jobs */
+
+PF_TRIANGLE_TRAVEL_SIMD(Rasterize_TriangleRows_MULTITEXTURE_LIGHT, {
+    GET_FRAG();
+    TEXTURING(0);
+    TEXTURING(1);
+    LIGHTING();
+    SET_FRAG();
+})
+
+PF_TRIANGLE_TRAVEL_SIMD(Rasterize_TriangleRows_MULTITEXTURE, {
+    GET_FRAG();
+    TEXTURING(0);
+    TEXTURING(1);
+    SET_FRAG();
+})
+
+PF_TRIANGLE_TRAVEL_SIMD(Rasterize_TriangleRows_TEXTURE_LIGHT, {
+    GET_FRAG();
+    TEXTURING(0);
+    LIGHTING();
+    SET_FRAG();
+})
+
+PF_TRIANGLE_TRAVEL_SIMD(Rasterize_TriangleRows_TEXTURE, {
+    GET_FRAG();
+    TEXTURING(0);
+    SET_FRAG();
+})
+
+PF_TRIANGLE_TRAVEL_SIMD(Rasterize_TriangleRows_LIGHT, {
+    GET_FRAG();
+    LIGHTING();
+    SET_FRAG();
+})
+
+PF_TRIANGLE_TRAVEL_SIMD(Rasterize_TriangleRows, {
+    GET_FRAG();
+    SET_FRAG();
+})
+
+/* Triangle rasterization functions */
+
+PFboolean Rasterize_IsFaceVisible(PFface faceToRender, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3)
+{
+    PFint x1 = (PFint)v1->screen[0], y1 = (PFint)v1->screen[1];
+    PFint x2 = (PFint)v2->screen[0], y2 = (PFint)v2->screen[1];
+    PFint x3 = (PFint)v3->screen[0], y3 = (PFint)v3->screen[1];
+
+    PFfloat signedArea = (x2 - x1)*(y3 - y1) - (x3 - x1)*(y2 - y1);
+
+    return !((faceToRender == PF_FRONT && signedArea >= 0)
+          || (faceToRender == PF_BACK  && signedArea <= 0));
+}
+
+void Rasterize_TriangleState(const PFItrianglestate* state, PFface faceToRender, PFboolean is3D, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, const PFMvec3 viewPos)
+{
+    PFItrianglejob job;
+    job.is3D = is3D;
+
+    PFsizei xMin, yMin, xMax, yMax;
     {
         /* Get integer 2D position coordinates */
 
@@ -298,15 +609,6 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
         PFint x2 = (PFint)v2->screen[0], y2 = (PFint)v2->screen[1];
         PFint x3 = (PFint)v3->screen[0], y3 = (PFint)v3->screen[1];
 
-        /* Check if the desired face can be rendered */
-
-        PFfloat signedArea = (x2 - x1)*(y3 - y1) - (x3 - x1)*(y2 - y1);
-
-        if ((faceToRender == PF_FRONT && signedArea >= 0)
-         || (faceToRender == PF_BACK  && signedArea <= 0)) {
-            return;
-        }
-
         /* Calculate the 2D bounding box of the triangle */
 
         xMin = (PFsizei)PF_MIN(x1, PF_MIN(x2, x3));
@@ -315,17 +617,19 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
         yMax = (PFsizei)PF_MAX(y1, PF_MAX(y2, y3));
 
         if (!is3D) {
-            xMin = (PFsizei)PF_CLAMP((PFint)xMin, G_currentCtx->vpMin[0], G_currentCtx->vpMax[0]);
-            yMin = (PFsizei)PF_CLAMP((PFint)yMin, G_currentCtx->vpMin[1], G_currentCtx->vpMax[1]);
-            xMax = (PFsizei)PF_CLAMP((PFint)xMax, G_currentCtx->vpMin[0], G_currentCtx->vpMax[0]);
-            yMax = (PFsizei)PF_CLAMP((PFint)yMax, G_currentCtx->vpMin[1], G_currentCtx->vpMax[1]);
+            xMin = (PFsizei)PF_CLAMP((PFint)xMin, state->vpMin[0], state->vpMax[0]);
+            yMin = (PFsizei)PF_CLAMP((PFint)yMin, state->vpMin[1], state->vpMax[1]);
+            xMax = (PFsizei)PF_CLAMP((PFint)xMax, state->vpMin[0], state->vpMax[0]);
+            yMax = (PFsizei)PF_CLAMP((PFint)yMax, state->vpMin[1], state->vpMax[1]);
         }
 
+        job.xMin = xMin, job.yMin = yMin, job.xMax = xMax;
+
         /* Barycentric interpolation */
 
-        w1XStep = y3 - y2, w1YStep = x2 - x3;
-        w2XStep = y1 - y3, w2YStep = x3 - x1;
-        w3XStep = y2 - y1, w3YStep = x1 - x2;
+        PFint w1XStep = y3 - y2, w1YStep = x2 - x3;
+        PFint w2XStep = y1 - y3, w2YStep = x3 - x1;
+        PFint w3XStep = y2 - y1, w3YStep = x1 - x2;
 
         if (faceToRender == PF_BACK) {
             w1XStep = -w1XStep, w1YStep = -w1YStep;
@@ -333,242 +637,179 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
             w3XStep = -w3XStep, w3YStep = -w3YStep;
         }
 
-        w1Row = (xMin - x2)*w1XStep + w1YStep*(yMin - y2);
-        w2Row = (xMin - x3)*w2XStep + w2YStep*(yMin - y3);
-        w3Row = (xMin - x1)*w3XStep + w3YStep*(yMin - y1);
+        job.w1XStep = w1XStep, job.w1YStep = w1YStep;
+        job.w2XStep = w2XStep, job.w2YStep = w2YStep;
+        job.w3XStep = w3XStep, job.w3YStep = w3YStep;
+
+        job.w1Row = (xMin - x2)*w1XStep + w1YStep*(yMin - y2);
+        job.w2Row = (xMin - x3)*w2XStep + w2YStep*(yMin - y3);
+        job.w3Row = (xMin - x1)*w3XStep + w3YStep*(yMin - y1);
     }
 
     // Vector constants
     PFIsimdvi pixOffsetV = pfiSimdSetR_I32(0, 1, 2, 3, 4, 5, 6, 7);
-    PFIsimdvi w1XStepV = pfiSimdMullo_I32(pfiSimdSet1_I32(w1XStep), pixOffsetV);
-    PFIsimdvi w2XStepV = pfiSimdMullo_I32(pfiSimdSet1_I32(w2XStep), pixOffsetV);
-    PFIsimdvi w3XStepV = pfiSimdMullo_I32(pfiSimdSet1_I32(w3XStep), pixOffsetV);
+    job.w1XStepV = pfiSimdMullo_I32(pfiSimdSet1_I32(job.w1XStep), pixOffsetV);
+    job.w2XStepV = pfiSimdMullo_I32(pfiSimdSet1_I32(job.w2XStep), pixOffsetV);
+    job.w3XStepV = pfiSimdMullo_I32(pfiSimdSet1_I32(job.w3XStep), pixOffsetV);
 
     // Calculate the reciprocal of the sum of the barycentric coordinates for normalization
     // NOTE: This sum remains constant throughout the triangle
-    PFIsimdvf wInvSumV = pfiSimdSet1_F32(1.0f/(w1Row + w2Row + w3Row));
+    job.wInvSumV = pfiSimdSet1_F32(1.0f/(job.w1Row + job.w2Row + job.w3Row));
 
     // Load vertices data into SIMD registers
-    PFIsimdvi c1V = pfiColorLoad_simd(v1->color);
-    PFIsimdvi c2V = pfiColorLoad_simd(v2->color);
-    PFIsimdvi c3V = pfiColorLoad_simd(v3->color);
+    job.c1V = pfiColorLoad_simd(v1->color);
+    job.c2V = pfiColorLoad_simd(v2->color);
+    job.c3V = pfiColorLoad_simd(v3->color);
 
-    PFIsimdv3f p1V, p2V, p3V;
-    pfiVec3Load_simd(p1V, v1->position);
-    pfiVec3Load_simd(p2V, v2->position);
-    pfiVec3Load_simd(p3V, v3->position);
+    pfiVec3Load_simd(job.p1V, v1->position);
+    pfiVec3Load_simd(job.p2V, v2->position);
+    pfiVec3Load_simd(job.p3V, v3->position);
 
-    PFIsimdv3f n1V, n2V, n3V;
-    pfiVec3Load_simd(n1V, v1->normal);
-    pfiVec3Load_simd(n2V, v2->normal);
-    pfiVec3Load_simd(n3V, v3->normal);
-
-    PFIsimdv2f tc1V, tc2V, tc3V;
-    pfiVec2Load_simd(tc1V, v1->texcoord);
-    pfiVec2Load_simd(tc2V, v2->texcoord);
-    pfiVec2Load_simd(tc3V, v3->texcoord);
+    pfiVec3Load_simd(job.n1V, v1->normal);
+    pfiVec3Load_simd(job.n2V, v2->normal);
+    pfiVec3Load_simd(job.n3V, v3->normal);
 
     /* Get some contextual values */
 
-    struct PFItex *texDst = G_currentCtx->currentFramebuffer->texture;
-    struct PFItex *texSrc = G_currentCtx->currentTexture;
+    struct PFItex *texDst = state->texDst;
 
-    PFfloat *zbDst = G_currentCtx->currentFramebuffer->zbuffer;
+    job.zbDst = state->zbDst;
 
-    PFIpixelgetter_simd fbGetter = texDst->getterSimd;
-    PFIpixelsetter_simd fbSetter = texDst->setterSimd;
-    PFsizei widthDst = texDst->w;
-    void *pbDst = texDst->pixels;
+    job.fbGetter = texDst->getterSimd;
+    job.fbSetter = texDst->setterSimd;
+    job.widthDst = texDst->w;
+    job.pbDst = texDst->pixels;
 
-    PFIsimdvf z1V = pfiSimdSet1_F32(v1->homogeneous[2]);
-    PFIsimdvf z2V = pfiSimdSet1_F32(v2->homogeneous[2]);
-    PFIsimdvf z3V = pfiSimdSet1_F32(v3->homogeneous[2]);
+    job.z1V = pfiSimdSet1_F32(v1->homogeneous[2]);
+    job.z2V = pfiSimdSet1_F32(v2->homogeneous[2]);
+    job.z3V = pfiSimdSet1_F32(v3->homogeneous[2]);
 
-    PFIsimdv3f viewPosV;
-    pfiVec3Load_simd(viewPosV, viewPos);
+    pfiVec3Load_simd(job.viewPosV, viewPos);
 
-    InterpolateColorSimdFunc interpolateColor = (G_currentCtx->shadingMode == PF_SMOOTH)
+    job.interpolateColor = (state->shadingMode == PF_SMOOTH)
         ? pfiColorBarySmooth_simd : pfiColorBaryFlat_simd;
 
-    PFIblendfunc_simd blendFunction = (G_currentCtx->state & PF_BLEND) ? G_currentCtx->blendSimdFunction : NULL;
-    PFIdepthfunc_simd depthFunction = (G_currentCtx->state & PF_DEPTH_TEST) ? G_currentCtx->depthSimdFunction : NULL;
-    PFItexturesampler_simd texSampler = ((G_currentCtx->state & PF_TEXTURE_2D) && texSrc) ? texSrc->samplerSimd : NULL;
-    const PFIlight *lights = ((G_currentCtx->state & PF_LIGHTING) && G_currentCtx->lightingMode == PF_PHONG) ? G_currentCtx->activeLights : NULL;
-
-    /* Loop macro definition */
-
-#ifdef _OPENMP
-#define PF_TRIANGLE_TRAVEL_SIMD(PIXEL_CODE)                                                 \
-    _Pragma("omp parallel for schedule(dynamic, PF_OPENMP_TRIANGLE_ROW_PER_THREAD)          \
-        if((yMax - yMin)*(xMax - xMin) >= PF_OPENMP_RASTER_THRESHOLD_AREA)")                \
-    for (PFsizei y = yMin; y <= yMax; ++y)  {                                               \
-        size_t yOffset = y * widthDst;                                                      \
-        PFint w1 = w1Row + (y - yMin)*w1YStep;                                              \
-        PFint w2 = w2Row + (y - yMin)*w2YStep;                                              \
-        PFint w3 = w3Row + (y - yMin)*w3YStep;                                              \
-        for (PFsizei x = xMin; x <= xMax; x += PF_SIMD_SIZE) {                              \
-            /* Load the current barycentric coordinates into SIMD registers */              \
-            PFIsimdvi w1V = pfiSimdAdd_I32(pfiSimdSet1_I32(w1), w1XStepV);                   \
-            PFIsimdvi w2V = pfiSimdAdd_I32(pfiSimdSet1_I32(w2), w2XStepV);                   \
-            PFIsimdvi w3V = pfiSimdAdd_I32(pfiSimdSet1_I32(w3), w3XStepV);                   \
-            /* Test if pixels are inside the triangle */                                    \
-            PFIsimdvi mask = pfiSimdOr_I32(pfiSimdOr_I32(w1V, w2V), w3V);                    \
-            mask = pfiSimdCmpGT_I32(mask, pfiSimdSetZero_I32());                            \
-            /* Bounds check to ensure pixels' x-coords are within the xMax limit */         \
-            /* Used for "2D" rendering; 3D clipping removes these cases. */                 \
-            mask = pfiSimdAnd_I32(mask, pfiSimdCmpLT_I32(                                   \
-                pfiSimdAdd_I32(pfiSimdSet1_I32(x), pixOffsetV), pfiSimdSet1_I32(xMax)));    \
-            /* Normalize weights */                                                         \
-            PFIsimdvf w1NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w1V), wInvSumV);       \
-            PFIsimdvf w2NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w2V), wInvSumV);       \
-            PFIsimdvf w3NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w3V), wInvSumV);       \
-            /* Compute Z-Depth values */                                                    \
-            PFIsimdvf zV; {                                                                  \
-                PFIsimdvf wZ1 = pfiSimdMul_F32(z1V, w1NormV);                                \
-                PFIsimdvf wZ2 = pfiSimdMul_F32(z2V, w2NormV);                                \
-                PFIsimdvf wZ3 = pfiSimdMul_F32(z3V, w3NormV);                                \
-                zV = pfiSimdAdd_F32(pfiSimdAdd_F32(wZ1, wZ2), wZ3);                         \
-                zV = pfiSimdRCP_F32(zV);                                                    \
-            }                                                                               \
-            /* Depth Testing */                                                             \
-            PFIsimdvf depths = pfiSimdLoad_F32(zbDst + yOffset + x);                         \
-            if (depthFunction)  {                                                           \
-                mask = pfiSimdAnd_I32(mask, pfiSimdCast_F32_I32(                            \
-                    depthFunction(zV, depths)));                                            \
-            }                                                                               \
-            /* Run the pixel code! */                                                       \
-            PIXEL_CODE                                                                      \
-            /* Increment the barycentric coordinates for the next pixels */                 \
-            w1 += PF_SIMD_SIZE*w1XStep;                                                     \
-            w2 += PF_SIMD_SIZE*w2XStep;                                                     \
-            w3 += PF_SIMD_SIZE*w3XStep;                                                     \
-        }                                                                                   \
-    }
-#else
-#define PF_TRIANGLE_TRAVEL_SIMD(PIXEL_CODE)                                                 \
-    for (PFsizei y = yMin; y <= yMax; ++y) {                                                \
-        size_t yOffset = y * widthDst;                                                      \
-        int w1 = w1Row;                                                                     \
-        int w2 = w2Row;                                                                     \
-        int w3 = w3Row;                                                                     \
-        for (PFsizei x = xMin; x <= xMax; x += PF_SIMD_SIZE) {                              \
-            /* Load the current barycentric coordinates into SIMD registers */              \
-            PFIsimdvi w1V = pfiSimdAdd_I32(pfiSimdSet1_I32(w1), w1XStepV);                   \
-            PFIsimdvi w2V = pfiSimdAdd_I32(pfiSimdSet1_I32(w2), w2XStepV);                   \
-            PFIsimdvi w3V = pfiSimdAdd_I32(pfiSimdSet1_I32(w3), w3XStepV);                   \
-            /* Test if pixels are inside the triangle */                                    \
-            PFIsimdvi mask = pfiSimdOr_I32(pfiSimdOr_I32(w1V, w2V), w3V);                    \
-            mask = pfiSimdCmpGT_I32(mask, pfiSimdSetZero_I32());                            \
-            /* Bounds check to ensure pixels' x-coords are within the xMax limit */         \
-            /* Used for "2D" rendering; 3D clipping removes these cases. */                 \
-            mask = pfiSimdAnd_I32(mask, pfiSimdCmpLT_I32(                                   \
-                pfiSimdAdd_I32(pfiSimdSet1_I32(x), pixOffsetV), pfiSimdSet1_I32(xMax)));    \
-            /* Normalize weights */                                                         \
-            PFIsimdvf w1NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w1V), wInvSumV);       \
-            PFIsimdvf w2NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w2V), wInvSumV);       \
-            PFIsimdvf w3NormV = pfiSimdMul_F32(pfiSimdConvert_I32_F32(w3V), wInvSumV);       \
-            /* Compute Z-Depth values */                                                    \
-            PFIsimdvf zV; {                                                                  \
-                PFIsimdvf wZ1 = pfiSimdMul_F32(z1V, w1NormV);                                \
-                PFIsimdvf wZ2 = pfiSimdMul_F32(z2V, w2NormV);                                \
-                PFIsimdvf wZ3 = pfiSimdMul_F32(z3V, w3NormV);                                \
-                zV = pfiSimdAdd_F32(pfiSimdAdd_F32(wZ1, wZ2), wZ3);                         \
-                zV = pfiSimdRCP_F32(zV);                                                    \
-            }                                                                               \
-            /* Depth Testing */                                                             \
-            PFIsimdvf depths = pfiSimdLoad_F32(zbDst + yOffset + x);                         \
-            if (depthFunction) {                                                            \
-                mask = pfiSimdAnd_I32(mask, pfiSimdCast_F32_I32(                            \
-                    depthFunction(zV, depths)));                                            \
-            }                                                                               \
-            /* Run the pixel code! */                                                       \
-            PIXEL_CODE                                                                      \
-            /* Increment the barycentric coordinates for the next pixels */                 \
-            w1 += PF_SIMD_SIZE*w1XStep;                                                     \
-            w2 += PF_SIMD_SIZE*w2XStep;                                                     \
-            w3 += PF_SIMD_SIZE*w3XStep;                                                     \
-        }                                                                                   \
-        /* Move to the next row in the bounding box */                                      \
-        w1Row += w1YStep;                                                                   \
-        w2Row += w2YStep;                                                                   \
-        w3Row += w3YStep;                                                                   \
-    }
-#endif
+    // Load the texcoords of the enabled texture units, with
+    // the derivatives used to select their mipmap levels
+    PFfloat wInvSum = 1.0f/(job.w1Row + job.w2Row + job.w3Row);
+    PFfloat w1Dx = job.w1XStep*wInvSum, w2Dx = job.w2XStep*wInvSum, w3Dx = job.w3XStep*wInvSum;
+    PFfloat w1Dy = job.w1YStep*wInvSum, w2Dy = job.w2YStep*wInvSum, w3Dy = job.w3YStep*wInvSum;
 
-    /* Processing macro definitions */
-
-#   define GET_FRAG() \
-        PFIsimdvi fragments = interpolateColor( \
-            c1V, c2V, c3V, w1NormV, w2NormV, w3NormV);
-
-#   define TEXTURING() \
-        PFIsimdv2f texcoords; \
-        { \
-            PFIsimdv2f zeroV2; pfiVec2Zero_simd(zeroV2); \
-            pfiVec2BaryInterpSmoothR_simd(texcoords, tc1V, tc2V, tc3V, w1NormV, w2NormV, w3NormV); \
-            if (is3D) pfiVec2Scale_simd(texcoords, texcoords, zV); /* Perspective correct */ \
-            pfiVec2Blend_simd(texcoords, zeroV2, texcoords, pfiSimdCast_I32_F32(mask)); \
-            PFIsimdvi texels = texSampler(texSrc, texcoords); \
-            fragments = pfiBlendMultiplicative_simd(texels, fragments); \
-        }
+    job.zDxV = pfiSimdSet1_F32(w1Dx*v1->homogeneous[2] + w2Dx*v2->homogeneous[2] + w3Dx*v3->homogeneous[2]);
+    job.zDyV = pfiSimdSet1_F32(w1Dy*v1->homogeneous[2] + w2Dy*v2->homogeneous[2] + w3Dy*v3->homogeneous[2]);
+
+    job.unitCount = state->textureCount;
+
+    for (PFint u = 0; u < state->textureCount; u++) {
+        const PFItextureunitstate *texture = &state->textures[u];
+        PFItrianglejobunit *unit = &job.units[u];
+
+        const PFMvec2_cptr uv1 = (texture->unit == PF_TEXTURE1) ? v1->texcoord1 : v1->texcoord;
+        const PFMvec2_cptr uv2 = (texture->unit == PF_TEXTURE1) ? v2->texcoord1 : v2->texcoord;
+        const PFMvec2_cptr uv3 = (texture->unit == PF_TEXTURE1) ? v3->texcoord1 : v3->texcoord;
+
+        pfiVec2Load_simd(unit->tc1V, uv1);
+        pfiVec2Load_simd(unit->tc2V, uv2);
+        pfiVec2Load_simd(unit->tc3V, uv3);
+
+        unit->texSrc = texture->texSrc;
+        unit->texSampler = texture->texSampler;
+        unit->combineFunction = texture->combineFunction;
+        unit->texLod = unit->texSrc->mipmapCount > 0 && pfiIsMipmapFilter(unit->texSrc->filter);
+
+        if (unit->texLod) {
+            PFMvec2 tcDx, tcDy, texSize = { (PFfloat)unit->texSrc->w, (PFfloat)unit->texSrc->h };
+            for (int_fast8_t i = 0; i < 2; i++) {
+                tcDx[i] = w1Dx*uv1[i] + w2Dx*uv2[i] + w3Dx*uv3[i];
+                tcDy[i] = w1Dy*uv1[i] + w2Dy*uv2[i] + w3Dy*uv3[i];
+            }
+
+            pfiVec2Load_simd(unit->tcDxV, tcDx);
+            pfiVec2Load_simd(unit->tcDyV, tcDy);
+            pfiVec2Load_simd(unit->texSizeV, texSize);
 
-#   define LIGHTING() \
-    { \
-        PFIsimdv3f normals, positions; \
-        pfiVec3BaryInterpSmoothR_simd(normals, n1V, n2V, n3V, w1NormV, w2NormV, w3NormV); \
-        pfiVec3BaryInterpSmoothR_simd(positions, p1V, p2V, p3V, w1NormV, w2NormV, w3NormV); \
-        fragments = pfiSimdLightingProcess(fragments, lights, &G_currentCtx->faceMaterial[faceToRender], viewPosV, positions, normals); \
+            // NOTE: The texcoords of a "2D" triangle are not divided by z, their derivatives are constant
+            PFfloat rho2X = tcDx[0]*tcDx[0]*texSize[0]*texSize[0] + tcDx[1]*tcDx[1]*texSize[1]*texSize[1];
+            PFfloat rho2Y = tcDy[0]*tcDy[0]*texSize[0]*texSize[0] + tcDy[1]*tcDy[1]*texSize[1]*texSize[1];
+            unit->texLod2D = pfiTexture2DComputeLod(PF_MAX(rho2X, rho2Y));
+        }
     }
 
-#   define SET_FRAG() \
-        if (blendFunction) { \
-            PFIsimdvi dstCol = fbGetter(pbDst, pfiSimdAdd_I32(pfiSimdSet1_I32(yOffset + x), pixOffsetV)); \
-            fragments = blendFunction(fragments, dstCol); \
-        } \
-        fbSetter(pbDst, yOffset + x, fragments, mask); \
-        pfiSimdStore_F32(zbDst + yOffset + x, pfiSimdBlendV_F32(depths, zV, pfiSimdCast_I32_F32(mask)));
+    job.blendFunction = state->blendFunction;
+    job.depthFunction = state->depthFunction;
+    job.lights = state->lights;
+    job.material = &state->materials[faceToRender];
 
     /* Loop rasterization */
 
-    if (texSampler && lights) {
-        PF_TRIANGLE_TRAVEL_SIMD({
-            GET_FRAG();
-            TEXTURING();
-            LIGHTING();
-            SET_FRAG();
-        })
-    } else if (texSampler) {
-        PF_TRIANGLE_TRAVEL_SIMD({
-            GET_FRAG();
-            TEXTURING();
-            SET_FRAG();
-        })
-    } else if (lights) {
-        PF_TRIANGLE_TRAVEL_SIMD({
-            GET_FRAG();
-            LIGHTING();
-            SET_FRAG();
-        })
-    } else {
-        PF_TRIANGLE_TRAVEL_SIMD({
-            GET_FRAG();
-            SET_FRAG();
-        })
+    PFjobfunc rasterizeRows = Rasterize_TriangleRows;
+
+    if (job.unitCount == 2) {
+        rasterizeRows = job.lights
+            ? Rasterize_TriangleRows_MULTITEXTURE_LIGHT
+            : Rasterize_TriangleRows_MULTITEXTURE;
+    } else if (job.unitCount == 1) {
+        rasterizeRows = job.lights
+            ? Rasterize_TriangleRows_TEXTURE_LIGHT
+            : Rasterize_TriangleRows_TEXTURE;
+    } else if (job.lights) {
+        rasterizeRows = Rasterize_TriangleRows_LIGHT;
     }
+
+    pfiParallelForIf((yMax - yMin)*(xMax - xMin) >= PF_PARALLEL_RASTER_THRESHOLD_AREA,
+                     yMin, yMax + 1, PF_PARALLEL_TRIANGLE_ROWS_PER_JOB, rasterizeRows, &job);
 }
 
 #else // PF_TRIANGLE_RASTER_MODE == PR_TRIANGLE_RASTER_SCANLINES
 
-void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, const PFMvec3 viewPos)
+// NOTE: Gets the screen-space gradients of the texcoords and of the reciprocal depth of the triangle,
+//       which are linear on screen, the texcoords of a 3D triangle being multiplied by its reciprocal depth
+static void Rasterize_GetTextureGradients(const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, PFtextureunit unit, PFMvec3 dX, PFMvec3 dY)
 {
-    /* Check if the face can be rendered, if not, skip */
-    {
-        PFfloat signedArea = pfmGeo2DSignedTriangleArea(v1->screen, v2->screen, v3->screen);
-        if ((faceToRender == PF_FRONT && signedArea > 0) || (faceToRender == PF_BACK && signedArea < 0)) {
-            return;
-        }
+    PFfloat x21 = v2->screen[0] - v1->screen[0], y21 = v2->screen[1] - v1->screen[1];
+    PFfloat x31 = v3->screen[0] - v1->screen[0], y31 = v3->screen[1] - v1->screen[1];
+
+    PFfloat det = x21*y31 - x31*y21;
+    PFfloat invDet = (det != 0.0f) ? 1.0f/det : 0.0f;
+
+    const PFMvec2_cptr uv1 = (unit == PF_TEXTURE1) ? v1->texcoord1 : v1->texcoord;
+    const PFMvec2_cptr uv2 = (unit == PF_TEXTURE1) ? v2->texcoord1 : v2->texcoord;
+    const PFMvec2_cptr uv3 = (unit == PF_TEXTURE1) ? v3->texcoord1 : v3->texcoord;
+
+    for (int_fast8_t i = 0; i < 3; i++) {
+        PFfloat a1 = (i < 2) ? uv1[i] : v1->homogeneous[2];
+        PFfloat a2 = (i < 2) ? uv2[i] : v2->homogeneous[2];
+        PFfloat a3 = (i < 2) ? uv3[i] : v3->homogeneous[2];
+        dX[i] = ((a2 - a1)*y31 - (a3 - a1)*y21)*invDet;
+        dY[i] = ((a3 - a1)*x21 - (a2 - a1)*x31)*invDet;
+    }
+}
+
+// NOTE: Returns the level of detail of the texel of a pixel from the largest derivative of its texcoords,
+//       with a perspective division the derivative of 'u = Q/P' is '(dQ - u*dP)/P' (see 'Rasterize_GetTextureGradients')
+static PFfloat Rasterize_GetTextureLod(const struct PFItex* tex, PFboolean is3D, const PFMvec2 uv, PFfloat z, const PFMvec3 dX, const PFMvec3 dY)
+{
+    PFfloat size[2] = { (PFfloat)tex->w, (PFfloat)tex->h };
+    PFfloat rho2X = 0.0f, rho2Y = 0.0f;
+
+    for (int_fast8_t i = 0; i < 2; i++) {
+        PFfloat du = is3D ? (dX[i] - uv[i]*dX[2])*z : dX[i];
+        PFfloat dv = is3D ? (dY[i] - uv[i]*dY[2])*z : dY[i];
+        du *= size[i], dv *= size[i];
+        rho2X += du*du, rho2Y += dv*dv;
     }
 
+    return pfiTexture2DComputeLod(PF_MAX(rho2X, rho2Y));
+}
+
+PFboolean Rasterize_IsFaceVisible(PFface faceToRender, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3)
+{
+    PFfloat signedArea = pfmGeo2DSignedTriangleArea(v1->screen, v2->screen, v3->screen);
+    return !((faceToRender == PF_FRONT && signedArea > 0) || (faceToRender == PF_BACK && signedArea < 0));
+}
+
+void Rasterize_TriangleState(const PFItrianglestate* state, PFface faceToRender, PFboolean is3D, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, const PFMvec3 viewPos)
+{
     /* Sort vertices in ascending order of y coordinates */
     {
         const PFIvertex* vTmp;
@@ -583,10 +824,6 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
     PFint x2 = (PFint)v2->screen[0], y2 = (PFint)v2->screen[1];
     PFint x3 = (PFint)v3->screen[0], y3 = (PFint)v3->screen[1];
 
-    const PFMvec2_cptr uv1 = v1->texcoord;
-    const PFMvec2_cptr uv2 = v2->texcoord;
-    const PFMvec2_cptr uv3 = v3->texcoord;
-
     const PFMvec3_cptr p1 = v1->position;
     const PFMvec3_cptr p2 = v2->position;
     const PFMvec3_cptr p3 = v3->position;
@@ -605,14 +842,35 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
 
     /* Get some contextual values */
 
-    struct PFItex *texSrc = G_currentCtx->currentTexture;
-    PFfloat *zbDst = G_currentCtx->currentFramebuffer->zbuffer;
-    struct PFItex *texDst = G_currentCtx->currentFramebuffer->texture;
-    PFIblendfunc blendFunction = (G_currentCtx->state & PF_BLEND) ? G_currentCtx->blendFunction : NULL;
-    PFIdepthfunc depthFunction = (G_currentCtx->state & PF_DEPTH_TEST) ? G_currentCtx->depthFunction : NULL;
-    PFItexturesampler texSampler = ((G_currentCtx->state & PF_TEXTURE_2D) && texSrc) ? texSrc->sampler : NULL;
-    InterpolateColorFunc interpolateColor = (G_currentCtx->shadingMode == PF_SMOOTH) ? pfiColorLerpSmooth : pfiColorLerpFlat;
-    const PFIlight *lights = ((G_currentCtx->state & PF_LIGHTING) && G_currentCtx->lightingMode == PF_PHONG) ? G_currentCtx->activeLights : NULL;
+    PFfloat *zbDst = state->zbDst;
+    struct PFItex *texDst = state->texDst;
+    PFIblendfunc blendFunction = state->blendFunction;
+    PFIdepthfunc depthFunction = state->depthFunction;
+    InterpolateColorFunc interpolateColor = (state->shadingMode == PF_SMOOTH) ? pfiColorLerpSmooth : pfiColorLerpFlat;
+    const PFIlight *lights = state->lights;
+
+    // Get the texcoords of the enabled texture units, with
+    // the gradients used to select their mipmap levels
+    const PFItextureunitstate *textures = state->textures;
+    PFint textureCount = state->textureCount;
+
+    PFMvec2_cptr uv1[2], uv2[2], uv3[2];
+    PFboolean texLod[2];
+    PFMvec3 texDx[2], texDy[2];
+
+    for (PFint u = 0; u < textureCount; u++) {
+        PFboolean unit1 = (textures[u].unit == PF_TEXTURE1);
+        uv1[u] = unit1 ? v1->texcoord1 : v1->texcoord;
+        uv2[u] = unit1 ? v2->texcoord1 : v2->texcoord;
+        uv3[u] = unit1 ? v3->texcoord1 : v3->texcoord;
+
+        const struct PFItex *texSrc = textures[u].texSrc;
+        texLod[u] = texSrc->mipmapCount > 0 && pfiIsMipmapFilter(texSrc->filter);
+
+        if (texLod[u]) {
+            Rasterize_GetTextureGradients(v1, v2, v3, textures[u].unit, texDx[u], texDy[u]);
+        }
+    }
 
     /*  */
 
@@ -620,8 +878,8 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
     PFint yMax = y3;
 
     if (!is3D) {
-        yMin = PF_CLAMP(yMin, G_currentCtx->vpMin[1], G_currentCtx->vpMax[1]);
-        yMax = PF_CLAMP(yMax, G_currentCtx->vpMin[1], G_currentCtx->vpMax[1]);
+        yMin = PF_CLAMP(yMin, state->vpMin[1], state->vpMax[1]);
+        yMax = PF_CLAMP(yMax, state->vpMin[1], state->vpMax[1]);
     }
 
     PFsizei yOffset = yMin * texDst->w;
@@ -646,7 +904,7 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
         PFint xA, xB;
         PFfloat zA, zB;
         PFcolor cA, cB;
-        PFMvec2 uvA, uvB;
+        PFMvec2 uvA[2], uvB[2];
         PFMvec3 pA, pB, nA, nB;
 
         if (y < y2) { // First half
@@ -656,9 +914,9 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
             zB = z1 + (z2 - z1) * beta1;
             cA = interpolateColor(c1, c3, alpha);
             cB = interpolateColor(c1, c2, beta1);
-            if (texSampler) {
-                pfmVec2LerpR(uvA, uv1, uv3, alpha);
-                pfmVec2LerpR(uvB, uv1, uv2, beta1);
+            for (PFint u = 0; u < textureCount; u++) {
+                pfmVec2LerpR(uvA[u], uv1[u], uv3[u], alpha);
+                pfmVec2LerpR(uvB[u], uv1[u], uv2[u], beta1);
             }
             if (lights) {
                 pfmVec3LerpR(pA, p1, p3, alpha);
@@ -673,9 +931,9 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
             zB = z2 + (z3 - z2) * beta2;
             cA = interpolateColor(c1, c3, alpha);
             cB = interpolateColor(c2, c3, beta2);
-            if (texSampler) {
-                pfmVec2LerpR(uvA, uv1, uv3, alpha);
-                pfmVec2LerpR(uvB, uv2, uv3, beta2);
+            for (PFint u = 0; u < textureCount; u++) {
+                pfmVec2LerpR(uvA[u], uv1[u], uv3[u], alpha);
+                pfmVec2LerpR(uvB[u], uv2[u], uv3[u], beta2);
             }
             if (lights) {
                 pfmVec3LerpR(pA, p1, p3, alpha);
@@ -691,7 +949,7 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
             PFint iTmp = xA; xA = xB; xB = iTmp;
             PFfloat fTmp = zA; zA = zB; zB = fTmp;
             PFcolor cTmp = cA; cA = cB; cB = cTmp;
-            pfmVec2Swap(uvA, uvB);
+            for (PFint u = 0; u < textureCount; u++) pfmVec2Swap(uvA[u], uvB[u]);
             pfmVec3Swap(pA, pB);
             pfmVec3Swap(nA, nB);
         }
@@ -702,8 +960,8 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
         PFint xMax = xB;
 
         if (!is3D) {
-            xMin = PF_CLAMP(xMin, G_currentCtx->vpMin[0], G_currentCtx->vpMax[0]);
-            xMax = PF_CLAMP(xMax, G_currentCtx->vpMin[0], G_currentCtx->vpMax[0]);
+            xMin = PF_CLAMP(xMin, state->vpMin[0], state->vpMax[0]);
+            xMax = PF_CLAMP(xMax, state->vpMin[0], state->vpMax[0]);
         }
 
         PFsizei xyOffset = yOffset + xMin;
@@ -719,17 +977,20 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
             PFfloat z = 1.0f / (zA + (zB - zA) * gamma);
             if (!depthFunction || depthFunction(z, zbDst[xyOffset])) {
                 PFcolor fragment = interpolateColor(cA, cB, gamma);
-                if (texSampler) {
-                    PFMvec2 uv; pfmVec2LerpR(uv, uvA, uvB, gamma);
+                for (PFint u = 0; u < textureCount; u++) {
+                    struct PFItex *texSrc = textures[u].texSrc;
+                    PFMvec2 uv; pfmVec2LerpR(uv, uvA[u], uvB[u], gamma);
                     if (is3D) pfmVec2Scale(uv, uv, z); // Perspective correct
-                    PFcolor texel = texSampler(texSrc, uv[0], uv[1]);
-                    fragment = pfiBlendMultiplicative(texel, fragment);
+                    PFcolor texel = texLod[u]
+                        ? pfiTexture2DSampleLod(texSrc, uv[0], uv[1], Rasterize_GetTextureLod(texSrc, is3D, uv, z, texDx[u], texDy[u]))
+                        : textures[u].texSampler(texSrc, uv[0], uv[1]);
+                    fragment = textures[u].combineFunction(texel, fragment);
                 }
                 if (lights) {
                     PFMvec3 position; pfmVec3LerpR(position, pA, pB, gamma);
                     PFMvec3 normal; pfmVec3LerpR(normal, nA, nB, gamma);
-                    fragment = pfiLightingProcess(G_currentCtx->activeLights,
-                        &G_currentCtx->faceMaterial[faceToRender], fragment,
+                    fragment = pfiLightingProcess(lights,
+                        &state->materials[faceToRender], fragment,
                         viewPos, position, normal);
                 }
                 if (blendFunction) fragment = blendFunction(fragment, texDst->getter(texDst->pixels, xyOffset));
@@ -741,3 +1002,321 @@ void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1
 }
 
 #endif //PF_TRIANGLE_RASTER_MODE
+
+
+/* Triangle binning functions (see PF_FRAME_PIPELINING) */
+
+static void Rasterize_GetTriangleState(PFItrianglestate* state)
+{
+    const PFIctx *ctx = G_currentCtx;
+
+    state->texDst = ctx->currentFramebuffer->texture;
+    state->zbDst = ctx->currentFramebuffer->zbuffer;
+    state->vpMin[0] = ctx->vpMin[0], state->vpMin[1] = ctx->vpMin[1];
+    state->vpMax[0] = ctx->vpMax[0], state->vpMax[1] = ctx->vpMax[1];
+    state->shadingMode = ctx->shadingMode;
+
+#if PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_BARYCENTRIC
+    state->blendFunction = (ctx->state & PF_BLEND) ? ctx->blendSimdFunction : NULL;
+    state->depthFunction = (ctx->state & PF_DEPTH_TEST) ? ctx->depthSimdFunction : NULL;
+#elif PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_SCANLINES
+    state->blendFunction = (ctx->state & PF_BLEND) ? ctx->blendFunction : NULL;
+    state->depthFunction = (ctx->state & PF_DEPTH_TEST) ? ctx->depthFunction : NULL;
+#endif //PF_RASTER_MODE
+
+    // Pack the enabled texture units, in the order in which they are combined
+    struct PFItex *textures[2] = { ctx->currentTexture, ctx->currentTexture1 };
+    PFboolean enabled[2] = { (ctx->state & PF_TEXTURE_2D) != 0, (ctx->texture1State & PF_TEXTURE_2D) != 0 };
+
+    state->textureCount = 0;
+
+    for (PFint unit = PF_TEXTURE0; unit <= PF_TEXTURE1; unit++) {
+        if (!enabled[unit] || textures[unit] == NULL) continue;
+        PFItextureunitstate *texture = &state->textures[state->textureCount++];
+        texture->texSrc = textures[unit];
+        texture->unit = unit;
+#   if PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_BARYCENTRIC
+        texture->texSampler = textures[unit]->samplerSimd;
+        texture->combineFunction = GC_textureCombineFuncs_simd[ctx->textureCombine[unit]];
+#   elif PF_TRIANGLE_RASTER_MODE == PF_TRIANGLE_RASTER_SCANLINES
+        texture->texSampler = textures[unit]->sampler;
+        texture->combineFunction = GC_textureCombineFuncs[ctx->textureCombine[unit]];
+#   endif //PF_RASTER_MODE
+    }
+
+    state->lights = ((ctx->state & PF_LIGHTING) && ctx->lightingMode == PF_PHONG) ? ctx->activeLights : NULL;
+    state->materials = ctx->faceMaterial;
+}
+
+// NOTE: Checks if the last state recorded in the bin can be used to rasterize
+//       the triangle, the lights and materials are only compared when used
+static PFboolean Rasterize_IsTriangleStateRecorded(const PFItrianglestatecmd* cmd, const PFItrianglestate* state)
+{
+    const PFItrianglestate *recorded = &cmd->state;
+
+    if (recorded->texDst != state->texDst || recorded->zbDst != state->zbDst
+     || recorded->shadingMode != state->shadingMode
+     || recorded->vpMin[0] != state->vpMin[0] || recorded->vpMin[1] != state->vpMin[1]
+     || recorded->vpMax[0] != state->vpMax[0] || recorded->vpMax[1] != state->vpMax[1]
+     || recorded->blendFunction != state->blendFunction
+     || recorded->depthFunction != state->depthFunction
+     || recorded->textureCount != state->textureCount) {
+        return PF_FALSE;
+    }
+
+    for (PFint i = 0; i < state->textureCount; i++) {
+        const PFItextureunitstate *a = &recorded->textures[i], *b = &state->textures[i];
+        if (a->texSrc != b->texSrc || a->texSampler != b->texSampler
+         || a->combineFunction != b->combineFunction || a->unit != b->unit) {
+            return PF_FALSE;
+        }
+    }
+
+    PFint lightCount = 0;
+
+    for (const PFIlight *light = state->lights; light; light = light->next, lightCount++) {
+        if (lightCount >= cmd->lightCount || memcmp(&cmd->lights[lightCount], light, offsetof(PFIlight, next)) != 0) {
+            return PF_FALSE;
+        }
+    }
+
+    if (lightCount != cmd->lightCount) {
+        return PF_FALSE;
+    }
+
+    return lightCount == 0 || memcmp(cmd->materials, state->materials, sizeof(cmd->materials)) == 0;
+}
+
+static void Rasterize_TriangleStateCommand(void* data)
+{
+    PFItrianglestatecmd *cmd = data;
+
+    // NOTE: The copies can only be linked here, the bin can be reallocated while recorded
+    for (PFint i = 0; i < cmd->lightCount; i++) {
+        cmd->lights[i].next = (i + 1 < cmd->lightCount) ? &cmd->lights[i + 1] : NULL;
+    }
+
+    cmd->state.lights = (cmd->lightCount > 0) ? cmd->lights : NULL;
+    cmd->state.materials = cmd->materials;
+}
+
+static void Rasterize_TriangleCommand(void* data)
+{
+    const PFItrianglecmd *cmd = data;
+    const PFItrianglestatecmd *stateCmd = (const PFItrianglestatecmd*)((const PFubyte*)data - cmd->stateDistance);
+    const PFIsetuptriangle *tri = &cmd->triangle;
+
+    Rasterize_TriangleState(&stateCmd->state, tri->faceToRender, tri->is3D,
+        &tri->vertices[0], &tri->vertices[1], &tri->vertices[2], tri->viewPos);
+}
+
+// NOTE: Rasterizes a visible triangle, or records it in the frame bin if PF_FRAME_PIPELINING is enabled
+void Rasterize_SubmitTriangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, const PFMvec3 viewPos)
+{
+    PFItrianglestate state;
+    Rasterize_GetTriangleState(&state);
+
+    PFIrasterqueue *queue = G_currentCtx->rasterQueue;
+
+    if (queue == NULL) {
+        Rasterize_TriangleState(&state, faceToRender, is3D, v1, v2, v3, viewPos);
+        return;
+    }
+
+    /* Record the state if it changed since the last triangle of the bin */
+
+    const PFItrianglestatecmd *recorded = pfiGetRasterState(queue);
+
+    if (recorded == NULL || !Rasterize_IsTriangleStateRecorded(recorded, &state)) {
+        PFItrianglestatecmd *stateCmd = pfiPushRasterState(queue, Rasterize_TriangleStateCommand, sizeof(PFItrianglestatecmd));
+        if (stateCmd == NULL) return;
+
+        stateCmd->state = state;
+        stateCmd->lightCount = 0;
+
+        for (const PFIlight *light = state.lights; light; light = light->next) {
+            stateCmd->lights[stateCmd->lightCount++] = *light;
+        }
+
+        memcpy(stateCmd->materials, state.materials, sizeof(stateCmd->materials));
+    }
+
+    /* Record the triangle */
+
+    PFItrianglecmd *cmd = pfiPushRasterCommand(queue, Rasterize_TriangleCommand, sizeof(PFItrianglecmd));
+    if (cmd == NULL) return;
+
+    cmd->stateDistance = (PFsizei)((PFubyte*)cmd - (PFubyte*)pfiGetRasterState(queue));
+    cmd->triangle.faceToRender = faceToRender;
+    cmd->triangle.is3D = is3D;
+    cmd->triangle.vertices[0] = *v1;
+    cmd->triangle.vertices[1] = *v2;
+    cmd->triangle.vertices[2] = *v3;
+    memcpy(cmd->triangle.viewPos, viewPos, sizeof(PFMvec3));
+}
+
+void Rasterize_Triangle(PFface faceToRender, PFboolean is3D, const PFIvertex* v1, const PFIvertex* v2, const PFIvertex* v3, const PFMvec3 viewPos)
+{
+    if (Rasterize_IsFaceVisible(faceToRender, v1, v2, v3)) {
+        Rasterize_SubmitTriangle(faceToRender, is3D, v1, v2, v3, viewPos);
+    }
+}
+
+
+/* Parallel triangle processing functions (see 'pfiProcessRasterize_TRIANGLES_PARALLEL') */
+
+// NOTE: Triangles produced by the geometry stage of a group of consecutive input triangles
+typedef struct {
+    PFIsetuptriangle *triangles;
+    PFsizei count;
+    PFsizei capacity;
+    PFboolean outOfMemory;
+} PFItrianglechunk;
+
+typedef struct {
+    PFIvertexfetchfunc fetch;
+    const void *fetchData;
+    PFItrianglechunk *chunks;
+    PFsizei firstChunk;
+    PFsizei triangleCount;
+    PFface faces[2];
+    PFint faceCount;
+} PFItrianglesjob;
+
+static PFIsetuptriangle* Process_PushTriangle(PFItrianglechunk* chunk)
+{
+    if (chunk->count == chunk->capacity) {
+        PFsizei capacity = chunk->capacity ? 2*chunk->capacity : PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB;
+        void *triangles = PF_REALLOC(chunk->triangles, capacity*sizeof(PFIsetuptriangle));
+        if (!triangles) {
+            chunk->outOfMemory = PF_TRUE;
+            return NULL;
+        }
+        chunk->triangles = triangles;
+        chunk->capacity = capacity;
+    }
+    return &chunk->triangles[chunk->count++];
+}
+
+static void Process_TrianglesJob(void* data, PFint begin, PFint end)
+{
+    const PFItrianglesjob *job = data;
+
+    for (PFint c = begin; c < end; c++) {
+        PFItrianglechunk *chunk = &job->chunks[c];
+        chunk->count = 0;
+
+        PFsizei first = (job->firstChunk + c)*PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB;
+        PFsizei last = PF_MIN(first + PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB, job->triangleCount);
+
+        for (PFsizei t = first; t < last; t++) {
+            PFIvertex vertices[3];
+            job->fetch(job->fetchData, 3*t + 0, &vertices[0]);
+            job->fetch(job->fetchData, 3*t + 1, &vertices[1]);
+            job->fetch(job->fetchData, 3*t + 2, &vertices[2]);
+
+            // NOTE: The faces are processed in the same order as 'pfiProcessAndRasterize'
+            for (PFint f = 0; f < job->faceCount; f++) {
+                PFface faceToRender = job->faces[f];
+
+                PFIvertex processed[PF_MAX_CLIPPED_POLYGON_VERTICES];
+                memcpy(processed, vertices, 3*sizeof(PFIvertex));
+
+                PFboolean is3D;
+                PFMvec3 viewPos;
+
+                int_fast8_t processedCounter = Process_Triangle(faceToRender, processed, &is3D, viewPos);
+
+                for (int_fast8_t i = 0; i < processedCounter - 2; i++) {
+                    if (!Rasterize_IsFaceVisible(faceToRender, &processed[0], &processed[i + 1], &processed[i + 2])) {
+                        continue;
+                    }
+
+                    PFIsetuptriangle *tri = Process_PushTriangle(chunk);
+                    if (!tri) return;
+
+                    tri->faceToRender = faceToRender;
+                    tri->is3D = is3D;
+                    tri->vertices[0] = processed[0];
+                    tri->vertices[1] = processed[i + 1];
+                    tri->vertices[2] = processed[i + 2];
+                    memcpy(tri->viewPos, viewPos, sizeof(PFMvec3));
+                }
+            }
+        }
+    }
+}
+
+PFboolean pfiProcessRasterize_TRIANGLES_PARALLEL(PFsizei vertexCount, PFsizei minTriangleCount, PFIvertexfetchfunc fetch, const void* data)
+{
+    PFsizei triangleCount = vertexCount/3;
+
+    if (triangleCount == 0 || triangleCount < minTriangleCount) {
+        return PF_FALSE;
+    }
+
+    PFsizei threadCount = pfGetThreadCount();
+    if (threadCount <= 1) return PF_FALSE;
+
+    /* Get the faces to render, the points and lines are rasterized by the geometry stage */
+
+    PFItrianglesjob job = {
+        .fetch = fetch,
+        .fetchData = data,
+        .triangleCount = triangleCount
+    };
+
+    // NOTE: Here we invert cullFace, because PF_FRONT = 0,
+    //       !PF_FRONT = PF_BACK, and vice versa.
+    if (G_currentCtx->state & PF_CULL_FACE) {
+        job.faces[job.faceCount++] = !G_currentCtx->cullFace;
+    } else {
+        job.faces[job.faceCount++] = PF_FRONT;
+        job.faces[job.faceCount++] = PF_BACK;
+    }
+
+    for (PFint f = 0; f < job.faceCount; f++) {
+        if (G_currentCtx->polygonMode[job.faces[f]] != PF_FILL) {
+            return PF_FALSE;
+        }
+    }
+
+    /* Process the triangles by batches of chunks, each batch is rasterized in submission order */
+
+    PFsizei chunkCount = (triangleCount + PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB - 1)/PF_PARALLEL_GEOMETRY_TRIANGLES_PER_JOB;
+    PFsizei batchSize = PF_MIN(chunkCount, 4*threadCount);
+
+    job.chunks = PF_CALLOC(batchSize, sizeof(PFItrianglechunk));
+    if (!job.chunks) return PF_FALSE;
+
+    PFboolean outOfMemory = PF_FALSE;
+
+    for (job.firstChunk = 0; job.firstChunk < chunkCount && !outOfMemory; job.firstChunk += batchSize) {
+        PFsizei batchChunkCount = PF_MIN(batchSize, chunkCount - job.firstChunk);
+
+        pfiParallelFor(0, batchChunkCount, 1, Process_TrianglesJob, &job);
+
+        for (PFsizei c = 0; c < batchChunkCount && !outOfMemory; c++) {
+            const PFItrianglechunk *chunk = &job.chunks[c];
+            outOfMemory = chunk->outOfMemory;
+
+            for (PFsizei i = 0; i < chunk->count; i++) {
+                const PFIsetuptriangle *tri = &chunk->triangles[i];
+                Rasterize_SubmitTriangle(tri->faceToRender, tri->is3D,
+                    &tri->vertices[0], &tri->vertices[1], &tri->vertices[2], tri->viewPos);
+            }
+        }
+    }
+
+    if (outOfMemory) {
+        G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+    }
+
+    for (PFsizei c = 0; c < batchSize; c++) {
+        PF_FREE(job.chunks[c].triangles);
+    }
+
+    PF_FREE(job.chunks);
+
+    return PF_TRUE;
+}
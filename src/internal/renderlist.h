@@ -0,0 +1,47 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_RENDERLIST_H
+#define PF_INTERNAL_RENDERLIST_H
+
+#include "./context/command.h"
+#include "./context/context.h"
+#include "../pixelforge.h"
+
+/* Internal render list recording functions */
+
+// NOTE: These functions only write to the given list, they are shared by the recording
+//       through the current context ('pfNewList') and by the list recorders, which can
+//       fill different lists from several threads at the same time.
+
+void pfiRecordBegin(PFIrenderlist* list, PFdrawmode mode, const PFImaterial faceMaterial[2], PFtexture texture, PFtexture texture1);
+PFboolean pfiRecordVertex(PFIrenderlist* list, const PFfloat* position, const PFfloat* texcoord, const PFfloat* texcoord1, const PFfloat* normal, PFcolor color);
+void pfiClearList(PFIrenderlist* list);
+
+// NOTE: Records a state change in the list of the current context ('pfNewList'), once the
+//       arguments have been validated by the API function. Returns PF_FALSE if no list is
+//       being recorded, in which case the API function must apply the change itself.
+PFboolean pfiRecordCommand(PFIcmdtype type, const PFIcmdarg* args, PFsizei argCount, const void* data, PFsizei dataSize);
+
+// NOTE: Compiles the recorded calls into vertex streams (see 'PFIvertexstreams'), called at the
+//       end of the recording, calls that are already compiled are skipped. If 'optimize' is set,
+//       the compatible adjacent calls are merged and the triangles are indexed beforehand.
+void pfiCompileList(PFIrenderlist* list, PFboolean optimize);
+
+#endif //PF_INTERNAL_RENDERLIST_H
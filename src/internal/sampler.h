@@ -23,6 +23,58 @@
 #include "./context/context.h"
 #include "./color.h"
 
+/* Texture2D Layout Functions */
+
+// NOTE: Spreads the 16 low bits of 'v' over the even bits of the result
+static inline PFuint
+pfiMortonSpread(PFuint v)
+{
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+// NOTE: Returns the index of the texel (x, y) in the pixels of the texture (see 'pfTextureLayout')
+static inline PFsizei
+pfiGetTexelOffset(const struct PFItex* tex, PFsizei x, PFsizei y)
+{
+    switch (tex->layout) {
+        case PF_LAYOUT_TILED:
+            return ((y >> 2)*((tex->w + 3) >> 2) + (x >> 2))*16 + (y & 3)*4 + (x & 3);
+        case PF_LAYOUT_MORTON: {
+            PFuint mask = (1u << tex->mortonBits) - 1;
+            return (pfiMortonSpread(x & mask) | (pfiMortonSpread(y & mask) << 1))
+                 | (((x | y) >> tex->mortonBits) << (2*tex->mortonBits));
+        }
+        default:
+            return y*tex->pitch + x;
+    }
+}
+
+// NOTE: Returns the texel (x, y) of a texture in a compressed format, from the decoded blocks
+//       kept by the calling thread, its block is decoded first if it is not one of them
+PFcolor pfiGetBlockTexel(const struct PFItex* tex, PFsizei x, PFsizei y);
+
+// NOTE: Returns the texel (x, y) of the texture, the RGBA8 texels (see 'pfTextureStorage')
+//       are loaded directly instead of being decoded by the getter of the texture, and the
+//       colors of PF_COLOR_INDEX are loaded from the palette (they have no getter)
+static inline PFcolor
+pfiGetTexel(const struct PFItex* tex, PFsizei x, PFsizei y)
+{
+    if (tex->format == PF_RGBA && tex->type == PF_UNSIGNED_BYTE) {
+        return ((const PFcolor*)tex->pixels)[pfiGetTexelOffset(tex, x, y)];
+    }
+    if (tex->format == PF_COLOR_INDEX) {
+        return tex->palette[((const PFubyte*)tex->pixels)[pfiGetTexelOffset(tex, x, y)]];
+    }
+    if (tex->format >= PF_COMPRESSED_BC1 && tex->format <= PF_COMPRESSED_ETC1) {
+        return pfiGetBlockTexel(tex, x, y);
+    }
+    return tex->getter(tex->pixels, pfiGetTexelOffset(tex, x, y));
+}
+
 /* Texture2D Mapper Functions */
 
 static inline void
@@ -52,7 +104,7 @@ pfiTexture2DMap_MIRRORED_REPEAT(const struct PFItex* tex, PFint* xOut, PFint* yO
     v = fmodf(fabsf(v), 2);
 
     if (u > 1.0f) u = 1.0f - (u - 1.0f);
-    if (v > 1.0f) v = 1.0f - (u - 1.0f);
+    if (v > 1.0f) v = 1.0f - (v - 1.0f);
 
     *xOut = (PFint)(u*((PFint)tex->w - 1) + 0.5f);
     *yOut = (PFint)(v*((PFint)tex->h - 1) + 0.5f);
@@ -68,6 +120,78 @@ pfiTexture2DMap_CLAMP_TO_EDGE(const struct PFItex* tex, PFint* xOut, PFint* yOut
     *yOut = (PFint)(v*((PFint)tex->h - 1) + 0.5f);
 }
 
+/* Texture2D Bilinear Footprint Functions */
+
+// NOTE: Returns the first of the two texels around the position 's' (in texels, from the center
+//       of the first texel), and retrieves the weight over 256 of the second one
+static inline PFint
+pfiTexture2DSplit(PFfloat s, PFuint* weight)
+{
+    PFfloat first = floorf(s);
+    *weight = (PFuint)lrintf((s - first)*256.0f);
+    return (PFint)first;
+}
+
+static inline void
+pfiTexture2DWrap_REPEAT(PFint c, PFint size, PFint* c0, PFint* c1)
+{
+    c %= size;
+    if (c < 0) c += size;
+
+    *c0 = c;
+    *c1 = (c + 1 == size) ? 0 : c + 1;
+}
+
+static inline void
+pfiTexture2DWrap_MIRRORED_REPEAT(PFint c, PFint size, PFint* c0, PFint* c1)
+{
+    // NOTE: The texels repeat every two sizes, the second size being mirrored
+    PFint period = 2*size;
+
+    c %= period;
+    if (c < 0) c += period;
+
+    PFint next = (c + 1 == period) ? 0 : c + 1;
+
+    *c0 = PF_MIN(c, period - 1 - c);
+    *c1 = PF_MIN(next, period - 1 - next);
+}
+
+static inline void
+pfiTexture2DWrap_CLAMP_TO_EDGE(PFint c, PFint size, PFint* c0, PFint* c1)
+{
+    *c0 = PF_CLAMP(c, 0, size - 1);
+    *c1 = PF_CLAMP(c + 1, 0, size - 1);
+}
+
+/* Texture2D Power-of-two Wrap Functions */
+
+// NOTE: Same as 'pfiTexture2DSplit', from the position in fixed point with 8 fractional bits.
+//       The first texel is shifted logically: if 's' is negative only its low bits are right,
+//       which is all that the masks of the power-of-two wraps read.
+static inline PFint
+pfiTexture2DSplitPOT(PFfloat s, PFuint* weight)
+{
+    PFint fixed = (PFint)lrintf(s*256.0f);
+    *weight = (PFuint)fixed & 0xFF;
+    return (PFint)((PFuint)fixed >> 8);
+}
+
+static inline void
+pfiTexture2DWrapPOT_REPEAT(PFint c, PFint size, PFint* c0, PFint* c1)
+{
+    *c0 = c & (size - 1);
+    *c1 = (c + 1) & (size - 1);
+}
+
+static inline void
+pfiTexture2DWrapPOT_MIRRORED_REPEAT(PFint c, PFint size, PFint* c0, PFint* c1)
+{
+    // NOTE: The index in the odd repetitions, which are mirrored, is the complement of the one in the even ones
+    *c0 = ((c & size) ? ~c : c) & (size - 1);
+    *c1 = (((c + 1) & size) ? ~(c + 1) : c + 1) & (size - 1);
+}
+
 /* Texture2D Sampler Functions */
 
 static inline PFcolor
@@ -76,7 +200,7 @@ pfiTexture2DSampler_NEAREST_REPEAT(const struct PFItex* tex, PFfloat u, PFfloat
     PFint x, y;
     pfiTexture2DMap_REPEAT(tex, &x, &y, u, v);
 
-    return tex->getter(tex->pixels, y*tex->w + x);
+    return pfiGetTexel(tex, x, y);
 }
 
 static inline PFcolor
@@ -85,7 +209,7 @@ pfiTexture2DSampler_NEAREST_MIRRORED_REPEAT(const struct PFItex* tex, PFfloat u,
     PFint x, y;
     pfiTexture2DMap_MIRRORED_REPEAT(tex, &x, &y, u, v);
 
-    return tex->getter(tex->pixels, y*tex->w + x);
+    return pfiGetTexel(tex, x, y);
 }
 
 static inline PFcolor
@@ -94,91 +218,82 @@ pfiTexture2DSampler_NEAREST_CLAMP_TO_EDGE(const struct PFItex* tex, PFfloat u, P
     PFint x, y;
     pfiTexture2DMap_CLAMP_TO_EDGE(tex, &x, &y, u, v);
 
-    return tex->getter(tex->pixels, y*tex->w + x);
+    return pfiGetTexel(tex, x, y);
 }
 
 static inline PFcolor
 pfiTexture2DSampler_BILINEAR_REPEAT(const struct PFItex* tex, PFfloat u, PFfloat v)
 {
-    int x0, y0, x1, y1;
-    float fx, fy;
+    PFint x0, y0, x1, y1;
+    PFuint wx, wy;
 
-    pfiTexture2DMap_REPEAT(tex, &x0, &y0, u, v);
-    pfiTexture2DMap_REPEAT(tex, &x1, &y1, u + tex->tx, v + tex->ty);
+    pfiTexture2DWrap_REPEAT(pfiTexture2DSplit(u*tex->w - 0.5f, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrap_REPEAT(pfiTexture2DSplit(v*tex->h - 0.5f, &wy), tex->h, &y0, &y1);
 
-    // Calculate fractions fx, fy
-    // REVIEW: It seems strange to me to have to clamp here, but the result is incorrect otherwise...
-    fx = PF_CLAMP(u * tex->w - x0, 0.0f, 1.0f);
-    fy = PF_CLAMP(v * tex->h - y0, 0.0f, 1.0f);
-
-    // Get the colors of the four pixels
-    PFcolor c00 = tex->getter(tex->pixels, y0 * tex->w + x0);
-    PFcolor c10 = tex->getter(tex->pixels, y0 * tex->w + x1);
-    PFcolor c01 = tex->getter(tex->pixels, y1 * tex->w + x0);
-    PFcolor c11 = tex->getter(tex->pixels, y1 * tex->w + x1);
-
-    // Interpolate colors horizontally
-    PFcolor c0 = pfiColorLerpSmooth(c00, c10, fx);
-    PFcolor c1 = pfiColorLerpSmooth(c01, c11, fx);
-
-    // Interpolate colors vertically
-    return pfiColorLerpSmooth(c0, c1, fy);
+    return pfiColorBilinear(
+        pfiGetTexel(tex, x0, y0), pfiGetTexel(tex, x1, y0),
+        pfiGetTexel(tex, x0, y1), pfiGetTexel(tex, x1, y1),
+        wx, wy);
 }
 
 static inline PFcolor
 pfiTexture2DSampler_BILINEAR_MIRRORED_REPEAT(const struct PFItex* tex, PFfloat u, PFfloat v)
 {
-    int x0, y0, x1, y1;
-    float fx, fy;
+    PFint x0, y0, x1, y1;
+    PFuint wx, wy;
 
-    pfiTexture2DMap_MIRRORED_REPEAT(tex, &x0, &y0, u, v);
-    pfiTexture2DMap_MIRRORED_REPEAT(tex, &x1, &y1, u + tex->tx, v + tex->ty);
+    pfiTexture2DWrap_MIRRORED_REPEAT(pfiTexture2DSplit(u*tex->w - 0.5f, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrap_MIRRORED_REPEAT(pfiTexture2DSplit(v*tex->h - 0.5f, &wy), tex->h, &y0, &y1);
 
-    // Calculate fractions fx, fy
-    // REVIEW: It seems strange to me to have to clamp here, but the result is incorrect otherwise...
-    fx = PF_CLAMP(u * tex->w - x0, 0.0f, 1.0f);
-    fy = PF_CLAMP(v * tex->h - y0, 0.0f, 1.0f);
+    return pfiColorBilinear(
+        pfiGetTexel(tex, x0, y0), pfiGetTexel(tex, x1, y0),
+        pfiGetTexel(tex, x0, y1), pfiGetTexel(tex, x1, y1),
+        wx, wy);
+}
 
-    // Get the colors of the four pixels
-    PFcolor c00 = tex->getter(tex->pixels, y0 * tex->w + x0);
-    PFcolor c10 = tex->getter(tex->pixels, y0 * tex->w + x1);
-    PFcolor c01 = tex->getter(tex->pixels, y1 * tex->w + x0);
-    PFcolor c11 = tex->getter(tex->pixels, y1 * tex->w + x1);
+static inline PFcolor
+pfiTexture2DSampler_BILINEAR_CLAMP_TO_EDGE(const struct PFItex* tex, PFfloat u, PFfloat v)
+{
+    PFint x0, y0, x1, y1;
+    PFuint wx, wy;
 
-    // Interpolate colors horizontally
-    PFcolor c0 = pfiColorLerpSmooth(c00, c10, fx);
-    PFcolor c1 = pfiColorLerpSmooth(c01, c11, fx);
+    pfiTexture2DWrap_CLAMP_TO_EDGE(pfiTexture2DSplit(u*tex->w - 0.5f, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrap_CLAMP_TO_EDGE(pfiTexture2DSplit(v*tex->h - 0.5f, &wy), tex->h, &y0, &y1);
 
-    // Interpolate colors vertically
-    return pfiColorLerpSmooth(c0, c1, fy);
+    return pfiColorBilinear(
+        pfiGetTexel(tex, x0, y0), pfiGetTexel(tex, x1, y0),
+        pfiGetTexel(tex, x0, y1), pfiGetTexel(tex, x1, y1),
+        wx, wy);
 }
 
 static inline PFcolor
-pfiTexture2DSampler_BILINEAR_CLAMP_TO_EDGE(const struct PFItex* tex, PFfloat u, PFfloat v)
+pfiTexture2DSamplerPOT_BILINEAR_REPEAT(const struct PFItex* tex, PFfloat u, PFfloat v)
 {
-    int x0, y0, x1, y1;
-    float fx, fy;
+    PFint x0, y0, x1, y1;
+    PFuint wx, wy;
 
-    pfiTexture2DMap_CLAMP_TO_EDGE(tex, &x0, &y0, u, v);
-    pfiTexture2DMap_CLAMP_TO_EDGE(tex, &x1, &y1, u + tex->tx, v + tex->ty);
+    pfiTexture2DWrapPOT_REPEAT(pfiTexture2DSplitPOT(u*tex->w - 0.5f, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrapPOT_REPEAT(pfiTexture2DSplitPOT(v*tex->h - 0.5f, &wy), tex->h, &y0, &y1);
 
-    // Calculate fractions fx, fy
-    // REVIEW: It seems strange to me to have to clamp here, but the result is incorrect otherwise...
-    fx = PF_CLAMP(u * tex->w - x0, 0.0f, 1.0f);
-    fy = PF_CLAMP(v * tex->h - y0, 0.0f, 1.0f);
+    return pfiColorBilinear(
+        pfiGetTexel(tex, x0, y0), pfiGetTexel(tex, x1, y0),
+        pfiGetTexel(tex, x0, y1), pfiGetTexel(tex, x1, y1),
+        wx, wy);
+}
 
-    // Get the colors of the four pixels
-    PFcolor c00 = tex->getter(tex->pixels, y0 * tex->w + x0);
-    PFcolor c10 = tex->getter(tex->pixels, y0 * tex->w + x1);
-    PFcolor c01 = tex->getter(tex->pixels, y1 * tex->w + x0);
-    PFcolor c11 = tex->getter(tex->pixels, y1 * tex->w + x1);
+static inline PFcolor
+pfiTexture2DSamplerPOT_BILINEAR_MIRRORED_REPEAT(const struct PFItex* tex, PFfloat u, PFfloat v)
+{
+    PFint x0, y0, x1, y1;
+    PFuint wx, wy;
 
-    // Interpolate colors horizontally
-    PFcolor c0 = pfiColorLerpSmooth(c00, c10, fx);
-    PFcolor c1 = pfiColorLerpSmooth(c01, c11, fx);
+    pfiTexture2DWrapPOT_MIRRORED_REPEAT(pfiTexture2DSplitPOT(u*tex->w - 0.5f, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrapPOT_MIRRORED_REPEAT(pfiTexture2DSplitPOT(v*tex->h - 0.5f, &wy), tex->h, &y0, &y1);
 
-    // Interpolate colors vertically
-    return pfiColorLerpSmooth(c0, c1, fy);
+    return pfiColorBilinear(
+        pfiGetTexel(tex, x0, y0), pfiGetTexel(tex, x1, y0),
+        pfiGetTexel(tex, x0, y1), pfiGetTexel(tex, x1, y1),
+        wx, wy);
 }
 
 static const PFItexturesampler GC_textureSamplers[2][3] = {
@@ -193,10 +308,135 @@ static const PFItexturesampler GC_textureSamplers[2][3] = {
 
 };
 
+// NOTE: Samplers of the textures whose width and height are powers of two, only the bilinear
+//       wraps use masks. The nearest texel is mapped by the samplers of the other sizes, so that
+//       it does not depend on the size, and so does clamping to the edges.
+static const PFItexturesampler GC_textureSamplersPOT[2][3] = {
+
+    [PF_NEAREST][PF_REPEAT]             = pfiTexture2DSampler_NEAREST_REPEAT,
+    [PF_NEAREST][PF_MIRRORED_REPEAT]    = pfiTexture2DSampler_NEAREST_MIRRORED_REPEAT,
+    [PF_NEAREST][PF_CLAMP_TO_EDGE]      = pfiTexture2DSampler_NEAREST_CLAMP_TO_EDGE,
+
+    [PF_BILINEAR][PF_REPEAT]            = pfiTexture2DSamplerPOT_BILINEAR_REPEAT,
+    [PF_BILINEAR][PF_MIRRORED_REPEAT]   = pfiTexture2DSamplerPOT_BILINEAR_MIRRORED_REPEAT,
+    [PF_BILINEAR][PF_CLAMP_TO_EDGE]     = pfiTexture2DSampler_BILINEAR_CLAMP_TO_EDGE,
+
+};
+
+/* Texture2D Mipmap Functions */
+
+static inline PFboolean
+pfiIsMipmapFilter(PFtexturefilter filter)
+{
+    return filter >= PF_NEAREST_MIPMAP_NEAREST;
+}
+
+// NOTE: Returns the filter used to sample a single level (index of 'GC_textureSamplers')
+static inline PFtexturefilter
+pfiGetLevelFilter(PFtexturefilter filter)
+{
+    return (filter == PF_BILINEAR || filter >= PF_BILINEAR_MIPMAP_NEAREST) ? PF_BILINEAR : PF_NEAREST;
+}
+
+static inline const struct PFItex*
+pfiGetTextureLevel(const struct PFItex* tex, PFsizei level)
+{
+    return (level == 0) ? tex : &tex->mipmaps[PF_MIN(level, tex->mipmapCount) - 1];
+}
+
+// NOTE: Returns the level of detail from the squared length of the largest derivative of the
+//       texture coordinates, in texels of the base level per pixel. The logarithm is approximated
+//       from the exponent and the mantissa of 'rho2', which is piecewise linear (error < 0.05 level)
+static inline PFfloat
+pfiTexture2DComputeLod(PFfloat rho2)
+{
+    if (!(rho2 > 1.0f)) return 0.0f;
+
+    union { PFfloat f; PFuint u; } bits = { .f = rho2 };
+    PFfloat exponent = (PFfloat)((PFint)(bits.u >> 23) - 127);
+    PFfloat mantissa = (PFfloat)(bits.u & 0x7FFFFF)*(1.0f/8388608.0f);
+
+    return 0.5f*(exponent + mantissa);
+}
+
+// NOTE: Samples a texture using a mipmap filter, the base level is sampled when magnified
+static inline PFcolor
+pfiTexture2DSampleLod(const struct PFItex* tex, PFfloat u, PFfloat v, PFfloat lod)
+{
+    if (lod <= 0.0f || tex->mipmapCount == 0) {
+        return tex->sampler(tex, u, v);
+    }
+
+    if (tex->filter == PF_NEAREST_MIPMAP_NEAREST || tex->filter == PF_BILINEAR_MIPMAP_NEAREST) {
+        const struct PFItex *level = pfiGetTextureLevel(tex, (PFsizei)(lod + 0.5f));
+        return level->sampler(level, u, v);
+    }
+
+    PFsizei l = (PFsizei)lod;
+    const struct PFItex *level0 = pfiGetTextureLevel(tex, l);
+    const struct PFItex *level1 = pfiGetTextureLevel(tex, l + 1);
+
+    PFcolor c0 = level0->sampler(level0, u, v);
+    if (level0 == level1) return c0;
+
+    return pfiColorLerpSmooth(c0, level1->sampler(level1, u, v), lod - l);
+}
+
 /* SIMD Implementation */
 
 #if PF_SIMD_SUPPORT
 
+/* SIMD - Texture2D Layout Functions */
+
+static inline PFIsimdvi
+pfiMortonSpread_simd(PFIsimdvi v)
+{
+    v = pfiSimdAnd_I32(pfiSimdOr_I32(v, pfiSimdShl_I32(v, 8)), pfiSimdSet1_I32(0x00FF00FF));
+    v = pfiSimdAnd_I32(pfiSimdOr_I32(v, pfiSimdShl_I32(v, 4)), pfiSimdSet1_I32(0x0F0F0F0F));
+    v = pfiSimdAnd_I32(pfiSimdOr_I32(v, pfiSimdShl_I32(v, 2)), pfiSimdSet1_I32(0x33333333));
+    v = pfiSimdAnd_I32(pfiSimdOr_I32(v, pfiSimdShl_I32(v, 1)), pfiSimdSet1_I32(0x55555555));
+    return v;
+}
+
+static inline PFIsimdvi
+pfiGetTexelOffset_simd(const struct PFItex* tex, PFIsimdvi x, PFIsimdvi y)
+{
+    switch (tex->layout) {
+        case PF_LAYOUT_TILED: {
+            PFIsimdvi tile = pfiSimdAdd_I32(pfiSimdMullo_I32(pfiSimdShr_I32(y, 2), pfiSimdSet1_I32((tex->w + 3) >> 2)), pfiSimdShr_I32(x, 2));
+            PFIsimdvi texel = pfiSimdOr_I32(pfiSimdShl_I32(pfiSimdAnd_I32(y, pfiSimdSet1_I32(3)), 2), pfiSimdAnd_I32(x, pfiSimdSet1_I32(3)));
+            return pfiSimdOr_I32(pfiSimdShl_I32(tile, 4), texel);
+        }
+        case PF_LAYOUT_MORTON: {
+            PFIsimdvi mask = pfiSimdSet1_I32((1 << tex->mortonBits) - 1);
+            PFIsimdvi morton = pfiSimdOr_I32(pfiMortonSpread_simd(pfiSimdAnd_I32(x, mask)), pfiSimdShl_I32(pfiMortonSpread_simd(pfiSimdAnd_I32(y, mask)), 1));
+            PFIsimdvi high = pfiSimdShl_I32(pfiSimdShr_I32(pfiSimdOr_I32(x, y), tex->mortonBits), 2*tex->mortonBits);
+            return pfiSimdOr_I32(morton, high);
+        }
+        default:
+            return pfiSimdAdd_I32(pfiSimdMullo_I32(y, pfiSimdSet1_I32(tex->pitch)), x);
+    }
+}
+
+static inline PFIsimdvi
+pfiGetTexel_simd(const struct PFItex* tex, PFIsimdvi x, PFIsimdvi y)
+{
+    if (tex->format == PF_RGBA && tex->type == PF_UNSIGNED_BYTE) {
+        return pfiSimdGather_I32(tex->pixels, pfiGetTexelOffset_simd(tex, x, y), sizeof(PFuint));
+    }
+    if (tex->format == PF_COLOR_INDEX) {
+        // NOTE: The indices are loaded byte by byte, a gather of 32-bit values at their offsets
+        //       would read up to three bytes past the end of the buffer given to 'pfGenTexture'
+        PFint offsets[PF_SIMD_SIZE], indices[PF_SIMD_SIZE];
+        pfiSimdStore_I32(offsets, pfiGetTexelOffset_simd(tex, x, y));
+        for (int_fast8_t i = 0; i < PF_SIMD_SIZE; i++) {
+            indices[i] = ((const PFubyte*)tex->pixels)[offsets[i]];
+        }
+        return pfiSimdGather_I32((const void*)tex->palette, pfiSimdLoad_I32(indices), sizeof(PFcolor));
+    }
+    return tex->getterSimd(tex->pixels, pfiGetTexelOffset_simd(tex, x, y));
+}
+
 /* SIMD - Texture2D Mapper Functions */
 
 static inline void
@@ -235,8 +475,10 @@ pfiTexture2DMap_MIRRORED_REPEAT_simd(const struct PFItex* tex, PFIsimdvi* xOut,
     u = pfiSimdMul_F32(u, pfiSimdSet1_F32((float)(tex->w - 1)));
     v = pfiSimdMul_F32(v, pfiSimdSet1_F32((float)(tex->h - 1)));
 
-    *xOut = pfiSimdConvert_F32_I32(pfiSimdAdd_F32(u, *(PFIsimdvf*)GC_simd_f32_0p5));
-    *yOut = pfiSimdConvert_F32_I32(pfiSimdAdd_F32(v, *(PFIsimdvf*)GC_simd_f32_0p5));
+    // NOTE: The conversion rounds to nearest, so a coordinate of 1 can give
+    //       the index 'size', which is brought back to the last texel
+    *xOut = pfiSimdMin_I32(pfiSimdConvert_F32_I32(pfiSimdAdd_F32(u, *(PFIsimdvf*)GC_simd_f32_0p5)), pfiSimdSet1_I32(tex->w - 1));
+    *yOut = pfiSimdMin_I32(pfiSimdConvert_F32_I32(pfiSimdAdd_F32(v, *(PFIsimdvf*)GC_simd_f32_0p5)), pfiSimdSet1_I32(tex->h - 1));
 }
 
 static inline void
@@ -250,8 +492,99 @@ pfiTexture2DMap_CLAMP_TO_EDGE_simd(const struct PFItex* tex, PFIsimdvi* xOut, PF
     u = pfiSimdMul_F32(u, pfiSimdSet1_F32((float)(tex->w - 1)));
     v = pfiSimdMul_F32(v, pfiSimdSet1_F32((float)(tex->h - 1)));
 
-    *xOut = pfiSimdConvert_F32_I32(pfiSimdAdd_F32(u, *(PFIsimdvf*)GC_simd_f32_0p5));
-    *yOut = pfiSimdConvert_F32_I32(pfiSimdAdd_F32(v, *(PFIsimdvf*)GC_simd_f32_0p5));
+    // NOTE: See 'pfiTexture2DMap_MIRRORED_REPEAT_simd'
+    *xOut = pfiSimdMin_I32(pfiSimdConvert_F32_I32(pfiSimdAdd_F32(u, *(PFIsimdvf*)GC_simd_f32_0p5)), pfiSimdSet1_I32(tex->w - 1));
+    *yOut = pfiSimdMin_I32(pfiSimdConvert_F32_I32(pfiSimdAdd_F32(v, *(PFIsimdvf*)GC_simd_f32_0p5)), pfiSimdSet1_I32(tex->h - 1));
+}
+
+/* SIMD - Texture2D Bilinear Footprint Functions */
+
+static inline PFIsimdvi
+pfiTexture2DSplit_simd(PFIsimdvf s, PFIsimdvi* weight)
+{
+    PFIsimdvf first = pfiSimdFloor_F32(s);
+    *weight = pfiSimdConvert_F32_I32(pfiSimdMul_F32(pfiSimdSub_F32(s, first), pfiSimdSet1_F32(256.0f)));
+    return pfiSimdConvert_F32_I32(first);
+}
+
+// NOTE: Returns 'c' modulo 'size' (positive), the quotient is computed in floating point
+//       and the remainder is then corrected if the quotient has been rounded
+static inline PFIsimdvi
+pfiTexture2DModulo_simd(PFIsimdvi c, PFint size)
+{
+    PFIsimdvf quotient = pfiSimdFloor_F32(pfiSimdMul_F32(pfiSimdConvert_I32_F32(c), pfiSimdSet1_F32(1.0f/size)));
+    PFIsimdvi sizeV = pfiSimdSet1_I32(size);
+
+    c = pfiSimdSub_I32(c, pfiSimdMullo_I32(pfiSimdConvert_F32_I32(quotient), sizeV));
+    c = pfiSimdAdd_I32(c, pfiSimdAnd_I32(pfiSimdCmpLT_I32(c, pfiSimdSetZero_I32()), sizeV));
+    c = pfiSimdSub_I32(c, pfiSimdAnd_I32(pfiSimdCmpGE_I32(c, sizeV), sizeV));
+
+    return c;
+}
+
+static inline void
+pfiTexture2DWrap_REPEAT_simd(PFIsimdvi c, PFint size, PFIsimdvi* c0, PFIsimdvi* c1)
+{
+    *c0 = pfiTexture2DModulo_simd(c, size);
+    *c1 = pfiSimdAdd_I32(*c0, pfiSimdSet1_I32(1));
+    *c1 = pfiSimdAndNot_I32(pfiSimdCmpEQ_I32(*c1, pfiSimdSet1_I32(size)), *c1);
+}
+
+static inline void
+pfiTexture2DWrap_MIRRORED_REPEAT_simd(PFIsimdvi c, PFint size, PFIsimdvi* c0, PFIsimdvi* c1)
+{
+    PFIsimdvi last = pfiSimdSet1_I32(2*size - 1);
+
+    c = pfiTexture2DModulo_simd(c, 2*size);
+
+    PFIsimdvi next = pfiSimdAdd_I32(c, pfiSimdSet1_I32(1));
+    next = pfiSimdAndNot_I32(pfiSimdCmpGT_I32(next, last), next);
+
+    *c0 = pfiSimdMin_I32(c, pfiSimdSub_I32(last, c));
+    *c1 = pfiSimdMin_I32(next, pfiSimdSub_I32(last, next));
+}
+
+static inline void
+pfiTexture2DWrap_CLAMP_TO_EDGE_simd(PFIsimdvi c, PFint size, PFIsimdvi* c0, PFIsimdvi* c1)
+{
+    PFIsimdvi zero = pfiSimdSetZero_I32(), last = pfiSimdSet1_I32(size - 1);
+
+    *c0 = pfiSimdClamp_I32(c, zero, last);
+    *c1 = pfiSimdClamp_I32(pfiSimdAdd_I32(c, pfiSimdSet1_I32(1)), zero, last);
+}
+
+/* SIMD - Texture2D Power-of-two Wrap Functions */
+
+// NOTE: See 'pfiTexture2DSplitPOT'
+static inline PFIsimdvi
+pfiTexture2DSplitPOT_simd(PFIsimdvf s, PFIsimdvi* weight)
+{
+    PFIsimdvi fixed = pfiSimdConvert_F32_I32(pfiSimdMul_F32(s, pfiSimdSet1_F32(256.0f)));
+    *weight = pfiSimdAnd_I32(fixed, pfiSimdSet1_I32(0xFF));
+    return pfiSimdShr_I32(fixed, 8);
+}
+
+static inline void
+pfiTexture2DWrapPOT_REPEAT_simd(PFIsimdvi c, PFint size, PFIsimdvi* c0, PFIsimdvi* c1)
+{
+    PFIsimdvi mask = pfiSimdSet1_I32(size - 1);
+
+    *c0 = pfiSimdAnd_I32(c, mask);
+    *c1 = pfiSimdAnd_I32(pfiSimdAdd_I32(c, pfiSimdSet1_I32(1)), mask);
+}
+
+static inline void
+pfiTexture2DWrapPOT_MIRRORED_REPEAT_simd(PFIsimdvi c, PFint size, PFIsimdvi* c0, PFIsimdvi* c1)
+{
+    PFIsimdvi mask = pfiSimdSet1_I32(size - 1), sizeV = pfiSimdSet1_I32(size);
+    PFIsimdvi next = pfiSimdAdd_I32(c, pfiSimdSet1_I32(1));
+
+    // NOTE: See 'pfiTexture2DWrapPOT_MIRRORED_REPEAT'
+    PFIsimdvi mirrored = pfiSimdCmpEQ_I32(pfiSimdAnd_I32(c, sizeV), sizeV);
+    PFIsimdvi nextMirrored = pfiSimdCmpEQ_I32(pfiSimdAnd_I32(next, sizeV), sizeV);
+
+    *c0 = pfiSimdBlendV_I8(pfiSimdAnd_I32(c, mask), pfiSimdAndNot_I32(c, mask), mirrored);
+    *c1 = pfiSimdBlendV_I8(pfiSimdAnd_I32(next, mask), pfiSimdAndNot_I32(next, mask), nextMirrored);
 }
 
 /* SIMD - Texture2D Sampler Functions */
@@ -263,10 +596,7 @@ pfiTexture2DSampler_NEAREST_REPEAT_simd(const struct PFItex* tex, const PFIsimdv
     pfiTexture2DMap_REPEAT_simd(
         tex, &x, &y, texcoords);
 
-    PFIsimdvi offsets = pfiSimdAdd_I32(pfiSimdMullo_I32(
-        y, pfiSimdSet1_I32(tex->w)), x);
-
-    return tex->getterSimd(tex->pixels, offsets);
+    return pfiGetTexel_simd(tex, x, y);
 }
 
 static inline PFIsimdvi
@@ -276,10 +606,7 @@ pfiTexture2DSampler_NEAREST_MIRRORED_REPEAT_simd(const struct PFItex* tex, const
     pfiTexture2DMap_MIRRORED_REPEAT_simd(
         tex, &x, &y, texcoords);
 
-    PFIsimdvi offsets = pfiSimdAdd_I32(pfiSimdMullo_I32(
-        y, pfiSimdSet1_I32(tex->w)), x);
-
-    return tex->getterSimd(tex->pixels, offsets);
+    return pfiGetTexel_simd(tex, x, y);
 }
 
 static inline PFIsimdvi
@@ -289,124 +616,97 @@ pfiTexture2DSampler_NEAREST_CLAMP_TO_EDGE_simd(const struct PFItex* tex, const P
     pfiTexture2DMap_CLAMP_TO_EDGE_simd(
         tex, &x, &y, texcoords);
 
-    PFIsimdvi offsets = pfiSimdAdd_I32(pfiSimdMullo_I32(
-        y, pfiSimdSet1_I32(tex->w)), x);
-
-    return tex->getterSimd(tex->pixels, offsets);
+    return pfiGetTexel_simd(tex, x, y);
 }
 
 static inline PFIsimdvi
 pfiTexture2DSampler_BILINEAR_REPEAT_simd(const struct PFItex* tex, const PFIsimdv2f texcoords)
 {
     PFIsimdvi x0, y0, x1, y1;
-    PFIsimdvf fx, fy;
-
-    PFIsimdv2f texelSize;
-    pfiVec2Set_simd(texelSize, tex->tx, tex->ty);
+    PFIsimdvi wx, wy;
 
-    PFIsimdv2f texcoords2;
-    pfiVec2AddR_simd(texcoords2, texcoords, texelSize);
+    PFIsimdvf u = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), *(PFIsimdvf*)GC_simd_f32_0p5);
+    PFIsimdvf v = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), *(PFIsimdvf*)GC_simd_f32_0p5);
 
-    pfiTexture2DMap_REPEAT_simd(tex, &x0, &y0, texcoords);
-    pfiTexture2DMap_REPEAT_simd(tex, &x1, &y1, texcoords2);
+    pfiTexture2DWrap_REPEAT_simd(pfiTexture2DSplit_simd(u, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrap_REPEAT_simd(pfiTexture2DSplit_simd(v, &wy), tex->h, &y0, &y1);
 
-    // Calculate fractions fx, fy
-    // REVIEW: It seems strange to me to have to clamp here, but the result is incorrect otherwise...
-    fx = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), pfiSimdConvert_I32_F32(x0));
-    fy = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), pfiSimdConvert_I32_F32(y0));
-    fx = pfiSimdClamp_F32(fx, pfiSimdSetZero_F32(), *(PFIsimdvf*)GC_simd_f32_1);
-    fy = pfiSimdClamp_F32(fy, pfiSimdSetZero_F32(), *(PFIsimdvf*)GC_simd_f32_1);
-
-    // Get the colors of the four pixels
-    PFIsimdvi c00 = tex->getterSimd(tex->pixels, y0 * tex->w + x0);
-    PFIsimdvi c10 = tex->getterSimd(tex->pixels, y0 * tex->w + x1);
-    PFIsimdvi c01 = tex->getterSimd(tex->pixels, y1 * tex->w + x0);
-    PFIsimdvi c11 = tex->getterSimd(tex->pixels, y1 * tex->w + x1);
-
-    // Interpolate colors horizontally
-    PFIsimdvi c0 = pfiColorLerpSmooth_simd(c00, c10, fx);
-    PFIsimdvi c1 = pfiColorLerpSmooth_simd(c01, c11, fx);
-
-    // Interpolate colors vertically
-    PFIsimdvi c = pfiColorLerpSmooth_simd(c0, c1, fy);
-
-    return c;
+    return pfiColorBilinear_simd(
+        pfiGetTexel_simd(tex, x0, y0), pfiGetTexel_simd(tex, x1, y0),
+        pfiGetTexel_simd(tex, x0, y1), pfiGetTexel_simd(tex, x1, y1),
+        wx, wy);
 }
 
 static inline PFIsimdvi
 pfiTexture2DSampler_BILINEAR_MIRRORED_REPEAT_simd(const struct PFItex* tex, const PFIsimdv2f texcoords)
 {
     PFIsimdvi x0, y0, x1, y1;
-    PFIsimdvf fx, fy;
-
-    PFIsimdv2f texelSize;
-    pfiVec2Set_simd(texelSize, tex->tx, tex->ty);
+    PFIsimdvi wx, wy;
 
-    PFIsimdv2f texcoords2;
-    pfiVec2AddR_simd(texcoords2, texcoords, texelSize);
+    PFIsimdvf u = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), *(PFIsimdvf*)GC_simd_f32_0p5);
+    PFIsimdvf v = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), *(PFIsimdvf*)GC_simd_f32_0p5);
 
-    pfiTexture2DMap_MIRRORED_REPEAT_simd(tex, &x0, &y0, texcoords);
-    pfiTexture2DMap_MIRRORED_REPEAT_simd(tex, &x1, &y1, texcoords2);
+    pfiTexture2DWrap_MIRRORED_REPEAT_simd(pfiTexture2DSplit_simd(u, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrap_MIRRORED_REPEAT_simd(pfiTexture2DSplit_simd(v, &wy), tex->h, &y0, &y1);
 
-    // Calculate fractions fx, fy
-    // REVIEW: It seems strange to me to have to clamp here, but the result is incorrect otherwise...
-    fx = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), pfiSimdConvert_I32_F32(x0));
-    fy = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), pfiSimdConvert_I32_F32(y0));
-    fx = pfiSimdClamp_F32(fx, pfiSimdSetZero_F32(), *(PFIsimdvf*)GC_simd_f32_1);
-    fy = pfiSimdClamp_F32(fy, pfiSimdSetZero_F32(), *(PFIsimdvf*)GC_simd_f32_1);
+    return pfiColorBilinear_simd(
+        pfiGetTexel_simd(tex, x0, y0), pfiGetTexel_simd(tex, x1, y0),
+        pfiGetTexel_simd(tex, x0, y1), pfiGetTexel_simd(tex, x1, y1),
+        wx, wy);
+}
 
-    // Get the colors of the four pixels
-    PFIsimdvi c00 = tex->getterSimd(tex->pixels, y0 * tex->w + x0);
-    PFIsimdvi c10 = tex->getterSimd(tex->pixels, y0 * tex->w + x1);
-    PFIsimdvi c01 = tex->getterSimd(tex->pixels, y1 * tex->w + x0);
-    PFIsimdvi c11 = tex->getterSimd(tex->pixels, y1 * tex->w + x1);
+static inline PFIsimdvi
+pfiTexture2DSampler_BILINEAR_CLAMP_TO_EDGE_simd(const struct PFItex* tex, const PFIsimdv2f texcoords)
+{
+    PFIsimdvi x0, y0, x1, y1;
+    PFIsimdvi wx, wy;
 
-    // Interpolate colors horizontally
-    PFIsimdvi c0 = pfiColorLerpSmooth_simd(c00, c10, fx);
-    PFIsimdvi c1 = pfiColorLerpSmooth_simd(c01, c11, fx);
+    PFIsimdvf u = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), *(PFIsimdvf*)GC_simd_f32_0p5);
+    PFIsimdvf v = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), *(PFIsimdvf*)GC_simd_f32_0p5);
 
-    // Interpolate colors vertically
-    PFIsimdvi c = pfiColorLerpSmooth_simd(c0, c1, fy);
+    pfiTexture2DWrap_CLAMP_TO_EDGE_simd(pfiTexture2DSplit_simd(u, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrap_CLAMP_TO_EDGE_simd(pfiTexture2DSplit_simd(v, &wy), tex->h, &y0, &y1);
 
-    return c;
+    return pfiColorBilinear_simd(
+        pfiGetTexel_simd(tex, x0, y0), pfiGetTexel_simd(tex, x1, y0),
+        pfiGetTexel_simd(tex, x0, y1), pfiGetTexel_simd(tex, x1, y1),
+        wx, wy);
 }
 
 static inline PFIsimdvi
-pfiTexture2DSampler_BILINEAR_CLAMP_TO_EDGE_simd(const struct PFItex* tex, const PFIsimdv2f texcoords)
+pfiTexture2DSamplerPOT_BILINEAR_REPEAT_simd(const struct PFItex* tex, const PFIsimdv2f texcoords)
 {
     PFIsimdvi x0, y0, x1, y1;
-    PFIsimdvf fx, fy;
+    PFIsimdvi wx, wy;
 
-    PFIsimdv2f texelSize;
-    pfiVec2Set_simd(texelSize, tex->tx, tex->ty);
+    PFIsimdvf u = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), *(PFIsimdvf*)GC_simd_f32_0p5);
+    PFIsimdvf v = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), *(PFIsimdvf*)GC_simd_f32_0p5);
 
-    PFIsimdv2f texcoords2;
-    pfiVec2AddR_simd(texcoords2, texcoords, texelSize);
+    pfiTexture2DWrapPOT_REPEAT_simd(pfiTexture2DSplitPOT_simd(u, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrapPOT_REPEAT_simd(pfiTexture2DSplitPOT_simd(v, &wy), tex->h, &y0, &y1);
 
-    pfiTexture2DMap_CLAMP_TO_EDGE_simd(tex, &x0, &y0, texcoords);
-    pfiTexture2DMap_CLAMP_TO_EDGE_simd(tex, &x1, &y1, texcoords2);
-
-    // Calculate fractions fx, fy
-    // REVIEW: It seems strange to me to have to clamp here, but the result is incorrect otherwise...
-    fx = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), pfiSimdConvert_I32_F32(x0));
-    fy = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), pfiSimdConvert_I32_F32(y0));
-    fx = pfiSimdClamp_F32(fx, pfiSimdSetZero_F32(), *(PFIsimdvf*)GC_simd_f32_1);
-    fy = pfiSimdClamp_F32(fy, pfiSimdSetZero_F32(), *(PFIsimdvf*)GC_simd_f32_1);
+    return pfiColorBilinear_simd(
+        pfiGetTexel_simd(tex, x0, y0), pfiGetTexel_simd(tex, x1, y0),
+        pfiGetTexel_simd(tex, x0, y1), pfiGetTexel_simd(tex, x1, y1),
+        wx, wy);
+}
 
-    // Get the colors of the four pixels
-    PFIsimdvi c00 = tex->getterSimd(tex->pixels, y0 * tex->w + x0);
-    PFIsimdvi c10 = tex->getterSimd(tex->pixels, y0 * tex->w + x1);
-    PFIsimdvi c01 = tex->getterSimd(tex->pixels, y1 * tex->w + x0);
-    PFIsimdvi c11 = tex->getterSimd(tex->pixels, y1 * tex->w + x1);
+static inline PFIsimdvi
+pfiTexture2DSamplerPOT_BILINEAR_MIRRORED_REPEAT_simd(const struct PFItex* tex, const PFIsimdv2f texcoords)
+{
+    PFIsimdvi x0, y0, x1, y1;
+    PFIsimdvi wx, wy;
 
-    // Interpolate colors horizontally
-    PFIsimdvi c0 = pfiColorLerpSmooth_simd(c00, c10, fx);
-    PFIsimdvi c1 = pfiColorLerpSmooth_simd(c01, c11, fx);
+    PFIsimdvf u = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[0], pfiSimdSet1_F32(tex->w)), *(PFIsimdvf*)GC_simd_f32_0p5);
+    PFIsimdvf v = pfiSimdSub_F32(pfiSimdMul_F32(texcoords[1], pfiSimdSet1_F32(tex->h)), *(PFIsimdvf*)GC_simd_f32_0p5);
 
-    // Interpolate colors vertically
-    PFIsimdvi c = pfiColorLerpSmooth_simd(c0, c1, fy);
+    pfiTexture2DWrapPOT_MIRRORED_REPEAT_simd(pfiTexture2DSplitPOT_simd(u, &wx), tex->w, &x0, &x1);
+    pfiTexture2DWrapPOT_MIRRORED_REPEAT_simd(pfiTexture2DSplitPOT_simd(v, &wy), tex->h, &y0, &y1);
 
-    return c;
+    return pfiColorBilinear_simd(
+        pfiGetTexel_simd(tex, x0, y0), pfiGetTexel_simd(tex, x1, y0),
+        pfiGetTexel_simd(tex, x0, y1), pfiGetTexel_simd(tex, x1, y1),
+        wx, wy);
 }
 
 static const PFItexturesampler_simd GC_textureSamplers_simd[2][3] = {
@@ -421,16 +721,75 @@ static const PFItexturesampler_simd GC_textureSamplers_simd[2][3] = {
 
 };
 
+static const PFItexturesampler_simd GC_textureSamplersPOT_simd[2][3] = {
+
+    [PF_NEAREST][PF_REPEAT]             = pfiTexture2DSampler_NEAREST_REPEAT_simd,
+    [PF_NEAREST][PF_MIRRORED_REPEAT]    = pfiTexture2DSampler_NEAREST_MIRRORED_REPEAT_simd,
+    [PF_NEAREST][PF_CLAMP_TO_EDGE]      = pfiTexture2DSampler_NEAREST_CLAMP_TO_EDGE_simd,
+
+    [PF_BILINEAR][PF_REPEAT]            = pfiTexture2DSamplerPOT_BILINEAR_REPEAT_simd,
+    [PF_BILINEAR][PF_MIRRORED_REPEAT]   = pfiTexture2DSamplerPOT_BILINEAR_MIRRORED_REPEAT_simd,
+    [PF_BILINEAR][PF_CLAMP_TO_EDGE]     = pfiTexture2DSampler_BILINEAR_CLAMP_TO_EDGE_simd,
+
+};
+
+/* SIMD - Texture2D Mipmap Functions */
+
+// NOTE: Samples a texture using a mipmap filter, with the same level of detail for all the texels
+static inline PFIsimdvi
+pfiTexture2DSampleLod_simd(const struct PFItex* tex, const PFIsimdv2f texcoords, PFfloat lod)
+{
+    if (lod <= 0.0f || tex->mipmapCount == 0) {
+        return tex->samplerSimd(tex, texcoords);
+    }
+
+    if (tex->filter == PF_NEAREST_MIPMAP_NEAREST || tex->filter == PF_BILINEAR_MIPMAP_NEAREST) {
+        const struct PFItex *level = pfiGetTextureLevel(tex, (PFsizei)(lod + 0.5f));
+        return level->samplerSimd(level, texcoords);
+    }
+
+    PFsizei l = (PFsizei)lod;
+    const struct PFItex *level0 = pfiGetTextureLevel(tex, l);
+    const struct PFItex *level1 = pfiGetTextureLevel(tex, l + 1);
+
+    PFIsimdvi c0 = level0->samplerSimd(level0, texcoords);
+    if (level0 == level1) return c0;
+
+    return pfiColorLerpSmooth_simd(c0, level1->samplerSimd(level1, texcoords), pfiSimdSet1_F32(lod - l));
+}
+
 #endif //PF_SIMD_SUPPORT
 
 
 /* Internal helper functions */
 
+static inline PFboolean
+pfiIsTexturePOT(const struct PFItex* tex)
+{
+    return (tex->w & (tex->w - 1)) == 0 && (tex->h & (tex->h - 1)) == 0;
+}
+
+// NOTE: Installs the samplers of a filter within a level (see 'pfiGetLevelFilter'), those that
+//       wrap the texels with masks are installed if the size of the texture is a power of two
+static inline void
+pfiSetTextureSampler(struct PFItex* tex, PFtexturefilter levelFilter, PFtexturewrap wrapMode)
+{
+    PFboolean pot = pfiIsTexturePOT(tex);
+
+    tex->sampler = pot ? GC_textureSamplersPOT[levelFilter][wrapMode]
+                       : GC_textureSamplers[levelFilter][wrapMode];
+
+#if PF_SIMD_SUPPORT
+    tex->samplerSimd = pot ? GC_textureSamplersPOT_simd[levelFilter][wrapMode]
+                           : GC_textureSamplers_simd[levelFilter][wrapMode];
+#endif //PF_SIMD_SUPPORT
+}
+
 static inline PFboolean
 pfiIsTextureParameterValid(PFtexturewrap wrapMode, PFtexturefilter filterMode)
 {
     return (wrapMode >= PF_REPEAT && wrapMode <= PF_CLAMP_TO_EDGE)
-        && (filterMode >= PF_NEAREST && filterMode <= PF_BILINEAR);
+        && (filterMode >= PF_NEAREST && filterMode <= PF_BILINEAR_MIPMAP_LINEAR);
 }
 
 #endif //PF_INTERNAL_SAMPLER_H
@@ -623,7 +623,7 @@ pfiSimdSetZero_F32(void)
 #   define pfiSimdFloor_F32(x) \
         _mm256_floor_ps(x)
 #elif defined(__SSE2__)
-#   define pfiSimdRound_F32(x) \
+#   define pfiSimdFloor_F32(x) \
         _mm_floor_ps(x)
 #endif
 
@@ -631,7 +631,7 @@ pfiSimdSetZero_F32(void)
 #   define pfiSimdCeil_F32(x) \
         _mm256_ceil_ps(x)
 #elif defined(__SSE2__)
-#   define pfiSimdRound_F32(x) \
+#   define pfiSimdCeil_F32(x) \
         _mm_ceil_ps(x)
 #endif
 
@@ -697,6 +697,26 @@ pfiSimdUnpackHi_I16(PFIsimdvi x, PFIsimdvi y)
 #endif
 }
 
+static inline PFIsimdvi
+pfiSimdUnpackLo_I32(PFIsimdvi x, PFIsimdvi y)
+{
+#if defined(__AVX2__)
+    return _mm256_unpacklo_epi32(x, y);
+#elif defined(__SSE2__)
+    return _mm_unpacklo_epi32(x, y);
+#endif
+}
+
+static inline PFIsimdvi
+pfiSimdUnpackHi_I32(PFIsimdvi x, PFIsimdvi y)
+{
+#if defined(__AVX2__)
+    return _mm256_unpackhi_epi32(x, y);
+#elif defined(__SSE2__)
+    return _mm_unpackhi_epi32(x, y);
+#endif
+}
+
 static inline void
 pfiSimdStore_I8(void* p, PFIsimdvi x)
 {
@@ -1102,6 +1122,16 @@ pfiSimdAdd_I32(PFIsimdvi x, PFIsimdvi y)
 #endif
 }
 
+static inline PFIsimdvi
+pfiSimdAdd_I16(PFIsimdvi x, PFIsimdvi y)
+{
+#if defined(__AVX2__)
+    return _mm256_add_epi16(x, y);
+#elif defined(__SSE2__)
+    return _mm_add_epi16(x, y);
+#endif
+}
+
 static inline PFIsimdvf
 pfiSimdAdd_F32(PFIsimdvf x, PFIsimdvf y)
 {
@@ -1144,6 +1174,16 @@ pfiSimdMullo_I32(PFIsimdvi x, PFIsimdvi y)
 #endif
 }
 
+static inline PFIsimdvi
+pfiSimdMullo_I16(PFIsimdvi x, PFIsimdvi y)
+{
+#if defined(__AVX2__)
+    return _mm256_mullo_epi16(x, y);
+#elif defined(__SSE2__)
+    return _mm_mullo_epi16(x, y);
+#endif
+}
+
 static inline PFIsimdvf
 pfiSimdMul_F32(PFIsimdvf x, PFIsimdvf y)
 {
@@ -1342,6 +1382,30 @@ pfiSimdShl_I32(PFIsimdvi x, int32_t imm8)
 #endif
 }
 
+static inline PFIsimdvi
+pfiSimdShr_I16(PFIsimdvi x, int32_t imm8)
+{
+#if defined(__AVX2__)
+    return _mm256_srli_epi16(x, imm8);
+#elif defined(__SSE2__)
+    return _mm_srli_epi16(x, imm8);
+#endif
+}
+
+static inline PFIsimdvi
+pfiSimdShrV_I32(PFIsimdvi x, PFIsimdvi counts)
+{
+#if defined(__AVX2__)
+    return _mm256_srlv_epi32(x, counts);
+#elif defined(__SSE2__)
+    uint32_t xx[4], cc[4];
+    _mm_storeu_si128((__m128i*)xx, x);
+    _mm_storeu_si128((__m128i*)cc, counts);
+    for (int j = 0; j < 4; j++) xx[j] = (cc[j] < 32) ? xx[j] >> cc[j] : 0;
+    return _mm_loadu_si128((__m128i const*)xx);
+#endif
+}
+
 static inline int32_t
 pfiSimdMoveMask_F32(PFIsimdvf x)
 {
@@ -1532,9 +1596,9 @@ static inline PFIsimdvi
 pfiSimdCmpLE_I32(PFIsimdvi x, PFIsimdvi y)
 {
 #if defined(__AVX2__)
-    return _mm256_cmpgt_epi32(y, x);
+    return _mm256_or_si256(_mm256_cmpgt_epi32(y, x), _mm256_cmpeq_epi32(x, y));
 #elif defined(__SSE2__)
-    return _mm_cmplt_epi32(x, y);
+    return _mm_or_si128(_mm_cmplt_epi32(x, y), _mm_cmpeq_epi32(x, y));
 #endif
 }
 
@@ -1552,9 +1616,9 @@ static inline PFIsimdvi
 pfiSimdCmpGE_I32(PFIsimdvi x, PFIsimdvi y)
 {
 #if defined(__AVX2__)
-    return _mm256_cmpgt_epi32(x, y);
+    return _mm256_or_si256(_mm256_cmpgt_epi32(x, y), _mm256_cmpeq_epi32(x, y));
 #elif defined(__SSE2__)
-    return _mm_cmpgt_epi32(x, y);
+    return _mm_or_si128(_mm_cmpgt_epi32(x, y), _mm_cmpeq_epi32(x, y));
 #endif
 }
 
@@ -0,0 +1,149 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_SKINNING_H
+#define PF_INTERNAL_SKINNING_H
+
+#include "./context/context.h"
+#include "../pixelforge.h"
+#include "./attribute.h"
+#include "./simd.h"
+
+/* Helper functions */
+
+// NOTE: Returns the number of influences fetched, influences
+//       referring to a bone outside the palette get a null weight
+static inline PFint
+pfiFetchBoneInfluences(PFuint* PF_RESTRICT bones, PFfloat* PF_RESTRICT weights,
+                       const PFIvertexattribs* attribs, PFsizei index)
+{
+    const PFIvertexattribbuffer *boneIndices = &attribs->boneIndices;
+    const void *src = pfiGetAttribElement(boneIndices, index);
+
+    PFint count = (attribs->weights.size < boneIndices->size)
+        ? attribs->weights.size : boneIndices->size;
+
+    pfiFetchAttrib(weights, &attribs->weights, index);
+
+    for (int_fast8_t i = 0; i < count; i++) {
+        switch (boneIndices->type) {
+            case PF_UNSIGNED_BYTE:  bones[i] = ((const PFubyte*)src)[i];   break;
+            case PF_UNSIGNED_SHORT: bones[i] = ((const PFushort*)src)[i];  break;
+            case PF_UNSIGNED_INT:   bones[i] = ((const PFuint*)src)[i];    break;
+            default:                bones[i] = PF_MAX_BONE_MATRICES;       break;
+        }
+        if (bones[i] >= PF_MAX_BONE_MATRICES) {
+            bones[i] = 0, weights[i] = 0.0f;
+        }
+    }
+
+    return count;
+}
+
+/* Vertex skinning functions */
+
+// NOTE: The bone matrices are first blended by their weights, so that the position
+//       and the normal are transformed only once, by the same (blended) matrix.
+//       'normal' can be NULL, in which case only the position is skinned.
+static inline void
+pfiSkinVertex(PFMvec4 position, PFfloat* normal, const PFMmat4* palette,
+              const PFIvertexattribs* attribs, PFsizei index)
+{
+    PFuint bones[4];
+    PFfloat weights[4];
+
+    PFint count = pfiFetchBoneInfluences(bones, weights, attribs, index);
+
+#if defined(__SSE__)
+
+    __m128 c0, c1, c2, c3;
+
+#   if defined(__AVX__)
+
+    // Two columns per register
+    __m256 m01 = _mm256_setzero_ps();
+    __m256 m23 = _mm256_setzero_ps();
+
+    for (int_fast8_t i = 0; i < count; i++) {
+        const PFfloat *m = palette[bones[i]];
+        __m256 w = _mm256_set1_ps(weights[i]);
+        m01 = _mm256_add_ps(m01, _mm256_mul_ps(_mm256_loadu_ps(m), w));
+        m23 = _mm256_add_ps(m23, _mm256_mul_ps(_mm256_loadu_ps(m + 8), w));
+    }
+
+    c0 = _mm256_castps256_ps128(m01), c1 = _mm256_extractf128_ps(m01, 1);
+    c2 = _mm256_castps256_ps128(m23), c3 = _mm256_extractf128_ps(m23, 1);
+
+#   else
+
+    c0 = c1 = c2 = c3 = _mm_setzero_ps();
+
+    for (int_fast8_t i = 0; i < count; i++) {
+        const PFfloat *m = palette[bones[i]];
+        __m128 w = _mm_set1_ps(weights[i]);
+        c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(m), w));
+        c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(m + 4), w));
+        c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(m + 8), w));
+        c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(m + 12), w));
+    }
+
+#   endif //__AVX__
+
+    __m128 p = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(position[0])), _mm_mul_ps(c1, _mm_set1_ps(position[1]))),
+        _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(position[2])), _mm_mul_ps(c3, _mm_set1_ps(position[3]))));
+
+    _mm_storeu_ps(position, p);
+
+    if (normal) {
+        __m128 n = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(normal[0])), _mm_mul_ps(c1, _mm_set1_ps(normal[1]))),
+            _mm_mul_ps(c2, _mm_set1_ps(normal[2])));
+
+        PFMvec4 result;
+        _mm_storeu_ps(result, n);
+        memcpy(normal, result, sizeof(PFMvec3));
+    }
+
+#else
+
+    PFMmat4 mat = { 0 };
+
+    for (int_fast8_t i = 0; i < count; i++) {
+        const PFfloat *m = palette[bones[i]];
+        for (int_fast8_t j = 0; j < 16; j++) {
+            mat[j] += m[j]*weights[i];
+        }
+    }
+
+    pfmVec4Transform(position, position, mat);
+
+    if (normal) {
+        PFMvec3 n = {
+            mat[0]*normal[0] + mat[4]*normal[1] + mat[8]*normal[2],
+            mat[1]*normal[0] + mat[5]*normal[1] + mat[9]*normal[2],
+            mat[2]*normal[0] + mat[6]*normal[1] + mat[10]*normal[2]
+        };
+        memcpy(normal, n, sizeof(PFMvec3));
+    }
+
+#endif //__SSE__
+}
+
+#endif //PF_INTERNAL_SKINNING_H
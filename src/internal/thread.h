@@ -0,0 +1,268 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_THREAD_H
+#define PF_INTERNAL_THREAD_H
+
+#include "../pixelforge.h"
+
+#if defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   include <windows.h>
+#else
+#   include <pthread.h>
+#   include <unistd.h>
+#   if defined(__linux__)
+#       include <sched.h>
+#   endif //__linux__
+#endif //_WIN32
+
+/* Thread types */
+
+#if defined(_WIN32)
+
+typedef HANDLE              PFIthread;
+typedef CRITICAL_SECTION    PFImutex;
+typedef CONDITION_VARIABLE  PFIcond;
+
+// NOTE: Thread entry points must be declared with this macro,
+//       they must end with 'PFI_THREAD_RETURN'
+#define PFI_THREAD_FUNC(name, arg) DWORD WINAPI name(LPVOID arg)
+#define PFI_THREAD_RETURN return 0
+
+typedef LPTHREAD_START_ROUTINE PFIthreadfunc;
+
+typedef INIT_ONCE           PFIonce;
+#define PFI_ONCE_INIT       INIT_ONCE_STATIC_INIT
+
+#else
+
+typedef pthread_t           PFIthread;
+typedef pthread_mutex_t     PFImutex;
+typedef pthread_cond_t      PFIcond;
+
+// NOTE: Thread entry points must be declared with this macro,
+//       they must end with 'PFI_THREAD_RETURN'
+#define PFI_THREAD_FUNC(name, arg) void* name(void* arg)
+#define PFI_THREAD_RETURN return NULL
+
+typedef void* (*PFIthreadfunc)(void*);
+
+typedef pthread_once_t      PFIonce;
+#define PFI_ONCE_INIT       PTHREAD_ONCE_INIT
+
+#endif //_WIN32
+
+/* Thread functions */
+
+static inline PFboolean
+pfiThreadCreate(PFIthread* thread, PFIthreadfunc func, void* arg)
+{
+#if defined(_WIN32)
+    *thread = CreateThread(NULL, 0, func, arg, 0, NULL);
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, func, arg) == 0;
+#endif //_WIN32
+}
+
+static inline void
+pfiThreadJoin(PFIthread thread)
+{
+#if defined(_WIN32)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif //_WIN32
+}
+
+static inline PFboolean
+pfiThreadIsCurrent(PFIthread thread)
+{
+#if defined(_WIN32)
+    return GetThreadId(thread) == GetCurrentThreadId();
+#else
+    return pthread_equal(thread, pthread_self()) != 0;
+#endif //_WIN32
+}
+
+// NOTE: Pins the thread to the given logical processor, the request
+//       is ignored on platforms that don't expose thread affinity
+static inline void
+pfiThreadSetAffinity(PFIthread thread, PFint cpu)
+{
+#if defined(_WIN32)
+    SetThreadAffinityMask(thread, (DWORD_PTR)1 << (cpu % (8*sizeof(DWORD_PTR))));
+#elif defined(__linux__) && defined(CPU_SET)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread, sizeof(cpu_set_t), &set);
+#else
+    (void)thread, (void)cpu;
+#endif //_WIN32
+}
+
+static inline PFint
+pfiGetProcessorCount(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (PFint)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (PFint)count : 1;
+#else
+    return 1;
+#endif //_WIN32
+}
+
+/* Mutex functions */
+
+static inline void
+pfiMutexInit(PFImutex* mutex)
+{
+#if defined(_WIN32)
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif //_WIN32
+}
+
+static inline void
+pfiMutexDestroy(PFImutex* mutex)
+{
+#if defined(_WIN32)
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif //_WIN32
+}
+
+static inline void
+pfiMutexLock(PFImutex* mutex)
+{
+#if defined(_WIN32)
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif //_WIN32
+}
+
+static inline void
+pfiMutexUnlock(PFImutex* mutex)
+{
+#if defined(_WIN32)
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif //_WIN32
+}
+
+/* Condition variable functions */
+
+static inline void
+pfiCondInit(PFIcond* cond)
+{
+#if defined(_WIN32)
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif //_WIN32
+}
+
+static inline void
+pfiCondDestroy(PFIcond* cond)
+{
+#if defined(_WIN32)
+    (void)cond; // NOTE: Windows condition variables don't need to be destroyed
+#else
+    pthread_cond_destroy(cond);
+#endif //_WIN32
+}
+
+static inline void
+pfiCondWait(PFIcond* cond, PFImutex* mutex)
+{
+#if defined(_WIN32)
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif //_WIN32
+}
+
+static inline void
+pfiCondBroadcast(PFIcond* cond)
+{
+#if defined(_WIN32)
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif //_WIN32
+}
+
+/* Once functions */
+
+#if defined(_WIN32)
+static BOOL CALLBACK
+pfiOnceCallback(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+    (void)once, (void)context;
+    ((void (*)(void))param)();
+    return TRUE;
+}
+#endif //_WIN32
+
+static inline void
+pfiCallOnce(PFIonce* once, void (*func)(void))
+{
+#if defined(_WIN32)
+    InitOnceExecuteOnce(once, pfiOnceCallback, (PVOID)func, NULL);
+#else
+    pthread_once(once, func);
+#endif //_WIN32
+}
+
+/* Atomic functions */
+
+static inline PFint
+pfiAtomicFetchAdd(volatile PFint* value, PFint increment)
+{
+#if defined(_WIN32)
+    return (PFint)InterlockedExchangeAdd((volatile LONG*)value, (LONG)increment);
+#else
+    return __atomic_fetch_add(value, increment, __ATOMIC_ACQ_REL);
+#endif //_WIN32
+}
+
+static inline void
+pfiAtomicStore(volatile PFint* value, PFint newValue)
+{
+#if defined(_WIN32)
+    InterlockedExchange((volatile LONG*)value, (LONG)newValue);
+#else
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+#endif //_WIN32
+}
+
+#endif //PF_INTERNAL_THREAD_H
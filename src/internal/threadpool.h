@@ -0,0 +1,49 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#ifndef PF_INTERNAL_THREADPOOL_H
+#define PF_INTERNAL_THREADPOOL_H
+
+#include "../pixelforge.h"
+
+/**
+ * @brief Runs 'func' over the range [begin, end) split in chunks of 'grain' iterations.
+ *
+ * The chunks are distributed between the calling thread and the worker threads of the
+ * library (or the job dispatcher defined with 'pfSetJobDispatcher'), the function only
+ * returns once all of them have been processed. 'G_currentCtx' is made current for the
+ * threads running the chunks, so 'func' can use the current context like the caller.
+ *
+ * If 'grain' is less than or equal to zero, the range is split evenly between the threads.
+ * The range is run on the calling thread alone if it fits in a single chunk, if only one
+ * thread is available, or if the worker threads are already busy with another range
+ * (nested call or call from another context).
+ */
+void pfiParallelFor(PFint begin, PFint end, PFint grain, PFjobfunc func, void* job);
+
+// NOTE: Runs the range on the calling thread if 'parallel' is false,
+//       used for the loops that are only worth sharing above a threshold
+static inline void
+pfiParallelForIf(PFboolean parallel, PFint begin, PFint end, PFint grain, PFjobfunc func, void* job)
+{
+    if (parallel) pfiParallelFor(begin, end, grain, func, job);
+    else func(job, begin, end);
+}
+
+#endif //PF_INTERNAL_THREADPOOL_H
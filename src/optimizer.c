@@ -0,0 +1,530 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+#include "internal/context/context.h"
+#include "internal/config.h"
+#include "pixelforge.h"
+#include "pfm.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Internal structures */
+
+typedef struct {
+    PFuint *counts;     ///< Number of triangles referencing each vertex
+    PFuint *offsets;    ///< Offset of the first triangle of each vertex in 'data'
+    PFuint *data;       ///< Triangle indices, grouped by vertex
+} PFItriadjacency;
+
+typedef struct {
+    PFfloat key;        ///< View-independent occlusion potential of the cluster
+    PFuint index;       ///< Index of the cluster (used to keep the sort stable)
+} PFIclustersortkey;
+
+/* Some static helper functions */
+
+static void pfiSetOptimizerError(PFerrcode errCode)
+{
+    if (G_currentCtx) {
+        G_currentCtx->errCode = errCode;
+    }
+}
+
+static PFuint pfiGetIndex(const void* indices, PFdatatype type, PFsizei i)
+{
+    switch (type) {
+        case PF_UNSIGNED_BYTE:  return ((const PFubyte*)indices)[i];
+        case PF_UNSIGNED_SHORT: return ((const PFushort*)indices)[i];
+        case PF_UNSIGNED_INT:   return ((const PFuint*)indices)[i];
+        default: break;
+    }
+    return 0;
+}
+
+static void pfiSetIndex(void* indices, PFdatatype type, PFsizei i, PFuint value)
+{
+    switch (type) {
+        case PF_UNSIGNED_BYTE:  ((PFubyte*)indices)[i] = (PFubyte)value;    break;
+        case PF_UNSIGNED_SHORT: ((PFushort*)indices)[i] = (PFushort)value;  break;
+        case PF_UNSIGNED_INT:   ((PFuint*)indices)[i] = value;              break;
+        default: break;
+    }
+}
+
+// NOTE: Validates the parameters common to all index optimization functions
+//       and returns a copy of the indices converted to 'PFuint', or NULL on error.
+static PFuint* pfiLoadTriangleIndices(const void* indices, PFsizei count, PFdatatype type, PFsizei vertexCount)
+{
+    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT)) {
+        pfiSetOptimizerError(PF_INVALID_ENUM);
+        return NULL;
+    }
+
+    if (indices == NULL || count == 0 || count % 3 != 0 || vertexCount == 0) {
+        pfiSetOptimizerError(PF_INVALID_VALUE);
+        return NULL;
+    }
+
+    PFuint *result = (PFuint*)PF_MALLOC(count * sizeof(PFuint));
+
+    if (result == NULL) {
+        pfiSetOptimizerError(PF_ERROR_OUT_OF_MEMORY);
+        return NULL;
+    }
+
+    for (PFsizei i = 0; i < count; i++) {
+        result[i] = pfiGetIndex(indices, type, i);
+        if (result[i] >= vertexCount) {
+            pfiSetOptimizerError(PF_INVALID_VALUE);
+            PF_FREE(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+static PFboolean pfiGenTriangleAdjacency(PFItriadjacency* adjacency, const PFuint* indices, PFsizei count, PFsizei vertexCount)
+{
+    adjacency->counts = (PFuint*)PF_CALLOC(vertexCount, sizeof(PFuint));
+    adjacency->offsets = (PFuint*)PF_MALLOC(vertexCount * sizeof(PFuint));
+    adjacency->data = (PFuint*)PF_MALLOC(count * sizeof(PFuint));
+
+    // NOTE: On failure the buffers are left to 'pfiDeleteTriangleAdjacency',
+    //       which the caller runs in any case
+    if (!adjacency->counts || !adjacency->offsets || !adjacency->data) {
+        return PF_FALSE;
+    }
+
+    for (PFsizei i = 0; i < count; i++) {
+        adjacency->counts[indices[i]]++;
+    }
+
+    PFuint offset = 0;
+    for (PFsizei i = 0; i < vertexCount; i++) {
+        adjacency->offsets[i] = offset;
+        offset += adjacency->counts[i];
+    }
+
+    // NOTE: The offsets are used as insertion cursors,
+    //       then rewound once all the triangles are placed
+    for (PFsizei i = 0; i < count; i++) {
+        adjacency->data[adjacency->offsets[indices[i]]++] = i / 3;
+    }
+
+    for (PFsizei i = 0; i < vertexCount; i++) {
+        adjacency->offsets[i] -= adjacency->counts[i];
+    }
+
+    return PF_TRUE;
+}
+
+static void pfiDeleteTriangleAdjacency(PFItriadjacency* adjacency)
+{
+    PF_FREE(adjacency->counts);
+    PF_FREE(adjacency->offsets);
+    PF_FREE(adjacency->data);
+}
+
+// NOTE: Simulates a FIFO post-transform cache of 'PF_VERTEX_CACHE_SIZE' entries,
+//       'cache' stores for each vertex the timestamp at which it entered the cache.
+static PFuint pfiCacheMisses(const PFuint* triangle, PFuint* cache, PFuint* timestamp)
+{
+    PFuint misses = 0;
+
+    for (int_fast8_t i = 0; i < 3; i++) {
+        PFuint v = triangle[i];
+        if (*timestamp - cache[v] > PF_VERTEX_CACHE_SIZE) {
+            cache[v] = (*timestamp)++;
+            misses++;
+        }
+    }
+
+    return misses;
+}
+
+static int pfiCompareClusterSortKeys(const void* a, const void* b)
+{
+    const PFIclustersortkey *ka = a, *kb = b;
+
+    // Sort in descending order of occlusion potential,
+    // equal keys keep their original order
+    if (ka->key != kb->key) return (ka->key < kb->key) ? 1 : -1;
+    return (ka->index > kb->index) - (ka->index < kb->index);
+}
+
+
+/* Mesh optimization functions */
+
+void pfOptimizeVertexCache(void* indices, PFsizei count, PFdatatype type, PFsizei vertexCount)
+{
+    // This is an implementation of "Tipsify" from
+    // Sander, Nehab and Barczak - "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (2007)
+
+    PFuint *input = pfiLoadTriangleIndices(indices, count, type, vertexCount);
+    if (input == NULL) return;
+
+    const PFsizei triangleCount = count / 3;
+    const PFint cacheSize = PF_VERTEX_CACHE_SIZE;
+
+    PFItriadjacency adjacency = { 0 };
+
+    PFuint *live = (PFuint*)PF_MALLOC(vertexCount * sizeof(PFuint));
+    PFuint *cache = (PFuint*)PF_CALLOC(vertexCount, sizeof(PFuint));
+    PFuint *deadEnd = (PFuint*)PF_MALLOC(count * sizeof(PFuint));
+    PFuint *candidates = (PFuint*)PF_MALLOC(count * sizeof(PFuint));
+    PFuint *output = (PFuint*)PF_MALLOC(count * sizeof(PFuint));
+    PFubyte *emitted = (PFubyte*)PF_CALLOC(triangleCount, sizeof(PFubyte));
+
+    if (!live || !cache || !deadEnd || !candidates || !output || !emitted
+        || !pfiGenTriangleAdjacency(&adjacency, input, count, vertexCount)) {
+        pfiSetOptimizerError(PF_ERROR_OUT_OF_MEMORY);
+        goto cleanup;
+    }
+
+    memcpy(live, adjacency.counts, vertexCount * sizeof(PFuint));
+
+    PFsizei outputCounter = 0;
+    PFsizei deadEndCounter = 0;
+    PFsizei cursor = 0;
+
+    // NOTE: The timestamp starts beyond the cache size so
+    //       that all vertices are initially out of the cache
+    PFint timestamp = cacheSize + 1;
+    PFint fanning = 0;
+
+    while (fanning >= 0) {
+        PFsizei candidatesCounter = 0;
+
+        // Emit all the remaining triangles around the fanning vertex
+
+        const PFuint *neighbors = adjacency.data + adjacency.offsets[fanning];
+
+        for (PFuint i = 0; i < adjacency.counts[fanning]; i++) {
+            PFuint t = neighbors[i];
+            if (emitted[t]) continue;
+
+            for (int_fast8_t j = 0; j < 3; j++) {
+                PFuint v = input[3*t + j];
+
+                output[outputCounter++] = v;
+                deadEnd[deadEndCounter++] = v;
+                candidates[candidatesCounter++] = v;
+                live[v]--;
+
+                if (timestamp - (PFint)cache[v] > cacheSize) {
+                    cache[v] = timestamp++;
+                }
+            }
+
+            emitted[t] = 1;
+        }
+
+        // Select the candidate that will stay in the cache the
+        // longest while still having live triangles to emit
+
+        PFint bestPriority = -1;
+        fanning = -1;
+
+        for (PFsizei i = 0; i < candidatesCounter; i++) {
+            PFuint v = candidates[i];
+            if (live[v] == 0) continue;
+
+            PFint priority = 0;
+            if (timestamp - (PFint)cache[v] + 2*(PFint)live[v] <= cacheSize) {
+                priority = timestamp - (PFint)cache[v];
+            }
+
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                fanning = (PFint)v;
+            }
+        }
+
+        // Dead-end: fall back to recently used vertices, then to the input order
+
+        if (fanning < 0) {
+            while (deadEndCounter > 0) {
+                PFuint v = deadEnd[--deadEndCounter];
+                if (live[v] > 0) {
+                    fanning = (PFint)v;
+                    break;
+                }
+            }
+        }
+
+        if (fanning < 0) {
+            while (cursor < vertexCount) {
+                if (live[cursor] > 0) {
+                    fanning = (PFint)cursor;
+                    break;
+                }
+                cursor++;
+            }
+        }
+    }
+
+    for (PFsizei i = 0; i < count; i++) {
+        pfiSetIndex(indices, type, i, output[i]);
+    }
+
+cleanup:
+    pfiDeleteTriangleAdjacency(&adjacency);
+    PF_FREE(emitted);
+    PF_FREE(output);
+    PF_FREE(candidates);
+    PF_FREE(deadEnd);
+    PF_FREE(cache);
+    PF_FREE(live);
+    PF_FREE(input);
+}
+
+void pfOptimizeOverdraw(void* indices, PFsizei count, PFdatatype type, const PFfloat* positions, PFint size, PFsizei vertexCount, PFfloat threshold)
+{
+    if (positions == NULL || size < 2 || size > 4 || threshold < 1.0f) {
+        pfiSetOptimizerError(PF_INVALID_VALUE);
+        return;
+    }
+
+    PFuint *input = pfiLoadTriangleIndices(indices, count, type, vertexCount);
+    if (input == NULL) return;
+
+    const PFsizei triangleCount = count / 3;
+
+    PFuint *cache = (PFuint*)PF_CALLOC(vertexCount, sizeof(PFuint));
+    PFuint *hardClusters = (PFuint*)PF_MALLOC((triangleCount + 1) * sizeof(PFuint));
+    PFuint *clusters = (PFuint*)PF_MALLOC((triangleCount + 1) * sizeof(PFuint));
+    PFIclustersortkey *sortKeys = (PFIclustersortkey*)PF_MALLOC(triangleCount * sizeof(PFIclustersortkey));
+
+    if (!cache || !hardClusters || !clusters || !sortKeys) {
+        pfiSetOptimizerError(PF_ERROR_OUT_OF_MEMORY);
+        goto cleanup;
+    }
+
+    /* Split the triangles into clusters at the points where the cache is entirely renewed */
+
+    PFuint timestamp = PF_VERTEX_CACHE_SIZE + 1;
+    PFsizei hardClusterCount = 0;
+
+    for (PFsizei t = 0; t < triangleCount; t++) {
+        if (pfiCacheMisses(input + 3*t, cache, &timestamp) == 3) {
+            hardClusters[hardClusterCount++] = t;
+        }
+    }
+
+    hardClusters[hardClusterCount] = triangleCount;
+
+    /* Split again the clusters as long as it does not degrade their cache efficiency beyond the threshold */
+
+    PFsizei clusterCount = 0;
+
+    for (PFsizei c = 0; c < hardClusterCount; c++) {
+        PFuint start = hardClusters[c];
+        PFuint end = hardClusters[c + 1];
+
+        timestamp += PF_VERTEX_CACHE_SIZE + 1;
+
+        PFuint clusterMisses = 0;
+        for (PFuint t = start; t < end; t++) {
+            clusterMisses += pfiCacheMisses(input + 3*t, cache, &timestamp);
+        }
+
+        PFfloat clusterThreshold = threshold * (PFfloat)clusterMisses / (PFfloat)(end - start);
+
+        timestamp += PF_VERTEX_CACHE_SIZE + 1;
+        clusters[clusterCount++] = start;
+
+        PFuint runningMisses = 0;
+        PFuint runningTriangles = 0;
+
+        for (PFuint t = start; t < end - 1; t++) {
+            runningMisses += pfiCacheMisses(input + 3*t, cache, &timestamp);
+            runningTriangles++;
+
+            if ((PFfloat)runningMisses <= clusterThreshold * (PFfloat)runningTriangles) {
+                clusters[clusterCount++] = t + 1;
+                timestamp += PF_VERTEX_CACHE_SIZE + 1;
+                runningMisses = runningTriangles = 0;
+            }
+        }
+    }
+
+    clusters[clusterCount] = triangleCount;
+
+    /* Compute the area-weighted centroid and the average normal of each cluster */
+
+    PFMvec3 *centroids = (PFMvec3*)PF_MALLOC(clusterCount * sizeof(PFMvec3));
+    PFMvec3 *normals = (PFMvec3*)PF_MALLOC(clusterCount * sizeof(PFMvec3));
+    PFuint *output = (PFuint*)PF_MALLOC(count * sizeof(PFuint));
+
+    if (!centroids || !normals || !output) {
+        pfiSetOptimizerError(PF_ERROR_OUT_OF_MEMORY);
+        goto cleanup_clusters;
+    }
+
+    PFMvec3 meshCentroid = { 0 };
+    PFfloat meshArea = 0.0f;
+
+    for (PFsizei c = 0; c < clusterCount; c++) {
+        PFfloat clusterArea = 0.0f;
+
+        memset(centroids[c], 0, sizeof(PFMvec3));
+        memset(normals[c], 0, sizeof(PFMvec3));
+
+        for (PFuint t = clusters[c]; t < clusters[c + 1]; t++) {
+            PFMvec3 p[3] = { 0 };
+            for (int_fast8_t i = 0; i < 3; i++) {
+                const PFfloat *src = positions + input[3*t + i]*size;
+                for (int_fast8_t j = 0; j < PF_MIN(size, 3); j++) p[i][j] = src[j];
+            }
+
+            PFMvec3 e1, e2, n;
+            pfmVec3Sub(e1, p[1], p[0]);
+            pfmVec3Sub(e2, p[2], p[0]);
+            pfmVec3Cross(n, e1, e2);
+
+            // NOTE: The length of the cross product is twice the area,
+            //       which does not matter since it is only used as a weight
+            PFfloat area = pfmVec3Length(n);
+
+            for (int_fast8_t j = 0; j < 3; j++) {
+                centroids[c][j] += area * (p[0][j] + p[1][j] + p[2][j]) * (1.0f/3.0f);
+                normals[c][j] += n[j];
+            }
+
+            clusterArea += area;
+        }
+
+        pfmVec3Add(meshCentroid, meshCentroid, centroids[c]);
+        meshArea += clusterArea;
+
+        if (clusterArea > 0.0f) {
+            pfmVec3Scale(centroids[c], centroids[c], 1.0f / clusterArea);
+        }
+
+        pfmVec3Normalize(normals[c], normals[c]);
+    }
+
+    if (meshArea > 0.0f) {
+        pfmVec3Scale(meshCentroid, meshCentroid, 1.0f / meshArea);
+    }
+
+    /* Sort the clusters from the most likely occluding to the least likely occluding */
+
+    for (PFsizei c = 0; c < clusterCount; c++) {
+        PFMvec3 dir;
+        pfmVec3Sub(dir, centroids[c], meshCentroid);
+        sortKeys[c].key = pfmVec3Dot(dir, normals[c]);
+        sortKeys[c].index = c;
+    }
+
+    qsort(sortKeys, clusterCount, sizeof(PFIclustersortkey), pfiCompareClusterSortKeys);
+
+    PFsizei outputCounter = 0;
+
+    for (PFsizei c = 0; c < clusterCount; c++) {
+        PFuint cluster = sortKeys[c].index;
+        PFuint start = 3*clusters[cluster];
+        PFuint end = 3*clusters[cluster + 1];
+        memcpy(output + outputCounter, input + start, (end - start) * sizeof(PFuint));
+        outputCounter += end - start;
+    }
+
+    for (PFsizei i = 0; i < count; i++) {
+        pfiSetIndex(indices, type, i, output[i]);
+    }
+
+cleanup_clusters:
+    PF_FREE(output);
+    PF_FREE(normals);
+    PF_FREE(centroids);
+
+cleanup:
+    PF_FREE(sortKeys);
+    PF_FREE(clusters);
+    PF_FREE(hardClusters);
+    PF_FREE(cache);
+    PF_FREE(input);
+}
+
+PFsizei pfOptimizeVertexFetchRemap(PFuint* remap, void* indices, PFsizei count, PFdatatype type, PFsizei vertexCount)
+{
+    if (!(type == PF_UNSIGNED_BYTE || type == PF_UNSIGNED_SHORT || type == PF_UNSIGNED_INT)) {
+        pfiSetOptimizerError(PF_INVALID_ENUM);
+        return 0;
+    }
+
+    if (remap == NULL || indices == NULL) {
+        pfiSetOptimizerError(PF_INVALID_VALUE);
+        return 0;
+    }
+
+    for (PFsizei i = 0; i < count; i++) {
+        if (pfiGetIndex(indices, type, i) >= vertexCount) {
+            pfiSetOptimizerError(PF_INVALID_VALUE);
+            return 0;
+        }
+    }
+
+    memset(remap, 0xFF, vertexCount * sizeof(PFuint));
+
+    // Vertices are renumbered in the order of their first use
+
+    PFuint next = 0;
+
+    for (PFsizei i = 0; i < count; i++) {
+        PFuint v = pfiGetIndex(indices, type, i);
+        if (remap[v] == PF_REMAP_UNUSED) remap[v] = next++;
+        pfiSetIndex(indices, type, i, remap[v]);
+    }
+
+    return next;
+}
+
+void pfRemapVertexArray(void* dst, const void* src, PFsizei vertexCount, PFsizei vertexSize, const PFuint* remap)
+{
+    if (dst == NULL || src == NULL || remap == NULL || vertexSize == 0) {
+        pfiSetOptimizerError(PF_INVALID_VALUE);
+        return;
+    }
+
+    // NOTE: When remapping in place, the source is copied first
+    //       since the vertices are moved in an arbitrary order
+
+    void *tmp = NULL;
+
+    if (dst == src) {
+        tmp = PF_MALLOC(vertexCount * vertexSize);
+        if (tmp == NULL) {
+            pfiSetOptimizerError(PF_ERROR_OUT_OF_MEMORY);
+            return;
+        }
+        memcpy(tmp, src, vertexCount * vertexSize);
+        src = tmp;
+    }
+
+    for (PFsizei i = 0; i < vertexCount; i++) {
+        if (remap[i] != PF_REMAP_UNUSED) {
+            memcpy((PFubyte*)dst + remap[i]*vertexSize, (const PFubyte*)src + i*vertexSize, vertexSize);
+        }
+    }
+
+    PF_FREE(tmp);
+}
@@ -76,6 +76,12 @@ PFM_API float rsqrtf(float x)
 #   endif //PLATFORM
 #endif //PFM_RESTRICT
 
+//  NOTE: The 'omp simd' hints only need the OpenMP SIMD directives, that '-fopenmp-simd'
+//        enables without the OpenMP runtime, in which case this macro is defined instead
+#if defined(_OPENMP) && !defined(PFM_OPENMP_SIMD)
+#   define PFM_OPENMP_SIMD
+#endif //_OPENMP
+
 /* Types definitions */
 
 typedef int32_t PFMfx32;
@@ -765,7 +771,7 @@ pfmVec2Direction(PFMvec2 dst, const PFMvec2 v1, const PFMvec2 v2)
     PFMvec2 tmp;
     float lengthSq = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 2; i++) {
@@ -775,7 +781,7 @@ pfmVec2Direction(PFMvec2 dst, const PFMvec2 v1, const PFMvec2 v2)
 
     float invLength = rsqrtf(lengthSq);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 2; i++) {
@@ -788,7 +794,7 @@ pfmVec2DirectionR(PFMvec2_ptr PFM_RESTRICT dst, const PFMvec2 v1, const PFMvec2
 {
     float lengthSq = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 2; i++) {
@@ -798,7 +804,7 @@ pfmVec2DirectionR(PFMvec2_ptr PFM_RESTRICT dst, const PFMvec2 v1, const PFMvec2
 
     float invLength = rsqrtf(lengthSq);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 2; i++) {
@@ -1015,7 +1021,7 @@ pfmVec3Copy(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3_ptr PFM_RESTRICT src)
 PFM_API void
 pfmVec3Swap(PFMvec3_ptr PFM_RESTRICT a, PFMvec3_ptr PFM_RESTRICT b)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1028,7 +1034,7 @@ pfmVec3Swap(PFMvec3_ptr PFM_RESTRICT a, PFMvec3_ptr PFM_RESTRICT b)
 PFM_API void
 pfmVec3Neg(PFMvec3 dst, const PFMvec3 v)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1039,7 +1045,7 @@ pfmVec3Neg(PFMvec3 dst, const PFMvec3 v)
 PFM_API void
 pfmVec3NegR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1050,7 +1056,7 @@ pfmVec3NegR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v)
 PFM_API void
 pfmVec3Add(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1061,7 +1067,7 @@ pfmVec3Add(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3AddR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1072,7 +1078,7 @@ pfmVec3AddR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3Sub(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1083,7 +1089,7 @@ pfmVec3Sub(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3SubR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1094,7 +1100,7 @@ pfmVec3SubR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3Mul(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1105,7 +1111,7 @@ pfmVec3Mul(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3MulR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1116,7 +1122,7 @@ pfmVec3MulR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3Div(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1127,7 +1133,7 @@ pfmVec3Div(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3DivR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1138,7 +1144,7 @@ pfmVec3DivR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2)
 PFM_API void
 pfmVec3Offset(PFMvec3 dst, const PFMvec3 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1149,7 +1155,7 @@ pfmVec3Offset(PFMvec3 dst, const PFMvec3 v, float scalar)
 PFM_API void
 pfmVec3OffsetR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1160,7 +1166,7 @@ pfmVec3OffsetR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v, float scalar)
 PFM_API void
 pfmVec3Scale(PFMvec3 dst, const PFMvec3 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1171,7 +1177,7 @@ pfmVec3Scale(PFMvec3 dst, const PFMvec3 v, float scalar)
 PFM_API void
 pfmVec3ScaleR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1187,7 +1193,7 @@ pfmVec3Normalize(PFMvec3 dst, const PFMvec3 v)
 
     float invLength = rsqrtf(squaredLength);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1203,7 +1209,7 @@ pfmVec3NormalizeR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v)
 
     float invLength = rsqrtf(squaredLength);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1226,7 +1232,7 @@ pfmVec3LengthSq(const PFMvec3 v)
 PFM_API float
 pfmVec3Dot(const PFMvec3 v1, const PFMvec3 v2)
 {
-#ifdef _OPENMP
+#ifdef PFM_OPENMP_SIMD
     float dotProduct = 0.0f;
 #   pragma omp simd
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1300,7 +1306,7 @@ pfmVec3Direction(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
     PFMvec3 tmp;
     float lengthSq = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1310,7 +1316,7 @@ pfmVec3Direction(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2)
 
     float invLength = rsqrtf(lengthSq);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1323,7 +1329,7 @@ pfmVec3DirectionR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3
 {
     float lengthSq = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1333,7 +1339,7 @@ pfmVec3DirectionR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3
 
     float invLength = rsqrtf(lengthSq);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1344,7 +1350,7 @@ pfmVec3DirectionR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3
 PFM_API void
 pfmVec3Lerp(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2, float t)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1355,7 +1361,7 @@ pfmVec3Lerp(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2, float t)
 PFM_API void
 pfmVec3LerpR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2, float t)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1366,7 +1372,7 @@ pfmVec3LerpR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2, f
 PFM_API void
 pfmVec3BaryInterpSmooth(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2, const PFMvec3 v3, float w1, float w2, float w3)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1377,7 +1383,7 @@ pfmVec3BaryInterpSmooth(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2, const P
 PFM_API void
 pfmVec3BaryInterpSmoothR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2, const PFMvec3 v3, float w1, float w2, float w3)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1388,7 +1394,7 @@ pfmVec3BaryInterpSmoothR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const P
 PFM_API void
 pfmVec3BaryInterpSmoothV(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2, const PFMvec3 v3, const PFMvec3 w)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1399,7 +1405,7 @@ pfmVec3BaryInterpSmoothV(PFMvec3 dst, const PFMvec3 v1, const PFMvec3 v2, const
 PFM_API void
 pfmVec3BaryInterpSmoothVR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 v1, const PFMvec3 v2, const PFMvec3 v3, const PFMvec3 w)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1548,7 +1554,7 @@ pfmVec3Reflect(PFMvec3 dst, const PFMvec3 incident, const PFMvec3 normal)
 {
     float dotProduct = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1557,7 +1563,7 @@ pfmVec3Reflect(PFMvec3 dst, const PFMvec3 incident, const PFMvec3 normal)
 
     dotProduct *= 2.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1570,7 +1576,7 @@ pfmVec3ReflectR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 incident, const PFMv
 {
     float dotProduct = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1579,7 +1585,7 @@ pfmVec3ReflectR(PFMvec3_ptr PFM_RESTRICT dst, const PFMvec3 incident, const PFMv
 
     dotProduct *= 2.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 3; i++) {
@@ -1616,7 +1622,7 @@ pfmVec4Copy(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4_ptr PFM_RESTRICT src)
 PFM_API void
 pfmVec4Swap(PFMvec4_ptr PFM_RESTRICT a, PFMvec4_ptr PFM_RESTRICT b)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1629,7 +1635,7 @@ pfmVec4Swap(PFMvec4_ptr PFM_RESTRICT a, PFMvec4_ptr PFM_RESTRICT b)
 PFM_API void
 pfmVec4Neg(PFMvec4 dst, const PFMvec4 v)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1640,7 +1646,7 @@ pfmVec4Neg(PFMvec4 dst, const PFMvec4 v)
 PFM_API void
 pfmVec4NegR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1651,7 +1657,7 @@ pfmVec4NegR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v)
 PFM_API void
 pfmVec4Add(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1662,7 +1668,7 @@ pfmVec4Add(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4AddR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1673,7 +1679,7 @@ pfmVec4AddR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4Sub(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1684,7 +1690,7 @@ pfmVec4Sub(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4SubR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1695,7 +1701,7 @@ pfmVec4SubR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4Mul(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1706,7 +1712,7 @@ pfmVec4Mul(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4MulR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1717,7 +1723,7 @@ pfmVec4MulR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4Div(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1728,7 +1734,7 @@ pfmVec4Div(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4DivR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1739,7 +1745,7 @@ pfmVec4DivR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4Offset(PFMvec4 dst, const PFMvec4 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1750,7 +1756,7 @@ pfmVec4Offset(PFMvec4 dst, const PFMvec4 v, float scalar)
 PFM_API void
 pfmVec4OffsetR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1761,7 +1767,7 @@ pfmVec4OffsetR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v, float scalar)
 PFM_API void
 pfmVec4Scale(PFMvec4 dst, const PFMvec4 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1772,7 +1778,7 @@ pfmVec4Scale(PFMvec4 dst, const PFMvec4 v, float scalar)
 PFM_API void
 pfmVec4ScaleR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v, float scalar)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1788,7 +1794,7 @@ pfmVec4Normalize(PFMvec4 dst, const PFMvec4 v)
 
     float invLength = rsqrtf(squaredLength);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1804,7 +1810,7 @@ pfmVec4NormalizeR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v)
 
     float invLength = rsqrtf(squaredLength);
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1833,7 +1839,7 @@ pfmVec4Dot(const PFMvec4 v1, const PFMvec4 v2)
 PFM_API void
 pfmVec4Lerp(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2, float t)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1844,7 +1850,7 @@ pfmVec4Lerp(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2, float t)
 PFM_API void
 pfmVec4LerpR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2, float t)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1855,7 +1861,7 @@ pfmVec4LerpR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2, f
 PFM_API void
 pfmVec4BaryInterpSmooth(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2, const PFMvec4 v3, float w1, float w2, float w3)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1866,7 +1872,7 @@ pfmVec4BaryInterpSmooth(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2, const P
 PFM_API void
 pfmVec4BaryInterpSmoothR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2, const PFMvec4 v3, float w1, float w2, float w3)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1877,7 +1883,7 @@ pfmVec4BaryInterpSmoothR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const P
 PFM_API void
 pfmVec4BaryInterpSmoothV(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2, const PFMvec4 v3, const PFMvec3 w)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -1888,7 +1894,7 @@ pfmVec4BaryInterpSmoothV(PFMvec4 dst, const PFMvec4 v1, const PFMvec4 v2, const
 PFM_API void
 pfmVec4BaryInterpSmoothVR(PFMvec4_ptr PFM_RESTRICT dst, const PFMvec4 v1, const PFMvec4 v2, const PFMvec4 v3, const PFMvec3 w)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -2131,7 +2137,7 @@ pfmMat4Identity(PFMmat4 dst)
 PFM_API void
 pfmMat4Add(PFMmat4 dst, const PFMmat4 left, const PFMmat4 right)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 16; i++) {
@@ -2142,7 +2148,7 @@ pfmMat4Add(PFMmat4 dst, const PFMmat4 left, const PFMmat4 right)
 PFM_API void
 pfmMat4AddR(PFMmat4_ptr PFM_RESTRICT dst, const PFMmat4 left, const PFMmat4 right)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 16; i++) {
@@ -2153,7 +2159,7 @@ pfmMat4AddR(PFMmat4_ptr PFM_RESTRICT dst, const PFMmat4 left, const PFMmat4 righ
 PFM_API void
 pfmMat4Sub(PFMmat4 dst, const PFMmat4 left, const PFMmat4 right)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 16; i++) {
@@ -2164,7 +2170,7 @@ pfmMat4Sub(PFMmat4 dst, const PFMmat4 left, const PFMmat4 right)
 PFM_API void
 pfmMat4SubR(PFMmat4_ptr PFM_RESTRICT dst, const PFMmat4 left, const PFMmat4 right)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 16; i++) {
@@ -2177,7 +2183,7 @@ pfmMat4Mul(PFMmat4 dst, const PFMmat4 left, const PFMmat4 right)
 {
     PFMmat4 result;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -2200,7 +2206,7 @@ pfmMat4Mul(PFMmat4 dst, const PFMmat4 left, const PFMmat4 right)
 PFM_API void
 pfmMat4MulR(PFMmat4_ptr PFM_RESTRICT dst, const PFMmat4 left, const PFMmat4 right)
 {
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
 #   endif
     for (int_fast8_t i = 0; i < 4; i++) {
@@ -2575,9 +2581,9 @@ pfmPolygonArea2D(const PFMvec2* vertices, int vertexCount)
 {
     float area = 0.0f;
 
-#   ifdef _OPENMP
+#   ifdef PFM_OPENMP_SIMD
 #       pragma omp simd
-#   endif //_OPENMP
+#   endif //PFM_OPENMP_SIMD
     for (int i = 0; i < vertexCount; i++) {
         const PFMvec2_cptr p1 = vertices[i];
         const PFMvec2_cptr p2 = vertices[(i + 1) % vertexCount];
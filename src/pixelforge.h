@@ -47,13 +47,7 @@
 
 #ifndef PF_CTX_DECL
 #   if defined(__GNUC__) || defined(__clang__)
-#       if defined(_OPENMP) && defined(__GNUC__)
-            // TODO: Using a global variable with __thread in GCC 11.4 seems to cause segmentation faults at runtime.
-            //       I haven't been able to obtain more information through debugging and some research. To investigate further.
-#           define PF_CTX_DECL
-#       else
-#           define PF_CTX_DECL __thread
-#       endif
+#       define PF_CTX_DECL __thread
 #   elif defined(_MSC_VER)
 #       define PF_CTX_DECL __declspec(thread)
 #   endif
@@ -180,6 +174,10 @@ typedef enum {
     PF_NORMAL_ARRAY         = 0x0200,
     PF_COLOR_ARRAY          = 0x0400,
     PF_TEXTURE_COORD_ARRAY  = 0x0800,
+    PF_WEIGHT_ARRAY         = 0x1000,
+    PF_BONE_INDEX_ARRAY     = 0x2000,
+    PF_FRAME_PIPELINING     = 0x4000,
+    PF_LIST_OPTIMIZATION    = 0x8000,
 } PFstate;
 
 typedef enum {
@@ -243,7 +241,10 @@ typedef enum {
     PF_COLOR_ARRAY_STRIDE,
     PF_COLOR_ARRAY_TYPE,
     PF_ZOOM_X,
-    PF_ZOOM_Y
+    PF_ZOOM_Y,
+    PF_MAX_BONES,
+    PF_ACTIVE_TEXTURE,
+    PF_TEXTURE_COMBINE
 } PFgettable;
 
 /* Error enum */
@@ -344,9 +345,30 @@ typedef enum {
 
 typedef enum {
     PF_NEAREST,
-    PF_BILINEAR
+    PF_BILINEAR,
+    PF_NEAREST_MIPMAP_NEAREST,      // NOTE: The mipmap filters need the levels generated by `pfGenerateMipmaps`
+    PF_NEAREST_MIPMAP_LINEAR,
+    PF_BILINEAR_MIPMAP_NEAREST,
+    PF_BILINEAR_MIPMAP_LINEAR       // Trilinear filtering
 } PFtexturefilter;
 
+typedef enum {
+    PF_LAYOUT_LINEAR,               // Rows of texels, the layout of the pixels given to `pfGenTexture`
+    PF_LAYOUT_TILED,                // Rows of tiles of 4x4 texels
+    PF_LAYOUT_MORTON                // Z-order curve, for power-of-two textures
+} PFtexturelayout;
+
+typedef enum {
+    PF_TEXTURE0,                    // NOTE: Texture unit used by the functions of the single texture API
+    PF_TEXTURE1
+} PFtextureunit;
+
+typedef enum {
+    PF_COMBINE_MODULATE,            // Texel multiplied by the previous color
+    PF_COMBINE_ADD,                 // Texel added to the previous color, alphas multiplied
+    PF_COMBINE_INTERPOLATE          // Previous color interpolated to the texel by its alpha, alpha kept
+} PFcombinemode;
+
 typedef enum {
     PF_LIGHT0 = 0,
     PF_LIGHT1,
@@ -414,7 +436,11 @@ typedef enum {
     PF_RGB,
     PF_RGBA,
     PF_BGR,
-    PF_BGRA
+    PF_BGRA,
+    PF_COMPRESSED_BC1,              // Blocks of 4x4 texels in 8 bytes (DXT1), with PF_UNSIGNED_BYTE
+    PF_COMPRESSED_BC3,              // Blocks of 4x4 texels in 16 bytes (DXT5), with PF_UNSIGNED_BYTE
+    PF_COMPRESSED_ETC1,             // Blocks of 4x4 texels in 8 bytes, with PF_UNSIGNED_BYTE
+    PF_COLOR_INDEX                  // Indices in a palette of 256 colors (see `pfTexturePalette`), with PF_UNSIGNED_BYTE
 } PFpixelformat;
 
 typedef void* PFtexture;
@@ -422,6 +448,7 @@ typedef void* PFtexture;
 /* Rendering List defintiions */
 
 typedef void* PFrenderlist; 
+typedef void* PFlistrecorder;   // NOTE: Fills a render list without using a context (see 'pfGenListRecorder')
 
 /* Framebuffer defintions */
 
@@ -430,6 +457,20 @@ typedef struct {
     PFfloat *zbuffer;
 } PFframebuffer;
 
+/* Mesh optimization definitions */
+
+#define PF_REMAP_UNUSED 0xFFFFFFFFu     // Remap value of the vertices not referenced by any index (see 'pfOptimizeVertexFetchRemap')
+
+/* Threading definitions */
+
+typedef void (*PFjobfunc)(void* job, PFint begin, PFint end);
+typedef void (*PFjobdispatcher)(PFjobfunc func, void* job, PFint begin, PFint end, PFint grain, void* userData);
+
+/* Context pool definitions */
+
+typedef void* PFcontextpool; // NOTE: This type is opaque, API functions are used to access its contexts
+typedef void (*PFrenderjobfunc)(PFsizei jobIndex, void* pixels, void* userData);
+
 #if defined(__cplusplus)
 extern "C" {
 #endif //__cplusplus
@@ -453,10 +494,61 @@ PF_API PFcontext
 pfCreateContext(void* targetBuffer, PFsizei width, PFsizei height,
                 PFpixelformat format, PFdatatype type);
 
+/**
+ * @brief Creates a deferred rendering context, executed by its own render thread.
+ *
+ * The API calls made on a deferred context are not executed by the calling thread: they are
+ * encoded into a command buffer, which is executed by the render thread of the context once
+ * submitted with `pfFlush`, `pfFinish` or `pfSwapBuffers` (or when the buffer becomes full).
+ * The caller can thus prepare the next frame while the previous one is being rendered.
+ *
+ * Data passed by pointer and read immediately by the API (vertices, matrices, indices of
+ * `pfDrawElements`, pixels of `pfDrawPixels`, etc.) are copied into the command buffer,
+ * so these indices and pixels cannot be NULL: the call is then ignored with `PF_INVALID_VALUE`.
+ * However, the memory retained by the context (vertex arrays, textures, framebuffers,
+ * render lists, main and auxiliary buffers) must remain valid and unchanged until the
+ * commands using it have been executed, which is guaranteed after a call to `pfFinish`.
+ *
+ * The functions returning information (`pfGetError`, `pfIsEnabled`, `pfGet*`, `pfReadPixels`)
+ * and those modifying or deleting a resource (`pfTextureParameter`, `pfDeleteTexture`,
+ * `pfDeleteList`) wait for the render thread to execute all the commands submitted before.
+ * Errors are therefore reported to `pfGetError` once the erroneous command has been executed.
+ *
+ * A deferred context must only be used by one thread at a time.
+ *
+ * @param targetBuffer Pointer to the target buffer where the rendering will occur.
+ * @param width        Width of the target buffer in pixels.
+ * @param height       Height of the target buffer in pixels.
+ * @param format       Pixel format of the target buffer, which defines the color and data representation.
+ * @param type         Data type of the pixels in the target buffer (e.g., unsigned integer, floating point).
+ *
+ * @return Pointer to the created rendering context. Returns NULL if context creation fails.
+ *
+ * Example usage:
+ * @code
+ * PFcontext ctx = pfCreateDeferredContext(screen, WIDTH, HEIGHT, PF_RGBA, PF_UNSIGNED_BYTE);
+ * pfMakeCurrent(ctx);
+ *
+ * while (running) {
+ *     UpdateSimulation();      // Runs while the previous frame is being rendered
+ *     pfFinish();              // Waits for the previous frame
+ *     PresentScreen(screen);
+ *
+ *     pfClear(PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT);
+ *     DrawScene();             // Only records the commands
+ *     pfFlush();               // Starts rendering the frame
+ * }
+ * @endcode
+ */
+PF_API PFcontext
+pfCreateDeferredContext(void* targetBuffer, PFsizei width, PFsizei height,
+                        PFpixelformat format, PFdatatype type);
+
 /**
  * @brief Deletes a rendering context.
  *
  * This function releases all resources associated with the specified rendering context.
+ * The render thread of a deferred context executes the commands submitted before it stops.
  *
  * @param ctx Pointer to the rendering context to be deleted. If `ctx` is NULL, the function does nothing.
  *
@@ -503,6 +595,25 @@ pfSetAuxBuffer(void *auxFramebuffer);
  * @brief Swaps the front and back buffers.
  *
  * @warning This function needs a context to be defined.
+ *
+ * @note On a deferred context, the recorded commands are submitted to the render thread (see `pfFlush`).
+ *
+ * @note When PF_FRAME_PIPELINING is enabled, the triangles and clears of the frame are submitted
+ *       to the raster thread of the context and this function returns without waiting for them.
+ *       It only waits for the previous frame, which is then swapped into the auxiliary buffer:
+ *       the auxiliary buffer always contains a completed frame, one frame behind the calls.
+ *
+ * Example usage:
+ * @code
+ * pfEnable(PF_FRAME_PIPELINING);
+ *
+ * while (running) {
+ *     pfClear(PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT);
+ *     DrawScene();        // Rasterized while the next frame is processed
+ *     pfSwapBuffers();
+ *     Present(aux);       // 'aux' now holds the frame drawn by the previous iteration
+ * }
+ * @endcode
  */
 PF_API void
 pfSwapBuffers(void);
@@ -527,6 +638,33 @@ pfGetCurrentContext(void);
 PF_API void
 pfMakeCurrent(PFcontext ctx);
 
+/**
+ * @brief Starts the execution of the commands submitted so far, without waiting for them.
+ *
+ * On a deferred context, the recorded commands are submitted to its render thread. If the
+ * render thread is still executing the previously submitted commands, this function waits
+ * for them before returning, so at most one buffer of commands is waiting to be rendered.
+ * On an immediate context, the primitives waiting in the vertex batch are rendered.
+ *
+ * @warning This function needs a context to be defined.
+ */
+PF_API void
+pfFlush(void);
+
+/**
+ * @brief Waits until all the commands submitted so far have been executed.
+ *
+ * After this call, the rendering is complete and the buffers, textures and vertex arrays
+ * used by the context can be accessed or modified by the application.
+ *
+ * When PF_FRAME_PIPELINING is enabled, this also waits for the raster thread of the context,
+ * and the swap requested by the last call to `pfSwapBuffers` is applied.
+ *
+ * @warning This function needs a context to be defined.
+ */
+PF_API void
+pfFinish(void);
+
 /**
  * @brief Checks if a rendering state is enabled.
  *
@@ -545,6 +683,14 @@ pfIsEnabled(PFstate state);
  * @warning This function needs a context to be defined.
  *
  * @param state The rendering state to enable.
+ *
+ * @note PF_FRAME_PIPELINING starts a raster thread for the context. The triangles and clears
+ *       of a frame are then only set up by the calling thread and rasterized by the raster
+ *       thread during the next frame (see `pfSwapBuffers`). The other raster operations
+ *       (points, lines, pixel transfers, fog and post-processing) wait for the raster thread
+ *       before being executed, as does any direct access to the framebuffers by the library.
+ *       The textures and framebuffers used by a frame must not be modified by the application
+ *       before the next call to `pfSwapBuffers` (or `pfFinish`) returns.
  */
 PF_API void
 pfEnable(PFstate state);
@@ -876,7 +1022,7 @@ PF_API void
 pfBindFramebuffer(PFframebuffer* framebuffer);
 
 /**
- * @brief Binds the specified texture for subsequent rendering operations.
+ * @brief Binds the specified texture to the active texture unit for subsequent rendering operations.
  *
  * Once the texture is bound to the current context, the PF_TEXTURE_2D state
  * must be active for the bound texture to be considered during rendering.
@@ -888,6 +1034,39 @@ pfBindFramebuffer(PFframebuffer* framebuffer);
 PF_API void
 pfBindTexture(PFtexture texture);
 
+/**
+ * @brief Selects the texture unit modified by the texture functions.
+ *
+ * `pfBindTexture`, `pfTexCombine`, `pfTexCoordPointer` and the PF_TEXTURE_2D and
+ * PF_TEXTURE_COORD_ARRAY states given to `pfEnable`, `pfDisable` and `pfIsEnabled`
+ * apply to the active unit, PF_TEXTURE0 by default. The unit PF_TEXTURE1 samples its
+ * texture with the texture coordinates given to `pfMultiTexCoord2f`, or read from its
+ * own texture coordinate array, the texture matrix only transforms those of PF_TEXTURE0.
+ *
+ * The texels of the enabled units are combined in order with the interpolated color,
+ * each unit with the color produced by the previous one (see `pfTexCombine`), before the
+ * Phong lighting, so a base texture and a lightmap can be drawn in a single pass.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * @param unit The texture unit to select (PF_TEXTURE0 or PF_TEXTURE1).
+ */
+PF_API void
+pfActiveTexture(PFtextureunit unit);
+
+/**
+ * @brief Specifies how the texels of the active texture unit are combined with the previous color.
+ *
+ * The previous color is the interpolated vertex color for the first enabled unit, and the color
+ * produced by PF_TEXTURE0 for PF_TEXTURE1. The default mode of both units is PF_COMBINE_MODULATE.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * @param mode The combine mode of the active texture unit.
+ */
+PF_API void
+pfTexCombine(PFcombinemode mode);
+
 /**
  * @brief Clears the specified buffers of the current framebuffer.
  *
@@ -1022,22 +1201,50 @@ pfColorMaterial(PFface face, PFenum mode);
  *
  * @warning This function needs a context to be defined.
  *
+ * Integer coordinates are decoded with the scale and offset defined by `pfVertexQuantization`
+ * (identity by default), which allows quantized positions to be used directly.
+ *
  * @param size Number of coordinates per vertex (2, 3, or 4).
- * @param type Data type of each coordinate (PF_SHORT, PF_INT, PF_FLOAT, or PF_DOUBLE).
- * @param stride Byte offset between consecutive vertices.
+ * @param type Data type of each coordinate (PF_BYTE, PF_UNSIGNED_BYTE, PF_SHORT, PF_UNSIGNED_SHORT, PF_INT, PF_HALF_FLOAT, PF_FLOAT, or PF_DOUBLE).
+ * @param stride Byte offset between consecutive vertices (0 if tightly packed).
  * @param pointer Pointer to the first coordinate of the first vertex.
  */
 PF_API void
 pfVertexPointer(PFint size, PFenum type,
                 PFsizei stride, const void* pointer);
 
+/**
+ * @brief Defines how quantized vertex positions are decoded.
+ *
+ * When the vertex array uses an integer type, each decoded coordinate is
+ * `offset[i] + scale[i] * value`. The fourth coordinate is never affected.
+ * The scale and offset are kept when `pfVertexPointer` is called again.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * @param scale Pointer to the 3 scale factors, or NULL to reset them to 1.
+ * @param offset Pointer to the 3 offsets, or NULL to reset them to 0.
+ *
+ * Example usage:
+ * @code
+ * // Positions quantized to 16-bit over the bounding box of the mesh
+ * PFfloat scale[3] = { (max.x - min.x)/65535, (max.y - min.y)/65535, (max.z - min.z)/65535 };
+ * pfVertexQuantization(scale, &min.x);
+ * pfVertexPointer(3, PF_UNSIGNED_SHORT, 0, quantizedPositions);
+ * @endcode
+ */
+PF_API void
+pfVertexQuantization(const PFfloat* scale, const PFfloat* offset);
+
 /**
  * @brief Specifies the location and data format of the normal array.
  *
  * @warning This function needs a context to be defined.
  *
- * @param type Data type of each normal (PF_FLOAT or PF_DOUBLE).
- * @param stride Byte offset between consecutive normals.
+ * Normals of type PF_BYTE or PF_SHORT are normalized, i.e. divided by 127 or 32767.
+ *
+ * @param type Data type of each normal (PF_BYTE, PF_SHORT, PF_HALF_FLOAT, PF_FLOAT or PF_DOUBLE).
+ * @param stride Byte offset between consecutive normals (0 if tightly packed).
  * @param pointer Pointer to the first normal.
  */
 PF_API void
@@ -1048,8 +1255,10 @@ pfNormalPointer(PFenum type, PFsizei stride, const void* pointer);
  *
  * @warning This function needs a context to be defined.
  *
- * @param type Data type of each texture coordinate (PF_FLOAT or PF_DOUBLE).
- * @param stride Byte offset between consecutive texture coordinates.
+ * Texture coordinates of type PF_UNSIGNED_SHORT are normalized to [0..1], i.e. divided by 65535.
+ *
+ * @param type Data type of each texture coordinate (PF_UNSIGNED_SHORT, PF_HALF_FLOAT, PF_FLOAT or PF_DOUBLE).
+ * @param stride Byte offset between consecutive texture coordinates (0 if tightly packed).
  * @param pointer Pointer to the first texture coordinate.
  */
 PF_API void
@@ -1061,13 +1270,81 @@ pfTexCoordPointer(PFenum type, PFsizei stride, const void* pointer);
  * @warning This function needs a context to be defined.
  *
  * @param size Number of color components per vertex (3 or 4).
- * @param type Data type of each color component (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT, PF_UNSIGNED_INT, PF_FLOAT, or PF_DOUBLE).
- * @param stride Byte offset between consecutive colors.
+ * @param type Data type of each color component (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT, PF_UNSIGNED_INT, PF_HALF_FLOAT, PF_FLOAT, or PF_DOUBLE).
+ * @param stride Byte offset between consecutive colors (0 if tightly packed).
  * @param pointer Pointer to the first color component.
  */
 PF_API void
 pfColorPointer(PFint size, PFenum type, PFsizei stride, const void* pointer);
 
+/**
+ * @brief Specifies the location and data format of the bone weight array used for skinning.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * Each vertex is influenced by up to four bones. Weights of type PF_UNSIGNED_BYTE or
+ * PF_UNSIGNED_SHORT are normalized to [0..1], i.e. divided by 255 or 65535.
+ * The weights of a vertex are expected to sum to one, they are not renormalized.
+ *
+ * @param size Number of weights per vertex (1 to 4).
+ * @param type Data type of each weight (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT, PF_HALF_FLOAT or PF_FLOAT).
+ * @param stride Byte offset between consecutive weights (0 if tightly packed).
+ * @param pointer Pointer to the first weight.
+ */
+PF_API void
+pfWeightPointer(PFint size, PFenum type, PFsizei stride, const void* pointer);
+
+/**
+ * @brief Specifies the location and data format of the bone index array used for skinning.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * Each index refers to a matrix of the bone palette loaded with `pfBoneMatrices`.
+ * Indices greater than or equal to PF_MAX_BONES are ignored, along with their weight.
+ *
+ * @param size Number of bone indices per vertex (1 to 4).
+ * @param type Data type of each index (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT or PF_UNSIGNED_INT).
+ * @param stride Byte offset between consecutive bone indices (0 if tightly packed).
+ * @param pointer Pointer to the first bone index.
+ */
+PF_API void
+pfBoneIndexPointer(PFint size, PFenum type, PFsizei stride, const void* pointer);
+
+/**
+ * @brief Loads matrices into the bone palette used for skinning.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * When PF_WEIGHT_ARRAY and PF_BONE_INDEX_ARRAY are both enabled, `pfDrawArrays` and
+ * `pfDrawElements` blend the bone matrices of each vertex by their weights and transform
+ * its position (and its normal if PF_NORMAL_ARRAY is enabled) with the result, before the
+ * usual model-view-projection transformation. The skinned vertices never go back to the
+ * application memory.
+ *
+ * Matrices are column-major, like those given to `pfMultMatrixf`. Normals are transformed
+ * by the upper 3x3 part of the blended matrix, so bones should not contain non-uniform scaling.
+ * All bones of the palette are initialized to identity when the context is created.
+ *
+ * @param first Index of the first bone to replace in the palette.
+ * @param count Number of matrices to load.
+ * @param matrices Pointer to `count` consecutive 4x4 matrices (16 floats each).
+ *
+ * Example usage:
+ * @code
+ * // Upload the pose computed for the current frame, then draw the bind pose mesh
+ * pfBoneMatrices(0, boneCount, (const PFfloat*)pose);
+ *
+ * pfEnable(PF_WEIGHT_ARRAY);
+ * pfEnable(PF_BONE_INDEX_ARRAY);
+ * pfWeightPointer(4, PF_FLOAT, 0, mesh.boneWeights);
+ * pfBoneIndexPointer(4, PF_UNSIGNED_BYTE, 0, mesh.boneIds);
+ *
+ * pfDrawElements(PF_TRIANGLES, mesh.indexCount, PF_UNSIGNED_SHORT, mesh.indices);
+ * @endcode
+ */
+PF_API void
+pfBoneMatrices(PFsizei first, PFsizei count, const PFfloat* matrices);
+
 /**
  * @brief Renders primitives from array data using indices.
  *
@@ -1110,6 +1387,10 @@ pfBegin(PFdrawmode mode);
 /**
  * @brief Ends the definition of a primitive.
  *
+ * The vertices submitted since `pfBegin` are accumulated in a per-context batch,
+ * this function flushes it so that every completed shape is rendered on return.
+ * The batch is also flushed when it is full and before any state change.
+ *
  * @warning This function needs a context to be defined.
  */
 PF_API void
@@ -1438,6 +1719,31 @@ pfTexCoord2f(PFfloat u, PFfloat v);
 PF_API void
 pfTexCoordfv(const PFfloat* v);
 
+/**
+ * @brief Specifies the 2D texture coordinates of a texture unit using floating-point components.
+ *
+ * With PF_TEXTURE0, this is equivalent to `pfTexCoord2f`.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * @param unit The texture unit whose texture coordinates are specified (PF_TEXTURE0 or PF_TEXTURE1).
+ * @param u U texture coordinate value (0.0-1.0).
+ * @param v V texture coordinate value (0.0-1.0).
+ */
+PF_API void
+pfMultiTexCoord2f(PFtextureunit unit, PFfloat u, PFfloat v);
+
+/**
+ * @brief Specifies the 2D texture coordinates of a texture unit using floating-point components provided as an array.
+ *
+ * @warning This function needs a context to be defined.
+ *
+ * @param unit The texture unit whose texture coordinates are specified (PF_TEXTURE0 or PF_TEXTURE1).
+ * @param v Array containing the U and V texture coordinates (0.0-1.0).
+ */
+PF_API void
+pfMultiTexCoordfv(PFtextureunit unit, const PFfloat* v);
+
 /**
  * @brief Specifies a normal vector using floating-point components.
  *
@@ -1803,6 +2109,13 @@ pfDeleteList(PFrenderlist* renderList);
  * can be actively recorded at a time; attempting to start a new list while another 
  * is being recorded will result in undefined behavior.
  *
+ * The matrix operations, `pfEnable`/`pfDisable`, polygon and shading modes, line width,
+ * point size, cull face, blend and depth functions, color material and light functions are
+ * recorded in the list instead of being applied to the context. Their arguments are validated
+ * when they are recorded (an invalid call sets the error and is not recorded), and the matrices
+ * of `pfTranslatef`, `pfRotatef`, `pfFrustum`, etc. are computed once at this time.
+ * Materials and texture bindings still apply to the context, and are captured by the draws.
+ *
  * @param renderList The handle of the render list to begin recording commands into.
  *
  * Example usage:
@@ -1824,6 +2137,17 @@ pfNewList(PFrenderlist renderList);
  * meaning that no more commands can be added until a new list is started with `pfNewList`.
  *
  * After calling `pfEndList`, the recorded commands can be executed by calling `pfCallList`.
+ * The bounding box and sphere of each draw and of the whole list are computed at this point,
+ * they allow `pfCallList` to skip the geometry located outside the view frustum.
+ *
+ * If PF_LIST_OPTIMIZATION is enabled (before `pfNewList`, since `pfEnable` is recorded otherwise),
+ * the adjacent draws that share the same textures and materials, with no other command between
+ * them, are merged into a single draw. The triangles, quads and polygons become indexed triangles whose identical vertices are
+ * stored once; points and lines are concatenated. The quads and polygons of an optimized list
+ * therefore show their diagonals with the PF_LINE polygon mode, and the PF_POINT polygon mode
+ * draws their shared vertices once. Lists filled by a recorder
+ * (see `pfGenListRecorder`) are not optimized.
+ *
  * If no render list is currently being recorded, calling this function will result in 
  * undefined behavior or an error, depending on the implementation.
  *
@@ -1847,6 +2171,17 @@ pfEndList(void);
  * Calling a render list can improve performance by avoiding the need to reissue the same 
  * commands repeatedly, especially for static geometry or complex state setups.
  *
+ * The state changes recorded in the list are applied in order with its draws, and remain
+ * in effect after the call. The current color, normal, texture coordinates, materials,
+ * bound textures and active texture unit are restored once the list has been executed.
+ *
+ * The bounding volumes of the recorded vertices are computed by `pfEndList`, the list, or
+ * each of its draws if the list itself modifies the matrices, is skipped when it lies
+ * entirely outside the frustum of the current matrices. Only the draws are skipped, the
+ * state changes of the list are still applied. Draws containing vertices with a W
+ * coordinate other than 1 are never skipped, nor are lists called during the recording
+ * of another list.
+ *
  * The render list must be finalized (i.e., `pfEndList` must have been called) before 
  * it can be executed. Calling `pfCallList` on an unfinalized or invalid render list 
  * will result in undefined behavior or an error, depending on the implementation.
@@ -1866,6 +2201,206 @@ pfEndList(void);
 PF_API void
 pfCallList(const PFrenderlist renderList);
 
+/**
+ * @brief Serializes a render list into a binary buffer that can be loaded by `pfLoadList`.
+ *
+ * The buffer contains the recorded state changes, the draw mode, materials and texture slot of
+ * each draw, and the vertex streams compiled by `pfEndList`, aligned so that they can be used
+ * in place once loaded. The format is versioned and only meant to be loaded by a build of the
+ * library with the same version of the format, byte order and configuration.
+ *
+ * Textures cannot be serialized: each texture bound to a unit by a draw of the list must be present in
+ * `textures`, the draw then refers to its index, which is resolved with the textures given
+ * to `pfLoadList`.
+ *
+ * Call it first with a NULL buffer to get the size of the buffer to allocate. The list must
+ * have been finalized with `pfEndList` (or by the deletion of its recorder).
+ *
+ * @param renderList The render list to save.
+ * @param buffer The buffer receiving the data, or NULL to only compute its size.
+ * @param bufferSize The size of the buffer in bytes.
+ * @param textures The textures that the draws of the list can use, can be NULL if there is none.
+ * @param textureCount The number of textures.
+ *
+ * @return The number of bytes written (or required if `buffer` is NULL), or 0 on error.
+ *         The error is `PF_INVALID_OPERATION` if the list is not finalized, `PF_INVALID_VALUE`
+ *         if the buffer is too small or if a texture of the list is not in `textures`.
+ *
+ * Example usage:
+ * @code
+ * PFtexture textures[] = { atlas, sky };
+ * PFsizei size = pfSaveList(myList, NULL, 0, textures, 2);
+ * void* data = malloc(size);
+ * pfSaveList(myList, data, size, textures, 2);
+ * fwrite(data, 1, size, file);
+ * @endcode
+ */
+PF_API PFsizei
+pfSaveList(const PFrenderlist renderList, void* buffer, PFsizei bufferSize, const PFtexture* textures, PFsizei textureCount);
+
+/**
+ * @brief Creates a render list from the data written by `pfSaveList`.
+ *
+ * The vertex streams are used in place without being copied when `data` is aligned on
+ * `PF_LIST_STREAM_ALIGNMENT` bytes, as is the case for a file mapped into memory (e.g. with
+ * `mmap`); the data must then remain valid and unmodified until the list is deleted or
+ * recorded again. Otherwise the streams are copied into memory owned by the list.
+ *
+ * The structure of the data is checked before use: a buffer that was not written by `pfSaveList`,
+ * that is truncated, or that was written with another version of the format is rejected. The
+ * values of the vertex attributes and of the recorded states are used as they are.
+ *
+ * @param data The serialized render list.
+ * @param dataSize The size of the data in bytes.
+ * @param textures The textures to bind to the texture slots of the draws, in the order given to `pfSaveList`.
+ * @param textureCount The number of textures, must cover all the slots used by the list.
+ *
+ * @return The loaded render list, to be deleted with `pfDeleteList`, or NULL on error
+ *         (`PF_INVALID_VALUE` for invalid data, `PF_ERROR_OUT_OF_MEMORY`).
+ *
+ * Example usage:
+ * @code
+ * void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+ * PFtexture textures[] = { atlas, sky };
+ * PFrenderlist myList = pfLoadList(data, size, textures, 2);
+ * pfCallList(myList);
+ * // ...
+ * pfDeleteList(&myList);
+ * munmap(data, size);
+ * @endcode
+ */
+PF_API PFrenderlist
+pfLoadList(const void* data, PFsizei dataSize, const PFtexture* textures, PFsizei textureCount);
+
+/**
+ * @brief Creates a recorder filling a render list without going through a context.
+ *
+ * `pfNewList` records the calls made on the current context, so only one list can be recorded
+ * at a time per context. A recorder has its own current color, normal, texture coordinates,
+ * face materials and bound texture, and only writes to its render list: each thread can fill a
+ * different list with its own recorder, without a current context, for instance to build the
+ * lists of the chunks of a scene in parallel at load time.
+ *
+ * The previous content of the list is discarded. Once the recorder has been deleted with
+ * `pfDeleteListRecorder`, the list can be called with `pfCallList` like any other list.
+ * A recorder must only be used by one thread at a time.
+ *
+ * The state of a recorder starts with the default values of a context (white color,
+ * default materials, no texture). `PF_COLOR_MATERIAL` has no effect on a recorder.
+ *
+ * @param renderList The render list to fill.
+ *
+ * @return The recorder, or NULL if the list is NULL or if the allocation fails.
+ *
+ * Example usage:
+ * @code
+ * void BuildChunk(void* job, PFint begin, PFint end)
+ * {
+ *     Scene* scene = job;
+ *     for (PFint i = begin; i < end; i++) {
+ *         PFlistrecorder rec = pfGenListRecorder(scene->chunks[i].list);
+ *         pfRecorderBindTexture(rec, scene->atlas);
+ *         pfRecorderBegin(rec, PF_TRIANGLES);
+ *         for (int v = 0; v < scene->chunks[i].vertexCount; v++) {
+ *             pfRecorderTexCoord2f(rec, scene->chunks[i].uv[v][0], scene->chunks[i].uv[v][1]);
+ *             pfRecorderVertex3fv(rec, scene->chunks[i].positions[v]);
+ *         }
+ *         pfRecorderEnd(rec);
+ *         pfDeleteListRecorder(&rec);
+ *     }
+ * }
+ * @endcode
+ */
+PF_API PFlistrecorder
+pfGenListRecorder(PFrenderlist renderList);
+
+/**
+ * @brief Deletes a list recorder, its render list is then ready to be called.
+ *
+ * @param recorder Pointer to the recorder to delete, set to NULL once deleted.
+ */
+PF_API void
+pfDeleteListRecorder(PFlistrecorder* recorder);
+
+/**
+ * @brief Starts a primitive in the list of a recorder, equivalent to `pfBegin`.
+ *
+ * The current face materials and textures of the recorder are recorded with the primitive.
+ */
+PF_API void
+pfRecorderBegin(PFlistrecorder recorder, PFdrawmode mode);
+
+/**
+ * @brief Ends the primitive started with `pfRecorderBegin`, equivalent to `pfEnd`.
+ */
+PF_API void
+pfRecorderEnd(PFlistrecorder recorder);
+
+/**
+ * @brief Records a vertex with the current color, normal and texture coordinates of the recorder.
+ */
+PF_API void
+pfRecorderVertex3f(PFlistrecorder recorder, PFfloat x, PFfloat y, PFfloat z);
+
+/**
+ * @brief Records a vertex from an array of 3 floats (see `pfRecorderVertex3f`).
+ */
+PF_API void
+pfRecorderVertex3fv(PFlistrecorder recorder, const PFfloat* v);
+
+/**
+ * @brief Records a vertex from an array of 4 floats (see `pfRecorderVertex3f`).
+ */
+PF_API void
+pfRecorderVertex4fv(PFlistrecorder recorder, const PFfloat* v);
+
+/**
+ * @brief Sets the current color of a recorder, equivalent to `pfColor4ub`.
+ */
+PF_API void
+pfRecorderColor4ub(PFlistrecorder recorder, PFubyte r, PFubyte g, PFubyte b, PFubyte a);
+
+/**
+ * @brief Sets the current normal of a recorder, equivalent to `pfNormal3f`.
+ */
+PF_API void
+pfRecorderNormal3f(PFlistrecorder recorder, PFfloat x, PFfloat y, PFfloat z);
+
+/**
+ * @brief Sets the current texture coordinates of a recorder, equivalent to `pfTexCoord2f`.
+ */
+PF_API void
+pfRecorderTexCoord2f(PFlistrecorder recorder, PFfloat u, PFfloat v);
+
+/**
+ * @brief Sets the current texture coordinates of a texture unit of a recorder, equivalent to `pfMultiTexCoord2f`.
+ */
+PF_API void
+pfRecorderMultiTexCoord2f(PFlistrecorder recorder, PFtextureunit unit, PFfloat u, PFfloat v);
+
+/**
+ * @brief Sets a material parameter of a recorder, equivalent to `pfMaterialfv`.
+ *
+ * The materials are recorded by the next call to `pfRecorderBegin`.
+ */
+PF_API void
+pfRecorderMaterialfv(PFlistrecorder recorder, PFface face, PFenum param, const void* value);
+
+/**
+ * @brief Selects the texture unit of a recorder bound by `pfRecorderBindTexture`, equivalent to `pfActiveTexture`.
+ */
+PF_API void
+pfRecorderActiveTexture(PFlistrecorder recorder, PFtextureunit unit);
+
+/**
+ * @brief Sets the texture of the active texture unit of a recorder, equivalent to `pfBindTexture`.
+ *
+ * The texture is recorded by the next call to `pfRecorderBegin`. It must remain valid
+ * as long as the render list is called.
+ */
+PF_API void
+pfRecorderBindTexture(PFlistrecorder recorder, PFtexture texture);
+
 
 /* Framebuffer functions */
 
@@ -2019,6 +2554,17 @@ pfSetFramebufferPixel(PFframebuffer* framebuffer,
  * @param format The pixel format of the texture, defining the color and data representation.
  * @param type   The data type of the texture's pixels (e.g., unsigned integer, floating point).
  *
+ * The compressed formats (`PF_COMPRESSED_BC1`, `PF_COMPRESSED_BC3` and `PF_COMPRESSED_ETC1`) take
+ * `PF_UNSIGNED_BYTE` and the blocks of 4x4 texels stored row by row, as in the files that contain them,
+ * with partial blocks on the right and bottom edges if the size is not a multiple of 4.
+ * The blocks are decoded on the fly when the texture is sampled; the blocks last decoded by each thread
+ * are kept in a small cache (see `PF_TEXTURE_BLOCK_CACHE_SIZE`), and `pfTextureStorage` must be called
+ * again if the blocks are modified while the texture is in use. Compressed textures cannot be the
+ * texture of a framebuffer, and their mipmap levels are stored in `PF_RGBA` and `PF_UNSIGNED_BYTE`.
+ *
+ * The same applies to `PF_COLOR_INDEX`, whose texels are the indices of their color in the palette
+ * of the texture, a gray ramp until one is given to `pfTexturePalette`.
+ *
  * @return PFtexture The generated texture object. Returns an invalid texture object if creation fails.
  */
 PF_API PFtexture
@@ -2059,6 +2605,16 @@ pfIsValidTexture(const PFtexture texture);
  * The wrap mode determines how texture coordinates outside the range [0.0, 1.0] are handled, while the
  * filter mode specifies how the texture is filtered when it is magnified or minified.
  *
+ * The mipmap filters (`PF_NEAREST_MIPMAP_NEAREST`, `PF_NEAREST_MIPMAP_LINEAR`, `PF_BILINEAR_MIPMAP_NEAREST`
+ * and `PF_BILINEAR_MIPMAP_LINEAR`) select the level of detail of each group of pixels from the screen-space
+ * derivatives of the texture coordinates. The first part of their name is the filter used within a level,
+ * the second one tells whether the nearest level is used or the two nearest levels are blended.
+ * The base level is used when the texture is magnified, or if `pfGenerateMipmaps` was not called.
+ *
+ * `PF_NEAREST` samples the texel nearest to the texture coordinates, and `PF_BILINEAR` blends the four texels
+ * around them. When the width and height of the texture are powers of two, `PF_BILINEAR` with `PF_REPEAT`
+ * and `PF_MIRRORED_REPEAT` wraps the texels with masks instead of divisions, for the same result.
+ *
  * @param texture The texture to set parameters for.
  * @param wrapMode The wrapping mode to be used (e.g., repeat, clamp).
  * @param filterMode The filtering mode to be used (e.g., nearest, linear).
@@ -2068,6 +2624,87 @@ pfTextureParameter(PFtexture texture,
                    PFtexturewrap wrapMode,
                    PFtexturefilter filterMode);
 
+/**
+ * @brief Sets the order in which the texels of a texture are stored for sampling.
+ *
+ * By default the texture samples the pixels given to `pfGenTexture`, stored row by row.
+ * A texture viewed at an angle, or rotated on screen, then reads texels from a different row,
+ * and so a different cache line, for almost every pixel. With `PF_LAYOUT_TILED` or `PF_LAYOUT_MORTON`,
+ * the texels are copied in a buffer owned by the texture where the neighbors of a texel in both
+ * directions are stored close to it: in tiles of 4x4 texels (64 bytes for 32-bit texels), or along
+ * a Z-order curve. `PF_LAYOUT_LINEAR` frees this copy and samples the pixels of `pfGenTexture` again,
+ * unless the texture also has its own storage format (see `pfTextureStorage`).
+ * The address of a texel costs a few more operations to compute in these layouts, they are worth it
+ * for large textures sampled out of row order, not for those that already fit in the cache.
+ * The blocks of a compressed texture are already stored in `PF_LAYOUT_TILED`.
+ *
+ * The copy is made from the pixels given to `pfGenTexture` and is not updated when they are modified,
+ * this function must then be called again. The mipmap levels of the texture are generated again
+ * in the new layout if they exist (see `pfGenerateMipmaps`).
+ *
+ * @param texture The texture whose layout is set. It must not be the texture of a framebuffer.
+ * @param layout The layout of the texels.
+ *
+ * @note The error is set to `PF_INVALID_ENUM` if the layout is not valid, to `PF_INVALID_VALUE` if
+ *       `PF_LAYOUT_MORTON` is used with a size that is not a power of two, to `PF_INVALID_OPERATION`
+ *       if the texels are stored in a compressed format, and to `PF_ERROR_OUT_OF_MEMORY` if the copy
+ *       cannot be allocated. The texture keeps its layout in all of these cases.
+ */
+PF_API void
+pfTextureLayout(PFtexture texture,
+                PFtexturelayout layout);
+
+/**
+ * @brief Sets the format in which the texels of a texture are stored for sampling.
+ *
+ * By default the texture samples the pixels given to `pfGenTexture` in their own format, and each
+ * texel read is decoded by a function specific to this format. With `PF_RGBA` and `PF_UNSIGNED_BYTE`,
+ * the texels are converted once in a buffer owned by the texture and then loaded directly by the
+ * samplers, which is the fastest format to sample. The rows of this copy are padded so that each of
+ * them starts on `PF_TEXTURE_STORAGE_ALIGNMENT` bytes. Using the format and type given to `pfGenTexture`
+ * frees this copy and samples the pixels of `pfGenTexture` again, unless the texture also has its own
+ * layout (see `pfTextureLayout`).
+ *
+ * The conversion goes through 8-bit components: a texture stored in a format with more precision than
+ * its pixels gains none. The copy is made from the pixels given to `pfGenTexture` and is not updated
+ * when they are modified, this function must then be called again. The mipmap levels of the texture
+ * are generated again in the new format if they exist (see `pfGenerateMipmaps`).
+ *
+ * A compressed or `PF_COLOR_INDEX` texture can be stored decoded, which trades its memory savings for
+ * faster sampling, and stored again in its own format. Pixels cannot be compressed or converted to
+ * indices by this function.
+ *
+ * @param texture The texture whose storage format is set. It must not be the texture of a framebuffer.
+ * @param format The pixel format of the stored texels.
+ * @param type The data type of the stored texels.
+ *
+ * @note The error is set to `PF_INVALID_ENUM` if the format and type are not a valid combination, to
+ *       `PF_INVALID_OPERATION` if the format is compressed or `PF_COLOR_INDEX` and not the one given to `pfGenTexture`, and to
+ *       `PF_ERROR_OUT_OF_MEMORY` if the copy cannot be allocated. The texture keeps its format in all of these cases.
+ */
+PF_API void
+pfTextureStorage(PFtexture texture,
+                 PFpixelformat format,
+                 PFdatatype type);
+
+/**
+ * @brief Sets the 256 colors of the palette of a `PF_COLOR_INDEX` texture.
+ *
+ * The colors are copied, the palette can then be replaced at any time without giving the indices again.
+ * The samplers read the colors of the indices in the palette while the texture is stored in `PF_COLOR_INDEX`,
+ * replacing it then costs only the copy. If the texture is stored decoded (see `pfTextureStorage`) or has
+ * mipmap levels (see `pfGenerateMipmaps`), they are decoded or generated again with the new colors.
+ *
+ * @param texture The texture whose palette is set, created in `PF_COLOR_INDEX`.
+ * @param palette The 256 colors of the palette, in the order of their indices.
+ *
+ * @note The error is set to `PF_INVALID_VALUE` if `palette` is NULL, and to `PF_INVALID_OPERATION`
+ *       if the texture was not created in `PF_COLOR_INDEX`. The palette is unchanged in both cases.
+ */
+PF_API void
+pfTexturePalette(PFtexture texture,
+                 const PFcolor* palette);
+
 /**
  * @brief Returns a pointer to the texels of the texture and retrieves texture details.
  *
@@ -2080,13 +2717,297 @@ pfTextureParameter(PFtexture texture,
  * @param height Pointer to store the height of the texture (can be NULL).
  * @param format Pointer to store the pixel format of the texture (can be NULL).
  * @param type Pointer to store the data type of the texture (can be NULL).
- * @return Pointer to the texels of the texture.
+ * @return Pointer to the texels of the texture, the pixels given to `pfGenTexture` whatever its layout
+ *         and storage format. The format and type retrieved are also those given to `pfGenTexture`.
  */
 PF_API void*
 pfGetTexturePixels(const PFtexture texture,
                    PFsizei* width, PFsizei* height,
                    PFpixelformat* format, PFdatatype* type);
 
+/**
+ * @brief Generates the mipmap levels of a texture from its pixels.
+ *
+ * Each level is a box-filtered copy of the previous one, half its size, down to a level of 1x1 pixel.
+ * The levels are stored by the texture in its pixel format and are used by the mipmap filters
+ * (see `pfTextureParameter`). Minified textures then sample a small level instead of skipping
+ * texels of the base level, which avoids aliasing and keeps the texels read in cache.
+ *
+ * The levels are not updated when the pixels of the texture are modified, this function must then
+ * be called again. They are freed with the texture by `pfDeleteTexture`.
+ *
+ * @param texture The texture whose mipmap levels are generated.
+ *
+ * @note If the memory for the levels cannot be allocated, the error is set to `PF_ERROR_OUT_OF_MEMORY`
+ *       and the texture keeps the levels it had before.
+ */
+PF_API void
+pfGenerateMipmaps(PFtexture texture);
+
+/* Mesh optimization functions */
+
+/**
+ * @brief Reorders the triangles of an indexed mesh to improve post-transform vertex locality.
+ *
+ * This function reorders in place the triangles described by `indices` (interpreted as `PF_TRIANGLES`)
+ * so that consecutive triangles share as many vertices as possible, using the "Tipsify" algorithm.
+ * The vertices themselves are not modified, and the winding of each triangle is preserved.
+ *
+ * This is intended to be run once at asset load time, before `pfDrawElements`. It can be followed
+ * by `pfOptimizeOverdraw`, then by `pfOptimizeVertexFetchRemap` to also improve vertex fetch locality.
+ *
+ * The size of the simulated vertex cache can be adjusted with `PF_VERTEX_CACHE_SIZE` at compile time.
+ *
+ * @param indices Pointer to the index array to reorder.
+ * @param count Number of indices (must be a multiple of 3).
+ * @param type Data type of the indices (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT or PF_UNSIGNED_INT).
+ * @param vertexCount Number of vertices referenced by the index array.
+ *
+ * Example usage:
+ * @code
+ * pfOptimizeVertexCache(mesh.indices, mesh.triangleCount*3, PF_UNSIGNED_SHORT, mesh.vertexCount);
+ * @endcode
+ */
+PF_API void
+pfOptimizeVertexCache(void* indices, PFsizei count,
+                      PFdatatype type, PFsizei vertexCount);
+
+/**
+ * @brief Reorders the triangles of an indexed mesh to reduce overdraw.
+ *
+ * This function splits the triangles into clusters, without degrading the vertex cache efficiency
+ * by more than `threshold`, then sorts these clusters so that the ones most likely to occlude the
+ * rest of the mesh, whatever the point of view, are drawn first. With the depth test enabled, this
+ * reduces the number of fragments shaded and written.
+ *
+ * The indices should have been optimized with `pfOptimizeVertexCache` beforehand.
+ *
+ * @param indices Pointer to the index array to reorder.
+ * @param count Number of indices (must be a multiple of 3).
+ * @param type Data type of the indices (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT or PF_UNSIGNED_INT).
+ * @param positions Pointer to the vertex positions (`PFfloat`, tightly packed).
+ * @param size Number of components per position (2, 3 or 4).
+ * @param vertexCount Number of vertices in the position array.
+ * @param threshold Allowed degradation of the vertex cache efficiency (1.0 disables it, 1.05 is a good default).
+ */
+PF_API void
+pfOptimizeOverdraw(void* indices, PFsizei count, PFdatatype type,
+                   const PFfloat* positions, PFint size,
+                   PFsizei vertexCount, PFfloat threshold);
+
+/**
+ * @brief Generates a vertex remap table improving vertex fetch locality.
+ *
+ * This function renumbers the vertices in the order in which they are first referenced by the
+ * indices, rewrites the indices in place accordingly, and fills `remap` with the new position of
+ * each vertex. Vertices that are not referenced are marked with `PF_REMAP_UNUSED`.
+ *
+ * Each vertex attribute array must then be reordered with `pfRemapVertexArray`.
+ *
+ * @param remap Pointer to an array of `vertexCount` elements receiving the remap table.
+ * @param indices Pointer to the index array to rewrite.
+ * @param count Number of indices.
+ * @param type Data type of the indices (PF_UNSIGNED_BYTE, PF_UNSIGNED_SHORT or PF_UNSIGNED_INT).
+ * @param vertexCount Number of vertices referenced by the index array.
+ * @return The number of vertices actually referenced, i.e. the size of the remapped vertex arrays.
+ *
+ * Example usage:
+ * @code
+ * PFuint *remap = malloc(vertexCount*sizeof(PFuint));
+ * PFsizei newCount = pfOptimizeVertexFetchRemap(remap, indices, indexCount, PF_UNSIGNED_SHORT, vertexCount);
+ * pfRemapVertexArray(positions, positions, vertexCount, 3*sizeof(PFfloat), remap);
+ * pfRemapVertexArray(texcoords, texcoords, vertexCount, 2*sizeof(PFfloat), remap);
+ * pfRemapVertexArray(normals, normals, vertexCount, 3*sizeof(PFfloat), remap);
+ * free(remap);
+ * @endcode
+ */
+PF_API PFsizei
+pfOptimizeVertexFetchRemap(PFuint* remap, void* indices, PFsizei count,
+                           PFdatatype type, PFsizei vertexCount);
+
+/**
+ * @brief Reorders a vertex attribute array according to a remap table.
+ *
+ * @param dst Pointer to the destination array (can be the same as `src`).
+ * @param src Pointer to the source array.
+ * @param vertexCount Number of vertices in the source array.
+ * @param vertexSize Size in bytes of one vertex in the array.
+ * @param remap Remap table generated by `pfOptimizeVertexFetchRemap`.
+ */
+PF_API void
+pfRemapVertexArray(void* dst, const void* src, PFsizei vertexCount,
+                   PFsizei vertexSize, const PFuint* remap);
+
+/* Threading functions */
+
+/**
+ * @brief Sets the number of threads used by the parallel loops of the library.
+ *
+ * The rasterization of large triangles, the clearing of the buffers, `pfDrawPixels`, `pfRectf`,
+ * `pfFogProcess`, `pfPostProcess` and `pfReadPixels` split their work between the thread calling
+ * them and a pool of persistent worker threads owned by the library. The pool is shared by all
+ * contexts; if it is already busy, the other threads run their loops alone.
+ *
+ * By default the number of threads is the number of logical processors (at most `PF_MAX_THREADS`).
+ * The worker threads are created on the first parallel loop following this call.
+ *
+ * @note This function must not be called while another thread is rendering.
+ *
+ * @param count Number of threads, the calling thread included.
+ *              0 selects the number of logical processors, 1 disables the worker threads.
+ */
+PF_API void
+pfSetThreadCount(PFsizei count);
+
+/**
+ * @brief Returns the number of threads used by the parallel loops of the library.
+ *
+ * @return The number of threads, the calling thread included.
+ */
+PF_API PFsizei
+pfGetThreadCount(void);
+
+/**
+ * @brief Enables or disables the pinning of the worker threads to the logical processors.
+ *
+ * When enabled, each worker thread is bound to its own logical processor, the first one being left
+ * to the thread calling the API. This avoids the migration of the workers between the cores at
+ * the cost of flexibility, it should only be enabled when the application controls the machine.
+ * Disabled by default, ignored on platforms that don't support thread affinity.
+ *
+ * @note This function must not be called while another thread is rendering.
+ *
+ * @param enabled PF_TRUE to pin the worker threads, PF_FALSE to let the system schedule them.
+ */
+PF_API void
+pfSetThreadAffinity(PFboolean enabled);
+
+/**
+ * @brief Replaces the worker threads of the library with the job system of the application.
+ *
+ * Each parallel loop of the library calls `dispatcher` instead of waking the worker threads.
+ * The dispatcher must call `func(job, chunkBegin, chunkEnd)` for chunks covering the range
+ * [begin, end) exactly once, in any order and from any thread, and must only return once all
+ * chunks have been processed. `grain` is the number of iterations suggested for each chunk,
+ * it is computed from the thread count defined with `pfSetThreadCount`.
+ *
+ * The chunks can be run from the thread calling the dispatcher, which is necessary for the
+ * dispatcher to make progress if it is called from one of the threads of the job system.
+ *
+ * @note This function must not be called while another thread is rendering.
+ *
+ * @param dispatcher Function that distributes the chunks, or NULL to use the worker threads of the library again.
+ * @param userData Pointer given as is to `dispatcher`.
+ *
+ * Example usage:
+ * @code
+ * void Dispatch(PFjobfunc func, void* job, PFint begin, PFint end, PFint grain, void* userData)
+ * {
+ *     JobSystem* js = userData;
+ *     JobCounter counter = { 0 };
+ *     for (PFint i = begin; i < end; i += grain) {
+ *         JobSystem_Push(js, &counter, func, job, i, (i + grain < end) ? i + grain : end);
+ *     }
+ *     JobSystem_WaitAndHelp(js, &counter);
+ * }
+ *
+ * pfSetJobDispatcher(Dispatch, &jobSystem);
+ * @endcode
+ */
+PF_API void
+pfSetJobDispatcher(PFjobdispatcher dispatcher, void* userData);
+
+/* Context pool functions */
+
+/**
+ * @brief Creates a pool of preallocated contexts, used to render many images in parallel.
+ *
+ * Each context of the pool owns a color buffer and a depth buffer of the given size and format.
+ * The pool renders one image per context at a time with `pfRenderJobs`, the contexts and their
+ * buffers are reused from one job to the next, so no allocation takes place while rendering.
+ *
+ * Textures and render lists are not owned by a context: the same `PFtexture` and `PFrenderlist`
+ * can be used by all the contexts of the pool at the same time, as long as they are not modified
+ * or deleted while jobs are running.
+ *
+ * @param contextCount Number of contexts, 0 selects the thread count (see `pfSetThreadCount`).
+ * @param width        Width of the buffers of each context in pixels.
+ * @param height       Height of the buffers of each context in pixels.
+ * @param format       Pixel format of the color buffers.
+ * @param type         Data type of the pixels of the color buffers.
+ *
+ * @return The created pool, or NULL if the format is invalid or if an allocation fails.
+ */
+PF_API PFcontextpool
+pfCreateContextPool(PFsizei contextCount, PFsizei width, PFsizei height,
+                    PFpixelformat format, PFdatatype type);
+
+/**
+ * @brief Deletes a context pool, its contexts and their buffers.
+ *
+ * @param pool Pointer to the pool to delete, set to NULL once deleted.
+ */
+PF_API void
+pfDeleteContextPool(PFcontextpool* pool);
+
+/**
+ * @brief Returns the number of contexts of a pool.
+ */
+PF_API PFsizei
+pfGetContextPoolSize(PFcontextpool pool);
+
+/**
+ * @brief Returns a context of a pool, to configure it outside of `pfRenderJobs`.
+ *
+ * @param pool  The pool containing the context.
+ * @param index Index of the context, less than `pfGetContextPoolSize(pool)`.
+ *
+ * @return The context, or NULL if the index is out of range.
+ */
+PF_API PFcontext
+pfGetPoolContext(PFcontextpool pool, PFsizei index);
+
+/**
+ * @brief Renders a batch of images with the contexts of a pool, on the threads of the library.
+ *
+ * `func` is called once for each job index in [0, jobCount), from the worker threads (or the job
+ * dispatcher defined with `pfSetJobDispatcher`) and from the calling thread. During the call one
+ * of the contexts of the pool is current, and `pixels` points to its color buffer. The jobs run
+ * on different contexts concurrently; each context runs one job at a time, so the number of jobs
+ * in flight is limited by both the size of the pool and the thread count.
+ *
+ * The state of a context is kept from one job to the next, including the content of its buffers:
+ * each job must clear the buffers and set the state it depends on. Once the job has drawn its image,
+ * it must call `pfFinish` before reading `pixels`, and copy or encode the image before returning.
+ * The parallel loops of the library run on the thread of the job while the pool renders.
+ *
+ * The context current on the calling thread is restored before returning.
+ *
+ * @param pool     The pool of contexts used to render the jobs.
+ * @param jobCount Number of jobs to run.
+ * @param func     Function rendering the image of a job.
+ * @param userData Pointer given as is to `func`.
+ *
+ * Example usage:
+ * @code
+ * void RenderThumbnail(PFsizei jobIndex, void* pixels, void* userData)
+ * {
+ *     Scene* scene = userData;
+ *     pfClear(PF_COLOR_BUFFER_BIT | PF_DEPTH_BUFFER_BIT);
+ *     SetupCamera(&scene->cameras[jobIndex]);
+ *     pfCallList(scene->models[jobIndex]);    // Lists and textures can be shared
+ *     pfFinish();
+ *     EncodeImage(scene->outputs[jobIndex], pixels, 128, 128);
+ * }
+ *
+ * PFcontextpool pool = pfCreateContextPool(0, 128, 128, PF_RGBA, PF_UNSIGNED_BYTE);
+ * pfRenderJobs(pool, scene.count, RenderThumbnail, &scene);
+ * pfDeleteContextPool(&pool);
+ * @endcode
+ */
+PF_API void
+pfRenderJobs(PFcontextpool pool, PFsizei jobCount, PFrenderjobfunc func, void* userData);
+
 #if defined(__cplusplus)
 }
 #endif //__cplusplus
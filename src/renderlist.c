@@ -1,14 +1,1057 @@
 #include "./internal/context/context.h"
+#include "./internal/context/command.h"
+#include "./internal/primitives/primitives.h"
+#include "./internal/renderlist.h"
 #include "./internal/vector.h"
+#include "./internal/config.h"
 #include "./pixelforge.h"
+#include "./pfm.h"
+
+#include <stdint.h>
 #include <string.h>
+#include <math.h>
+
+/* Internal types */
+
+#define PFI_LIST_FILE_VERSION       3
+#define PFI_LIST_FILE_BYTE_ORDER    0x01020304
+#define PFI_LIST_NO_TEXTURE         0xFFFFFFFF
+
+typedef struct {
+    PFIrenderlist *list;            ///< List being filled, owned by the user
+    PFImaterial faceMaterial[2];
+    PFtexture currentTexture[2];    ///< Textures of PF_TEXTURE0 and PF_TEXTURE1
+    PFtextureunit activeTexture;    ///< Unit bound by 'pfRecorderBindTexture'
+    PFMvec3 currentNormal;
+    PFMvec2 currentTexcoord[2];     ///< Texture coordinates of PF_TEXTURE0 and PF_TEXTURE1
+    PFcolor currentColor;
+    PFboolean inBegin;              ///< Whether the recorder is between 'pfRecorderBegin' and 'pfRecorderEnd'
+} PFIlistrecorder;
+
+// NOTE: Layout of the vertices in the arena of a render list while it is recorded
+typedef struct {
+    PFMvec4 position;
+    PFMvec3 normal;
+    PFMvec2 texcoord;
+    PFMvec2 texcoord1;
+    PFcolor color;
+} PFIlistvertex;
+
+typedef struct {
+    const PFIvertexstreams *streams;
+    PFMmat4 matTexture;             ///< Texture matrix applied to the texture coordinates, like 'pfTexCoordfv'
+    PFboolean transformTexcoord;    ///< Whether the texture matrix is not the identity
+    PFboolean normalize;            ///< Whether the normals are normalized, like 'pfNormal3fv'
+} PFIlistfetch;
+
+// NOTE: Bounding volumes as stored by 'pfSaveList' (see 'PFIbounds')
+typedef struct {
+    PFMvec3 min;
+    PFMvec3 max;
+    PFMvec3 center;
+    PFfloat radius;
+    PFuint valid;
+} PFIlistfilebounds;
+
+// NOTE: Header of the binary format written by 'pfSaveList'. It is followed by the commands,
+//       the calls (PFIlistfilecall), the material table and the vertex streams of the calls,
+//       each block starting at a multiple of PF_LIST_STREAM_ALIGNMENT bytes from the header.
+//       The streams are stored as compiled by 'pfEndList' so that they can be used in place.
+typedef struct {
+    PFubyte magic[4];               ///< "PFRL"
+    PFuint version;                 ///< PFI_LIST_FILE_VERSION, incremented when the format or the commands change
+    PFuint byteOrder;               ///< PFI_LIST_FILE_BYTE_ORDER, written in the byte order of the writer
+    PFuint argSize;                 ///< Size of the command arguments (PFIcmdarg) of the writer
+    PFuint streamAlignment;         ///< PF_LIST_STREAM_ALIGNMENT of the writer
+    PFuint transforms;              ///< Whether the commands modify the matrices
+    PFuint callCount;
+    PFuint materialCount;
+    PFuint textureCount;            ///< Number of texture slots referenced by the calls
+    PFuint commandsOffset;
+    PFuint commandsSize;
+    PFuint callsOffset;
+    PFuint materialsOffset;
+    PFuint streamsOffset;
+    PFuint streamsSize;
+    PFIlistfilebounds bounds;
+} PFIlistfileheader;
+
+typedef struct {
+    PFuint drawMode;
+    PFuint vertexCount;
+    PFuint triangleCount;
+    PFuint streamsOffset;           ///< Offset of the streams of the call in the streams block
+    PFuint materialSlots[2];        ///< Front and back materials, indices in the material table
+    PFuint textureSlots[2];         ///< Indices in the textures given to 'pfLoadList' for each texture unit, or PFI_LIST_NO_TEXTURE
+    PFuint indexed;                 ///< Non-zero if the triangles of the call were merged (PF_LIST_OPTIMIZATION)
+    PFIlistfilebounds bounds;
+} PFIlistfilecall;
+
+typedef enum {
+    PFI_BOUNDS_OUTSIDE,             ///< Nothing can be rasterized, the geometry can be skipped
+    PFI_BOUNDS_INTERSECT,           ///< The geometry may be partially visible, or cannot be tested
+    PFI_BOUNDS_INSIDE               ///< The geometry is entirely within the frustum
+} PFIboundstest;
+
+/* Internal helper functions */
+
+static PFsizei
+pfiAlignStreamSize(PFsizei size)
+{
+    return (size + PF_LIST_STREAM_ALIGNMENT - 1) & ~((PFsizei)PF_LIST_STREAM_ALIGNMENT - 1);
+}
+
+// NOTE: Returns the number of vertices of an element of the draw mode, the number of vertices
+//       that separate two elements and the number of triangles assembled from each element,
+//       as done by 'pfiResetVertexBufferForNextElement' and 'pfiProcessAndRasterize'
+static PFsizei
+pfiGetElementLayout(PFdrawmode mode, PFsizei* elementSize, PFsizei* elementStride)
+{
+    switch (mode) {
+        case PF_TRIANGLES:      *elementSize = 3; *elementStride = 3; return 1;
+        case PF_QUADS:          *elementSize = 4; *elementStride = 4; return 2;
+        case PF_TRIANGLE_FAN:
+        case PF_TRIANGLE_STRIP: *elementSize = 4; *elementStride = 3; return 2;
+        case PF_QUAD_FAN:
+        case PF_QUAD_STRIP:     *elementSize = 6; *elementStride = 4; return 4;
+        default: break;
+    }
+    return 0;
+}
+
+// NOTE: Returns the number of triangles assembled from the vertices of a call of the draw mode
+static PFsizei
+pfiGetTriangleCount(PFdrawmode mode, PFsizei vertexCount)
+{
+    PFsizei elementSize = 0, elementStride = 0;
+    PFsizei elementTriangles = pfiGetElementLayout(mode, &elementSize, &elementStride);
+
+    if (elementTriangles == 0 || vertexCount < elementSize) {
+        return 0;
+    }
+
+    return ((vertexCount - elementSize)/elementStride + 1)*elementTriangles;
+}
+
+// NOTE: Writes the vertex indices of the triangles assembled from the vertices of the
+//       call, in the order of 'pfiProcessRasterize_TRIANGLE_FAN/STRIP' (the quads are fans)
+static void
+pfiExpandTriangles(PFuint* triangles, PFdrawmode mode, PFsizei vertexCount)
+{
+    PFsizei elementSize = 0, elementStride = 0;
+    PFsizei elementTriangles = pfiGetElementLayout(mode, &elementSize, &elementStride);
+    PFboolean strip = (mode == PF_TRIANGLE_STRIP || mode == PF_QUAD_STRIP);
+
+    for (PFsizei first = 0; first + elementSize <= vertexCount; first += elementStride) {
+        for (PFuint i = 0; i < elementTriangles; i++) {
+            if (!strip) {
+                triangles[0] = first;
+                triangles[1] = first + i + 1;
+                triangles[2] = first + i + 2;
+            } else if (i % 2 == 0) {
+                triangles[0] = first + i;
+                triangles[1] = first + i + 1;
+                triangles[2] = first + i + 2;
+            } else {
+                triangles[0] = first + i + 2;
+                triangles[1] = first + i + 1;
+                triangles[2] = first + i;
+            }
+            triangles += 3;
+        }
+    }
+}
+
+static PFsizei
+pfiGetStreamsSize(const PFIrendercall* call)
+{
+    return pfiAlignStreamSize(call->vertexCount*sizeof(PFMvec4))
+         + pfiAlignStreamSize(call->vertexCount*sizeof(PFMvec3))
+         + 2*pfiAlignStreamSize(call->vertexCount*sizeof(PFMvec2))
+         + pfiAlignStreamSize(call->vertexCount*sizeof(PFcolor))
+         + pfiAlignStreamSize(3*call->streams.triangleCount*sizeof(PFuint));
+}
+
+static void
+pfiSetStreamsPointers(PFIvertexstreams* streams, PFsizei vertexCount, PFubyte* memory)
+{
+    PFubyte *stream = memory + streams->offset;
+
+    streams->positions = (PFfloat*)stream, stream += pfiAlignStreamSize(vertexCount*sizeof(PFMvec4));
+    streams->normals = (PFfloat*)stream, stream += pfiAlignStreamSize(vertexCount*sizeof(PFMvec3));
+    streams->texcoords = (PFfloat*)stream, stream += pfiAlignStreamSize(vertexCount*sizeof(PFMvec2));
+    streams->texcoords1 = (PFfloat*)stream, stream += pfiAlignStreamSize(vertexCount*sizeof(PFMvec2));
+    streams->colors = (PFcolor*)stream, stream += pfiAlignStreamSize(vertexCount*sizeof(PFcolor));
+    streams->triangles = (streams->triangleCount > 0) ? (PFuint*)stream : NULL;
+}
+
+// NOTE: Returns the size of the streams of the call, the offset of its streams must be set
+static PFsizei
+pfiLayoutCall(PFIrendercall* call)
+{
+    PFIvertexstreams *streams = &call->streams;
+
+    // NOTE: The triangles of an indexed call are counted by 'pfiOptimizeList'
+    if (call->indexed) {
+        streams->elementTriangles = 1;
+        return pfiGetStreamsSize(call);
+    }
+
+    PFsizei elementSize = 0, elementStride = 0;
+    streams->elementTriangles = pfiGetElementLayout(call->drawMode, &elementSize, &elementStride);
+    streams->triangleCount = pfiGetTriangleCount(call->drawMode, call->vertexCount);
+
+    return pfiGetStreamsSize(call);
+}
+
+// NOTE: Sets the offsets of the streams of the calls, returns the size of all the streams
+static PFsizei
+pfiLayoutList(PFIrenderlist* list)
+{
+    PFsizei streamsSize = 0;
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        PFIrendercall *call = pfiAtVector(&list->calls, i);
+        call->streams.offset = streamsSize;
+        streamsSize += pfiLayoutCall(call);
+    }
+    return streamsSize;
+}
+
+// NOTE: Writes the streams of the call at 'memory' + its offset, from its recorded vertices,
+//       'indices' are the triangles of an indexed call, built by 'pfiOptimizeList'
+static void
+pfiCompileCall(PFIrendercall* call, const PFIlistvertex* vertices, const PFuint* indices, PFubyte* memory)
+{
+    PFIvertexstreams *streams = &call->streams;
+    pfiSetStreamsPointers(streams, call->vertexCount, memory);
+
+    for (PFsizei i = 0; i < call->vertexCount; i++) {
+        const PFIlistvertex *vertex = vertices + call->firstVertex + i;
+        memcpy(streams->positions + 4*i, vertex->position, sizeof(PFMvec4));
+        memcpy(streams->normals + 3*i, vertex->normal, sizeof(PFMvec3));
+        memcpy(streams->texcoords + 2*i, vertex->texcoord, sizeof(PFMvec2));
+        memcpy(streams->texcoords1 + 2*i, vertex->texcoord1, sizeof(PFMvec2));
+        streams->colors[i] = vertex->color;
+    }
+
+    if (streams->triangles == NULL) return;
+
+    if (call->indexed) {
+        memcpy(streams->triangles, indices, 3*streams->triangleCount*sizeof(PFuint));
+    } else {
+        pfiExpandTriangles(streams->triangles, call->drawMode, call->vertexCount);
+    }
+}
+
+// NOTE: Returns whether the call can be appended to the merged call started by 'first' when the list
+//       is optimized, the triangles of all the draw modes can be merged since they become indexed
+//       triangles, the points and lines are concatenated unless a line would join the two calls
+static PFboolean
+pfiCanMergeCalls(const PFIrendercall* first, PFsizei mergedVertexCount, const PFIrendercall* call)
+{
+    if (first->texture != call->texture || first->texture1 != call->texture1 || memcmp(first->faceMaterial, call->faceMaterial, 2*sizeof(PFImaterial)) != 0) {
+        return PF_FALSE;
+    }
+
+    if (first->drawMode >= PF_TRIANGLES || call->drawMode >= PF_TRIANGLES) {
+        return first->drawMode >= PF_TRIANGLES && call->drawMode >= PF_TRIANGLES;
+    }
+
+    return first->drawMode == call->drawMode && (call->drawMode == PF_POINTS || mergedVertexCount % 2 == 0);
+}
+
+static PFuint
+pfiHashListVertex(const PFIlistvertex* vertex)
+{
+    const PFubyte *bytes = (const PFubyte*)vertex;
+    PFuint hash = 2166136261u;
+
+    for (PFsizei i = 0; i < sizeof(PFIlistvertex); i++) {
+        hash = (hash ^ bytes[i])*16777619u;
+    }
+
+    return hash;
+}
+
+// NOTE: Merges the compatible adjacent calls of the list (PF_LIST_OPTIMIZATION), two calls being
+//       adjacent if no other command is recorded between them. The calls of triangles become indexed
+//       triangles: the identical vertices of a merged call are compacted at the start of its range
+//       in the arena, in order of first use. Returns the triangles of the indexed calls, one after
+//       the other, or NULL without modifying the list if the temporary memory cannot be allocated.
+static PFuint*
+pfiOptimizeList(PFIrenderlist* list)
+{
+    PFsizei callCount = list->calls.size;
+    if (callCount == 0) return NULL;
+
+    PFuint *groups = PF_MALLOC(callCount*sizeof(PFuint));
+    if (groups == NULL) return NULL;
+
+    // Get the merged call of each call, the calls being recorded in the order of the commands
+    const PFIrendercall *groupFirst = NULL;
+    PFsizei groupCount = 0, groupVertexCount = 0, maxVertexCount = 0, indexCount = 0;
+    PFboolean adjacent = PF_FALSE;
+
+    for (const PFubyte *cmd = list->commands.data; (const void*)cmd < pfiEndVector(&list->commands);) {
+        const PFIcmdheader *header = (const PFIcmdheader*)cmd;
+        cmd += pfiGetCommandSize(header->argCount, header->dataSize);
+
+        if (header->type != PFI_CMD_RENDER_CALL) {
+            adjacent = PF_FALSE;
+            continue;
+        }
+
+        PFuint index = ((const PFIcmdarg*)(header + 1))->u;
+        const PFIrendercall *call = pfiAtVector(&list->calls, index);
+
+        if (!adjacent || !pfiCanMergeCalls(groupFirst, groupVertexCount, call)) {
+            groupFirst = call;
+            groupVertexCount = 0;
+            groupCount++;
+        }
+
+        groups[index] = groupCount - 1;
+        groupVertexCount += call->vertexCount;
+        indexCount += 3*pfiGetTriangleCount(call->drawMode, call->vertexCount);
+        adjacent = PF_TRUE;
+
+        if (groupVertexCount > maxVertexCount) {
+            maxVertexCount = groupVertexCount;
+        }
+    }
+
+    PFuint *table = PF_MALLOC(pfmNextPOT(2*maxVertexCount)*sizeof(PFuint));
+    PFuint *remap = PF_MALLOC((maxVertexCount + 1)*sizeof(PFuint));
+    PFuint *indices = PF_MALLOC((indexCount + 1)*sizeof(PFuint));
+
+    if (table == NULL || remap == NULL || indices == NULL) {
+        PF_FREE(groups), PF_FREE(table), PF_FREE(remap), PF_FREE(indices);
+        return NULL;
+    }
+
+    // Build the merged calls in place, each one is written once the calls it merges have been read
+    PFIlistvertex *vertices = (PFIlistvertex*)list->arena;
+    PFuint *triangles = indices;
+
+    for (PFsizei first = 0, last = 0; first < callCount; first = last) {
+        PFIrendercall merged = *(const PFIrendercall*)pfiAtVector(&list->calls, first);
+        while (last < callCount && groups[last] == groups[first]) last++;
+
+        const PFIrendercall *lastCall = pfiAtVector(&list->calls, last - 1);
+        merged.vertexCount = lastCall->firstVertex + lastCall->vertexCount - merged.firstVertex;
+
+        if (merged.drawMode >= PF_TRIANGLES) {
+            // Deduplicate the vertices with an open addressing table of their indices plus one
+            PFIlistvertex *mergedVertices = vertices + merged.firstVertex;
+            PFuint tableMask = (PFuint)pfmNextPOT(2*merged.vertexCount) - 1;
+            PFsizei uniqueCount = 0;
+
+            memset(table, 0, (tableMask + 1)*sizeof(PFuint));
+
+            for (PFsizei i = 0; i < merged.vertexCount; i++) {
+                PFuint slot = pfiHashListVertex(&mergedVertices[i]) & tableMask;
+                while (table[slot] != 0 && memcmp(&mergedVertices[table[slot] - 1], &mergedVertices[i], sizeof(PFIlistvertex)) != 0) {
+                    slot = (slot + 1) & tableMask;
+                }
+                if (table[slot] == 0) {
+                    mergedVertices[uniqueCount] = mergedVertices[i];
+                    table[slot] = ++uniqueCount;
+                }
+                remap[i] = table[slot] - 1;
+            }
+
+            // Expand the triangles of each call in the order they were drawn, then remap them
+            PFsizei triangleCount = 0;
+            for (PFsizei i = first; i < last; i++) {
+                const PFIrendercall *call = pfiAtVector(&list->calls, i);
+                PFuint *callTriangles = triangles + 3*triangleCount;
+                PFsizei callTriangleCount = pfiGetTriangleCount(call->drawMode, call->vertexCount);
+
+                pfiExpandTriangles(callTriangles, call->drawMode, call->vertexCount);
+                for (PFsizei j = 0; j < 3*callTriangleCount; j++) {
+                    callTriangles[j] = remap[call->firstVertex - merged.firstVertex + callTriangles[j]];
+                }
+
+                triangleCount += callTriangleCount;
+            }
+
+            merged.vertexCount = uniqueCount;
+            merged.drawMode = PF_TRIANGLES;
+            merged.indexed = PF_TRUE;
+            merged.streams.triangleCount = triangleCount;
+            triangles += 3*triangleCount;
+        }
+
+        *(PFIrendercall*)pfiAtVector(&list->calls, groups[first]) = merged;
+    }
+
+    // Remove the render call commands of the merged calls, and renumber the others
+    PFubyte *dst = list->commands.data;
+    const PFubyte *end = pfiEndVector(&list->commands);
+
+    for (PFubyte *cmd = list->commands.data; cmd < end;) {
+        PFIcmdheader *header = (PFIcmdheader*)cmd;
+        PFsizei cmdSize = pfiGetCommandSize(header->argCount, header->dataSize);
+
+        if (header->type == PFI_CMD_RENDER_CALL) {
+            PFIcmdarg *args = (PFIcmdarg*)(header + 1);
+            if (args->u > 0 && groups[args->u] == groups[args->u - 1]) {
+                cmd += cmdSize;
+                continue;
+            }
+            args->u = groups[args->u];
+        }
+
+        memmove(dst, cmd, cmdSize);
+        dst += cmdSize, cmd += cmdSize;
+    }
+
+    list->commands.size = dst - (PFubyte*)list->commands.data;
+    list->calls.size = groupCount;
+
+    PF_FREE(groups), PF_FREE(table), PF_FREE(remap);
+
+    return indices;
+}
+
+// NOTE: Computes the bounds of the vertices of the call from its recorded vertices,
+//       they are only valid if all the vertices have a W coordinate of 1
+static void
+pfiComputeCallBounds(PFIrendercall* call, const PFIlistvertex* vertices)
+{
+    PFIbounds *bounds = &call->bounds;
+    vertices += call->firstVertex;
+
+    bounds->valid = (call->vertexCount > 0);
+    if (!bounds->valid) return;
+
+    memcpy(bounds->min, vertices[0].position, sizeof(PFMvec3));
+    memcpy(bounds->max, vertices[0].position, sizeof(PFMvec3));
+
+    for (PFsizei i = 0; i < call->vertexCount; i++) {
+        const PFfloat *position = vertices[i].position;
+        if (position[3] != 1.0f) {
+            bounds->valid = PF_FALSE;
+            return;
+        }
+        for (int_fast8_t j = 0; j < 3; j++) {
+            if (position[j] < bounds->min[j]) bounds->min[j] = position[j];
+            if (position[j] > bounds->max[j]) bounds->max[j] = position[j];
+        }
+    }
+
+    PFfloat radiusSq = 0.0f;
+    pfmVec3Add(bounds->center, bounds->min, bounds->max);
+    pfmVec3Scale(bounds->center, bounds->center, 0.5f);
+
+    for (PFsizei i = 0; i < call->vertexCount; i++) {
+        PFMvec3 offset;
+        pfmVec3Sub(offset, vertices[i].position, bounds->center);
+        PFfloat distanceSq = pfmVec3Dot(offset, offset);
+        if (distanceSq > radiusSq) radiusSq = distanceSq;
+    }
+
+    bounds->radius = sqrtf(radiusSq);
+}
+
+// NOTE: Computes the bounds of the list from the bounds of its calls, they are not
+//       valid if the list has no call or if the bounds of one of its calls are not
+static void
+pfiComputeListBounds(PFIrenderlist* list)
+{
+    PFIbounds *bounds = &list->bounds;
+    bounds->valid = (list->calls.size > 0);
+
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        const PFIbounds *callBounds = &((const PFIrendercall*)pfiAtVector(&list->calls, i))->bounds;
+        if (!callBounds->valid) {
+            bounds->valid = PF_FALSE;
+            return;
+        }
+        for (int_fast8_t j = 0; j < 3; j++) {
+            if (i == 0 || callBounds->min[j] < bounds->min[j]) bounds->min[j] = callBounds->min[j];
+            if (i == 0 || callBounds->max[j] > bounds->max[j]) bounds->max[j] = callBounds->max[j];
+        }
+    }
+
+    if (!bounds->valid) return;
+
+    pfmVec3Add(bounds->center, bounds->min, bounds->max);
+    pfmVec3Scale(bounds->center, bounds->center, 0.5f);
+    bounds->radius = 0.0f;
+
+    // The sphere of the list encloses the spheres of its calls
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        const PFIbounds *callBounds = &((const PFIrendercall*)pfiAtVector(&list->calls, i))->bounds;
+        PFfloat radius = pfmVec3Distance(callBounds->center, bounds->center) + callBounds->radius;
+        if (radius > bounds->radius) bounds->radius = radius;
+    }
+}
+
+// NOTE: Tests the bounds against the frustum of the model-view-projection matrix. The geometry
+//       is only reported outside if none of its primitives can be rasterized, whichever clipping
+//       path they take: primitives whose W coordinates are 1 are not clipped in clip space but in
+//       screen space (see 'Process_ProjectAndClipTriangle'), so when the box may contain such
+//       vertices, only the sides of the frustum are tested, with a guard band of a few pixels.
+static PFIboundstest
+pfiTestBounds(const PFIbounds* bounds, const PFMmat4 mvp)
+{
+    if (!bounds->valid) return PFI_BOUNDS_INTERSECT;
+
+    // Quick acceptance of the sphere with the planes of the frustum, which are
+    // extracted from the rows of the matrix (the row of W, plus or minus another row)
+    PFboolean inside = PF_TRUE;
+    for (int_fast8_t i = 0; i < 6 && inside; i++) {
+        PFfloat sign = (i % 2 == 0) ? 1.0f : -1.0f;
+        PFint row = i / 2;
+        PFMvec3 normal = {
+            mvp[3] + sign*mvp[row],
+            mvp[7] + sign*mvp[4 + row],
+            mvp[11] + sign*mvp[8 + row]
+        };
+        PFfloat distance = pfmVec3Dot(normal, bounds->center) + mvp[15] + sign*mvp[12 + row];
+        inside = (distance > bounds->radius*pfmVec3Length(normal));
+    }
+
+    if (inside) {
+        return PFI_BOUNDS_INSIDE;
+    }
+
+    // Transform the corners of the box, with a tolerance for the rounding
+    // differences with the transformation of the vertices themselves
+    PFfloat matrixScale = 0.0f, boundsScale = 1.0f;
+    for (int_fast8_t i = 0; i < 16; i++) {
+        matrixScale = fmaxf(matrixScale, fabsf(mvp[i]));
+    }
+    for (int_fast8_t i = 0; i < 3; i++) {
+        boundsScale += fmaxf(fabsf(bounds->min[i]), fabsf(bounds->max[i]));
+    }
+
+    PFfloat tolerance = 2*PF_CLIP_EPSILON + 1e-4f*matrixScale*boundsScale;
+
+    PFMvec4 corners[8];
+    PFboolean aboveOne = PF_TRUE, belowOne = PF_TRUE;
+
+    for (int_fast8_t i = 0; i < 8; i++) {
+        PFMvec4 corner = {
+            (i & 1) ? bounds->max[0] : bounds->min[0],
+            (i & 2) ? bounds->max[1] : bounds->min[1],
+            (i & 4) ? bounds->max[2] : bounds->min[2],
+            1.0f
+        };
+        pfmVec4Transform(corners[i], corner, mvp);
+        aboveOne &= (corners[i][3] > 1.0f + 2*PF_CLIP_EPSILON + tolerance);
+        belowOne &= (corners[i][3] < 1.0f - 2*PF_CLIP_EPSILON - tolerance);
+    }
+
+    if (aboveOne || belowOne) {
+        // All the primitives are clipped in clip space, against W and the six planes
+        for (int_fast8_t plane = 0; plane < 7; plane++) {
+            PFboolean outside = PF_TRUE;
+            for (int_fast8_t i = 0; i < 8 && outside; i++) {
+                const PFfloat *c = corners[i];
+                PFfloat distance = (plane == 0) ? -c[3] : ((plane % 2) ? 1.0f : -1.0f)*c[(plane - 1)/2] - c[3];
+                outside = (distance > tolerance);
+            }
+            if (outside) return PFI_BOUNDS_OUTSIDE;
+        }
+    } else {
+        // The corners must be outside the side in clip space and beyond the guard band,
+        // both with and without the division by W
+        PFfloat guard[2] = {
+            1.0f + 8.0f/(G_currentCtx->vpDim[0] + 1),
+            1.0f + 8.0f/(G_currentCtx->vpDim[1] + 1)
+        };
+        for (int_fast8_t side = 0; side < 4; side++) {
+            PFfloat sign = (side % 2 == 0) ? 1.0f : -1.0f;
+            PFint axis = side / 2;
+            PFboolean outside = PF_TRUE;
+            for (int_fast8_t i = 0; i < 8 && outside; i++) {
+                PFfloat coord = sign*corners[i][axis];
+                outside = (coord - guard[axis]*corners[i][3] > tolerance && coord - guard[axis] > tolerance);
+            }
+            if (outside) return PFI_BOUNDS_OUTSIDE;
+        }
+    }
+
+    return PFI_BOUNDS_INTERSECT;
+}
+
+// NOTE: Returns whether the command modifies the matrices, the calls recorded after
+//       such a command cannot be tested with the matrices given to 'pfCallList'
+static PFboolean
+pfiIsMatrixCommand(PFIcmdtype type)
+{
+    return (type >= PFI_CMD_MATRIX_MODE && type <= PFI_CMD_ORTHO) || type == PFI_CMD_TRANSFORM;
+}
+
+static PFIlistfilebounds
+pfiSaveBounds(const PFIbounds* bounds)
+{
+    PFIlistfilebounds fileBounds = { .radius = bounds->radius, .valid = bounds->valid };
+    memcpy(fileBounds.min, bounds->min, sizeof(PFMvec3));
+    memcpy(fileBounds.max, bounds->max, sizeof(PFMvec3));
+    memcpy(fileBounds.center, bounds->center, sizeof(PFMvec3));
+    return fileBounds;
+}
+
+static PFIbounds
+pfiLoadBounds(const PFIlistfilebounds* fileBounds)
+{
+    PFIbounds bounds = { .radius = fileBounds->radius, .valid = (fileBounds->valid != 0) };
+    memcpy(bounds.min, fileBounds->min, sizeof(PFMvec3));
+    memcpy(bounds.max, fileBounds->max, sizeof(PFMvec3));
+    memcpy(bounds.center, fileBounds->center, sizeof(PFMvec3));
+    return bounds;
+}
+
+// NOTE: Returns the index of the material in the table, or the size of the table if it is not in it
+static PFsizei
+pfiFindListMaterial(const PFIvector* materials, const PFImaterial* material)
+{
+    for (PFsizei i = 0; i < materials->size; i++) {
+        if (memcmp((const PFImaterial*)materials->data + i, material, sizeof(PFImaterial)) == 0) {
+            return i;
+        }
+    }
+    return materials->size;
+}
+
+// NOTE: Returns the index of the texture in the given textures, or 'textureCount' if it is not in them
+static PFuint
+pfiFindTextureSlot(PFtexture texture, const PFtexture* textures, PFsizei textureCount)
+{
+    if (texture == NULL) return PFI_LIST_NO_TEXTURE;
+
+    for (PFsizei i = 0; i < textureCount; i++) {
+        if (textures[i] == texture) return i;
+    }
+    return textureCount;
+}
+
+static PFboolean
+pfiIsValidListHeader(const PFIlistfileheader* header, PFsizei dataSize, PFsizei textureCount)
+{
+    if (memcmp(header->magic, "PFRL", 4) != 0 || header->version != PFI_LIST_FILE_VERSION
+        || header->byteOrder != PFI_LIST_FILE_BYTE_ORDER || header->argSize != sizeof(PFIcmdarg)
+        || header->streamAlignment != PF_LIST_STREAM_ALIGNMENT || header->textureCount > textureCount) {
+        return PF_FALSE;
+    }
+
+    // The blocks must follow each other within the data, the streams being aligned
+    return header->commandsOffset >= sizeof(PFIlistfileheader)
+        && header->callsOffset >= (uint64_t)header->commandsOffset + header->commandsSize
+        && header->materialsOffset >= (uint64_t)header->callsOffset + (uint64_t)header->callCount*sizeof(PFIlistfilecall)
+        && header->streamsOffset >= (uint64_t)header->materialsOffset + (uint64_t)header->materialCount*sizeof(PFImaterial)
+        && header->streamsOffset % PF_LIST_STREAM_ALIGNMENT == 0
+        && (uint64_t)header->streamsOffset + header->streamsSize <= dataSize;
+}
+
+// NOTE: Returns whether the command can be executed from a loaded list, only the commands
+//       recorded in lists are accepted, with the arguments and data they read
+static PFboolean
+pfiIsValidListCommand(const PFIcmdheader* header, const PFIcmdarg* args, PFsizei callCount)
+{
+    PFsizei argCount = 0, dataSize = 0;
+
+    switch (header->type) {
+        case PFI_CMD_PUSH_MATRIX:
+        case PFI_CMD_POP_MATRIX:
+        case PFI_CMD_LOAD_IDENTITY:
+            break;
+        case PFI_CMD_ENABLE:
+        case PFI_CMD_DISABLE:
+        case PFI_CMD_MATRIX_MODE:
+        case PFI_CMD_SHADE_MODEL:
+        case PFI_CMD_LIGHT_MODEL:
+        case PFI_CMD_LINE_WIDTH:
+        case PFI_CMD_POINT_SIZE:
+        case PFI_CMD_CULL_FACE:
+        case PFI_CMD_BLEND_FUNC:
+        case PFI_CMD_DEPTH_FUNC:
+        case PFI_CMD_ACTIVE_TEXTURE:
+        case PFI_CMD_TEX_COMBINE:
+        case PFI_CMD_ENABLE_LIGHT:
+        case PFI_CMD_DISABLE_LIGHT:
+            argCount = 1;
+            break;
+        case PFI_CMD_POLYGON_MODE:
+        case PFI_CMD_COLOR_MATERIAL:
+            argCount = 2;
+            break;
+        case PFI_CMD_LIGHTF:
+            argCount = 3;
+            break;
+        case PFI_CMD_LIGHTFV:
+            if (header->argCount < 2) return PF_FALSE;
+            argCount = 2, dataSize = pfiGetParamValueSize(args[1].u);
+            break;
+        case PFI_CMD_MULT_MATRIX:
+        case PFI_CMD_TRANSFORM:
+            dataSize = sizeof(PFMmat4);
+            break;
+        case PFI_CMD_RENDER_CALL:
+            return header->argCount >= 1 && args[0].u < callCount;
+        default:
+            return PF_FALSE;
+    }
+
+    return header->argCount >= argCount && header->dataSize >= dataSize;
+}
+
+// NOTE: Returns where to write a command of 'cmdSize' bytes at the end of the
+//       commands of the list, or NULL if the commands could not grow
+static void*
+pfiAppendCommand(PFIrenderlist* list, PFsizei cmdSize)
+{
+    PFIvector *commands = &list->commands;
+
+    if (commands->size + cmdSize > commands->capacity) {
+        PFsizei capacity = (PFsizei)pfmNextPOT(commands->size + cmdSize);
+        if (pfiResizeVector(commands, capacity) != 0) {
+            return NULL;
+        }
+    }
+
+    void *cmd = (PFubyte*)commands->data + commands->size;
+    commands->size += cmdSize;
+
+    return cmd;
+}
+
+static PFboolean
+pfiReserveArena(PFIrenderlist* list, PFsizei size)
+{
+    if (size <= list->arenaCapacity) {
+        return PF_TRUE;
+    }
+
+    PFsizei capacity = (list->arenaCapacity > 0) ? list->arenaCapacity : PF_LIST_ARENA_MIN_SIZE;
+    while (capacity < size) capacity *= 2;
+
+    PFubyte *arena = PF_REALLOC(list->arena, capacity);
+    if (arena == NULL) return PF_FALSE;
+
+    list->arena = arena;
+    list->arenaCapacity = capacity;
+
+    return PF_TRUE;
+}
+
+static void
+pfiFetchStreamVertex(const PFIlistfetch* fetch, PFuint index, PFIvertex* vertex)
+{
+    const PFIvertexstreams *streams = fetch->streams;
+
+    // NOTE: The other members of the vertex are written by the processing
+    memcpy(vertex->position, streams->positions + 4*index, sizeof(PFMvec4));
+    memcpy(vertex->normal, streams->normals + 3*index, sizeof(PFMvec3));
+    memcpy(vertex->texcoord, streams->texcoords + 2*index, sizeof(PFMvec2));
+    memcpy(vertex->texcoord1, streams->texcoords1 + 2*index, sizeof(PFMvec2));
+    vertex->color = streams->colors[index];
+
+    if (fetch->transformTexcoord) {
+        pfmVec2Transform(vertex->texcoord, vertex->texcoord, fetch->matTexture);
+    }
+
+    if (fetch->normalize) {
+        pfmVec3Normalize(vertex->normal, vertex->normal);
+    }
+}
+
+// NOTE: Fetches the vertices of the expanded triangles, does not access the current
+//       context so it can be called from the jobs of 'pfiProcessRasterize_TRIANGLES_PARALLEL'
+static void
+pfiFetchTriangleVertex(const void* data, PFsizei index, PFIvertex* vertex)
+{
+    const PFIlistfetch *fetch = data;
+    pfiFetchStreamVertex(fetch, fetch->streams->triangles[index], vertex);
+}
+
+// NOTE: Large calls of filled triangles have their geometry stage shared between threads
+static PFboolean
+pfiDrawCompiledTriangles(const PFIrendercall* call, const PFIlistfetch* fetch)
+{
+    const PFIvertexstreams *streams = &call->streams;
+    if (streams->triangles == NULL) return PF_FALSE;
+
+    // Get faces to render
+    // NOTE: Here we invert cullFace, because PF_FRONT = 0,
+    //       !PF_FRONT = PF_BACK, and vice versa.
+    PFface faceToRender = (G_currentCtx->state & PF_CULL_FACE)
+        ? (!G_currentCtx->cullFace) : PF_FRONT_AND_BACK;
+
+    // NOTE: The parallel path processes both faces of each triangle in turn, while
+    //       the elements made of several triangles are processed face by face
+    if (faceToRender == PF_FRONT_AND_BACK) {
+        if (streams->elementTriangles > 1) return PF_FALSE;
+        if (G_currentCtx->polygonMode[PF_FRONT] != PF_FILL) return PF_FALSE;
+        if (G_currentCtx->polygonMode[PF_BACK] != PF_FILL) return PF_FALSE;
+    } else if (G_currentCtx->polygonMode[faceToRender] != PF_FILL) {
+        return PF_FALSE;
+    }
+
+    pfBegin(PF_TRIANGLES);
+
+    PFboolean drawn = pfiProcessRasterize_TRIANGLES_PARALLEL(
+        3*streams->triangleCount, PF_PARALLEL_GEOMETRY_THRESHOLD_TRIANGLES, pfiFetchTriangleVertex, fetch);
+
+    pfEnd();
+
+    return drawn;
+}
+
+// NOTE: Draws a compiled call without going through the vertex batch, returns
+//       PF_FALSE if the call must be replayed vertex by vertex ('pfiReplayCall')
+static PFboolean
+pfiDrawCompiledCall(const PFIrendercall* call)
+{
+    const PFIvertexstreams *streams = &call->streams;
+
+    // The colors must go through 'pfColor' when they modify the materials,
+    // and the calls made while recording another list are recorded into it
+    if (G_currentCtx->currentRenderList != NULL || (G_currentCtx->state & PF_COLOR_MATERIAL)) {
+        return PF_FALSE;
+    }
+
+    PFMmat4 identity;
+    pfmMat4Identity(identity);
+
+    PFIlistfetch fetch = {
+        .streams = streams,
+        .transformTexcoord = memcmp(G_currentCtx->matTexture, identity, sizeof(PFMmat4)) != 0,
+        .normalize = (G_currentCtx->state & PF_NORMALIZE) != 0
+    };
+
+    memcpy(fetch.matTexture, G_currentCtx->matTexture, sizeof(PFMmat4));
+
+    if (pfiDrawCompiledTriangles(call, &fetch)) {
+        return PF_TRUE;
+    }
+
+    // Assemble the primitives like 'pfiFlushBatch', directly from the streams
+    pfBegin(call->drawMode);
+
+    PFsizei drawModeVertexCount = pfiGetDrawModeVertexCount(call->drawMode);
+    PFsizei vertexCount = call->indexed ? 3*streams->triangleCount : call->vertexCount;
+
+    for (PFuint i = 0; i < vertexCount; i++) {
+        PFuint index = call->indexed ? streams->triangles[i] : i;
+        pfiFetchStreamVertex(&fetch, index, &G_currentCtx->vertexBuffer[G_currentCtx->vertexCounter++]);
+
+        if (G_currentCtx->vertexCounter == drawModeVertexCount) {
+            pfiProcessAndRasterize();
+            pfiResetVertexBufferForNextElement();
+        }
+    }
+
+    pfEnd();
+
+    return PF_TRUE;
+}
+
+static void
+pfiReplayCall(const PFIrenderlist* list, const PFIrendercall* call)
+{
+    pfBegin(call->drawMode);
+
+    if (list->compiled) {
+        const PFIvertexstreams *streams = &call->streams;
+        PFsizei vertexCount = call->indexed ? 3*streams->triangleCount : call->vertexCount;
+        for (PFsizei i = 0; i < vertexCount; ++i) {
+            PFuint index = call->indexed ? streams->triangles[i] : i;
+            pfColor4ubv((const PFubyte*)(streams->colors + index));
+            pfTexCoordfv(streams->texcoords + 2 * index);
+            pfMultiTexCoordfv(PF_TEXTURE1, streams->texcoords1 + 2 * index);
+            pfNormal3fv(streams->normals + 3 * index);
+            pfVertex4fv(streams->positions + 4 * index);
+        }
+    } else {
+        const PFIlistvertex *vertices = (const PFIlistvertex*)list->arena + call->firstVertex;
+        for (PFsizei i = 0; i < call->vertexCount; ++i) {
+            pfColor4ubv((const PFubyte*)&vertices[i].color);
+            pfTexCoordfv(vertices[i].texcoord);
+            pfMultiTexCoordfv(PF_TEXTURE1, vertices[i].texcoord1);
+            pfNormal3fv(vertices[i].normal);
+            pfVertex4fv(vertices[i].position);
+        }
+    }
+
+    pfEnd();
+}
+
+/* Internal render list recording functions */
+
+void
+pfiRecordBegin(PFIrenderlist* list, PFdrawmode mode, const PFImaterial faceMaterial[2], PFtexture texture, PFtexture texture1)
+{
+    PFIrendercall call = {
+        .faceMaterial[0] = faceMaterial[0],
+        .faceMaterial[1] = faceMaterial[1],
+        .firstVertex = list->arenaSize/sizeof(PFIlistvertex),
+        .vertexCount = 0,
+        .texture = texture,
+        .texture1 = texture1,
+        .drawMode = mode,
+    };
+
+    PFIcmdarg args[] = { { .u = list->calls.size } };
+    PFsizei cmdSize = pfiGetCommandSize(1, 0);
+    void *cmd = pfiAppendCommand(list, cmdSize);
+
+    if (cmd == NULL || pfiPushBackVector(&list->calls, &call) != 0) {
+        // NOTE: The command would be read without its call, it is removed from the stream
+        if (cmd != NULL) {
+            list->commands.size -= cmdSize;
+        }
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        }
+        return;
+    }
+
+    pfiEncodeCommand(cmd, PFI_CMD_RENDER_CALL, args, 1, NULL, 0);
+}
+
+PFboolean
+pfiRecordVertex(PFIrenderlist* list, const PFfloat* position, const PFfloat* texcoord, const PFfloat* texcoord1, const PFfloat* normal, PFcolor color)
+{
+    PFIrendercall *call = pfiAtVector(&list->calls, list->calls.size - 1);
+    if (call == NULL) return PF_FALSE;
+
+    if (!pfiReserveArena(list, list->arenaSize + sizeof(PFIlistvertex))) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        }
+        return PF_FALSE;
+    }
+
+    PFIlistvertex *vertex = (PFIlistvertex*)(list->arena + list->arenaSize);
+    memcpy(vertex->position, position, sizeof(PFMvec4));
+    memcpy(vertex->normal, normal, sizeof(PFMvec3));
+    memcpy(vertex->texcoord, texcoord, sizeof(PFMvec2));
+    memcpy(vertex->texcoord1, texcoord1, sizeof(PFMvec2));
+    vertex->color = color;
+
+    list->arenaSize += sizeof(PFIlistvertex);
+    call->vertexCount++;
+
+    return PF_TRUE;
+}
+
+PFboolean
+pfiRecordCommand(PFIcmdtype type, const PFIcmdarg* args, PFsizei argCount, const void* data, PFsizei dataSize)
+{
+    PFIrenderlist *list = G_currentCtx->currentRenderList;
+    if (list == NULL) return PF_FALSE;
+
+    void *cmd = pfiAppendCommand(list, pfiGetCommandSize(argCount, dataSize));
+
+    if (cmd == NULL) {
+        G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        return PF_TRUE;
+    }
+
+    pfiEncodeCommand(cmd, type, args, argCount, data, dataSize);
+    list->transforms |= pfiIsMatrixCommand(type);
+
+    return PF_TRUE;
+}
+
+void
+pfiClearList(PFIrenderlist* list)
+{
+    // NOTE: The arena is kept to record the list again without allocating,
+    //       unless it is the memory given to 'pfLoadList'
+    if (list->externalArena) {
+        list->arena = NULL;
+        list->arenaCapacity = 0;
+        list->externalArena = PF_FALSE;
+    }
+
+    pfiClearVector(&list->commands);
+    pfiClearVector(&list->calls);
+    list->arenaSize = 0;
+    list->bounds.valid = PF_FALSE;
+    list->transforms = PF_FALSE;
+    list->compiled = PF_FALSE;
+}
+
+void
+pfiCompileList(PFIrenderlist* list, PFboolean optimize)
+{
+    if (list->compiled) return;
+
+    // The streams are written after the recorded vertices, then moved to the start of the arena
+    // NOTE: If the arena cannot grow, the calls are replayed from the recorded vertices, so the
+    //       list is only optimized once reserved, which can only reduce the size of the streams
+    PFsizei streamsOffset = pfiAlignStreamSize(list->arenaSize);
+    PFsizei streamsSize = pfiLayoutList(list);
+    if (!pfiReserveArena(list, streamsOffset + streamsSize)) {
+        return;
+    }
+
+    PFuint *indices = optimize ? pfiOptimizeList(list) : NULL;
+    if (indices != NULL) {
+        streamsSize = pfiLayoutList(list);
+    }
+
+    // Compute the bounds used by 'pfCallList' to cull the calls
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        pfiComputeCallBounds(pfiAtVector(&list->calls, i), (const PFIlistvertex*)list->arena);
+    }
+
+    pfiComputeListBounds(list);
+
+    const PFIlistvertex *vertices = (const PFIlistvertex*)list->arena;
+    const PFuint *triangles = indices;
+
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        PFIrendercall *call = pfiAtVector(&list->calls, i);
+        pfiCompileCall(call, vertices, triangles, list->arena + streamsOffset);
+        if (call->indexed) triangles += 3*call->streams.triangleCount;
+    }
+
+    PF_FREE(indices);
+
+    memmove(list->arena, list->arena + streamsOffset, streamsSize);
+
+    // Shrink the arena to fit the streams, keeping room to align them
+    // NOTE: If the reallocation fails, the arena stays valid with its current size
+    PFsizei capacity = streamsSize + PF_LIST_STREAM_ALIGNMENT - 1;
+    if (capacity < list->arenaCapacity) {
+        PFubyte *arena = PF_REALLOC(list->arena, capacity);
+        if (arena != NULL) {
+            list->arena = arena;
+            list->arenaCapacity = capacity;
+        }
+    }
+
+    PFsizei padding = (PFsizei)((PF_LIST_STREAM_ALIGNMENT - (uintptr_t)list->arena % PF_LIST_STREAM_ALIGNMENT) % PF_LIST_STREAM_ALIGNMENT);
+    if (padding > 0) {
+        memmove(list->arena + padding, list->arena, streamsSize);
+    }
+
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        PFIrendercall *call = pfiAtVector(&list->calls, i);
+        pfiSetStreamsPointers(&call->streams, call->vertexCount, list->arena + padding);
+    }
+
+    list->arenaSize = padding + streamsSize;
+    list->compiled = PF_TRUE;
+}
+
+/* Render list functions */
 
 PFrenderlist
 pfGenList(void)
 {
-    PFIrenderlist *list = malloc(sizeof(PFIrenderlist));
+    PFIrenderlist *list = PF_MALLOC(sizeof(PFIrenderlist));
     if (list != NULL) {
-        *list = pfiGenVector(1, sizeof(PFIrendercall));
+        *list = (PFIrenderlist) {
+            .commands = pfiGenVector(PF_LIST_COMMANDS_MIN_SIZE, sizeof(PFubyte)),
+            .calls = pfiGenVector(1, sizeof(PFIrendercall))
+        };
     }
     return list;
 }
@@ -18,17 +1061,15 @@ pfDeleteList(PFrenderlist* renderList)
 {
     if (renderList == NULL) return;
 
+    // NOTE: The list can be in use by the render thread of a deferred context
+    if (G_currentCtx) pfiSyncCommands();
+
     PFIrenderlist *list = *renderList;
 
     if (list != NULL) {
-        for (PFint i = list->size - 1; i >= 0; --i) {
-            PFIrendercall *call = pfiAtVector(list, i);
-            pfiDeleteVector(&call->positions);
-            pfiDeleteVector(&call->texcoords);
-            pfiDeleteVector(&call->normals);
-            pfiDeleteVector(&call->colors);
-        }
-        pfiDeleteVector(list);
+        pfiDeleteVector(&list->commands);
+        pfiDeleteVector(&list->calls);
+        if (!list->externalArena) PF_FREE(list->arena);
         PF_FREE(list);
     }
 
@@ -38,6 +1079,12 @@ pfDeleteList(PFrenderlist* renderList)
 void
 pfNewList(PFrenderlist renderList)
 {
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .p = renderList } };
+        pfiPushCommand(PFI_CMD_NEW_LIST, args, 1, NULL, 0);
+        return;
+    }
+
     if (renderList == NULL) {
         G_currentCtx->errCode = PF_INVALID_VALUE;
         return;
@@ -45,14 +1092,9 @@ pfNewList(PFrenderlist renderList)
 
     PFIrenderlist *list = renderList;
 
-    while (list->size > 0) {
-        PFIrendercall call = { 0 };
-        pfiPopBackVector(list, &call);
-        pfiDeleteVector(&call.positions);
-        pfiDeleteVector(&call.texcoords);
-        pfiDeleteVector(&call.normals);
-        pfiDeleteVector(&call.colors);
-    }
+    pfiFlushBatch();
+
+    pfiClearList(list);
 
     G_currentCtx->currentRenderList = renderList;
     pfiMakeContextBackup();
@@ -61,8 +1103,15 @@ pfNewList(PFrenderlist renderList)
 void
 pfEndList(void)
 {
+    if (pfiIsDeferred()) {
+        pfiPushCommand(PFI_CMD_END_LIST, NULL, 0, NULL, 0);
+        return;
+    }
+
     if (G_currentCtx->currentRenderList == NULL) {
         G_currentCtx->errCode = PF_INVALID_OPERATION;
+    } else {
+        pfiCompileList(G_currentCtx->currentRenderList, (G_currentCtx->state & PF_LIST_OPTIMIZATION) != 0);
     }
     G_currentCtx->currentRenderList = NULL;
     pfiRestoreContext();
@@ -71,27 +1120,479 @@ pfEndList(void)
 void
 pfCallList(const PFrenderlist renderList)
 {
-    pfiMakeContextBackup();
+    if (pfiIsDeferred()) {
+        PFIcmdarg args[] = { { .p = renderList } };
+        pfiPushCommand(PFI_CMD_CALL_LIST, args, 1, NULL, 0);
+        return;
+    }
 
     PFIrenderlist *list = renderList;
-    for (const PFIrendercall *call = list->data; (const void*)call < pfiEndVector(list); ++call) {
-        float *positions = call->positions.data;
-        float *texcoords = call->texcoords.data;
-        float *normals = call->normals.data;
-        PFcolor *colors = call->colors.data;
-
-        memcpy(G_currentCtx->faceMaterial, call->faceMaterial, 2 * sizeof(PFImaterial));
-        pfBindTexture(call->texture);
-
-        pfBegin(call->drawMode);
-            for (PFsizei i = 0; i < call->positions.size; ++i) {
-                pfColor4ubv((PFubyte*)(colors + i));
-                pfTexCoordfv(texcoords + 2 * i);
-                pfNormal3fv(normals + 3 * i);
-                pfVertex4fv(positions + 4 * i);
+    const PFubyte *cmd = list->commands.data;
+
+    // Frustum culling, the bounds of a list that does not modify the matrices are tested
+    // once, and those of its calls only if it intersects the frustum, otherwise the calls
+    // are tested one by one with the matrices set by the commands that precede them
+    // NOTE: The calls replayed into a list being recorded are never culled
+    PFboolean testCalls = (G_currentCtx->currentRenderList == NULL);
+    PFboolean skipCalls = PF_FALSE;
+    PFboolean updateMVP = PF_TRUE;
+    PFMmat4 mvp;
+
+    if (testCalls && !list->transforms) {
+        pfiComputeMVP(mvp);
+        PFIboundstest test = pfiTestBounds(&list->bounds, mvp);
+
+        // Nothing to do if the list is outside and only contains render calls
+        if (test == PFI_BOUNDS_OUTSIDE && list->commands.size == list->calls.size*pfiGetCommandSize(1, 0)) {
+            return;
+        }
+
+        skipCalls = (test == PFI_BOUNDS_OUTSIDE);
+        testCalls = (test == PFI_BOUNDS_INTERSECT);
+        updateMVP = PF_FALSE;
+    }
+
+    pfiFlushBatch();
+    pfiMakeContextBackup();
+
+    while ((const void*)cmd < pfiEndVector(&list->commands)) {
+        const PFIcmdheader *header = (const PFIcmdheader*)cmd;
+        PFsizei cmdSize = pfiGetCommandSize(header->argCount, header->dataSize);
+
+        if (header->type == PFI_CMD_RENDER_CALL) {
+            const PFIrendercall *call = pfiAtVector(&list->calls, ((const PFIcmdarg*)(header + 1))->u);
+
+            if (testCalls && updateMVP) {
+                pfiComputeMVP(mvp);
+                updateMVP = PF_FALSE;
+            }
+
+            if (!skipCalls && (!testCalls || pfiTestBounds(&call->bounds, mvp) != PFI_BOUNDS_OUTSIDE)) {
+                memcpy(G_currentCtx->faceMaterial, call->faceMaterial, 2 * sizeof(PFImaterial));
+                pfiFlushBatch();
+                G_currentCtx->currentTexture = call->texture;
+                G_currentCtx->currentTexture1 = call->texture1;
+
+                if (!list->compiled || !pfiDrawCompiledCall(call)) {
+                    pfiReplayCall(list, call);
+                }
             }
-        pfEnd();
+        } else if (G_currentCtx->currentRenderList != NULL) {
+            // NOTE: The state changes of a list called while recording another one are
+            //       copied into it, like its render calls which are replayed into it
+            void *copy = pfiAppendCommand(G_currentCtx->currentRenderList, cmdSize);
+            if (copy != NULL) memcpy(copy, cmd, cmdSize);
+            else G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+            G_currentCtx->currentRenderList->transforms |= pfiIsMatrixCommand(header->type);
+        } else {
+            pfiExecuteCommand(cmd);
+            updateMVP |= pfiIsMatrixCommand(header->type);
+        }
+
+        cmd += cmdSize;
     }
 
+    // NOTE: The states enabled or disabled by the list are kept, like its other
+    //       recorded state changes, only the vertex attributes, materials,
+    //       textures and active texture unit overwritten by the render calls are restored
+    PFuint state = G_currentCtx->state, texture1State = G_currentCtx->texture1State;
     pfiRestoreContext();
+    G_currentCtx->state = state;
+    G_currentCtx->texture1State = texture1State;
+}
+
+/* Render list serialization functions */
+
+PFsizei
+pfSaveList(const PFrenderlist renderList, void* buffer, PFsizei bufferSize, const PFtexture* textures, PFsizei textureCount)
+{
+    // NOTE: The list can be recorded by the render thread of a deferred context
+    if (G_currentCtx) pfiSyncCommands();
+
+    PFIrenderlist *list = renderList;
+
+    if (list == NULL || !list->compiled) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = (list == NULL) ? PF_INVALID_VALUE : PF_INVALID_OPERATION;
+        }
+        return 0;
+    }
+
+    // Gather the distinct materials of the calls and check their textures
+    PFIvector materials = pfiGenVector(2, sizeof(PFImaterial));
+    PFerrcode errCode = (materials.data == NULL) ? PF_ERROR_OUT_OF_MEMORY : PF_NO_ERROR;
+    PFuint textureSlotCount = 0;
+    PFsizei streamsSize = 0;
+
+    for (PFsizei i = 0; i < list->calls.size && errCode == PF_NO_ERROR; i++) {
+        const PFIrendercall *call = pfiAtVector(&list->calls, i);
+        for (int_fast8_t face = 0; face < 2; face++) {
+            if (pfiFindListMaterial(&materials, &call->faceMaterial[face]) == materials.size
+                && pfiPushBackVector(&materials, &call->faceMaterial[face]) != 0) {
+                errCode = PF_ERROR_OUT_OF_MEMORY;
+            }
+        }
+        for (int_fast8_t unit = 0; unit < 2; unit++) {
+            PFuint textureSlot = pfiFindTextureSlot(unit ? call->texture1 : call->texture, textures, textureCount);
+            if (textureSlot == textureCount) {
+                errCode = PF_INVALID_VALUE;
+            } else if (textureSlot != PFI_LIST_NO_TEXTURE && textureSlot >= textureSlotCount) {
+                textureSlotCount = textureSlot + 1;
+            }
+        }
+        streamsSize += pfiGetStreamsSize(call);
+    }
+
+    if (errCode != PF_NO_ERROR) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = errCode;
+        }
+        pfiDeleteVector(&materials);
+        return 0;
+    }
+
+    PFIlistfileheader header = {
+        .magic = { 'P', 'F', 'R', 'L' },
+        .version = PFI_LIST_FILE_VERSION,
+        .byteOrder = PFI_LIST_FILE_BYTE_ORDER,
+        .argSize = sizeof(PFIcmdarg),
+        .streamAlignment = PF_LIST_STREAM_ALIGNMENT,
+        .transforms = list->transforms,
+        .callCount = list->calls.size,
+        .materialCount = materials.size,
+        .textureCount = textureSlotCount,
+        .commandsSize = list->commands.size,
+        .streamsSize = streamsSize,
+        .bounds = pfiSaveBounds(&list->bounds)
+    };
+
+    header.commandsOffset = pfiAlignStreamSize(sizeof(PFIlistfileheader));
+    header.callsOffset = header.commandsOffset + pfiAlignStreamSize(header.commandsSize);
+    header.materialsOffset = header.callsOffset + pfiAlignStreamSize(header.callCount*sizeof(PFIlistfilecall));
+    header.streamsOffset = header.materialsOffset + pfiAlignStreamSize(header.materialCount*sizeof(PFImaterial));
+
+    PFsizei size = header.streamsOffset + streamsSize;
+
+    if (buffer == NULL || bufferSize < size) {
+        if (buffer != NULL && G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_VALUE;
+        }
+        pfiDeleteVector(&materials);
+        return (buffer == NULL) ? size : 0;
+    }
+
+    // Write the blocks, the padding between them is zeroed
+    PFubyte *bytes = buffer;
+    memset(bytes, 0, header.streamsOffset);
+    memcpy(bytes, &header, sizeof(PFIlistfileheader));
+    memcpy(bytes + header.commandsOffset, list->commands.data, header.commandsSize);
+    memcpy(bytes + header.materialsOffset, materials.data, header.materialCount*sizeof(PFImaterial));
+
+    for (PFsizei i = 0; i < list->calls.size; i++) {
+        const PFIrendercall *call = pfiAtVector(&list->calls, i);
+        PFIlistfilecall fileCall = {
+            .drawMode = call->drawMode,
+            .vertexCount = call->vertexCount,
+            .triangleCount = call->streams.triangleCount,
+            .streamsOffset = call->streams.offset,
+            .materialSlots[0] = pfiFindListMaterial(&materials, &call->faceMaterial[0]),
+            .materialSlots[1] = pfiFindListMaterial(&materials, &call->faceMaterial[1]),
+            .textureSlots[0] = pfiFindTextureSlot(call->texture, textures, textureCount),
+            .textureSlots[1] = pfiFindTextureSlot(call->texture1, textures, textureCount),
+            .indexed = call->indexed,
+            .bounds = pfiSaveBounds(&call->bounds)
+        };
+        memcpy(bytes + header.callsOffset + i*sizeof(PFIlistfilecall), &fileCall, sizeof(PFIlistfilecall));
+    }
+
+    // NOTE: The streams are at the end of the arena, after the padding that aligns them
+    memcpy(bytes + header.streamsOffset, list->arena + list->arenaSize - streamsSize, streamsSize);
+
+    pfiDeleteVector(&materials);
+
+    return size;
+}
+
+PFrenderlist
+pfLoadList(const void* data, PFsizei dataSize, const PFtexture* textures, PFsizei textureCount)
+{
+    const PFubyte *bytes = data;
+    PFIlistfileheader header;
+    PFerrcode errCode = PF_INVALID_VALUE;
+    PFIrenderlist *list = NULL;
+
+    // NOTE: The blocks are copied with 'memcpy', except the streams which are used in place,
+    //       so that the data can be read at any address (e.g. from an archive in memory)
+    if (data == NULL || dataSize < sizeof(PFIlistfileheader)) goto error;
+    memcpy(&header, bytes, sizeof(PFIlistfileheader));
+    if (!pfiIsValidListHeader(&header, dataSize, (textures != NULL) ? textureCount : 0)) goto error;
+
+    errCode = PF_ERROR_OUT_OF_MEMORY;
+    list = pfGenList();
+    if (list == NULL) goto error;
+
+    if (header.commandsSize > 0 && pfiInsertToVector(&list->commands, 0, bytes + header.commandsOffset, header.commandsSize) != 0) goto error;
+    if (pfiResizeVector(&list->calls, (header.callCount > 0) ? header.callCount : 1) < 0) goto error;
+
+    // Check the commands before they can be executed by 'pfCallList'
+    errCode = PF_INVALID_VALUE;
+    for (PFsizei offset = 0; offset < list->commands.size;) {
+        const PFIcmdheader *cmd = (const PFIcmdheader*)((const PFubyte*)list->commands.data + offset);
+        if (list->commands.size - offset < sizeof(PFIcmdheader)) goto error;
+        PFsizei cmdSize = pfiGetCommandSize(cmd->argCount, cmd->dataSize);
+        if (list->commands.size - offset < cmdSize) goto error;
+        if (!pfiIsValidListCommand(cmd, (const PFIcmdarg*)(cmd + 1), header.callCount)) goto error;
+        offset += cmdSize;
+    }
+
+    // Use the streams in place if they are aligned, otherwise copy them into the arena
+    const PFubyte *streams = bytes + header.streamsOffset;
+    if ((uintptr_t)streams % PF_LIST_STREAM_ALIGNMENT == 0) {
+        list->arena = (PFubyte*)streams;
+        list->arenaSize = list->arenaCapacity = header.streamsSize;
+        list->externalArena = PF_TRUE;
+    } else {
+        errCode = PF_ERROR_OUT_OF_MEMORY;
+        if (!pfiReserveArena(list, header.streamsSize + PF_LIST_STREAM_ALIGNMENT - 1)) goto error;
+        PFsizei padding = (PFsizei)((PF_LIST_STREAM_ALIGNMENT - (uintptr_t)list->arena % PF_LIST_STREAM_ALIGNMENT) % PF_LIST_STREAM_ALIGNMENT);
+        memcpy(list->arena + padding, streams, header.streamsSize);
+        list->arenaSize = padding + header.streamsSize;
+        errCode = PF_INVALID_VALUE;
+    }
+
+    for (PFsizei i = 0; i < header.callCount; i++) {
+        PFIlistfilecall fileCall;
+        memcpy(&fileCall, bytes + header.callsOffset + i*sizeof(PFIlistfilecall), sizeof(PFIlistfilecall));
+
+        // NOTE: Each vertex takes at least the size of its attributes in the streams
+        if ((PFint)fileCall.drawMode < PF_POINTS || fileCall.drawMode > PF_QUAD_STRIP
+            || (uint64_t)fileCall.vertexCount*sizeof(PFIlistvertex) > header.streamsSize
+            || fileCall.materialSlots[0] >= header.materialCount || fileCall.materialSlots[1] >= header.materialCount
+            || (fileCall.textureSlots[0] != PFI_LIST_NO_TEXTURE && fileCall.textureSlots[0] >= header.textureCount)
+            || (fileCall.textureSlots[1] != PFI_LIST_NO_TEXTURE && fileCall.textureSlots[1] >= header.textureCount)
+            || (fileCall.indexed != 0 && (fileCall.drawMode != PF_TRIANGLES
+                || (uint64_t)fileCall.triangleCount*3*sizeof(PFuint) > header.streamsSize))) {
+            goto error;
+        }
+
+        PFIrendercall call = {
+            .vertexCount = fileCall.vertexCount,
+            .texture = (fileCall.textureSlots[0] != PFI_LIST_NO_TEXTURE) ? textures[fileCall.textureSlots[0]] : NULL,
+            .texture1 = (fileCall.textureSlots[1] != PFI_LIST_NO_TEXTURE) ? textures[fileCall.textureSlots[1]] : NULL,
+            .streams.triangleCount = fileCall.triangleCount,
+            .drawMode = fileCall.drawMode,
+            .indexed = (fileCall.indexed != 0),
+            .bounds = pfiLoadBounds(&fileCall.bounds)
+        };
+
+        for (int_fast8_t face = 0; face < 2; face++) {
+            memcpy(&call.faceMaterial[face], bytes + header.materialsOffset + fileCall.materialSlots[face]*sizeof(PFImaterial), sizeof(PFImaterial));
+        }
+
+        // The layout of the streams must match the one 'pfEndList' would have computed
+        PFsizei streamsSize = pfiLayoutCall(&call);
+        if (call.streams.triangleCount != fileCall.triangleCount || fileCall.streamsOffset % PF_LIST_STREAM_ALIGNMENT != 0
+            || (uint64_t)fileCall.streamsOffset + streamsSize > header.streamsSize) {
+            goto error;
+        }
+
+        call.streams.offset = fileCall.streamsOffset;
+        pfiSetStreamsPointers(&call.streams, call.vertexCount, list->arena + list->arenaSize - header.streamsSize);
+
+        // NOTE: The triangles are read without bounds checks when the call is drawn
+        for (PFsizei j = 0; j < 3*call.streams.triangleCount; j++) {
+            if (call.streams.triangles[j] >= call.vertexCount) goto error;
+        }
+
+        pfiPushBackVector(&list->calls, &call);
+    }
+
+    list->bounds = pfiLoadBounds(&header.bounds);
+    list->transforms = (header.transforms != 0);
+    list->compiled = PF_TRUE;
+
+    return list;
+
+error:
+    if (G_currentCtx) {
+        G_currentCtx->errCode = errCode;
+    }
+    if (list != NULL) {
+        PFrenderlist renderList = list;
+        pfDeleteList(&renderList);
+    }
+    return NULL;
+}
+
+/* List recorder functions */
+
+PFlistrecorder
+pfGenListRecorder(PFrenderlist renderList)
+{
+    if (renderList == NULL) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_VALUE;
+        }
+        return NULL;
+    }
+
+    PFIlistrecorder *recorder = PF_MALLOC(sizeof(PFIlistrecorder));
+
+    if (recorder == NULL) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        }
+        return NULL;
+    }
+
+    *recorder = (PFIlistrecorder) {
+        .list = renderList,
+        .faceMaterial[0] = pfiGetDefaultMaterial(),
+        .faceMaterial[1] = pfiGetDefaultMaterial(),
+        .currentTexture = { NULL, NULL },
+        .activeTexture = PF_TEXTURE0,
+        .currentNormal = { 0 },
+        .currentTexcoord = { { 0 } },
+        .currentColor = (PFcolor) { 255, 255, 255, 255 },
+        .inBegin = PF_FALSE
+    };
+
+    pfiClearList(recorder->list);
+
+    return recorder;
+}
+
+void
+pfDeleteListRecorder(PFlistrecorder* recorder)
+{
+    if (recorder == NULL || *recorder == NULL) return;
+
+    pfiCompileList(((PFIlistrecorder*)*recorder)->list, PF_FALSE);
+
+    PF_FREE(*recorder);
+    *recorder = NULL;
+}
+
+void
+pfRecorderBegin(PFlistrecorder recorder, PFdrawmode mode)
+{
+    PFIlistrecorder *rec = recorder;
+
+    if (rec->inBegin || mode < PF_POINTS || mode > PF_QUAD_STRIP) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = rec->inBegin ? PF_INVALID_OPERATION : PF_INVALID_ENUM;
+        }
+        return;
+    }
+
+    pfiRecordBegin(rec->list, mode, rec->faceMaterial, rec->currentTexture[0], rec->currentTexture[1]);
+    rec->inBegin = PF_TRUE;
+}
+
+void
+pfRecorderEnd(PFlistrecorder recorder)
+{
+    ((PFIlistrecorder*)recorder)->inBegin = PF_FALSE;
+}
+
+void
+pfRecorderVertex3f(PFlistrecorder recorder, PFfloat x, PFfloat y, PFfloat z)
+{
+    PFMvec4 v = { x, y, z, 1.0f };
+    pfRecorderVertex4fv(recorder, v);
+}
+
+void
+pfRecorderVertex3fv(PFlistrecorder recorder, const PFfloat* v)
+{
+    PFMvec4 v4 = { v[0], v[1], v[2], 1.0f };
+    pfRecorderVertex4fv(recorder, v4);
+}
+
+void
+pfRecorderVertex4fv(PFlistrecorder recorder, const PFfloat* v)
+{
+    PFIlistrecorder *rec = recorder;
+
+    if (!rec->inBegin) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_OPERATION;
+        }
+        return;
+    }
+
+    pfiRecordVertex(rec->list, v, rec->currentTexcoord[0], rec->currentTexcoord[1], rec->currentNormal, rec->currentColor);
+}
+
+void
+pfRecorderColor4ub(PFlistrecorder recorder, PFubyte r, PFubyte g, PFubyte b, PFubyte a)
+{
+    ((PFIlistrecorder*)recorder)->currentColor = (PFcolor) { r, g, b, a };
+}
+
+void
+pfRecorderNormal3f(PFlistrecorder recorder, PFfloat x, PFfloat y, PFfloat z)
+{
+    pfmVec3Set(((PFIlistrecorder*)recorder)->currentNormal, x, y, z);
+}
+
+void
+pfRecorderTexCoord2f(PFlistrecorder recorder, PFfloat u, PFfloat v)
+{
+    pfmVec2Set(((PFIlistrecorder*)recorder)->currentTexcoord[0], u, v);
+}
+
+void
+pfRecorderMultiTexCoord2f(PFlistrecorder recorder, PFtextureunit unit, PFfloat u, PFfloat v)
+{
+    if (unit != PF_TEXTURE0 && unit != PF_TEXTURE1) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+        }
+        return;
+    }
+
+    pfmVec2Set(((PFIlistrecorder*)recorder)->currentTexcoord[unit], u, v);
+}
+
+void
+pfRecorderMaterialfv(PFlistrecorder recorder, PFface face, PFenum param, const void* value)
+{
+    PFIlistrecorder *rec = recorder;
+
+    if (face < PF_FRONT || face > PF_FRONT_AND_BACK) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+        }
+        return;
+    }
+
+    PFImaterial *material0 = &rec->faceMaterial[(face == PF_BACK) ? PF_BACK : PF_FRONT];
+    PFImaterial *material1 = &rec->faceMaterial[(face == PF_FRONT) ? PF_FRONT : PF_BACK];
+
+    if (!pfiSetMaterialParam(material0, material1, param, value)) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+        }
+    }
+}
+
+void
+pfRecorderActiveTexture(PFlistrecorder recorder, PFtextureunit unit)
+{
+    if (unit != PF_TEXTURE0 && unit != PF_TEXTURE1) {
+        if (G_currentCtx) {
+            G_currentCtx->errCode = PF_INVALID_ENUM;
+        }
+        return;
+    }
+
+    ((PFIlistrecorder*)recorder)->activeTexture = unit;
+}
+
+void
+pfRecorderBindTexture(PFlistrecorder recorder, PFtexture texture)
+{
+    PFIlistrecorder *rec = recorder;
+    rec->currentTexture[rec->activeTexture] = texture;
 }
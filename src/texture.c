@@ -20,16 +20,242 @@
 #include "internal/context/context.h"
 #include "internal/sampler.h"
 #include "internal/pixel.h"
+#include "internal/thread.h"
 #include "pixelforge.h"
 
 #include <stdlib.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Decoded blocks of the compressed textures */
+
+typedef struct {
+    PFuint      cacheId;                ///< 'cacheId' of the texture of the block, 0 if the entry is empty
+    PFsizei     block;                  ///< Index of the block in the texels of the texture
+    PFcolor     texels[16];
+} PFIdecodedblock;
+
+// NOTE: Each thread keeps its own blocks, the samplers of a texture run on several threads
+static PF_CTX_DECL PFIdecodedblock G_decodedBlocks[PF_TEXTURE_BLOCK_CACHE_SIZE];
+
+static volatile PFint G_lastCacheId = 0;
+
+// NOTE: Returns an identifier for texels that have never been decoded, so that
+//       the cached blocks of the previous texels are never returned again
+static PFuint
+pfiNewCacheId(void)
+{
+    PFuint cacheId;
+    do {
+        cacheId = (PFuint)pfiAtomicFetchAdd(&G_lastCacheId, 1) + 1;
+    } while (cacheId == 0);
+    return cacheId;
+}
+
+PFcolor pfiGetBlockTexel(const struct PFItex* tex, PFsizei x, PFsizei y)
+{
+    PFsizei offset = pfiGetTexelOffset(tex, x, y);
+    PFsizei block = offset >> 4;
+
+    // NOTE: The blocks next to each other in a row or a column use different entries
+    PFsizei index = ((x >> 2) + (y >> 2)*4 + tex->cacheId) & (PF_TEXTURE_BLOCK_CACHE_SIZE - 1);
+    PFIdecodedblock *entry = &G_decodedBlocks[index];
+
+    if (entry->cacheId != tex->cacheId || entry->block != block) {
+        PFsizei blockBytes = (tex->format == PF_COMPRESSED_BC3) ? 16 : 8;
+        GC_blockDecoders[tex->format - PF_COMPRESSED_BC1]((const PFubyte*)tex->pixels + block*blockBytes, entry->texels);
+        entry->cacheId = tex->cacheId;
+        entry->block = block;
+    }
+
+    return entry->texels[offset & 15];
+}
+
+/* Internal helper functions */
+
+// NOTE: Returns the number of texels stored for a texture in the given layout, the tiles are complete
+static PFsizei
+pfiGetLayoutTexelCount(PFtexturelayout layout, PFsizei width, PFsizei height)
+{
+    if (layout == PF_LAYOUT_TILED) {
+        return ((width + 3) & ~3u)*((height + 3) & ~3u);
+    }
+    return width*height;
+}
+
+static PFuint
+pfiGetMortonBits(PFsizei width, PFsizei height)
+{
+    PFuint bits = 0;
+    while ((2u << bits) <= PF_MIN(width, height)) bits++;
+    return bits;
+}
+
+// NOTE: Returns the number of texels from a row to the next of a linear copy of the texels,
+//       so that each row starts on PF_TEXTURE_STORAGE_ALIGNMENT bytes
+static PFsizei
+pfiGetStoragePitch(PFsizei width, PFsizei pixelBytes)
+{
+    PFsizei rowAlignment = PF_TEXTURE_STORAGE_ALIGNMENT;
+    while (rowAlignment % pixelBytes != 0) {
+        rowAlignment += PF_TEXTURE_STORAGE_ALIGNMENT;
+    }
+
+    PFsizei pitchAlignment = rowAlignment/pixelBytes;
+    return ((width + pitchAlignment - 1)/pitchAlignment)*pitchAlignment;
+}
+
+// NOTE: Copies the texels of 'src' into 'dst' (of the same size) in the layout and format of 'dst'
+static void
+pfiCopyTexels(struct PFItex* dst, const struct PFItex* src)
+{
+    if (dst->format != src->format || dst->type != src->type) {
+        for (PFsizei y = 0; y < src->h; y++) {
+            for (PFsizei x = 0; x < src->w; x++) {
+                dst->setter(dst->pixels, pfiGetTexelOffset(dst, x, y), pfiGetTexel(src, x, y));
+            }
+        }
+        return;
+    }
+
+    PFsizei pixelBytes = pfiGetPixelBytes(src->format, src->type);
+
+    for (PFsizei y = 0; y < src->h; y++) {
+        for (PFsizei x = 0; x < src->w; x++) {
+            memcpy((PFubyte*)dst->pixels + pfiGetTexelOffset(dst, x, y)*pixelBytes,
+                   (const PFubyte*)src->pixels + pfiGetTexelOffset(src, x, y)*pixelBytes, pixelBytes);
+        }
+    }
+}
+
+// NOTE: Replaces the texels of the texture by a copy of its source in the given layout and format,
+//       the source is sampled again if they are its own. The texture is unchanged if the copy
+//       cannot be allocated, PF_FALSE is then returned. The blocks of a compressed source
+//       are in PF_LAYOUT_TILED, and they are decoded again if they have been modified.
+static PFboolean
+pfiUpdateTexels(struct PFItex* tex, PFtexturelayout layout, PFpixelformat format, PFdatatype type)
+{
+    struct PFItex src = *tex;
+    src.pixels = tex->source;
+    src.format = tex->sourceFormat;
+    src.type = tex->sourceType;
+    src.getter = GC_pixelGetters[src.format][src.type];
+    src.layout = pfiIsCompressedFormat(src.format) ? PF_LAYOUT_TILED : PF_LAYOUT_LINEAR;
+    src.pitch = tex->w;
+    src.cacheId = pfiNewCacheId();
+
+    struct PFItex dst = *tex;
+    dst.pixels = tex->source;
+    dst.storage = NULL;
+    dst.format = format;
+    dst.type = type;
+    dst.layout = layout;
+    dst.pitch = tex->w;
+    dst.mortonBits = pfiGetMortonBits(tex->w, tex->h);
+    dst.cacheId = src.cacheId;
+    dst.getter = GC_pixelGetters[format][type];
+    dst.setter = GC_pixelSetters[format][type];
+
+#if PF_SIMD_SUPPORT
+    dst.getterSimd = GC_pixelGetters_simd[format][type];
+    dst.setterSimd = GC_pixelSetters_simd[format][type];
+#endif //PF_SIMD_SUPPORT
+
+    if (layout != src.layout || format != src.format || type != src.type) {
+        PFsizei pixelBytes = pfiGetPixelBytes(format, type);
+        PFsizei texelCount = pfiGetLayoutTexelCount(layout, tex->w, tex->h);
+
+        if (layout == PF_LAYOUT_LINEAR) {
+            dst.pitch = pfiGetStoragePitch(tex->w, pixelBytes);
+            texelCount = dst.pitch*tex->h;
+        }
+
+        dst.storage = PF_MALLOC(texelCount*pixelBytes + PF_TEXTURE_STORAGE_ALIGNMENT - 1);
+        if (dst.storage == NULL) {
+            return PF_FALSE;
+        }
+
+        dst.pixels = (void*)(((uintptr_t)dst.storage + PF_TEXTURE_STORAGE_ALIGNMENT - 1) & ~(uintptr_t)(PF_TEXTURE_STORAGE_ALIGNMENT - 1));
+        pfiCopyTexels(&dst, &src);
+    }
+
+    PF_FREE(tex->storage);
+    *tex = dst;
+
+    return PF_TRUE;
+}
+
+static void
+pfiDownsampleTexel(struct PFItex* dst, const struct PFItex* src, PFsizei x, PFsizei y)
+{
+    PFsizei x0 = 2*x, x1 = PF_MIN(2*x + 1, src->w - 1);
+    PFsizei y0 = 2*y, y1 = PF_MIN(2*y + 1, src->h - 1);
+
+    PFcolor c[4] = {
+        pfiGetTexel(src, x0, y0),
+        pfiGetTexel(src, x1, y0),
+        pfiGetTexel(src, x0, y1),
+        pfiGetTexel(src, x1, y1)
+    };
+
+    PFcolor average;
+    for (int_fast8_t i = 0; i < 4; i++) {
+        PFuint sum = ((PFubyte*)&c[0])[i] + ((PFubyte*)&c[1])[i] + ((PFubyte*)&c[2])[i] + ((PFubyte*)&c[3])[i];
+        ((PFubyte*)&average)[i] = (PFubyte)((sum + 2) >> 2);
+    }
+
+    dst->setter(dst->pixels, pfiGetTexelOffset(dst, x, y), average);
+}
+
+// NOTE: Writes into 'dst' the average of each 2x2 block of texels of 'src'. The size of a level
+//       is rounded down, so the last row or column of an odd size is dropped, only a side of a
+//       single texel is repeated to complete the blocks
+static void
+pfiDownsampleTexture(struct PFItex* dst, const struct PFItex* src)
+{
+    for (PFsizei y = 0; y < dst->h; y++) {
+        PFsizei x = 0;
+
+#if PF_SIMD_SUPPORT
+        // NOTE: The groups of texels are written with a full mask, the last texels of
+        //       the row are written one by one so that nothing is written past the row.
+        //       The texels of a group are only contiguous in the linear layout.
+        PFIsimdvi y0 = pfiSimdSet1_I32(2*y), y1 = pfiSimdSet1_I32(PF_MIN(2*y + 1, src->h - 1));
+        PFIsimdvi pixOffsetV = pfiSimdSetR_I32(0, 1, 2, 3, 4, 5, 6, 7);
+        PFIsimdvi mask = pfiSimdSet1_I32(-1);
+
+        for (; dst->layout == PF_LAYOUT_LINEAR && x + PF_SIMD_SIZE <= dst->w; x += PF_SIMD_SIZE) {
+            PFIsimdvi x0 = pfiSimdShl_I32(pfiSimdAdd_I32(pfiSimdSet1_I32(x), pixOffsetV), 1);
+            PFIsimdvi x1 = pfiSimdMin_I32(pfiSimdAdd_I32(x0, pfiSimdSet1_I32(1)), pfiSimdSet1_I32(src->w - 1));
+
+            PFIsimdvi c[4][4];
+            pfiColorSIMDToVecI_simd(c[0], pfiGetTexel_simd(src, x0, y0), 4);
+            pfiColorSIMDToVecI_simd(c[1], pfiGetTexel_simd(src, x1, y0), 4);
+            pfiColorSIMDToVecI_simd(c[2], pfiGetTexel_simd(src, x0, y1), 4);
+            pfiColorSIMDToVecI_simd(c[3], pfiGetTexel_simd(src, x1, y1), 4);
+
+            PFIsimdvi average[4];
+            for (int_fast8_t i = 0; i < 4; i++) {
+                PFIsimdvi sum = pfiSimdAdd_I32(pfiSimdAdd_I32(c[0][i], c[1][i]), pfiSimdAdd_I32(c[2][i], c[3][i]));
+                average[i] = pfiSimdShr_I32(pfiSimdAdd_I32(sum, pfiSimdSet1_I32(2)), 2);
+            }
+
+            dst->setterSimd(dst->pixels, y*dst->pitch + x, pfiColorSIMDFromVecI_simd(average, 4), mask);
+        }
+#endif //PF_SIMD_SUPPORT
+
+        for (; x < dst->w; x++) {
+            pfiDownsampleTexel(dst, src, x, y);
+        }
+    }
+}
 
 /* Texture functions */
 
 PFtexture pfGenTexture(void* pixels, PFsizei width, PFsizei height, PFpixelformat format, PFdatatype type)
 {
-    if (!pfiIsPixelFormatValid(format, type)) {
+    if (!pfiIsTextureFormatValid(format, type)) {
         if (G_currentCtx) {
             G_currentCtx->errCode = PF_INVALID_ENUM;
         }
@@ -46,25 +272,49 @@ PFtexture pfGenTexture(void* pixels, PFsizei width, PFsizei height, PFpixelforma
     }
 
     texture->pixels = pixels;
+    texture->source = pixels;
+    texture->storage = NULL;
     texture->format = format;
     texture->type = type;
+    texture->sourceFormat = format;
+    texture->sourceType = type;
 
     texture->w = width;
     texture->h = height;
+    texture->pitch = width;
 
-    texture->tx = 1.0f / width;
-    texture->ty = 1.0f / height;
+    texture->mipmaps = NULL;
+    texture->mipmapCount = 0;
+    texture->filter = PF_NEAREST;
+    texture->layout = pfiIsCompressedFormat(format) ? PF_LAYOUT_TILED : PF_LAYOUT_LINEAR;
+    texture->mortonBits = 0;
+    texture->cacheId = pfiNewCacheId();
+    texture->palette = NULL;
+
+    if (format == PF_COLOR_INDEX) {
+        texture->palette = PF_MALLOC(256*sizeof(PFcolor));
+        if (texture->palette == NULL) {
+            if (G_currentCtx) {
+                G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+            }
+            PF_FREE(texture);
+            return NULL;
+        }
+        for (PFuint i = 0; i < 256; i++) {
+            texture->palette[i] = (PFcolor) { (PFubyte)i, (PFubyte)i, (PFubyte)i, 255 };
+        }
+    }
 
     texture->getter = GC_pixelGetters[format][type];
     texture->setter = GC_pixelSetters[format][type];
-    texture->sampler = pfiTexture2DSampler_NEAREST_REPEAT;
 
 #if PF_SIMD_SUPPORT
     texture->getterSimd = GC_pixelGetters_simd[format][type];
     texture->setterSimd = GC_pixelSetters_simd[format][type];
-    texture->samplerSimd = pfiTexture2DSampler_NEAREST_REPEAT_simd;
 #endif //PF_SIMD_SUPPORT
 
+    pfiSetTextureSampler(texture, PF_NEAREST, PF_REPEAT);
+
     return texture;
 }
 
@@ -72,9 +322,13 @@ void pfDeleteTexture(PFtexture* texture, PFboolean freeBuffer)
 {
     struct PFItex* tex = *texture;
     if (tex) {
-        if (freeBuffer && tex->pixels) {
-            PF_FREE(tex->pixels);
+        if (G_currentCtx) pfFinish();
+        PF_FREE(tex->storage);
+        PF_FREE(tex->palette);
+        if (freeBuffer && tex->source) {
+            PF_FREE(tex->source);
         }
+        PF_FREE(tex->mipmaps);
         PF_FREE(tex);
         *texture = NULL;
     }
@@ -87,7 +341,7 @@ PFboolean pfIsValidTexture(const PFtexture texture)
     if (tex) {
         result = tex->pixels &&
                  tex->w > 0 && tex->h > 0 &&
-                 tex->getter && tex->setter;
+                 (tex->getter || tex->palette) && (tex->setter || pfiIsDecodeOnlyFormat(tex->format));
     }
     return result;
 }
@@ -96,16 +350,195 @@ void pfTextureParameter(PFtexture texture, PFtexturewrap wrapMode, PFtexturefilt
 {
     struct PFItex* tex = texture;
 
+    // NOTE: The texture can be in use by the render thread of a deferred context
+    if (G_currentCtx) pfFinish();
+
     if (!pfiIsTextureParameterValid(wrapMode, filterMode)) {
         if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_ENUM;
         return;
     }
 
-    tex->sampler = GC_textureSamplers[filterMode][wrapMode];
+    // NOTE: The sampler of each level uses the filter within a level, the mipmap filters
+    //       only select the levels (see 'pfiTexture2DSampleLod')
+    PFtexturefilter levelFilter = pfiGetLevelFilter(filterMode);
+
+    tex->filter = filterMode;
 
+    for (PFsizei i = 0; i <= tex->mipmapCount; i++) {
+        struct PFItex *level = (i == 0) ? tex : &tex->mipmaps[i - 1];
+        pfiSetTextureSampler(level, levelFilter, wrapMode);
+    }
+}
+
+void pfTextureLayout(PFtexture texture, PFtexturelayout layout)
+{
+    struct PFItex* tex = texture;
+
+    // NOTE: The texture can be in use by the render thread of a deferred context
+    if (G_currentCtx) pfFinish();
+
+    if (layout < PF_LAYOUT_LINEAR || layout > PF_LAYOUT_MORTON) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
+
+    if (pfiIsCompressedFormat(tex->format)) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_OPERATION;
+        return;
+    }
+
+    if (layout == PF_LAYOUT_MORTON && !pfiIsTexturePOT(tex)) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_VALUE;
+        return;
+    }
+
+    if (!pfiUpdateTexels(tex, layout, tex->format, tex->type)) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        return;
+    }
+
+    // NOTE: If the levels cannot be generated again, the previous ones remain usable in their own layout
+    if (tex->mipmapCount > 0) {
+        pfGenerateMipmaps(texture);
+    }
+}
+
+void pfTextureStorage(PFtexture texture, PFpixelformat format, PFdatatype type)
+{
+    struct PFItex* tex = texture;
+
+    // NOTE: The texture can be in use by the render thread of a deferred context
+    if (G_currentCtx) pfFinish();
+
+    if (!pfiIsTextureFormatValid(format, type)) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_ENUM;
+        return;
+    }
+
+    // NOTE: The texels can be decoded, but not compressed or indexed again in another format
+    if (pfiIsDecodeOnlyFormat(format) && format != tex->sourceFormat) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_OPERATION;
+        return;
+    }
+
+    PFtexturelayout layout = pfiIsCompressedFormat(format) ? PF_LAYOUT_TILED : tex->layout;
+
+    if (!pfiUpdateTexels(tex, layout, format, type)) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        return;
+    }
+
+    // NOTE: If the levels cannot be generated again, the previous ones remain usable in their own format
+    if (tex->mipmapCount > 0) {
+        pfGenerateMipmaps(texture);
+    }
+}
+
+void pfTexturePalette(PFtexture texture, const PFcolor* palette)
+{
+    struct PFItex* tex = texture;
+
+    // NOTE: The palette can be in use by the render thread of a deferred context
+    if (G_currentCtx) pfFinish();
+
+    if (palette == NULL) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_VALUE;
+        return;
+    }
+
+    if (tex->sourceFormat != PF_COLOR_INDEX) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_INVALID_OPERATION;
+        return;
+    }
+
+    memcpy(tex->palette, palette, 256*sizeof(PFcolor));
+
+    // NOTE: If the texels cannot be decoded again, the previous ones remain usable with the previous colors
+    if (tex->format != PF_COLOR_INDEX && !pfiUpdateTexels(tex, tex->layout, tex->format, tex->type)) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        return;
+    }
+
+    if (tex->mipmapCount > 0) {
+        pfGenerateMipmaps(texture);
+    }
+}
+
+void pfGenerateMipmaps(PFtexture texture)
+{
+    struct PFItex* tex = texture;
+
+    // NOTE: The levels can be in use by the render thread of a deferred context
+    if (G_currentCtx) pfFinish();
+
+    // NOTE: The levels of a compressed or indexed texture are stored decoded
+    PFpixelformat levelFormat = tex->format;
+    PFdatatype levelType = tex->type;
+    if (pfiIsDecodeOnlyFormat(levelFormat)) {
+        levelFormat = PF_RGBA;
+        levelType = PF_UNSIGNED_BYTE;
+    }
+
+    // Get the number of levels after the base level, and the size of their texels
+    PFsizei pixelBytes = pfiGetPixelBytes(levelFormat, levelType);
+    PFsizei levelCount = 0, pixelsSize = 0;
+
+    for (PFsizei w = tex->w, h = tex->h; w > 1 || h > 1; levelCount++) {
+        w = PF_MAX(w/2, 1), h = PF_MAX(h/2, 1);
+        pixelsSize += pfiGetLayoutTexelCount(tex->layout, w, h)*pixelBytes;
+    }
+
+    if (levelCount == 0) {
+        PF_FREE(tex->mipmaps);
+        tex->mipmaps = NULL;
+        tex->mipmapCount = 0;
+        return;
+    }
+
+    // NOTE: The levels and their texels are stored in a single allocation
+    PFsizei levelsSize = levelCount*sizeof(struct PFItex);
+    PFubyte *memory = PF_MALLOC(levelsSize + pixelsSize);
+
+    if (memory == NULL) {
+        if (G_currentCtx) G_currentCtx->errCode = PF_ERROR_OUT_OF_MEMORY;
+        return;
+    }
+
+    struct PFItex *levels = (struct PFItex*)memory;
+    PFubyte *pixels = memory + levelsSize;
+
+    for (PFsizei i = 0; i < levelCount; i++) {
+        const struct PFItex *src = (i == 0) ? tex : &levels[i - 1];
+        struct PFItex *dst = &levels[i];
+
+        *dst = *src;
+        dst->pixels = pixels;
+        dst->source = pixels;
+        dst->storage = NULL;
+        dst->format = dst->sourceFormat = levelFormat;
+        dst->type = dst->sourceType = levelType;
+        dst->getter = GC_pixelGetters[levelFormat][levelType];
+        dst->setter = GC_pixelSetters[levelFormat][levelType];
 #   if PF_SIMD_SUPPORT
-        tex->samplerSimd = GC_textureSamplers_simd[filterMode][wrapMode];
+        dst->getterSimd = GC_pixelGetters_simd[levelFormat][levelType];
+        dst->setterSimd = GC_pixelSetters_simd[levelFormat][levelType];
 #   endif //PF_SIMD_SUPPORT
+        dst->w = PF_MAX(src->w/2, 1);
+        dst->h = PF_MAX(src->h/2, 1);
+        dst->pitch = dst->w;
+        dst->mipmaps = NULL;
+        dst->mipmapCount = 0;
+        dst->palette = NULL;
+        dst->mortonBits = pfiGetMortonBits(dst->w, dst->h);
+
+        pfiDownsampleTexture(dst, src);
+        pixels += pfiGetLayoutTexelCount(dst->layout, dst->w, dst->h)*pixelBytes;
+    }
+
+    PF_FREE(tex->mipmaps);
+
+    tex->mipmaps = levels;
+    tex->mipmapCount = levelCount;
 }
 
 void* pfGetTexturePixels(const PFtexture texture, PFsizei* width, PFsizei* height, PFpixelformat* format, PFdatatype* type)
@@ -115,9 +548,9 @@ void* pfGetTexturePixels(const PFtexture texture, PFsizei* width, PFsizei* heigh
     if (tex) {
         if (width) *width = tex->w;
         if (height) *height = tex->h;
-        if (format) *format = tex->format;
-        if (type) *type = tex->type;
-        pixels = tex->pixels;
+        if (format) *format = tex->sourceFormat;
+        if (type) *type = tex->sourceType;
+        pixels = tex->source;
     }
     return pixels;
 }
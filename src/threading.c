@@ -0,0 +1,355 @@
+/**
+ *  Copyright (c) 2024 Le Juez Victor
+ *
+ *  This software is provided "as-is", without any express or implied warranty. In no event 
+ *  will the authors be held liable for any damages arising from the use of this software.
+ *
+ *  Permission is granted to anyone to use this software for any purpose, including commercial 
+ *  applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *  1. The origin of this software must not be misrepresented; you must not claim that you 
+ *  wrote the original software. If you use this software in a product, an acknowledgment 
+ *  in the product documentation would be appreciated but is not required.
+ *
+ *  2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *  as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ */
+
+// NOTE: Required by 'pthread_setaffinity_np', must be defined before any include
+#ifndef _GNU_SOURCE
+#   define _GNU_SOURCE
+#endif //_GNU_SOURCE
+
+#include "internal/context/context.h"
+#include "internal/threadpool.h"
+#include "internal/thread.h"
+#include "internal/config.h"
+#include "pixelforge.h"
+
+/* Internal structures */
+
+typedef struct {
+    PFIctx *ctx;                ///< Context made current for the threads running the range
+    PFjobfunc func;             ///< Function called for each chunk of the range
+    void *job;                  ///< Data given to 'func'
+    PFint end;                  ///< End of the range (excluded)
+    PFint grain;                ///< Number of iterations of a chunk
+    volatile PFint next;        ///< Beginning of the next chunk to claim
+} PFIparallelfor;
+
+typedef struct {
+    PFIthread threads[PF_MAX_THREADS - 1];
+    PFImutex mutex;
+    PFIcond wakeCond;           ///< Signaled when a range is submitted or the workers must quit
+    PFIcond doneCond;           ///< Signaled when the workers are done with a range, or when the pool is released
+    PFIparallelfor *range;      ///< Range being run, NULL once the submitting thread ran out of chunks
+    PFuint generation;          ///< Incremented each time a range is submitted
+    PFint workerCount;          ///< Number of worker threads running
+    PFint runningCount;         ///< Number of worker threads running chunks of 'range'
+    PFint threadCount;          ///< Number of threads requested, the submitting thread included
+    PFjobdispatcher dispatcher; ///< Job system of the user, replaces the workers if not NULL
+    void *dispatcherData;       ///< User data given to 'dispatcher'
+    PFboolean started;          ///< Whether the workers have been created for 'threadCount'
+    PFboolean affinity;         ///< Whether the workers are pinned to a logical processor
+    PFboolean busy;             ///< Whether a range or a reconfiguration is in progress
+    PFboolean quit;
+} PFIthreadpool;
+
+/* Internal data */
+
+static PFIthreadpool G_threadPool;
+static PFIonce G_threadPoolOnce = PFI_ONCE_INIT;
+
+/* Internal helper functions */
+
+static void
+pfiInitThreadPool(void)
+{
+    PFIthreadpool *pool = &G_threadPool;
+
+    pfiMutexInit(&pool->mutex);
+    pfiCondInit(&pool->wakeCond);
+    pfiCondInit(&pool->doneCond);
+
+    pool->threadCount = PF_MIN(pfiGetProcessorCount(), PF_MAX_THREADS);
+}
+
+static void
+pfiRunChunks(PFIparallelfor* range)
+{
+    // NOTE: Only has an effect on the worker threads
+    if (G_currentCtx != range->ctx) {
+        G_currentCtx = range->ctx;
+    }
+
+    for (;;) {
+        PFint begin = pfiAtomicFetchAdd(&range->next, range->grain);
+        if (begin >= range->end) break;
+
+        PFint end = PF_MIN(begin + range->grain, range->end);
+        range->func(range->job, begin, end);
+    }
+}
+
+static void
+pfiRunDispatchedChunk(void* job, PFint begin, PFint end)
+{
+    PFIparallelfor *range = job;
+
+    if (G_currentCtx != range->ctx) {
+        G_currentCtx = range->ctx;
+    }
+
+    range->func(range->job, begin, end);
+}
+
+static PFI_THREAD_FUNC(pfiWorkerThread, arg)
+{
+    PFIthreadpool *pool = arg;
+
+    pfiMutexLock(&pool->mutex);
+
+    // NOTE: The workers are created while the pool is busy, no range can be submitted before this point
+    PFuint generation = pool->generation;
+
+    for (;;) {
+        while (!pool->quit && pool->generation == generation) {
+            pfiCondWait(&pool->wakeCond, &pool->mutex);
+        }
+
+        if (pool->quit) break;
+        generation = pool->generation;
+
+        // NOTE: The range may already have been completed by the other threads
+        PFIparallelfor *range = pool->range;
+        if (range == NULL) continue;
+
+        pool->runningCount++;
+        pfiMutexUnlock(&pool->mutex);
+
+        pfiRunChunks(range);
+
+        pfiMutexLock(&pool->mutex);
+        if (--pool->runningCount == 0) {
+            pfiCondBroadcast(&pool->doneCond);
+        }
+    }
+
+    pfiMutexUnlock(&pool->mutex);
+
+    PFI_THREAD_RETURN;
+}
+
+static void
+pfiAcquireThreadPool(PFIthreadpool* pool)
+{
+    pfiMutexLock(&pool->mutex);
+    while (pool->busy) {
+        pfiCondWait(&pool->doneCond, &pool->mutex);
+    }
+    pool->busy = PF_TRUE;
+    pfiMutexUnlock(&pool->mutex);
+}
+
+static void
+pfiReleaseThreadPool(PFIthreadpool* pool)
+{
+    pfiMutexLock(&pool->mutex);
+    pool->busy = PF_FALSE;
+    pfiCondBroadcast(&pool->doneCond);
+    pfiMutexUnlock(&pool->mutex);
+}
+
+// NOTE: Must be called while the pool is acquired
+static void
+pfiStopWorkers(PFIthreadpool* pool)
+{
+    pfiMutexLock(&pool->mutex);
+    pool->quit = PF_TRUE;
+    pfiCondBroadcast(&pool->wakeCond);
+    pfiMutexUnlock(&pool->mutex);
+
+    for (PFint i = 0; i < pool->workerCount; i++) {
+        pfiThreadJoin(pool->threads[i]);
+    }
+
+    pfiMutexLock(&pool->mutex);
+    pool->workerCount = 0;
+    pool->started = PF_FALSE;
+    pool->quit = PF_FALSE;
+    pfiMutexUnlock(&pool->mutex);
+}
+
+// NOTE: Must be called while the pool is acquired
+static void
+pfiStartWorkers(PFIthreadpool* pool)
+{
+    PFint cpuCount = pfiGetProcessorCount();
+    PFint workerCount = 0;
+
+    for (PFint i = 0; i < pool->threadCount - 1; i++) {
+        if (!pfiThreadCreate(&pool->threads[i], pfiWorkerThread, pool)) break;
+        workerCount++;
+
+        // NOTE: The first logical processor is left to the submitting thread
+        if (pool->affinity) {
+            pfiThreadSetAffinity(pool->threads[i], (i + 1) % cpuCount);
+        }
+    }
+
+    pfiMutexLock(&pool->mutex);
+    pool->workerCount = workerCount;
+    pool->started = PF_TRUE;
+    pfiMutexUnlock(&pool->mutex);
+}
+
+/* Internal thread pool functions */
+
+void pfiParallelFor(PFint begin, PFint end, PFint grain, PFjobfunc func, void* job)
+{
+    PFint count = end - begin;
+    if (count <= 0) return;
+
+    PFIthreadpool *pool = &G_threadPool;
+    pfiCallOnce(&G_threadPoolOnce, pfiInitThreadPool);
+
+    pfiMutexLock(&pool->mutex);
+
+    // The workers are only created on the first parallel loop
+    if (!pool->started && !pool->busy && !pool->dispatcher && pool->threadCount > 1) {
+        pool->busy = PF_TRUE;
+        pfiMutexUnlock(&pool->mutex);
+        pfiStartWorkers(pool);
+        pfiMutexLock(&pool->mutex);
+        pool->busy = PF_FALSE;
+        pfiCondBroadcast(&pool->doneCond);
+    }
+
+    PFint threadCount = pool->dispatcher
+        ? pool->threadCount : pool->workerCount + 1;
+
+    if (grain <= 0) {
+        grain = (count + 4*threadCount - 1)/(4*threadCount);
+    }
+
+    // Run the range on this thread if it cannot be shared
+    if (pool->busy || threadCount <= 1 || count <= grain) {
+        pfiMutexUnlock(&pool->mutex);
+        func(job, begin, end);
+        return;
+    }
+
+    PFIparallelfor range = {
+        .ctx = G_currentCtx,
+        .func = func,
+        .job = job,
+        .end = end,
+        .grain = grain,
+        .next = begin
+    };
+
+    pool->busy = PF_TRUE;
+
+    if (pool->dispatcher) {
+        PFjobdispatcher dispatcher = pool->dispatcher;
+        void *dispatcherData = pool->dispatcherData;
+        pfiMutexUnlock(&pool->mutex);
+        dispatcher(pfiRunDispatchedChunk, &range, begin, end, grain, dispatcherData);
+        pfiMutexLock(&pool->mutex);
+    } else {
+        pool->range = &range;
+        pool->generation++;
+        pfiCondBroadcast(&pool->wakeCond);
+        pfiMutexUnlock(&pool->mutex);
+
+        pfiRunChunks(&range);
+
+        // Wait for the workers that are still running the last chunks
+        pfiMutexLock(&pool->mutex);
+        pool->range = NULL;
+        while (pool->runningCount > 0) {
+            pfiCondWait(&pool->doneCond, &pool->mutex);
+        }
+    }
+
+    pool->busy = PF_FALSE;
+    pfiCondBroadcast(&pool->doneCond);
+    pfiMutexUnlock(&pool->mutex);
+}
+
+/* Threading functions */
+
+void pfSetThreadCount(PFsizei count)
+{
+    PFIthreadpool *pool = &G_threadPool;
+    pfiCallOnce(&G_threadPoolOnce, pfiInitThreadPool);
+
+    if (count == 0) count = pfiGetProcessorCount();
+    count = PF_MIN(count, PF_MAX_THREADS);
+
+    pfiAcquireThreadPool(pool);
+
+    if (pool->started) {
+        pfiStopWorkers(pool);
+    }
+
+    pfiMutexLock(&pool->mutex);
+    pool->threadCount = count;
+    pfiMutexUnlock(&pool->mutex);
+
+    pfiReleaseThreadPool(pool);
+}
+
+PFsizei pfGetThreadCount(void)
+{
+    PFIthreadpool *pool = &G_threadPool;
+    pfiCallOnce(&G_threadPoolOnce, pfiInitThreadPool);
+
+    pfiMutexLock(&pool->mutex);
+    PFsizei count = pool->threadCount;
+    pfiMutexUnlock(&pool->mutex);
+
+    return count;
+}
+
+void pfSetThreadAffinity(PFboolean enabled)
+{
+    PFIthreadpool *pool = &G_threadPool;
+    pfiCallOnce(&G_threadPoolOnce, pfiInitThreadPool);
+
+    pfiAcquireThreadPool(pool);
+
+    // NOTE: The workers are created again on the next parallel loop,
+    //       which is also the way to clear the affinity of the threads
+    if (pool->started && pool->affinity != enabled) {
+        pfiStopWorkers(pool);
+    }
+
+    pfiMutexLock(&pool->mutex);
+    pool->affinity = enabled;
+    pfiMutexUnlock(&pool->mutex);
+
+    pfiReleaseThreadPool(pool);
+}
+
+void pfSetJobDispatcher(PFjobdispatcher dispatcher, void* userData)
+{
+    PFIthreadpool *pool = &G_threadPool;
+    pfiCallOnce(&G_threadPoolOnce, pfiInitThreadPool);
+
+    pfiAcquireThreadPool(pool);
+
+    // The workers of the library are no longer needed with a user job system
+    if (dispatcher && pool->started) {
+        pfiStopWorkers(pool);
+    }
+
+    pfiMutexLock(&pool->mutex);
+    pool->dispatcher = dispatcher;
+    pool->dispatcherData = userData;
+    pfiMutexUnlock(&pool->mutex);
+
+    pfiReleaseThreadPool(pool);
+}